@@ -0,0 +1,973 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include <gio/gio.h>
+#include <json-glib/json-glib.h>
+#include <math.h>
+#include <string.h>
+
+#include "geocode-glib-private.h"
+#include "geocode-glib.h"
+#include "geocode-boundary-backend.h"
+
+/**
+ * SECTION:geocode-boundary-backend
+ * @short_description: Geocode backend for offline reverse geocoding
+ * @include: geocode-glib/geocode-glib.h
+ *
+ * #GeocodeBoundaryBackend is a #GeocodeBackend which answers reverse queries
+ * from administrative boundary polygons held in memory, such as simplified
+ * country, state, county and town boundaries. A reverse query returns one
+ * #GeocodePlace for each boundary which contains the point, ordered from
+ * the most specific (such as the town) to the least specific (such as the
+ * country). The address fields of each place are filled in from the
+ * boundaries containing it, so the town’s place also has its county, state
+ * and country set. Forward queries are not supported.
+ *
+ * Boundaries are loaded from GeoJSON (RFC 7946) with
+ * geocode_boundary_backend_load_file() or
+ * geocode_boundary_backend_load_data(), which take a FeatureCollection or a
+ * single Feature. Features with Polygon or MultiPolygon geometries and a
+ * `name` property are loaded; anything else is skipped. These optional
+ * properties are also read:
+ *
+ *  - `place_type`: the nick of a #GeocodePlaceType, such as `town` or
+ *    `country`;
+ *  - `admin_level`: the OpenStreetMap admin level, used to order the
+ *    boundaries, and to set the place type if `place_type` is missing;
+ *  - `osm_id` and `osm_type`: the OpenStreetMap ID and type (`node`, `way`
+ *    or `relation`);
+ *  - `country_code`: the ISO 3166 country code.
+ *
+ * Candidate boundaries are found through a grid of one degree cells, each
+ * listing the boundaries whose bounding box overlaps it, so each query only
+ * tests the point against the few polygons around it.
+ *
+ * Boundaries must not be loaded while queries are running on other
+ * threads.
+ *
+ * Since: 3.28
+ */
+
+#define GRID_N_ROWS 180
+#define GRID_N_COLUMNS 360
+#define GRID_N_CELLS (GRID_N_ROWS * GRID_N_COLUMNS)
+
+typedef struct {
+	guint first_point;
+	guint n_points;
+	gdouble top, bottom, left, right;
+} Ring;
+
+typedef struct {
+	char *name;
+	char *country_code;
+	char *osm_id;
+	GeocodePlaceType place_type;
+	GeocodePlaceOsmType osm_type;
+	gint64 rank;  /* higher is more specific */
+
+	guint first_ring;
+	guint n_rings;
+	gdouble top, bottom, left, right;
+	gdouble latitude, longitude;  /* centroid of the largest polygon */
+} Boundary;
+
+struct _GeocodeBoundaryBackend {
+	GObject parent;
+
+	GArray *boundaries;  /* (owned) (element-type Boundary) */
+	GArray *rings;  /* (owned) (element-type Ring) */
+	GArray *points;  /* (owned) (element-type gdouble) longitude, latitude pairs */
+	GArray **cells;  /* (owned) (nullable) GRID_N_CELLS (nullable) (element-type guint) */
+};
+
+static void geocode_backend_iface_init (GeocodeBackendInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GeocodeBoundaryBackend, geocode_boundary_backend, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (GEOCODE_TYPE_BACKEND,
+                                                geocode_backend_iface_init))
+
+/******************************************************************************/
+
+static guint
+cell_row (gdouble latitude)
+{
+	gint row = (gint) floor (latitude + 90.0);
+
+	return CLAMP (row, 0, GRID_N_ROWS - 1);
+}
+
+static guint
+cell_column (gdouble longitude)
+{
+	gint column = (gint) floor (longitude + 180.0);
+
+	return CLAMP (column, 0, GRID_N_COLUMNS - 1);
+}
+
+static void
+boundary_clear (Boundary *boundary)
+{
+	g_free (boundary->name);
+	g_free (boundary->country_code);
+	g_free (boundary->osm_id);
+}
+
+/* Even-odd rule over all the rings of the boundary, which handles holes and
+ * multiple parts alike. */
+static gboolean
+boundary_contains (GeocodeBoundaryBackend *self,
+                   const Boundary         *boundary,
+                   gdouble                 latitude,
+                   gdouble                 longitude)
+{
+	gboolean inside = FALSE;
+	guint r;
+
+	for (r = boundary->first_ring; r < boundary->first_ring + boundary->n_rings; r++) {
+		const Ring *ring = &g_array_index (self->rings, Ring, r);
+		const gdouble *points;
+		guint i, j;
+
+		/* A ray cast east from the point can only cross rings which
+		 * span its latitude and reach east of it. */
+		if (latitude < ring->bottom || latitude > ring->top ||
+		    longitude > ring->right)
+			continue;
+
+		points = &g_array_index (self->points, gdouble, 2 * ring->first_point);
+
+		for (i = 0, j = ring->n_points - 1; i < ring->n_points; j = i++) {
+			gdouble xi = points[2 * i], yi = points[2 * i + 1];
+			gdouble xj = points[2 * j], yj = points[2 * j + 1];
+
+			if ((yi > latitude) != (yj > latitude) &&
+			    longitude < (xj - xi) * (latitude - yi) / (yj - yi) + xi)
+				inside = !inside;
+		}
+	}
+
+	return inside;
+}
+
+/* Sets the address fields of @place which @boundary provides, unless a
+ * more specific boundary has already set them. */
+static void
+fill_place_from_boundary (GeocodePlace   *place,
+                          const Boundary *boundary)
+{
+	static const struct {
+		GeocodePlaceType place_type;
+		const char *property;
+	} fields[] = {
+		{ GEOCODE_PLACE_TYPE_SUBURB, "area" },
+		{ GEOCODE_PLACE_TYPE_TOWN, "town" },
+		{ GEOCODE_PLACE_TYPE_LOCAL_ADMINISTRATIVE_AREA, "administrative-area" },
+		{ GEOCODE_PLACE_TYPE_COUNTY, "county" },
+		{ GEOCODE_PLACE_TYPE_STATE, "state" },
+		{ GEOCODE_PLACE_TYPE_COUNTRY, "country" },
+		{ GEOCODE_PLACE_TYPE_CONTINENT, "continent" },
+	};
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (fields); i++) {
+		g_autofree char *value = NULL;
+
+		if (fields[i].place_type != boundary->place_type)
+			continue;
+
+		g_object_get (place, fields[i].property, &value, NULL);
+		if (value == NULL)
+			g_object_set (place, fields[i].property, boundary->name, NULL);
+	}
+
+	if (boundary->country_code != NULL &&
+	    geocode_place_get_country_code (place) == NULL)
+		geocode_place_set_country_code (place, boundary->country_code);
+}
+
+static GeocodePlace *
+place_from_boundary (const Boundary *boundary)
+{
+	GeocodePlace *place;
+	g_autoptr (GeocodeLocation) location = NULL;
+	g_autoptr (GeocodeBoundingBox) bbox = NULL;
+
+	place = geocode_place_new (boundary->name, boundary->place_type);
+
+	location = geocode_location_new_with_description (boundary->latitude,
+	                                                  boundary->longitude,
+	                                                  GEOCODE_LOCATION_ACCURACY_UNKNOWN,
+	                                                  boundary->name);
+	geocode_place_set_location (place, location);
+
+	bbox = geocode_bounding_box_new (boundary->top, boundary->bottom,
+	                                 boundary->left, boundary->right);
+	geocode_place_set_bounding_box (place, bbox);
+
+	if (boundary->osm_id != NULL)
+		g_object_set (place,
+		              "osm-id", boundary->osm_id,
+		              "osm-type", boundary->osm_type,
+		              NULL);
+
+	return place;
+}
+
+static gint
+compare_boundaries (gconstpointer a,
+                    gconstpointer b)
+{
+	const Boundary *boundary_a = *((const Boundary **) a);
+	const Boundary *boundary_b = *((const Boundary **) b);
+	gdouble area_a, area_b;
+
+	if (boundary_a->rank != boundary_b->rank)
+		return (boundary_a->rank > boundary_b->rank) ? -1 : 1;
+
+	/* Between boundaries of the same rank, the smaller is more specific. */
+	area_a = (boundary_a->top - boundary_a->bottom) * (boundary_a->right - boundary_a->left);
+	area_b = (boundary_b->top - boundary_b->bottom) * (boundary_b->right - boundary_b->left);
+
+	return (area_a > area_b) - (area_a < area_b);
+}
+
+static void
+places_list_free (GList *places)
+{
+	g_list_free_full (places, g_object_unref);
+}
+
+/******************************************************************************/
+
+static GList *
+geocode_boundary_backend_forward_search (GeocodeBackend  *backend,
+                                         GHashTable      *params,
+                                         GCancellable    *cancellable,
+                                         GError         **error)
+{
+	g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED,
+	                     "Forward geocoding is not supported by this backend");
+	return NULL;
+}
+
+static void
+geocode_boundary_backend_forward_search_async (GeocodeBackend      *backend,
+                                               GHashTable          *params,
+                                               GCancellable        *cancellable,
+                                               GAsyncReadyCallback  callback,
+                                               gpointer             user_data)
+{
+	g_task_report_new_error (backend, callback, user_data,
+	                         geocode_boundary_backend_forward_search_async,
+	                         GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED,
+	                         "Forward geocoding is not supported by this backend");
+}
+
+static GList *
+geocode_boundary_backend_forward_search_finish (GeocodeBackend  *backend,
+                                                GAsyncResult    *result,
+                                                GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static GList *
+geocode_boundary_backend_reverse_resolve (GeocodeBackend  *backend,
+                                          GHashTable      *params,
+                                          GCancellable    *cancellable,
+                                          GError         **error)
+{
+	GeocodeBoundaryBackend *self = GEOCODE_BOUNDARY_BACKEND (backend);
+	g_autoptr (GPtrArray) matches = NULL;  /* (element-type Boundary) */
+	GList *places = NULL;  /* (element-type GeocodePlace) */
+	gdouble latitude, longitude;
+	GArray *cell;
+	guint i, j;
+
+	if (g_cancellable_set_error_if_cancelled (cancellable, error))
+		return NULL;
+
+	if (!_geocode_params_lookup_double (params, "lat", &latitude) ||
+	    !_geocode_params_lookup_double (params, "lon", &longitude) ||
+	    !(latitude >= -90.0 && latitude <= 90.0) ||
+	    !(longitude >= -180.0 && longitude <= 180.0)) {
+		g_set_error (error, GEOCODE_ERROR, GEOCODE_ERROR_INVALID_ARGUMENTS,
+		             "Only following parameters supported: lat, lon");
+		return NULL;
+	}
+
+	matches = g_ptr_array_new ();
+	cell = (self->cells != NULL) ?
+	       self->cells[cell_row (latitude) * GRID_N_COLUMNS + cell_column (longitude)] :
+	       NULL;
+
+	for (i = 0; cell != NULL && i < cell->len; i++) {
+		const Boundary *boundary;
+
+		boundary = &g_array_index (self->boundaries, Boundary,
+		                           g_array_index (cell, guint, i));
+
+		if (latitude >= boundary->bottom && latitude <= boundary->top &&
+		    longitude >= boundary->left && longitude <= boundary->right &&
+		    boundary_contains (self, boundary, latitude, longitude))
+			g_ptr_array_add (matches, (gpointer) boundary);
+	}
+
+	if (matches->len == 0) {
+		g_set_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED,
+		             "No matches found for request");
+		return NULL;
+	}
+
+	g_ptr_array_sort (matches, compare_boundaries);
+
+	for (i = matches->len; i > 0; i--) {
+		GeocodePlace *place = place_from_boundary (matches->pdata[i - 1]);
+
+		for (j = i - 1; j < matches->len; j++)
+			fill_place_from_boundary (place, matches->pdata[j]);
+
+		places = g_list_prepend (places, place);
+	}
+
+	return places;
+}
+
+static void
+geocode_boundary_backend_reverse_resolve_async (GeocodeBackend      *backend,
+                                                GHashTable          *params,
+                                                GCancellable        *cancellable,
+                                                GAsyncReadyCallback  callback,
+                                                gpointer             user_data)
+{
+	g_autoptr (GTask) task = NULL;
+	GList *places;
+	GError *error = NULL;
+
+	/* Lookups never block, so there is no point in using a thread. */
+	task = g_task_new (backend, cancellable, callback, user_data);
+	g_task_set_source_tag (task, geocode_boundary_backend_reverse_resolve_async);
+
+	places = geocode_boundary_backend_reverse_resolve (backend, params,
+	                                                   cancellable, &error);
+	if (error != NULL)
+		g_task_return_error (task, error);
+	else
+		g_task_return_pointer (task, places,
+		                       (GDestroyNotify) places_list_free);
+}
+
+static GList *
+geocode_boundary_backend_reverse_resolve_finish (GeocodeBackend  *backend,
+                                                 GAsyncResult    *result,
+                                                 GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/******************************************************************************/
+
+static const char *
+get_string_member (JsonObject *object,
+                   const char *member_name)
+{
+	JsonNode *node = json_object_get_member (object, member_name);
+
+	if (node == NULL || !JSON_NODE_HOLDS_VALUE (node) ||
+	    json_node_get_value_type (node) != G_TYPE_STRING)
+		return NULL;
+
+	return json_node_get_string (node);
+}
+
+/* OpenStreetMap exports have numbers such as `admin_level` as either
+ * numbers or strings. */
+static gboolean
+get_int_member (JsonObject *object,
+                const char *member_name,
+                gint64     *out)
+{
+	JsonNode *node = json_object_get_member (object, member_name);
+	const char *str;
+	char *end;
+
+	if (node == NULL || !JSON_NODE_HOLDS_VALUE (node))
+		return FALSE;
+
+	if (json_node_get_value_type (node) == G_TYPE_INT64) {
+		*out = json_node_get_int (node);
+		return TRUE;
+	}
+
+	str = get_string_member (object, member_name);
+	if (str == NULL)
+		return FALSE;
+
+	*out = g_ascii_strtoll (str, &end, 10);
+	return (end != str && *end == '\0');
+}
+
+static gboolean
+parse_position (JsonNode *node,
+                gdouble  *longitude,
+                gdouble  *latitude)
+{
+	JsonArray *position;
+	JsonNode *x, *y;
+
+	if (!JSON_NODE_HOLDS_ARRAY (node))
+		return FALSE;
+
+	position = json_node_get_array (node);
+	if (json_array_get_length (position) < 2)
+		return FALSE;
+
+	x = json_array_get_element (position, 0);
+	y = json_array_get_element (position, 1);
+	if (!JSON_NODE_HOLDS_VALUE (x) || !JSON_NODE_HOLDS_VALUE (y) ||
+	    (json_node_get_value_type (x) != G_TYPE_DOUBLE &&
+	     json_node_get_value_type (x) != G_TYPE_INT64) ||
+	    (json_node_get_value_type (y) != G_TYPE_DOUBLE &&
+	     json_node_get_value_type (y) != G_TYPE_INT64))
+		return FALSE;
+
+	*longitude = json_node_get_double (x);
+	*latitude = json_node_get_double (y);
+
+	return (*latitude >= -90.0 && *latitude <= 90.0 &&
+	        *longitude >= -180.0 && *longitude <= 180.0);
+}
+
+/* Appends a linear ring to @self->rings, and returns its signed area and
+ * the sums for its centroid through @area, @centroid_x and @centroid_y. */
+static gboolean
+parse_ring (GeocodeBoundaryBackend *self,
+            JsonNode               *node,
+            gdouble                *area,
+            gdouble                *centroid_x,
+            gdouble                *centroid_y)
+{
+	JsonArray *positions;
+	Ring ring;
+	const gdouble *points;
+	guint i, j;
+
+	if (!JSON_NODE_HOLDS_ARRAY (node))
+		return FALSE;
+
+	positions = json_node_get_array (node);
+	if (json_array_get_length (positions) < 3)
+		return FALSE;
+
+	ring.first_point = self->points->len / 2;
+	ring.n_points = json_array_get_length (positions);
+	ring.top = -G_MAXDOUBLE;
+	ring.bottom = G_MAXDOUBLE;
+	ring.left = G_MAXDOUBLE;
+	ring.right = -G_MAXDOUBLE;
+
+	for (i = 0; i < ring.n_points; i++) {
+		gdouble point[2];
+
+		if (!parse_position (json_array_get_element (positions, i),
+		                     &point[0], &point[1]))
+			return FALSE;
+
+		g_array_append_vals (self->points, point, 2);
+
+		ring.top = MAX (ring.top, point[1]);
+		ring.bottom = MIN (ring.bottom, point[1]);
+		ring.left = MIN (ring.left, point[0]);
+		ring.right = MAX (ring.right, point[0]);
+	}
+
+	/* Shoelace formula. The ring is closed implicitly, so the repeated
+	 * last position required by GeoJSON just adds an empty edge. */
+	points = &g_array_index (self->points, gdouble, 2 * ring.first_point);
+	*area = *centroid_x = *centroid_y = 0.0;
+
+	for (i = 0, j = ring.n_points - 1; i < ring.n_points; j = i++) {
+		gdouble cross = points[2 * j] * points[2 * i + 1] -
+		                points[2 * i] * points[2 * j + 1];
+
+		*area += cross;
+		*centroid_x += (points[2 * j] + points[2 * i]) * cross;
+		*centroid_y += (points[2 * j + 1] + points[2 * i + 1]) * cross;
+	}
+
+	g_array_append_val (self->rings, ring);
+
+	return TRUE;
+}
+
+/* Appends the rings of a Polygon to @self->rings, and makes the centroid of
+ * its exterior ring the location of @boundary if it is the largest polygon
+ * so far. */
+static gboolean
+parse_polygon (GeocodeBoundaryBackend *self,
+               JsonNode               *node,
+               Boundary               *boundary,
+               gdouble                *largest_area)
+{
+	JsonArray *rings;
+	guint i;
+
+	if (!JSON_NODE_HOLDS_ARRAY (node))
+		return FALSE;
+
+	rings = json_node_get_array (node);
+	if (json_array_get_length (rings) == 0)
+		return FALSE;
+
+	for (i = 0; i < json_array_get_length (rings); i++) {
+		gdouble area, centroid_x, centroid_y;
+
+		if (!parse_ring (self, json_array_get_element (rings, i),
+		                 &area, &centroid_x, &centroid_y))
+			return FALSE;
+
+		boundary->n_rings++;
+
+		if (i == 0 && fabs (area) > *largest_area) {
+			*largest_area = fabs (area);
+			boundary->longitude = centroid_x / (3.0 * area);
+			boundary->latitude = centroid_y / (3.0 * area);
+		}
+	}
+
+	return TRUE;
+}
+
+static gboolean
+parse_geometry (GeocodeBoundaryBackend *self,
+                JsonObject             *geometry,
+                Boundary               *boundary)
+{
+	const char *type;
+	JsonNode *coordinates;
+	gdouble largest_area = 0.0;
+	guint r;
+
+	type = get_string_member (geometry, "type");
+	coordinates = json_object_get_member (geometry, "coordinates");
+
+	boundary->first_ring = self->rings->len;
+	boundary->n_rings = 0;
+
+	if (g_strcmp0 (type, "Polygon") == 0) {
+		if (!parse_polygon (self, coordinates, boundary, &largest_area))
+			return FALSE;
+	} else if (g_strcmp0 (type, "MultiPolygon") == 0 &&
+	           coordinates != NULL && JSON_NODE_HOLDS_ARRAY (coordinates)) {
+		JsonArray *polygons = json_node_get_array (coordinates);
+		guint i;
+
+		for (i = 0; i < json_array_get_length (polygons); i++) {
+			if (!parse_polygon (self, json_array_get_element (polygons, i),
+			                    boundary, &largest_area))
+				return FALSE;
+		}
+	} else {
+		return FALSE;
+	}
+
+	if (boundary->n_rings == 0)
+		return FALSE;
+
+	boundary->top = -G_MAXDOUBLE;
+	boundary->bottom = G_MAXDOUBLE;
+	boundary->left = G_MAXDOUBLE;
+	boundary->right = -G_MAXDOUBLE;
+
+	for (r = boundary->first_ring; r < self->rings->len; r++) {
+		const Ring *ring = &g_array_index (self->rings, Ring, r);
+
+		boundary->top = MAX (boundary->top, ring->top);
+		boundary->bottom = MIN (boundary->bottom, ring->bottom);
+		boundary->left = MIN (boundary->left, ring->left);
+		boundary->right = MAX (boundary->right, ring->right);
+	}
+
+	/* Degenerate polygons have no centroid. */
+	if (largest_area == 0.0 ||
+	    !(boundary->latitude >= boundary->bottom && boundary->latitude <= boundary->top) ||
+	    !(boundary->longitude >= boundary->left && boundary->longitude <= boundary->right)) {
+		boundary->latitude = (boundary->top + boundary->bottom) / 2.0;
+		boundary->longitude = (boundary->left + boundary->right) / 2.0;
+	}
+
+	return TRUE;
+}
+
+static GeocodePlaceType
+place_type_for_admin_level (gint64 admin_level)
+{
+	if (admin_level <= 2)
+		return GEOCODE_PLACE_TYPE_COUNTRY;
+	else if (admin_level <= 4)
+		return GEOCODE_PLACE_TYPE_STATE;
+	else if (admin_level <= 6)
+		return GEOCODE_PLACE_TYPE_COUNTY;
+	else if (admin_level <= 8)
+		return GEOCODE_PLACE_TYPE_TOWN;
+	else
+		return GEOCODE_PLACE_TYPE_SUBURB;
+}
+
+static gint64
+admin_level_for_place_type (GeocodePlaceType place_type)
+{
+	switch (place_type) {
+	case GEOCODE_PLACE_TYPE_CONTINENT:
+		return 1;
+	case GEOCODE_PLACE_TYPE_COUNTRY:
+		return 2;
+	case GEOCODE_PLACE_TYPE_STATE:
+		return 4;
+	case GEOCODE_PLACE_TYPE_COUNTY:
+		return 6;
+	case GEOCODE_PLACE_TYPE_LOCAL_ADMINISTRATIVE_AREA:
+		return 7;
+	case GEOCODE_PLACE_TYPE_TOWN:
+		return 8;
+	case GEOCODE_PLACE_TYPE_SUBURB:
+		return 10;
+	default:
+		return 12;
+	}
+}
+
+static gint
+get_enum_member (JsonObject *object,
+                 const char *member_name,
+                 GType       enum_type,
+                 gint        default_value)
+{
+	const char *nick = get_string_member (object, member_name);
+	GEnumClass *enum_class;
+	GEnumValue *value;
+	gint ret = default_value;
+
+	if (nick == NULL)
+		return default_value;
+
+	enum_class = g_type_class_ref (enum_type);
+	value = g_enum_get_value_by_nick (enum_class, nick);
+	if (value != NULL)
+		ret = value->value;
+	g_type_class_unref (enum_class);
+
+	return ret;
+}
+
+/* Returns %FALSE if @feature has no name or no polygons, in which case it
+ * is skipped, and sets @error if its geometry is invalid. */
+static gboolean
+parse_feature (GeocodeBoundaryBackend  *self,
+               JsonNode                *node,
+               guint                    index,
+               GError                 **error)
+{
+	JsonObject *feature, *properties = NULL;
+	JsonNode *geometry, *properties_node;
+	Boundary boundary = { NULL, };
+	const char *name, *type;
+	gint64 admin_level, osm_id;
+
+	if (!JSON_NODE_HOLDS_OBJECT (node))
+		return FALSE;
+
+	feature = json_node_get_object (node);
+	geometry = json_object_get_member (feature, "geometry");
+	properties_node = json_object_get_member (feature, "properties");
+
+	if (properties_node != NULL && JSON_NODE_HOLDS_OBJECT (properties_node))
+		properties = json_node_get_object (properties_node);
+
+	name = (properties != NULL) ? get_string_member (properties, "name") : NULL;
+	if (name == NULL || geometry == NULL || !JSON_NODE_HOLDS_OBJECT (geometry))
+		return FALSE;
+
+	type = get_string_member (json_node_get_object (geometry), "type");
+	if (g_strcmp0 (type, "Polygon") != 0 && g_strcmp0 (type, "MultiPolygon") != 0)
+		return FALSE;
+
+	if (!parse_geometry (self, json_node_get_object (geometry), &boundary)) {
+		g_set_error (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		             "Invalid %s geometry in feature %u (%s)",
+		             type, index, name);
+		return FALSE;
+	}
+
+	boundary.name = g_strdup (name);
+	boundary.country_code = g_strdup (get_string_member (properties, "country_code"));
+
+	if (get_int_member (properties, "admin_level", &admin_level)) {
+		boundary.place_type = get_enum_member (properties, "place_type",
+		                                       GEOCODE_TYPE_PLACE_TYPE,
+		                                       place_type_for_admin_level (admin_level));
+		boundary.rank = admin_level;
+	} else {
+		boundary.place_type = get_enum_member (properties, "place_type",
+		                                       GEOCODE_TYPE_PLACE_TYPE,
+		                                       GEOCODE_PLACE_TYPE_UNKNOWN);
+		boundary.rank = admin_level_for_place_type (boundary.place_type);
+	}
+
+	if (get_int_member (properties, "osm_id", &osm_id))
+		boundary.osm_id = g_strdup_printf ("%" G_GINT64_FORMAT, osm_id);
+	boundary.osm_type = get_enum_member (properties, "osm_type",
+	                                     GEOCODE_TYPE_PLACE_OSM_TYPE,
+	                                     GEOCODE_PLACE_OSM_TYPE_UNKNOWN);
+
+	g_array_append_val (self->boundaries, boundary);
+
+	return TRUE;
+}
+
+static void
+add_to_grid (GeocodeBoundaryBackend *self,
+             guint                   index)
+{
+	const Boundary *boundary = &g_array_index (self->boundaries, Boundary, index);
+	guint row, column;
+
+	if (self->cells == NULL)
+		self->cells = g_new0 (GArray *, GRID_N_CELLS);
+
+	for (row = cell_row (boundary->bottom); row <= cell_row (boundary->top); row++) {
+		for (column = cell_column (boundary->left);
+		     column <= cell_column (boundary->right);
+		     column++) {
+			GArray **cell = &self->cells[row * GRID_N_COLUMNS + column];
+
+			if (*cell == NULL)
+				*cell = g_array_new (FALSE, FALSE, sizeof (guint));
+			g_array_append_val (*cell, index);
+		}
+	}
+}
+
+/**
+ * geocode_boundary_backend_load_data:
+ * @self: a #GeocodeBoundaryBackend
+ * @data: GeoJSON data
+ * @length: length of @data in bytes, or -1 if it is nul-terminated
+ * @error: return location for a #GError, or %NULL
+ *
+ * Loads the boundaries in the GeoJSON FeatureCollection or Feature in
+ * @data, in addition to any already loaded. See the description of
+ * #GeocodeBoundaryBackend for the properties which are read.
+ *
+ * If @data is not valid JSON, or if a Polygon or MultiPolygon geometry is
+ * invalid, none of the boundaries in @data are loaded, and an error is
+ * returned.
+ *
+ * Returns: %TRUE on success, %FALSE otherwise
+ *
+ * Since: 3.28
+ */
+gboolean
+geocode_boundary_backend_load_data (GeocodeBoundaryBackend  *self,
+                                    const char              *data,
+                                    gssize                   length,
+                                    GError                 **error)
+{
+	g_autoptr (JsonParser) parser = NULL;
+	JsonNode *root;
+	JsonObject *object;
+	guint n_boundaries, n_rings, n_points, i;
+	GError *local_error = NULL;
+
+	g_return_val_if_fail (GEOCODE_IS_BOUNDARY_BACKEND (self), FALSE);
+	g_return_val_if_fail (data != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	parser = json_parser_new ();
+	if (!json_parser_load_from_data (parser, data, length, error))
+		return FALSE;
+
+	root = json_parser_get_root (parser);
+	if (root == NULL || !JSON_NODE_HOLDS_OBJECT (root)) {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		                     "Expected a GeoJSON FeatureCollection or Feature");
+		return FALSE;
+	}
+
+	n_boundaries = self->boundaries->len;
+	n_rings = self->rings->len;
+	n_points = self->points->len;
+
+	object = json_node_get_object (root);
+
+	if (g_strcmp0 (get_string_member (object, "type"), "FeatureCollection") == 0) {
+		JsonNode *features = json_object_get_member (object, "features");
+
+		if (features != NULL && JSON_NODE_HOLDS_ARRAY (features)) {
+			JsonArray *array = json_node_get_array (features);
+
+			for (i = 0; i < json_array_get_length (array) && local_error == NULL; i++)
+				parse_feature (self, json_array_get_element (array, i),
+				               i, &local_error);
+		}
+	} else {
+		parse_feature (self, root, 0, &local_error);
+	}
+
+	if (local_error != NULL) {
+		g_array_set_size (self->boundaries, n_boundaries);
+		g_array_set_size (self->rings, n_rings);
+		g_array_set_size (self->points, n_points);
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	for (i = n_boundaries; i < self->boundaries->len; i++)
+		add_to_grid (self, i);
+
+	return TRUE;
+}
+
+/**
+ * geocode_boundary_backend_load_file:
+ * @self: a #GeocodeBoundaryBackend
+ * @path: (type filename): path of a GeoJSON file
+ * @error: return location for a #GError, or %NULL
+ *
+ * Loads the boundaries in the GeoJSON file at @path. See
+ * geocode_boundary_backend_load_data().
+ *
+ * Returns: %TRUE on success, %FALSE otherwise
+ *
+ * Since: 3.28
+ */
+gboolean
+geocode_boundary_backend_load_file (GeocodeBoundaryBackend  *self,
+                                    const char              *path,
+                                    GError                 **error)
+{
+	g_autoptr (GMappedFile) file = NULL;
+
+	g_return_val_if_fail (GEOCODE_IS_BOUNDARY_BACKEND (self), FALSE);
+	g_return_val_if_fail (path != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	file = g_mapped_file_new (path, FALSE, error);
+	if (file == NULL)
+		return FALSE;
+
+	/* Empty files map to %NULL contents. */
+	return geocode_boundary_backend_load_data (self,
+	                                           g_mapped_file_get_contents (file) ?
+	                                           g_mapped_file_get_contents (file) : "",
+	                                           g_mapped_file_get_length (file),
+	                                           error);
+}
+
+/**
+ * geocode_boundary_backend_get_n_boundaries:
+ * @self: a #GeocodeBoundaryBackend
+ *
+ * Gets the number of boundaries loaded so far.
+ *
+ * Returns: the number of boundaries
+ *
+ * Since: 3.28
+ */
+guint
+geocode_boundary_backend_get_n_boundaries (GeocodeBoundaryBackend *self)
+{
+	g_return_val_if_fail (GEOCODE_IS_BOUNDARY_BACKEND (self), 0);
+
+	return self->boundaries->len;
+}
+
+/**
+ * geocode_boundary_backend_new:
+ *
+ * Creates a new backend with no boundaries. Load some with
+ * geocode_boundary_backend_load_file() before using it.
+ *
+ * Returns: (transfer full): a new #GeocodeBoundaryBackend. Use
+ * g_object_unref() when done.
+ *
+ * Since: 3.28
+ */
+GeocodeBoundaryBackend *
+geocode_boundary_backend_new (void)
+{
+	return GEOCODE_BOUNDARY_BACKEND (g_object_new (GEOCODE_TYPE_BOUNDARY_BACKEND,
+	                                               NULL));
+}
+
+static void
+geocode_boundary_backend_init (GeocodeBoundaryBackend *self)
+{
+	self->boundaries = g_array_new (FALSE, FALSE, sizeof (Boundary));
+	g_array_set_clear_func (self->boundaries, (GDestroyNotify) boundary_clear);
+	self->rings = g_array_new (FALSE, FALSE, sizeof (Ring));
+	self->points = g_array_new (FALSE, FALSE, sizeof (gdouble));
+}
+
+static void
+geocode_boundary_backend_finalize (GObject *object)
+{
+	GeocodeBoundaryBackend *self = GEOCODE_BOUNDARY_BACKEND (object);
+	guint i;
+
+	if (self->cells != NULL) {
+		for (i = 0; i < GRID_N_CELLS; i++) {
+			if (self->cells[i] != NULL)
+				g_array_unref (self->cells[i]);
+		}
+		g_free (self->cells);
+	}
+
+	g_array_unref (self->boundaries);
+	g_array_unref (self->rings);
+	g_array_unref (self->points);
+
+	G_OBJECT_CLASS (geocode_boundary_backend_parent_class)->finalize (object);
+}
+
+static void
+geocode_backend_iface_init (GeocodeBackendInterface *iface)
+{
+	iface->forward_search = geocode_boundary_backend_forward_search;
+	iface->forward_search_async = geocode_boundary_backend_forward_search_async;
+	iface->forward_search_finish = geocode_boundary_backend_forward_search_finish;
+	iface->reverse_resolve = geocode_boundary_backend_reverse_resolve;
+	iface->reverse_resolve_async = geocode_boundary_backend_reverse_resolve_async;
+	iface->reverse_resolve_finish = geocode_boundary_backend_reverse_resolve_finish;
+}
+
+static void
+geocode_boundary_backend_class_init (GeocodeBoundaryBackendClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->finalize = geocode_boundary_backend_finalize;
+}
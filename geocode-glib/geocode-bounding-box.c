@@ -20,8 +20,12 @@
 
  */
 
+#include <math.h>
 #include <geocode-glib/geocode-bounding-box.h>
 
+/* As in geocode-location.c */
+#define EARTH_RADIUS_KM 6372.795
+
 /**
  * SECTION:geocode-bounding-box
  * @short_description: Geocode BoundingBox object
@@ -29,6 +33,11 @@
  *
  * The #GeocodeBoundingBox represents a geographical area on earth, bounded
  * by top, bottom, left and right coordinates.
+ *
+ * A bounding box whose left coordinate is greater than its right coordinate
+ * crosses the antimeridian: it covers the longitudes from left eastwards to
+ * 180°, and from -180° eastwards to right. A box with a left coordinate of
+ * -180° and a right coordinate of 180° covers all longitudes.
  **/
 
 struct _GeocodeBoundingBoxPrivate {
@@ -382,3 +391,305 @@ geocode_bounding_box_get_right (GeocodeBoundingBox *bbox)
         priv = geocode_bounding_box_get_instance_private (bbox);
         return priv->right;
 }
+
+/* Longitudes are handled as arcs going eastwards from the left coordinate,
+ * which is what makes boxes crossing the antimeridian work. */
+static gdouble
+longitude_span (gdouble left,
+                gdouble right)
+{
+        return (left <= right) ? right - left : right - left + 360.0;
+}
+
+static gboolean
+arc_contains (gdouble left,
+              gdouble span,
+              gdouble longitude)
+{
+        gdouble offset = longitude - left;
+
+        if (offset < 0)
+                offset += 360.0;
+
+        return offset <= span;
+}
+
+static gdouble
+normalize_longitude (gdouble longitude)
+{
+        if (longitude > 180.0)
+                return longitude - 360.0;
+        if (longitude < -180.0)
+                return longitude + 360.0;
+        return longitude;
+}
+
+/**
+ * geocode_bounding_box_contains_point:
+ * @bbox: a #GeocodeBoundingBox
+ * @latitude: latitude of the point, in degrees
+ * @longitude: longitude of the point, in degrees
+ *
+ * Checks whether the given point is inside @bbox, or on its boundary.
+ *
+ * Returns: %TRUE if the point is in @bbox, %FALSE otherwise
+ *
+ * Since: 3.28
+ **/
+gboolean
+geocode_bounding_box_contains_point (GeocodeBoundingBox *bbox,
+                                     gdouble             latitude,
+                                     gdouble             longitude)
+{
+        gboolean result;
+
+        g_return_val_if_fail (GEOCODE_IS_BOUNDING_BOX (bbox), FALSE);
+
+        geocode_bounding_box_contains_points (bbox, &latitude, &longitude, 1, &result);
+
+        return result;
+}
+
+/**
+ * geocode_bounding_box_contains_coordinate:
+ * @bbox: a #GeocodeBoundingBox
+ * @coord: a #GeocodeCoordinate
+ *
+ * Checks whether @coord is inside @bbox, or on its boundary, as
+ * geocode_bounding_box_contains_point() does.
+ *
+ * Returns: %TRUE if @coord is in @bbox, %FALSE otherwise
+ *
+ * Since: 3.28
+ **/
+gboolean
+geocode_bounding_box_contains_coordinate (GeocodeBoundingBox      *bbox,
+                                          const GeocodeCoordinate *coord)
+{
+        g_return_val_if_fail (coord != NULL, FALSE);
+
+        return geocode_bounding_box_contains_point (bbox,
+                                                    coord->latitude,
+                                                    coord->longitude);
+}
+
+/**
+ * geocode_bounding_box_contains_points:
+ * @bbox: a #GeocodeBoundingBox
+ * @latitudes: (array length=n_points): latitudes of the points, in degrees
+ * @longitudes: (array length=n_points): longitudes of the points, in degrees
+ * @n_points: the number of points
+ * @results: (out caller-allocates) (array length=n_points): return location
+ *    for whether each point is in @bbox
+ *
+ * Checks which of the given points are inside @bbox, or on its boundary,
+ * as geocode_bounding_box_contains_point() does for a single point.
+ *
+ * Returns: the number of points in @bbox
+ *
+ * Since: 3.28
+ **/
+gsize
+geocode_bounding_box_contains_points (GeocodeBoundingBox *bbox,
+                                      const gdouble      *latitudes,
+                                      const gdouble      *longitudes,
+                                      gsize               n_points,
+                                      gboolean           *results)
+{
+        GeocodeBoundingBoxPrivate *priv;
+        gdouble top, bottom, left, right;
+        gboolean crosses_antimeridian;
+        gsize i, n_inside = 0;
+
+        g_return_val_if_fail (GEOCODE_IS_BOUNDING_BOX (bbox), 0);
+        g_return_val_if_fail (n_points == 0 || latitudes != NULL, 0);
+        g_return_val_if_fail (n_points == 0 || longitudes != NULL, 0);
+        g_return_val_if_fail (n_points == 0 || results != NULL, 0);
+
+        priv = geocode_bounding_box_get_instance_private (bbox);
+        top = priv->top;
+        bottom = priv->bottom;
+        left = priv->left;
+        right = priv->right;
+        crosses_antimeridian = (left > right);
+
+        /* Branch-free, so the loop can be vectorised */
+        for (i = 0; i < n_points; i++) {
+                gboolean in_latitude, in_longitude;
+
+                in_latitude = (latitudes[i] >= bottom) & (latitudes[i] <= top);
+                in_longitude = crosses_antimeridian ?
+                               (longitudes[i] >= left) | (longitudes[i] <= right) :
+                               (longitudes[i] >= left) & (longitudes[i] <= right);
+                results[i] = in_latitude & in_longitude;
+                n_inside += results[i];
+        }
+
+        return n_inside;
+}
+
+/**
+ * geocode_bounding_box_intersects:
+ * @a: a bounding box
+ * @b: another bounding box
+ *
+ * Checks whether two bounding boxes overlap. Boxes which only share an
+ * edge or a corner are considered to overlap.
+ *
+ * Returns: %TRUE if @a and @b overlap, %FALSE otherwise
+ *
+ * Since: 3.28
+ **/
+gboolean
+geocode_bounding_box_intersects (GeocodeBoundingBox *a,
+                                 GeocodeBoundingBox *b)
+{
+        GeocodeBoundingBoxPrivate *priv_a;
+        GeocodeBoundingBoxPrivate *priv_b;
+
+        g_return_val_if_fail (GEOCODE_IS_BOUNDING_BOX (a), FALSE);
+        g_return_val_if_fail (GEOCODE_IS_BOUNDING_BOX (b), FALSE);
+
+        priv_a = geocode_bounding_box_get_instance_private (a);
+        priv_b = geocode_bounding_box_get_instance_private (b);
+
+        if (priv_a->bottom > priv_b->top || priv_b->bottom > priv_a->top)
+                return FALSE;
+
+        /* Two arcs overlap iff one contains the start of the other */
+        return arc_contains (priv_a->left,
+                             longitude_span (priv_a->left, priv_a->right),
+                             priv_b->left) ||
+               arc_contains (priv_b->left,
+                             longitude_span (priv_b->left, priv_b->right),
+                             priv_a->left);
+}
+
+/**
+ * geocode_bounding_box_union:
+ * @a: a bounding box
+ * @b: another bounding box
+ *
+ * Creates the smallest bounding box which contains both @a and @b. Where
+ * the two boxes can be joined either eastwards or westwards around the
+ * globe, the narrower of the two results is chosen, so the union of boxes
+ * either side of the antimeridian crosses it rather than covering the
+ * rest of the world.
+ *
+ * Returns: (transfer full): a new #GeocodeBoundingBox. Use g_object_unref()
+ *    when done.
+ *
+ * Since: 3.28
+ **/
+GeocodeBoundingBox *
+geocode_bounding_box_union (GeocodeBoundingBox *a,
+                            GeocodeBoundingBox *b)
+{
+        GeocodeBoundingBoxPrivate *priv_a;
+        GeocodeBoundingBoxPrivate *priv_b;
+        gdouble span_a, span_b, span_ab, span_ba, offset;
+        gdouble left, span;
+
+        g_return_val_if_fail (GEOCODE_IS_BOUNDING_BOX (a), NULL);
+        g_return_val_if_fail (GEOCODE_IS_BOUNDING_BOX (b), NULL);
+
+        priv_a = geocode_bounding_box_get_instance_private (a);
+        priv_b = geocode_bounding_box_get_instance_private (b);
+
+        span_a = longitude_span (priv_a->left, priv_a->right);
+        span_b = longitude_span (priv_b->left, priv_b->right);
+
+        /* Candidate arcs: from the left of @a round to the right of @b,
+         * and from the left of @b round to the right of @a. Each covers
+         * both boxes unless one box already contains the other. */
+        offset = priv_b->left - priv_a->left;
+        if (offset < 0)
+                offset += 360.0;
+        span_ab = MAX (offset + span_b, span_a);
+
+        offset = priv_a->left - priv_b->left;
+        if (offset < 0)
+                offset += 360.0;
+        span_ba = MAX (offset + span_a, span_b);
+
+        if (span_ab <= span_ba) {
+                left = priv_a->left;
+                span = span_ab;
+        } else {
+                left = priv_b->left;
+                span = span_ba;
+        }
+
+        if (span >= 360.0)
+                return geocode_bounding_box_new (MAX (priv_a->top, priv_b->top),
+                                                 MIN (priv_a->bottom, priv_b->bottom),
+                                                 -180.0,
+                                                 180.0);
+
+        return geocode_bounding_box_new (MAX (priv_a->top, priv_b->top),
+                                         MIN (priv_a->bottom, priv_b->bottom),
+                                         left,
+                                         normalize_longitude (left + span));
+}
+
+/**
+ * geocode_bounding_box_expand:
+ * @bbox: a #GeocodeBoundingBox
+ * @distance: the distance to expand by, in km
+ *
+ * Creates a bounding box which contains every point within @distance km of
+ * @bbox, along the curvature of the Earth. The result is not necessarily
+ * the smallest such box: away from the equator, it is wider than needed
+ * towards its equatorial edge. If it would reach a pole, it covers all
+ * longitudes.
+ *
+ * Returns: (transfer full): a new #GeocodeBoundingBox. Use g_object_unref()
+ *    when done.
+ *
+ * Since: 3.28
+ **/
+GeocodeBoundingBox *
+geocode_bounding_box_expand (GeocodeBoundingBox *bbox,
+                             gdouble             distance)
+{
+        GeocodeBoundingBoxPrivate *priv;
+        gdouble angle, dlat, top, bottom, max_lat, sin_dlon, dlon, span, left;
+
+        g_return_val_if_fail (GEOCODE_IS_BOUNDING_BOX (bbox), NULL);
+        g_return_val_if_fail (distance >= 0, NULL);
+
+        priv = geocode_bounding_box_get_instance_private (bbox);
+
+        /* Angular distance, in radians */
+        angle = MIN (distance / EARTH_RADIUS_KM, M_PI);
+        dlat = angle * 180.0 / M_PI;
+        top = priv->top + dlat;
+        bottom = priv->bottom - dlat;
+
+        if (top > 90.0 || bottom < -90.0)
+                return geocode_bounding_box_new (MIN (top, 90.0),
+                                                 MAX (bottom, -90.0),
+                                                 -180.0,
+                                                 180.0);
+
+        /* The widest longitude offset reachable from a point at latitude φ
+         * is asin (sin (angle) / cos (φ)), which is greatest at the
+         * poleward edge of the box. */
+        max_lat = MAX (fabs (priv->top), fabs (priv->bottom)) * M_PI / 180.0;
+        sin_dlon = sin (angle) / cos (max_lat);
+        if (sin_dlon >= 1.0)
+                dlon = 180.0;
+        else
+                dlon = asin (sin_dlon) * 180.0 / M_PI;
+
+        span = longitude_span (priv->left, priv->right) + 2 * dlon;
+        if (span >= 360.0)
+                return geocode_bounding_box_new (top, bottom, -180.0, 180.0);
+
+        left = normalize_longitude (priv->left - dlon);
+
+        return geocode_bounding_box_new (top,
+                                         bottom,
+                                         left,
+                                         normalize_longitude (left + span));
+}
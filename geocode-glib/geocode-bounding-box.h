@@ -24,6 +24,7 @@
 #define GEOCODE_BOUNDING_BOX_H
 
 #include <glib-object.h>
+#include <geocode-glib/geocode-coordinate.h>
 
 G_BEGIN_DECLS
 
@@ -79,6 +80,23 @@ gdouble geocode_bounding_box_get_bottom (GeocodeBoundingBox *bbox);
 gdouble geocode_bounding_box_get_left   (GeocodeBoundingBox *bbox);
 gdouble geocode_bounding_box_get_right  (GeocodeBoundingBox *bbox);
 
+gboolean geocode_bounding_box_contains_point (GeocodeBoundingBox *bbox,
+                                              gdouble             latitude,
+                                              gdouble             longitude);
+gboolean geocode_bounding_box_contains_coordinate (GeocodeBoundingBox      *bbox,
+                                                   const GeocodeCoordinate *coord);
+gsize geocode_bounding_box_contains_points   (GeocodeBoundingBox *bbox,
+                                              const gdouble      *latitudes,
+                                              const gdouble      *longitudes,
+                                              gsize               n_points,
+                                              gboolean           *results);
+gboolean geocode_bounding_box_intersects     (GeocodeBoundingBox *a,
+                                              GeocodeBoundingBox *b);
+GeocodeBoundingBox *geocode_bounding_box_union  (GeocodeBoundingBox *a,
+                                                 GeocodeBoundingBox *b);
+GeocodeBoundingBox *geocode_bounding_box_expand (GeocodeBoundingBox *bbox,
+                                                 gdouble             distance);
+
 G_END_DECLS
 
 #endif /* GEOCODE_BOUNDING_BOX_H */
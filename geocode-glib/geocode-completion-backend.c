@@ -0,0 +1,709 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include <gio/gio.h>
+#include <math.h>
+#include <string.h>
+
+#include "geocode-glib-private.h"
+#include "geocode-glib.h"
+#include "geocode-completion-backend.h"
+
+/**
+ * SECTION:geocode-completion-backend
+ * @short_description: Geocode backend for type-ahead completion
+ * @include: geocode-glib/geocode-glib.h
+ *
+ * #GeocodeCompletionBackend completes partial place names from a set of
+ * places held in memory, so that search-as-you-type does not need to send a
+ * request to a remote service for every key press. Each place is added with
+ * an importance, and queries return the most important places whose name
+ * starts with the text typed so far. Names are compared ignoring case and
+ * Unicode composition.
+ *
+ * It can be used on its own, by calling
+ * geocode_completion_backend_complete() or by passing it to
+ * geocode_forward_set_backend(), or in front of another backend, such as a
+ * #GeocodeNominatim, passed to geocode_completion_backend_new(). Queries
+ * which match no places, and reverse queries, are then passed on to that
+ * fallback backend.
+ *
+ * Forward queries use the `location` parameter as the prefix, and return
+ * up to `limit` places; other parameters are ignored. The places returned
+ * are the ones which were added, not copies, so they should not be
+ * modified.
+ *
+ * Places are kept sorted by name, along with a tree of the most important
+ * place in each range of names, so a query takes O(k log n) time for k
+ * results from n places however common the prefix is. The index is rebuilt
+ * on the first query after places are added, so it is best to add all the
+ * places before querying.
+ *
+ * Since: 3.28
+ */
+
+typedef struct {
+	char *key;  /* (owned) normalized name */
+	GeocodePlace *place;  /* (owned) */
+	gdouble importance;
+} Entry;
+
+/* A range of entries [start, end) with the same prefix, and the index of the
+ * most important entry in it. */
+typedef struct {
+	guint start;
+	guint end;
+	guint best;
+} Range;
+
+struct _GeocodeCompletionBackend {
+	GObject parent;
+
+	GeocodeBackend *fallback;  /* (owned) (nullable) */
+
+	GMutex lock;
+	GArray *entries;  /* (owned) (element-type Entry); locked by @lock */
+	/* Segment tree over @entries: node i > 0 holds the index of the most
+	 * important entry below it, and node @entries->len + j holds j.
+	 * Locked by @lock, and only valid while @index_valid is %TRUE. */
+	guint *tree;  /* (owned) (nullable) */
+	gboolean index_valid;
+};
+
+typedef enum {
+	PROP_FALLBACK = 1,
+} GeocodeCompletionBackendProperty;
+
+static GParamSpec *properties[PROP_FALLBACK + 1];
+
+static void geocode_backend_iface_init (GeocodeBackendInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GeocodeCompletionBackend, geocode_completion_backend, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (GEOCODE_TYPE_BACKEND,
+                                                geocode_backend_iface_init))
+
+/******************************************************************************/
+
+static void
+entry_clear (Entry *entry)
+{
+	g_free (entry->key);
+	g_clear_object (&entry->place);
+}
+
+static gint
+compare_entries (gconstpointer a,
+                 gconstpointer b)
+{
+	const Entry *entry_a = a;
+	const Entry *entry_b = b;
+	gint ret;
+
+	ret = strcmp (entry_a->key, entry_b->key);
+	if (ret != 0)
+		return ret;
+
+	return (entry_a->importance < entry_b->importance) -
+	       (entry_a->importance > entry_b->importance);
+}
+
+/* Returns whichever of the entries at @a and @b is more important, or the
+ * earlier one if they are equally important, so that shorter names come
+ * first. */
+static guint
+better_entry (GeocodeCompletionBackend *self,
+              guint                     a,
+              guint                     b)
+{
+	gdouble importance_a = g_array_index (self->entries, Entry, a).importance;
+	gdouble importance_b = g_array_index (self->entries, Entry, b).importance;
+
+	if (importance_a != importance_b)
+		return (importance_a > importance_b) ? a : b;
+
+	return MIN (a, b);
+}
+
+static void
+ensure_index (GeocodeCompletionBackend *self)
+{
+	guint n = self->entries->len;
+	guint i;
+
+	if (self->index_valid)
+		return;
+
+	g_array_sort (self->entries, compare_entries);
+
+	g_free (self->tree);
+	self->tree = g_new (guint, 2 * MAX (n, 1));
+
+	for (i = 0; i < n; i++)
+		self->tree[n + i] = i;
+	for (i = n - 1; i > 0 && n > 0; i--)
+		self->tree[i] = better_entry (self, self->tree[2 * i],
+		                              self->tree[2 * i + 1]);
+
+	self->index_valid = TRUE;
+}
+
+/* Returns the most important entry in [@start, @end), which must not be
+ * empty, walking up the tree from both ends. */
+static guint
+find_best_entry (GeocodeCompletionBackend *self,
+                 guint                     start,
+                 guint                     end)
+{
+	guint n = self->entries->len;
+	guint best = start;
+
+	for (start += n, end += n; start < end; start /= 2, end /= 2) {
+		if (start & 1)
+			best = better_entry (self, best, self->tree[start++]);
+		if (end & 1)
+			best = better_entry (self, best, self->tree[--end]);
+	}
+
+	return best;
+}
+
+/* Returns the index of the first entry whose key starts with @prefix, or
+ * would if there is none, and sets @end to the index after the last one. */
+static guint
+find_prefix_range (GeocodeCompletionBackend *self,
+                   const char               *prefix,
+                   guint                    *end)
+{
+	gsize prefix_len = strlen (prefix);
+	guint low = 0, high = self->entries->len;
+	guint start;
+
+	while (low < high) {
+		guint mid = low + (high - low) / 2;
+
+		if (strcmp (g_array_index (self->entries, Entry, mid).key, prefix) < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	start = low;
+	high = self->entries->len;
+
+	/* Keys from @start on compare greater than or equal to @prefix, so
+	 * the ones starting with it come first. */
+	while (low < high) {
+		guint mid = low + (high - low) / 2;
+
+		if (strncmp (g_array_index (self->entries, Entry, mid).key, prefix, prefix_len) == 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	*end = low;
+
+	return start;
+}
+
+static void
+add_range (GeocodeCompletionBackend *self,
+           GArray                   *ranges,
+           guint                     start,
+           guint                     end)
+{
+	Range range;
+
+	if (start >= end)
+		return;
+
+	range.start = start;
+	range.end = end;
+	range.best = find_best_entry (self, start, end);
+	g_array_append_val (ranges, range);
+}
+
+/**
+ * geocode_completion_backend_complete:
+ * @self: a #GeocodeCompletionBackend
+ * @prefix: the start of a place name
+ * @n_results: maximum number of places to return
+ *
+ * Finds the most important places whose names start with @prefix, ignoring
+ * case. This does not use the fallback backend.
+ *
+ * Returns: (transfer full) (element-type GeocodePlace): the matching
+ * places, most important first, or %NULL if there are none
+ *
+ * Since: 3.28
+ */
+GList *
+geocode_completion_backend_complete (GeocodeCompletionBackend *self,
+                                     const char               *prefix,
+                                     guint                     n_results)
+{
+	g_autofree char *key = NULL;
+	g_autoptr (GArray) ranges = NULL;  /* (element-type Range) */
+	GList *places = NULL;  /* (element-type GeocodePlace) */
+	guint start, end, n_places = 0;
+
+	g_return_val_if_fail (GEOCODE_IS_COMPLETION_BACKEND (self), NULL);
+	g_return_val_if_fail (prefix != NULL, NULL);
+
+	key = _geocode_normalize_name (prefix);
+	if (key == NULL || n_results == 0)
+		return NULL;
+
+	ranges = g_array_new (FALSE, FALSE, sizeof (Range));
+
+	g_mutex_lock (&self->lock);
+
+	ensure_index (self);
+
+	start = find_prefix_range (self, key, &end);
+	add_range (self, ranges, start, end);
+
+	/* Each range holds the entries not yet returned between two which
+	 * have been, so the next result is the best of the ranges’ bests,
+	 * and taking it splits its range in two. There are never more than
+	 * @n_results + 1 ranges, so a linear scan is fine. */
+	while (n_places < n_results && ranges->len > 0) {
+		const Entry *entry;
+		Range range;
+		guint i, chosen = 0;
+
+		for (i = 1; i < ranges->len; i++) {
+			if (better_entry (self,
+			                  g_array_index (ranges, Range, chosen).best,
+			                  g_array_index (ranges, Range, i).best) !=
+			    g_array_index (ranges, Range, chosen).best)
+				chosen = i;
+		}
+
+		range = g_array_index (ranges, Range, chosen);
+		g_array_remove_index_fast (ranges, chosen);
+
+		entry = &g_array_index (self->entries, Entry, range.best);
+		places = g_list_prepend (places, g_object_ref (entry->place));
+		n_places++;
+
+		add_range (self, ranges, range.start, range.best);
+		add_range (self, ranges, range.best + 1, range.end);
+	}
+
+	g_mutex_unlock (&self->lock);
+
+	return g_list_reverse (places);
+}
+
+/**
+ * geocode_completion_backend_add_place:
+ * @self: a #GeocodeCompletionBackend
+ * @place: a #GeocodePlace with a name
+ * @importance: how important @place is relative to other places
+ *
+ * Adds @place to the places which can be completed. Places with a higher
+ * @importance are returned first; this could be the importance given by
+ * Nominatim, or the population, for example.
+ *
+ * Since: 3.28
+ */
+void
+geocode_completion_backend_add_place (GeocodeCompletionBackend *self,
+                                      GeocodePlace             *place,
+                                      gdouble                   importance)
+{
+	Entry entry;
+
+	g_return_if_fail (GEOCODE_IS_COMPLETION_BACKEND (self));
+	g_return_if_fail (GEOCODE_IS_PLACE (place));
+	g_return_if_fail (geocode_place_get_name (place) != NULL);
+	g_return_if_fail (!isnan (importance));
+
+	entry.key = _geocode_normalize_name (geocode_place_get_name (place));
+	g_return_if_fail (entry.key != NULL);
+	entry.place = g_object_ref (place);
+	entry.importance = importance;
+
+	g_mutex_lock (&self->lock);
+	g_array_append_val (self->entries, entry);
+	self->index_valid = FALSE;
+	g_mutex_unlock (&self->lock);
+}
+
+/**
+ * geocode_completion_backend_get_n_places:
+ * @self: a #GeocodeCompletionBackend
+ *
+ * Gets the number of places added with
+ * geocode_completion_backend_add_place().
+ *
+ * Returns: the number of places
+ *
+ * Since: 3.28
+ */
+guint
+geocode_completion_backend_get_n_places (GeocodeCompletionBackend *self)
+{
+	guint n_places;
+
+	g_return_val_if_fail (GEOCODE_IS_COMPLETION_BACKEND (self), 0);
+
+	g_mutex_lock (&self->lock);
+	n_places = self->entries->len;
+	g_mutex_unlock (&self->lock);
+
+	return n_places;
+}
+
+/**
+ * geocode_completion_backend_get_fallback:
+ * @self: a #GeocodeCompletionBackend
+ *
+ * Gets the #GeocodeCompletionBackend:fallback backend.
+ *
+ * Returns: (transfer none) (nullable): the fallback backend, or %NULL
+ *
+ * Since: 3.28
+ */
+GeocodeBackend *
+geocode_completion_backend_get_fallback (GeocodeCompletionBackend *self)
+{
+	g_return_val_if_fail (GEOCODE_IS_COMPLETION_BACKEND (self), NULL);
+
+	return self->fallback;
+}
+
+/******************************************************************************/
+
+static void
+places_list_free (GList *places)
+{
+	g_list_free_full (places, g_object_unref);
+}
+
+/* Answers a forward query from the local places only. */
+static GList *
+complete_forward (GeocodeCompletionBackend  *self,
+                  GHashTable                *params,
+                  GError                   **error)
+{
+	const char *location;
+	GList *places;
+
+	location = _geocode_params_lookup_string (params, "location");
+	if (location == NULL) {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_INVALID_ARGUMENTS,
+		                     "Only following parameters supported: location, limit");
+		return NULL;
+	}
+
+	places = geocode_completion_backend_complete (self, location,
+	                                              _geocode_params_lookup_limit (params));
+	if (places == NULL)
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_NO_MATCHES,
+		                     "No matches found for request");
+
+	return places;
+}
+
+static GList *
+geocode_completion_backend_forward_search (GeocodeBackend  *backend,
+                                           GHashTable      *params,
+                                           GCancellable    *cancellable,
+                                           GError         **error)
+{
+	GeocodeCompletionBackend *self = GEOCODE_COMPLETION_BACKEND (backend);
+	GList *places;
+	GError *local_error = NULL;
+
+	if (g_cancellable_set_error_if_cancelled (cancellable, error))
+		return NULL;
+
+	places = complete_forward (self, params, &local_error);
+	if (local_error == NULL)
+		return places;
+
+	if (self->fallback == NULL) {
+		g_propagate_error (error, local_error);
+		return NULL;
+	}
+
+	g_error_free (local_error);
+
+	return geocode_backend_forward_search (self->fallback, params,
+	                                       cancellable, error);
+}
+
+static void
+forward_search_fallback_cb (GObject      *source_object,
+                            GAsyncResult *result,
+                            gpointer      user_data)
+{
+	g_autoptr (GTask) task = G_TASK (user_data);
+	GList *places;
+	GError *error = NULL;
+
+	places = geocode_backend_forward_search_finish (GEOCODE_BACKEND (source_object),
+	                                                result, &error);
+	if (error != NULL)
+		g_task_return_error (task, error);
+	else
+		g_task_return_pointer (task, places,
+		                       (GDestroyNotify) places_list_free);
+}
+
+static void
+geocode_completion_backend_forward_search_async (GeocodeBackend      *backend,
+                                                 GHashTable          *params,
+                                                 GCancellable        *cancellable,
+                                                 GAsyncReadyCallback  callback,
+                                                 gpointer             user_data)
+{
+	GeocodeCompletionBackend *self = GEOCODE_COMPLETION_BACKEND (backend);
+	g_autoptr (GTask) task = NULL;
+	GList *places;
+	GError *error = NULL;
+
+	task = g_task_new (backend, cancellable, callback, user_data);
+	g_task_set_source_tag (task, geocode_completion_backend_forward_search_async);
+
+	if (g_task_return_error_if_cancelled (task))
+		return;
+
+	/* Completion never blocks, so there is no point in using a thread. */
+	places = complete_forward (self, params, &error);
+
+	if (error == NULL) {
+		g_task_return_pointer (task, places,
+		                       (GDestroyNotify) places_list_free);
+	} else if (self->fallback == NULL) {
+		g_task_return_error (task, error);
+	} else {
+		g_error_free (error);
+		geocode_backend_forward_search_async (self->fallback, params,
+		                                      cancellable,
+		                                      forward_search_fallback_cb,
+		                                      g_steal_pointer (&task));
+	}
+}
+
+static GList *
+geocode_completion_backend_forward_search_finish (GeocodeBackend  *backend,
+                                                  GAsyncResult    *result,
+                                                  GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static GList *
+geocode_completion_backend_reverse_resolve (GeocodeBackend  *backend,
+                                            GHashTable      *params,
+                                            GCancellable    *cancellable,
+                                            GError         **error)
+{
+	GeocodeCompletionBackend *self = GEOCODE_COMPLETION_BACKEND (backend);
+
+	if (self->fallback == NULL) {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED,
+		                     "Reverse geocoding is not supported by this backend");
+		return NULL;
+	}
+
+	return geocode_backend_reverse_resolve (self->fallback, params,
+	                                        cancellable, error);
+}
+
+static void
+reverse_resolve_fallback_cb (GObject      *source_object,
+                             GAsyncResult *result,
+                             gpointer      user_data)
+{
+	g_autoptr (GTask) task = G_TASK (user_data);
+	GList *places;
+	GError *error = NULL;
+
+	places = geocode_backend_reverse_resolve_finish (GEOCODE_BACKEND (source_object),
+	                                                 result, &error);
+	if (error != NULL)
+		g_task_return_error (task, error);
+	else
+		g_task_return_pointer (task, places,
+		                       (GDestroyNotify) places_list_free);
+}
+
+static void
+geocode_completion_backend_reverse_resolve_async (GeocodeBackend      *backend,
+                                                  GHashTable          *params,
+                                                  GCancellable        *cancellable,
+                                                  GAsyncReadyCallback  callback,
+                                                  gpointer             user_data)
+{
+	GeocodeCompletionBackend *self = GEOCODE_COMPLETION_BACKEND (backend);
+	g_autoptr (GTask) task = NULL;
+
+	task = g_task_new (backend, cancellable, callback, user_data);
+	g_task_set_source_tag (task, geocode_completion_backend_reverse_resolve_async);
+
+	if (self->fallback == NULL) {
+		g_task_return_new_error (task, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED,
+		                         "Reverse geocoding is not supported by this backend");
+		return;
+	}
+
+	geocode_backend_reverse_resolve_async (self->fallback, params, cancellable,
+	                                       reverse_resolve_fallback_cb,
+	                                       g_steal_pointer (&task));
+}
+
+static GList *
+geocode_completion_backend_reverse_resolve_finish (GeocodeBackend  *backend,
+                                                   GAsyncResult    *result,
+                                                   GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/******************************************************************************/
+
+/**
+ * geocode_completion_backend_new:
+ * @fallback: (nullable): backend for queries which match no places, or %NULL
+ *
+ * Creates a new completion backend with no places. Add some with
+ * geocode_completion_backend_add_place() before using it.
+ *
+ * Returns: (transfer full): a new #GeocodeCompletionBackend. Use
+ * g_object_unref() when done.
+ *
+ * Since: 3.28
+ */
+GeocodeCompletionBackend *
+geocode_completion_backend_new (GeocodeBackend *fallback)
+{
+	g_return_val_if_fail (fallback == NULL || GEOCODE_IS_BACKEND (fallback), NULL);
+
+	return GEOCODE_COMPLETION_BACKEND (g_object_new (GEOCODE_TYPE_COMPLETION_BACKEND,
+	                                                 "fallback", fallback,
+	                                                 NULL));
+}
+
+static void
+geocode_completion_backend_init (GeocodeCompletionBackend *self)
+{
+	g_mutex_init (&self->lock);
+	self->entries = g_array_new (FALSE, FALSE, sizeof (Entry));
+	g_array_set_clear_func (self->entries, (GDestroyNotify) entry_clear);
+}
+
+static void
+geocode_completion_backend_get_property (GObject    *object,
+                                         guint       property_id,
+                                         GValue     *value,
+                                         GParamSpec *pspec)
+{
+	GeocodeCompletionBackend *self = GEOCODE_COMPLETION_BACKEND (object);
+
+	switch ((GeocodeCompletionBackendProperty) property_id) {
+	case PROP_FALLBACK:
+		g_value_set_object (value, self->fallback);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+		break;
+	}
+}
+
+static void
+geocode_completion_backend_set_property (GObject      *object,
+                                         guint         property_id,
+                                         const GValue *value,
+                                         GParamSpec   *pspec)
+{
+	GeocodeCompletionBackend *self = GEOCODE_COMPLETION_BACKEND (object);
+
+	switch ((GeocodeCompletionBackendProperty) property_id) {
+	case PROP_FALLBACK:
+		/* Construct only. */
+		g_assert (self->fallback == NULL);
+		self->fallback = g_value_dup_object (value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+		break;
+	}
+}
+
+static void
+geocode_completion_backend_finalize (GObject *object)
+{
+	GeocodeCompletionBackend *self = GEOCODE_COMPLETION_BACKEND (object);
+
+	g_clear_object (&self->fallback);
+	g_array_unref (self->entries);
+	g_free (self->tree);
+	g_mutex_clear (&self->lock);
+
+	G_OBJECT_CLASS (geocode_completion_backend_parent_class)->finalize (object);
+}
+
+static void
+geocode_backend_iface_init (GeocodeBackendInterface *iface)
+{
+	iface->forward_search = geocode_completion_backend_forward_search;
+	iface->forward_search_async = geocode_completion_backend_forward_search_async;
+	iface->forward_search_finish = geocode_completion_backend_forward_search_finish;
+	iface->reverse_resolve = geocode_completion_backend_reverse_resolve;
+	iface->reverse_resolve_async = geocode_completion_backend_reverse_resolve_async;
+	iface->reverse_resolve_finish = geocode_completion_backend_reverse_resolve_finish;
+}
+
+static void
+geocode_completion_backend_class_init (GeocodeCompletionBackendClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->get_property = geocode_completion_backend_get_property;
+	object_class->set_property = geocode_completion_backend_set_property;
+	object_class->finalize = geocode_completion_backend_finalize;
+
+	/**
+	 * GeocodeCompletionBackend:fallback:
+	 *
+	 * The backend which forward queries matching no places, and reverse
+	 * queries, are passed on to, or %NULL if they should fail.
+	 *
+	 * Since: 3.28
+	 */
+	properties[PROP_FALLBACK] = g_param_spec_object ("fallback",
+	                                                 "Fallback",
+	                                                 "Backend for queries which match no places",
+	                                                 GEOCODE_TYPE_BACKEND,
+	                                                 (G_PARAM_READWRITE |
+	                                                  G_PARAM_CONSTRUCT_ONLY |
+	                                                  G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_properties (object_class,
+	                                   G_N_ELEMENTS (properties), properties);
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#ifndef GEOCODE_COMPLETION_BACKEND_H
+#define GEOCODE_COMPLETION_BACKEND_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "geocode-backend.h"
+#include "geocode-place.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GeocodeCompletionBackend:
+ *
+ * All the fields in the #GeocodeCompletionBackend structure are private and
+ * should never be accessed directly.
+ *
+ * Since: 3.28
+ */
+#define GEOCODE_TYPE_COMPLETION_BACKEND (geocode_completion_backend_get_type ())
+G_DECLARE_FINAL_TYPE (GeocodeCompletionBackend, geocode_completion_backend,
+                      GEOCODE, COMPLETION_BACKEND, GObject)
+
+/**
+ * GEOCODE_TYPE_COMPLETION_BACKEND:
+ *
+ * See #GeocodeCompletionBackend.
+ *
+ * Since: 3.28
+ */
+
+GeocodeCompletionBackend *geocode_completion_backend_new (GeocodeBackend *fallback);
+
+GeocodeBackend *geocode_completion_backend_get_fallback (GeocodeCompletionBackend *self);
+
+void geocode_completion_backend_add_place (GeocodeCompletionBackend *self,
+                                           GeocodePlace             *place,
+                                           gdouble                   importance);
+guint geocode_completion_backend_get_n_places (GeocodeCompletionBackend *self);
+
+GList *geocode_completion_backend_complete (GeocodeCompletionBackend *self,
+                                            const char               *prefix,
+                                            guint                     n_results);
+
+G_END_DECLS
+
+#endif /* GEOCODE_COMPLETION_BACKEND_H */
@@ -0,0 +1,237 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include "geocode-coordinate.h"
+#include "geocode-geo-uri.h"
+#include "geocode-glib-private.h"
+#include "geocode-location.h"
+
+/**
+ * SECTION:geocode-coordinate
+ * @short_description: Plain coordinate structure
+ * @include: geocode-glib/geocode-glib.h
+ *
+ * #GeocodeCoordinate holds a latitude, longitude, altitude and accuracy in
+ * a plain structure, for code which handles too many positions for a
+ * #GeocodeLocation object per position to be affordable, such as a stream
+ * of GPS fixes. Coordinates can be declared on the stack and initialised
+ * with geocode_coordinate_init(), or kept in arrays.
+ *
+ * They can be converted to and from #GeocodeLocation with
+ * geocode_location_new_for_coordinate() and
+ * geocode_location_get_coordinate(), and are accepted directly by
+ * geocode_bounding_box_contains_coordinate() and
+ * geocode_reverse_new_for_coordinate().
+ *
+ * Since: 3.28
+ */
+
+G_DEFINE_BOXED_TYPE (GeocodeCoordinate, geocode_coordinate,
+                     geocode_coordinate_copy, geocode_coordinate_free)
+
+/**
+ * geocode_coordinate_new:
+ * @latitude: a valid latitude
+ * @longitude: a valid longitude
+ * @accuracy: accuracy of the coordinate in meters
+ *
+ * Creates a new #GeocodeCoordinate on the heap, with an unknown altitude.
+ * Where possible, use a #GeocodeCoordinate on the stack and
+ * geocode_coordinate_init() instead.
+ *
+ * Returns: (transfer full): a new #GeocodeCoordinate. Use
+ * geocode_coordinate_free() when done.
+ *
+ * Since: 3.28
+ */
+GeocodeCoordinate *
+geocode_coordinate_new (gdouble latitude,
+                        gdouble longitude,
+                        gdouble accuracy)
+{
+	GeocodeCoordinate *coord;
+
+	coord = g_new (GeocodeCoordinate, 1);
+	geocode_coordinate_init (coord, latitude, longitude, accuracy);
+
+	return coord;
+}
+
+/**
+ * geocode_coordinate_init:
+ * @coord: (out caller-allocates): a #GeocodeCoordinate
+ * @latitude: a valid latitude
+ * @longitude: a valid longitude
+ * @accuracy: accuracy of the coordinate in meters
+ *
+ * Initialises @coord with the given values and an unknown altitude, like
+ * geocode_location_new() does for a #GeocodeLocation.
+ *
+ * Since: 3.28
+ */
+void
+geocode_coordinate_init (GeocodeCoordinate *coord,
+                         gdouble            latitude,
+                         gdouble            longitude,
+                         gdouble            accuracy)
+{
+	g_return_if_fail (coord != NULL);
+	g_return_if_fail (latitude >= -90.0 && latitude <= 90.0);
+	g_return_if_fail (longitude >= -180.0 && longitude <= 180.0);
+	g_return_if_fail (accuracy >= GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+
+	coord->latitude = latitude;
+	coord->longitude = longitude;
+	coord->altitude = GEOCODE_LOCATION_ALTITUDE_UNKNOWN;
+	coord->accuracy = accuracy;
+}
+
+/**
+ * geocode_coordinate_copy:
+ * @coord: a #GeocodeCoordinate
+ *
+ * Copies @coord.
+ *
+ * Returns: (transfer full): a copy of @coord. Use geocode_coordinate_free()
+ * when done.
+ *
+ * Since: 3.28
+ */
+GeocodeCoordinate *
+geocode_coordinate_copy (const GeocodeCoordinate *coord)
+{
+	GeocodeCoordinate *copy;
+
+	g_return_val_if_fail (coord != NULL, NULL);
+
+	copy = g_new (GeocodeCoordinate, 1);
+	*copy = *coord;
+
+	return copy;
+}
+
+/**
+ * geocode_coordinate_free:
+ * @coord: (transfer full) (nullable): a #GeocodeCoordinate
+ *
+ * Frees a #GeocodeCoordinate allocated with geocode_coordinate_new() or
+ * geocode_coordinate_copy().
+ *
+ * Since: 3.28
+ */
+void
+geocode_coordinate_free (GeocodeCoordinate *coord)
+{
+	g_free (coord);
+}
+
+/**
+ * geocode_coordinate_get_distance_from:
+ * @coorda: a #GeocodeCoordinate
+ * @coordb: a #GeocodeCoordinate
+ *
+ * Calculates the distance in km, along the curvature of the Earth, between
+ * 2 coordinates, exactly as geocode_location_get_distance_from() does for
+ * locations. Note that altitude changes are not taken into account.
+ *
+ * Returns: a distance in km.
+ *
+ * Since: 3.28
+ */
+gdouble
+geocode_coordinate_get_distance_from (const GeocodeCoordinate *coorda,
+                                      const GeocodeCoordinate *coordb)
+{
+	g_return_val_if_fail (coorda != NULL, 0.0);
+	g_return_val_if_fail (coordb != NULL, 0.0);
+
+	return _geocode_haversine_distance (coorda->latitude, coorda->longitude,
+	                                    coordb->latitude, coordb->longitude);
+}
+
+/**
+ * geocode_coordinate_set_from_uri:
+ * @coord: a #GeocodeCoordinate
+ * @uri: a geo URI
+ * @error: #GError for error reporting, or %NULL to ignore
+ *
+ * Sets @coord from a geo URI, as geocode_location_set_from_uri() does for
+ * a #GeocodeLocation. Any description in the URI is ignored, and the
+ * altitude and accuracy are set to unknown if the URI does not give them.
+ *
+ * @coord is only modified if @uri is valid.
+ *
+ * Returns: %TRUE on success and %FALSE on error.
+ *
+ * Since: 3.28
+ */
+gboolean
+geocode_coordinate_set_from_uri (GeocodeCoordinate  *coord,
+                                 const char         *uri,
+                                 GError            **error)
+{
+	GeocodeGeoUri geo_uri;
+
+	g_return_val_if_fail (coord != NULL, FALSE);
+	g_return_val_if_fail (uri != NULL, FALSE);
+
+	if (!geocode_geo_uri_parse (uri, &geo_uri, error))
+		return FALSE;
+
+	coord->latitude = geo_uri.latitude;
+	coord->longitude = geo_uri.longitude;
+	coord->altitude = geo_uri.has_altitude ?
+	                  geo_uri.altitude : GEOCODE_LOCATION_ALTITUDE_UNKNOWN;
+	coord->accuracy = geo_uri.has_accuracy ?
+	                  geo_uri.accuracy : GEOCODE_LOCATION_ACCURACY_UNKNOWN;
+
+	return TRUE;
+}
+
+/**
+ * geocode_coordinate_format_uri:
+ * @coord: a #GeocodeCoordinate
+ * @buffer: (out caller-allocates) (array length=buffer_size): return
+ *    location for the URI
+ * @buffer_size: the size of @buffer, in bytes
+ *
+ * Writes the geo URI for @coord to @buffer, as geocode_geo_uri_format()
+ * does. This is the URI geocode_location_to_uri() returns for the same
+ * coordinates.
+ *
+ * Returns: the length of the URI, not including the nul terminator. If this
+ *    is not less than @buffer_size, the URI did not fit.
+ *
+ * Since: 3.28
+ */
+gsize
+geocode_coordinate_format_uri (const GeocodeCoordinate *coord,
+                               char                    *buffer,
+                               gsize                    buffer_size)
+{
+	g_return_val_if_fail (coord != NULL, 0);
+
+	return geocode_geo_uri_format (coord->latitude,
+	                               coord->longitude,
+	                               coord->altitude,
+	                               coord->accuracy,
+	                               buffer,
+	                               buffer_size);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#ifndef GEOCODE_COORDINATE_H
+#define GEOCODE_COORDINATE_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GeocodeCoordinate:
+ * @latitude: the latitude, in degrees
+ * @longitude: the longitude, in degrees
+ * @altitude: the altitude, in metres, or
+ *    %GEOCODE_LOCATION_ALTITUDE_UNKNOWN
+ * @accuracy: the accuracy, in metres, or
+ *    %GEOCODE_LOCATION_ACCURACY_UNKNOWN
+ *
+ * A position on the Earth, as a plain structure which can be allocated on
+ * the stack or in arrays. It holds the same coordinates as a
+ * #GeocodeLocation, without its description, CRS, timestamp or any of the
+ * overhead of a #GObject.
+ *
+ * Since: 3.28
+ */
+typedef struct {
+	gdouble latitude;
+	gdouble longitude;
+	gdouble altitude;
+	gdouble accuracy;
+} GeocodeCoordinate;
+
+#define GEOCODE_TYPE_COORDINATE (geocode_coordinate_get_type ())
+
+GType geocode_coordinate_get_type (void) G_GNUC_CONST;
+
+GeocodeCoordinate *geocode_coordinate_new (gdouble latitude,
+                                           gdouble longitude,
+                                           gdouble accuracy);
+void geocode_coordinate_init (GeocodeCoordinate *coord,
+                              gdouble            latitude,
+                              gdouble            longitude,
+                              gdouble            accuracy);
+GeocodeCoordinate *geocode_coordinate_copy (const GeocodeCoordinate *coord);
+void geocode_coordinate_free (GeocodeCoordinate *coord);
+
+gdouble geocode_coordinate_get_distance_from (const GeocodeCoordinate *coorda,
+                                              const GeocodeCoordinate *coordb);
+
+gboolean geocode_coordinate_set_from_uri (GeocodeCoordinate  *coord,
+                                          const char         *uri,
+                                          GError            **error);
+gsize geocode_coordinate_format_uri (const GeocodeCoordinate *coord,
+                                     char                    *buffer,
+                                     gsize                    buffer_size);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GeocodeCoordinate, geocode_coordinate_free)
+
+G_END_DECLS
+
+#endif /* GEOCODE_COORDINATE_H */
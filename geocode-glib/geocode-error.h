@@ -43,6 +43,8 @@ G_BEGIN_DECLS
  * @GEOCODE_ERROR_NO_MATCHES: The requests made didn't have any matches.
  * @GEOCODE_ERROR_INVALID_ARGUMENTS: The request made contained invalid arguments.
  * @GEOCODE_ERROR_INTERNAL_SERVER: The server encountered an (possibly unrecoverable) internal error.
+ * @GEOCODE_ERROR_TIMED_OUT: The request did not complete before its deadline
+ *   or timeout expired. Since: 3.28
  *
  * Error codes returned by geocode-glib functions.
  **/
@@ -51,7 +53,8 @@ typedef enum {
 	GEOCODE_ERROR_NOT_SUPPORTED,
 	GEOCODE_ERROR_NO_MATCHES,
 	GEOCODE_ERROR_INVALID_ARGUMENTS,
-	GEOCODE_ERROR_INTERNAL_SERVER
+	GEOCODE_ERROR_INTERNAL_SERVER,
+	GEOCODE_ERROR_TIMED_OUT
 } GeocodeError;
 
 GQuark geocode_error_quark (void);
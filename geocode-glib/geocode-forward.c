@@ -46,6 +46,7 @@ struct _GeocodeForwardPrivate {
 	guint       answer_count;
 	GeocodeBoundingBox *search_area;
 	gboolean bounded;
+	guint deadline;
 
 	GeocodeBackend  *backend;
 };
@@ -55,7 +56,8 @@ enum {
 
         PROP_ANSWER_COUNT,
         PROP_SEARCH_AREA,
-        PROP_BOUNDED
+        PROP_BOUNDED,
+        PROP_DEADLINE
 };
 
 G_DEFINE_TYPE_WITH_CODE (GeocodeForward, geocode_forward, G_TYPE_OBJECT,
@@ -85,6 +87,11 @@ geocode_forward_get_property (GObject	 *object,
 					     geocode_forward_get_bounded (forward));
 			break;
 
+		case PROP_DEADLINE:
+			g_value_set_uint (value,
+					  geocode_forward_get_deadline (forward));
+			break;
+
 		default:
 			/* We don't have any other property... */
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -116,6 +123,11 @@ geocode_forward_set_property(GObject	   *object,
 						     g_value_get_boolean (value));
 			break;
 
+		case PROP_DEADLINE:
+			geocode_forward_set_deadline (forward,
+						      g_value_get_uint (value));
+			break;
+
 		default:
 			/* We don't have any other property... */
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -191,6 +203,24 @@ geocode_forward_class_init (GeocodeForwardClass *klass)
 				      G_PARAM_READWRITE |
 				      G_PARAM_STATIC_STRINGS);
 	g_object_class_install_property (gforward_class, PROP_BOUNDED, pspec);
+
+	/**
+	* GeocodeForward:deadline:
+	*
+	* The time, in milliseconds, a search may take before it is abandoned
+	* and fails with %GEOCODE_ERROR_TIMED_OUT, or 0 for no deadline.
+	*
+	* Since: 3.28
+	*/
+	pspec = g_param_spec_uint ("deadline",
+				   "Deadline",
+				   "Time allowed for a search, in milliseconds",
+				   0,
+				   G_MAXUINT,
+				   0,
+				   G_PARAM_READWRITE |
+				   G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property (gforward_class, PROP_DEADLINE, pspec);
 }
 
 static void
@@ -305,6 +335,7 @@ backend_forward_search_ready (GeocodeBackend *backend,
 	GError *error = NULL;
 
 	places = geocode_backend_forward_search_finish (backend, res, &error);
+	_geocode_deadline_translate_error (g_task_get_task_data (task), &error);
 	if (places != NULL)
 		g_task_return_pointer (task, places, (GDestroyNotify) g_list_free);
 	else
@@ -343,6 +374,17 @@ geocode_forward_search_async (GeocodeForward      *forward,
 	g_assert (priv->backend != NULL);
 
 	task = g_task_new (forward, cancellable, callback, user_data);
+	if (priv->deadline > 0) {
+		GeocodeDeadline *deadline;
+
+		deadline = _geocode_deadline_new (priv->deadline,
+		                                  cancellable,
+		                                  g_task_get_context (task));
+		g_task_set_task_data (task, deadline,
+		                      (GDestroyNotify) _geocode_deadline_finish);
+		cancellable = _geocode_deadline_get_cancellable (deadline);
+	}
+
 	geocode_backend_forward_search_async (priv->backend,
 	                                      priv->ht,
 	                                      cancellable,
@@ -396,6 +438,10 @@ geocode_forward_search (GeocodeForward      *forward,
 			GError             **error)
 {
 	GeocodeForwardPrivate *priv;
+	GeocodeDeadline *deadline;
+	GList *places;  /* (element-type GeocodePlace) */
+	GError *local_error = NULL;
+
 	g_return_val_if_fail (GEOCODE_IS_FORWARD (forward), NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
@@ -403,10 +449,24 @@ geocode_forward_search (GeocodeForward      *forward,
 	priv = geocode_forward_get_instance_private (forward);
 	g_assert (priv->backend != NULL);
 
-	return geocode_backend_forward_search (priv->backend,
-	                                       priv->ht,
-	                                       NULL,
-	                                       error);
+	if (priv->deadline == 0)
+		return geocode_backend_forward_search (priv->backend,
+		                                       priv->ht,
+		                                       NULL,
+		                                       error);
+
+	deadline = _geocode_deadline_new (priv->deadline, NULL, NULL);
+	places = geocode_backend_forward_search (priv->backend,
+	                                         priv->ht,
+	                                         _geocode_deadline_get_cancellable (deadline),
+	                                         &local_error);
+	_geocode_deadline_translate_error (deadline, &local_error);
+	_geocode_deadline_finish (deadline);
+
+	if (local_error != NULL)
+		g_propagate_error (error, local_error);
+
+	return places;
 }
 
 /**
@@ -566,6 +626,50 @@ geocode_forward_get_bounded (GeocodeForward *forward)
 	return priv->bounded;
 }
 
+/**
+ * geocode_forward_set_deadline:
+ * @forward: a #GeocodeForward representing a query
+ * @deadline: the time allowed for a search, in milliseconds, or 0
+ *
+ * Sets the #GeocodeForward:deadline property. Searches which take longer
+ * than @deadline are cancelled and fail with %GEOCODE_ERROR_TIMED_OUT, so
+ * that callers can fall back to another source of results.
+ *
+ * Since: 3.28
+ **/
+void
+geocode_forward_set_deadline (GeocodeForward *forward,
+			      guint           deadline)
+{
+	GeocodeForwardPrivate *priv;
+
+	g_return_if_fail (GEOCODE_IS_FORWARD (forward));
+
+	priv = geocode_forward_get_instance_private (forward);
+	priv->deadline = deadline;
+}
+
+/**
+ * geocode_forward_get_deadline:
+ * @forward: a #GeocodeForward representing a query
+ *
+ * Gets the #GeocodeForward:deadline property.
+ *
+ * Returns: the time allowed for a search, in milliseconds, or 0 if there
+ * is no deadline.
+ *
+ * Since: 3.28
+ **/
+guint
+geocode_forward_get_deadline (GeocodeForward *forward)
+{
+	GeocodeForwardPrivate *priv;
+	g_return_val_if_fail (GEOCODE_IS_FORWARD (forward), 0);
+
+	priv = geocode_forward_get_instance_private (forward);
+	return priv->deadline;
+}
+
 /**
  * geocode_forward_set_backend:
  * @forward: a #GeocodeForward representing a query
@@ -78,6 +78,9 @@ void geocode_forward_set_search_area                 (GeocodeForward     *forwar
 gboolean geocode_forward_get_bounded                 (GeocodeForward *forward);
 void geocode_forward_set_bounded                     (GeocodeForward *forward,
 						      gboolean        bounded);
+guint geocode_forward_get_deadline                   (GeocodeForward *forward);
+void geocode_forward_set_deadline                    (GeocodeForward *forward,
+						      guint           deadline);
 
 void geocode_forward_search_async  (GeocodeForward       *forward,
 				    GCancellable        *cancellable,
@@ -0,0 +1,1287 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include <gio/gio.h>
+#include <math.h>
+#include <string.h>
+
+#include "geocode-glib-private.h"
+#include "geocode-glib.h"
+#include "geocode-gazetteer.h"
+
+/**
+ * SECTION:geocode-gazetteer
+ * @short_description: Geocode backend for offline gazetteer files
+ * @include: geocode-glib/geocode-glib.h
+ *
+ * #GeocodeGazetteer is a #GeocodeBackend which answers forward and reverse
+ * queries from a prebuilt gazetteer file on the local machine, rather than
+ * from a Nominatim server. It is intended for systems which have no network
+ * access, or which need answers faster than an HTTP round trip allows.
+ *
+ * The gazetteer file is mapped into memory when the backend is created.
+ * Opening it checks the header and reads the whole table of grid cells
+ * (about 250 KiB) to validate their offsets, which takes the same time
+ * regardless of the number of places; records, names and strings are only
+ * checked as queries read them. The mapping is read-only, so all the
+ * processes which use the same gazetteer share its pages. Each place in
+ * the file stores its name, its address hierarchy, its coordinates, its
+ * bounding box and its OpenStreetMap ID and type. Gazetteer files are
+ * built from Nominatim results with the `geocode-gazetteer-build` tool.
+ *
+ * Forward queries look up the first component of the `location` parameter
+ * (or the most specific of the structured parameters) in a sorted index of
+ * case-folded names. Exact matches are returned before prefix matches, and
+ * any further comma-separated components must each match one of the
+ * address fields of the place, so `Paris, Texas` only matches places named
+ * Paris in Texas. Reverse queries return the place nearest to the given
+ * `lat` and `lon`, found through a grid of one degree cells.
+ *
+ * Since: 3.28
+ */
+
+/* On-disk format, in host byte order:
+ *
+ *  - a #GazetteerHeader;
+ *  - @n_records #GazetteerRecords, in the order they were added;
+ *  - @n_names #GazetteerNames, sorted by key and then by record;
+ *  - GAZETTEER_N_CELLS + 1 offsets into the cell entries, one cell per
+ *    degree of latitude and longitude, starting at the south-west corner
+ *    and going east, then north;
+ *  - @n_records cell entries, each the index of a record;
+ *  - the string pool, which starts with an empty string; all strings are
+ *    nul-terminated, and referred to by their offset in the pool.
+ */
+#define GAZETTEER_MAGIC "GCGAZET\n"
+#define GAZETTEER_BYTE_ORDER 0x01020304
+#define GAZETTEER_VERSION 1
+
+#define GAZETTEER_N_ROWS 180
+#define GAZETTEER_N_COLUMNS 360
+#define GAZETTEER_N_CELLS (GAZETTEER_N_ROWS * GAZETTEER_N_COLUMNS)
+
+typedef struct {
+	gchar magic[8];
+	guint32 byte_order;
+	guint32 version;
+	guint32 n_records;
+	guint32 n_names;
+	guint64 records_offset;
+	guint64 names_offset;
+	guint64 cells_offset;
+	guint64 cell_entries_offset;
+	guint64 strings_offset;
+	guint64 strings_size;
+} GazetteerHeader;
+
+typedef enum {
+	FIELD_NAME,
+	FIELD_STREET_ADDRESS,
+	FIELD_STREET,
+	FIELD_BUILDING,
+	FIELD_POSTAL_CODE,
+	FIELD_AREA,
+	FIELD_TOWN,
+	FIELD_COUNTY,
+	FIELD_STATE,
+	FIELD_ADMINISTRATIVE_AREA,
+	FIELD_COUNTRY_CODE,
+	FIELD_COUNTRY,
+	FIELD_CONTINENT,
+	N_FIELDS
+} GazetteerField;
+
+typedef struct {
+	guint64 osm_id;  /* 0 if unknown */
+	gdouble latitude;
+	gdouble longitude;
+	gdouble bbox[4];  /* top, bottom, left, right */
+	guint32 strings[N_FIELDS];  /* offsets into the string pool */
+	guint8 place_type;
+	guint8 osm_type;
+	guint8 has_bbox;
+	guint8 padding;
+} GazetteerRecord;
+
+typedef struct {
+	guint32 key;  /* offset of the normalized name in the string pool */
+	guint32 record;
+} GazetteerName;
+
+G_STATIC_ASSERT (sizeof (GazetteerHeader) == 72);
+G_STATIC_ASSERT (sizeof (GazetteerRecord) == 112);
+G_STATIC_ASSERT (sizeof (GazetteerName) == 8);
+
+struct _GeocodeGazetteer {
+	GObject parent;
+
+	GMappedFile *file;  /* (owned) */
+
+	/* All pointing into @file. */
+	const GazetteerRecord *records;
+	guint n_records;
+	const GazetteerName *names;
+	guint n_names;
+	const guint32 *cells;
+	const guint32 *cell_entries;
+	const char *strings;
+	gsize strings_size;
+};
+
+static void geocode_backend_iface_init (GeocodeBackendInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GeocodeGazetteer, geocode_gazetteer, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (GEOCODE_TYPE_BACKEND,
+                                                geocode_backend_iface_init))
+
+/******************************************************************************/
+
+static guint
+cell_row (gdouble latitude)
+{
+	gint row = (gint) floor (latitude + 90.0);
+
+	return CLAMP (row, 0, GAZETTEER_N_ROWS - 1);
+}
+
+static guint
+cell_column (gdouble longitude)
+{
+	gint column = (gint) floor (longitude + 180.0);
+
+	return CLAMP (column, 0, GAZETTEER_N_COLUMNS - 1);
+}
+
+static gboolean
+coordinates_are_valid (gdouble latitude,
+                       gdouble longitude)
+{
+	/* Also false for NaNs. */
+	return (latitude >= -90.0 && latitude <= 90.0 &&
+	        longitude >= -180.0 && longitude <= 180.0);
+}
+
+/******************************************************************************/
+
+static const char *
+get_string (GeocodeGazetteer *self,
+            guint32           offset)
+{
+	/* The pool is nul-terminated, which was checked on load. */
+	return (offset < self->strings_size) ? self->strings + offset : "";
+}
+
+/* Returns %NULL rather than an empty string for unset fields. */
+static const char *
+get_field (GeocodeGazetteer      *self,
+           const GazetteerRecord *record,
+           GazetteerField         field)
+{
+	const char *str = get_string (self, record->strings[field]);
+
+	return (*str != '\0') ? str : NULL;
+}
+
+static GeocodePlace *
+place_from_record (GeocodeGazetteer      *self,
+                   const GazetteerRecord *record)
+{
+	GeocodePlace *place;
+	g_autoptr (GeocodeLocation) location = NULL;
+	GeocodePlaceType place_type;
+	const char *name;
+	guint i;
+	static const struct {
+		GazetteerField field;
+		const char *property;
+	} properties[] = {
+		{ FIELD_STREET_ADDRESS, "street-address" },
+		{ FIELD_STREET, "street" },
+		{ FIELD_BUILDING, "building" },
+		{ FIELD_POSTAL_CODE, "postal-code" },
+		{ FIELD_AREA, "area" },
+		{ FIELD_TOWN, "town" },
+		{ FIELD_COUNTY, "county" },
+		{ FIELD_STATE, "state" },
+		{ FIELD_ADMINISTRATIVE_AREA, "administrative-area" },
+		{ FIELD_COUNTRY_CODE, "country-code" },
+		{ FIELD_COUNTRY, "country" },
+		{ FIELD_CONTINENT, "continent" },
+	};
+
+	place_type = record->place_type;
+	if (place_type > GEOCODE_PLACE_TYPE_LIGHT_RAIL_STATION)
+		place_type = GEOCODE_PLACE_TYPE_UNKNOWN;
+
+	name = get_field (self, record, FIELD_NAME);
+	place = geocode_place_new (name, place_type);
+
+	location = geocode_location_new_with_description (record->latitude,
+	                                                  record->longitude,
+	                                                  GEOCODE_LOCATION_ACCURACY_UNKNOWN,
+	                                                  name);
+	geocode_place_set_location (place, location);
+
+	if (record->has_bbox) {
+		g_autoptr (GeocodeBoundingBox) bbox = NULL;
+
+		bbox = geocode_bounding_box_new (record->bbox[0], record->bbox[1],
+		                                 record->bbox[2], record->bbox[3]);
+		geocode_place_set_bounding_box (place, bbox);
+	}
+
+	for (i = 0; i < G_N_ELEMENTS (properties); i++) {
+		const char *value = get_field (self, record, properties[i].field);
+
+		if (value != NULL)
+			g_object_set (place, properties[i].property, value, NULL);
+	}
+
+	if (record->osm_id != 0) {
+		g_autofree char *osm_id = NULL;
+
+		osm_id = g_strdup_printf ("%" G_GUINT64_FORMAT, record->osm_id);
+		g_object_set (place, "osm-id", osm_id, NULL);
+	}
+
+	if (record->osm_type <= GEOCODE_PLACE_OSM_TYPE_WAY)
+		g_object_set (place, "osm-type", (GeocodePlaceOsmType) record->osm_type, NULL);
+
+	return place;
+}
+
+static const GazetteerRecord *
+get_record (GeocodeGazetteer *self,
+            guint32           index)
+{
+	const GazetteerRecord *record;
+
+	if (index >= self->n_records)
+		return NULL;
+
+	record = &self->records[index];
+	if (!coordinates_are_valid (record->latitude, record->longitude))
+		return NULL;
+
+	return record;
+}
+
+static void
+places_list_free (GList *places)
+{
+	g_list_free_full (places, g_object_unref);
+}
+
+/******************************************************************************/
+
+/* Parses the `viewbox` and `bounded` parameters set by
+ * geocode_forward_set_search_area() and geocode_forward_set_bounded(). Returns
+ * %FALSE if results should not be restricted to an area. */
+static gboolean
+lookup_search_area (GHashTable *params,
+                    gdouble     area[4])
+{
+	const GValue *bounded = g_hash_table_lookup (params, "bounded");
+	const char *viewbox;
+	char *str;
+	guint i;
+
+	if (bounded == NULL)
+		return FALSE;
+	if (G_VALUE_HOLDS_BOOLEAN (bounded) && !g_value_get_boolean (bounded))
+		return FALSE;
+	if (G_VALUE_HOLDS_STRING (bounded) &&
+	    g_strcmp0 (g_value_get_string (bounded), "1") != 0 &&
+	    g_strcmp0 (g_value_get_string (bounded), "true") != 0)
+		return FALSE;
+
+	viewbox = _geocode_params_lookup_string (params, "viewbox");
+	if (viewbox == NULL)
+		return FALSE;
+
+	/* left,top,right,bottom */
+	for (i = 0, str = (char *) viewbox; i < 4; i++) {
+		char *end;
+
+		area[i] = g_ascii_strtod (str, &end);
+		if (end == str || *end != ((i < 3) ? ',' : '\0'))
+			return FALSE;
+		str = end + 1;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+area_contains (const gdouble          area[4],
+               const GazetteerRecord *record)
+{
+	gdouble left = area[0], top = area[1], right = area[2], bottom = area[3];
+
+	if (record->latitude > top || record->latitude < bottom)
+		return FALSE;
+
+	/* The area may cross the antimeridian. */
+	if (left <= right)
+		return (record->longitude >= left && record->longitude <= right);
+	else
+		return (record->longitude >= left || record->longitude <= right);
+}
+
+/* Builds the name index key and the address constraints for a forward
+ * query. The key is the first component of `location`, or else the most
+ * specific structured parameter; every other component must match one of
+ * the address fields of a result. */
+static char *
+parse_forward_params (GHashTable  *params,
+                      GPtrArray   *constraints,
+                      GError     **error)
+{
+	static const char *structured_keys[] = {
+		"street",
+		"locality",
+		"county",
+		"region",
+		"country",
+		"postalcode",  /* only ever a constraint */
+	};
+	char *key = NULL;
+	const char *location;
+	guint i;
+
+	location = _geocode_params_lookup_string (params, "location");
+
+	if (location != NULL) {
+		g_auto (GStrv) components = g_strsplit (location, ",", -1);
+
+		for (i = 0; components[i] != NULL; i++) {
+			char *component = _geocode_normalize_name (components[i]);
+
+			if (component == NULL || *component == '\0')
+				g_free (component);
+			else if (key == NULL)
+				key = component;
+			else
+				g_ptr_array_add (constraints, component);
+		}
+	} else {
+		for (i = 0; i < G_N_ELEMENTS (structured_keys); i++) {
+			char *value;
+
+			value = _geocode_normalize_name (_geocode_params_lookup_string (params, structured_keys[i]));
+
+			if (value == NULL || *value == '\0')
+				g_free (value);
+			else if (key == NULL && i < G_N_ELEMENTS (structured_keys) - 1)
+				key = value;
+			else
+				g_ptr_array_add (constraints, value);
+		}
+	}
+
+	if (key == NULL) {
+		g_set_error (error, GEOCODE_ERROR, GEOCODE_ERROR_INVALID_ARGUMENTS,
+		             "Only following parameters supported: location, "
+		             "street, locality, county, region, country, postalcode");
+		return NULL;
+	}
+
+	return key;
+}
+
+static gboolean
+record_matches_constraints (GeocodeGazetteer      *self,
+                            const GazetteerRecord *record,
+                            GPtrArray             *constraints)
+{
+	guint i;
+
+	for (i = 0; i < constraints->len; i++) {
+		const char *constraint = constraints->pdata[i];
+		gboolean matched = FALSE;
+		guint field;
+
+		for (field = FIELD_STREET_ADDRESS; field < N_FIELDS && !matched; field++) {
+			g_autofree char *value = NULL;
+
+			if (record->strings[field] == 0)
+				continue;
+
+			value = _geocode_normalize_name (get_string (self, record->strings[field]));
+			matched = (g_strcmp0 (value, constraint) == 0);
+		}
+
+		if (!matched)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Index of the first name whose key is not less than @key. */
+static guint
+names_lower_bound (GeocodeGazetteer *self,
+                   const char       *key)
+{
+	guint low = 0, high = self->n_names;
+
+	while (low < high) {
+		guint mid = low + (high - low) / 2;
+
+		if (strcmp (get_string (self, self->names[mid].key), key) < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
+static GList *
+geocode_gazetteer_forward_search (GeocodeBackend  *backend,
+                                  GHashTable      *params,
+                                  GCancellable    *cancellable,
+                                  GError         **error)
+{
+	GeocodeGazetteer *self = GEOCODE_GAZETTEER (backend);
+	g_autoptr (GPtrArray) constraints = NULL;
+	g_autofree char *key = NULL;
+	GList *places = NULL;  /* (element-type GeocodePlace) */
+	gdouble area[4];
+	gboolean bounded;
+	guint limit, n_places = 0, i;
+
+	if (g_cancellable_set_error_if_cancelled (cancellable, error))
+		return NULL;
+
+	constraints = g_ptr_array_new_with_free_func (g_free);
+	key = parse_forward_params (params, constraints, error);
+	if (key == NULL)
+		return NULL;
+
+	limit = _geocode_params_lookup_limit (params);
+	bounded = lookup_search_area (params, area);
+
+	/* Keys which start with @key are contiguous in the index, and an exact
+	 * match sorts before all the longer keys. */
+	for (i = names_lower_bound (self, key);
+	     i < self->n_names && n_places < limit;
+	     i++) {
+		const GazetteerName *name = &self->names[i];
+		const GazetteerRecord *record;
+
+		if (!g_str_has_prefix (get_string (self, name->key), key))
+			break;
+
+		record = get_record (self, name->record);
+		if (record == NULL ||
+		    (bounded && !area_contains (area, record)) ||
+		    !record_matches_constraints (self, record, constraints))
+			continue;
+
+		places = g_list_prepend (places, place_from_record (self, record));
+		n_places++;
+	}
+
+	if (places == NULL) {
+		g_set_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NO_MATCHES,
+		             "No matches found for request");
+		return NULL;
+	}
+
+	return g_list_reverse (places);
+}
+
+static void
+geocode_gazetteer_forward_search_async (GeocodeBackend      *backend,
+                                        GHashTable          *params,
+                                        GCancellable        *cancellable,
+                                        GAsyncReadyCallback  callback,
+                                        gpointer             user_data)
+{
+	g_autoptr (GTask) task = NULL;
+	GList *places;
+	GError *error = NULL;
+
+	/* Lookups never block, so there is no point in using a thread. */
+	task = g_task_new (backend, cancellable, callback, user_data);
+	g_task_set_source_tag (task, geocode_gazetteer_forward_search_async);
+
+	places = geocode_gazetteer_forward_search (backend, params,
+	                                           cancellable, &error);
+	if (error != NULL)
+		g_task_return_error (task, error);
+	else
+		g_task_return_pointer (task, places,
+		                       (GDestroyNotify) places_list_free);
+}
+
+static GList *
+geocode_gazetteer_forward_search_finish (GeocodeBackend  *backend,
+                                         GAsyncResult    *result,
+                                         GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/******************************************************************************/
+
+static gdouble
+haversine (gdouble angle)
+{
+	gdouble s = sin (angle / 2.0);
+
+	return s * s;
+}
+
+/* Angle, in radians, from (@latitude, @longitude) to the nearest point
+ * outside the square of cells within @radius - 1 cells of (@row, @column);
+ * that is, a lower bound on the distance to any cell in ring @radius or
+ * beyond. Returns G_MAXDOUBLE if there are no such cells. */
+static gdouble
+ring_distance_bound (gdouble latitude,
+                     gdouble longitude,
+                     guint   row,
+                     guint   column,
+                     guint   radius)
+{
+	gdouble bound = G_MAXDOUBLE;
+	gdouble north, south, east, west;
+
+	north = (gdouble) row - 90.0 + radius;
+	south = (gdouble) row - 90.0 - (radius - 1.0);
+	if (north < 90.0)
+		bound = MIN (bound, north - latitude);
+	if (south > -90.0)
+		bound = MIN (bound, latitude - south);
+
+	if (2 * radius - 1 < GAZETTEER_N_COLUMNS) {
+		gdouble cos_latitude = cos (latitude * G_PI / 180.0);
+		gdouble delta;
+
+		/* Everything east or west of the square is beyond the nearest
+		 * of its two bounding meridians, and no further than a pole. */
+		east = (gdouble) column - 180.0 + radius;
+		west = (gdouble) column - 180.0 - (radius - 1.0);
+		delta = MIN (east - longitude, longitude - west);
+
+		if (delta >= 90.0)
+			bound = MIN (bound, 90.0 - fabs (latitude));
+		else
+			bound = MIN (bound,
+			             asin (cos_latitude * sin (delta * G_PI / 180.0)) * 180.0 / G_PI);
+	}
+
+	return (bound == G_MAXDOUBLE) ? bound : bound * G_PI / 180.0;
+}
+
+static void
+nearest_in_cell (GeocodeGazetteer       *self,
+                 gdouble                 latitude,
+                 gdouble                 longitude,
+                 gint                    row,
+                 gint                    column,
+                 const GazetteerRecord **nearest,
+                 gdouble                *nearest_haversine)
+{
+	gdouble phi = latitude * G_PI / 180.0;
+	guint cell, i;
+
+	column = ((column % GAZETTEER_N_COLUMNS) + GAZETTEER_N_COLUMNS) % GAZETTEER_N_COLUMNS;
+	cell = row * GAZETTEER_N_COLUMNS + column;
+
+	for (i = self->cells[cell]; i < self->cells[cell + 1]; i++) {
+		const GazetteerRecord *record;
+		gdouble record_phi, h;
+
+		record = get_record (self, self->cell_entries[i]);
+		if (record == NULL)
+			continue;
+
+		record_phi = record->latitude * G_PI / 180.0;
+		h = haversine (record_phi - phi) +
+		    cos (phi) * cos (record_phi) *
+		    haversine ((record->longitude - longitude) * G_PI / 180.0);
+
+		if (h < *nearest_haversine) {
+			*nearest = record;
+			*nearest_haversine = h;
+		}
+	}
+}
+
+/* Searches rings of cells of increasing radius around the query point until
+ * the nearest record found so far is closer than anything in the next ring
+ * could be. Each cell belongs to exactly one ring, with its column offset in
+ * (-180, 180]. */
+static const GazetteerRecord *
+find_nearest (GeocodeGazetteer *self,
+              gdouble           latitude,
+              gdouble           longitude)
+{
+	const GazetteerRecord *nearest = NULL;
+	gdouble nearest_haversine = G_MAXDOUBLE;
+	gint row, column, radius;
+
+	row = cell_row (latitude);
+	column = cell_column (longitude);
+
+	for (radius = 0; radius <= GAZETTEER_N_COLUMNS / 2; radius++) {
+		gdouble bound;
+		gint dr;
+
+		for (dr = -radius; dr <= radius; dr++) {
+			if (row + dr < 0 || row + dr >= GAZETTEER_N_ROWS)
+				continue;
+
+			if (dr == -radius || dr == radius) {
+				gint dc;
+
+				for (dc = MAX (-radius, 1 - GAZETTEER_N_COLUMNS / 2);
+				     dc <= MIN (radius, GAZETTEER_N_COLUMNS / 2);
+				     dc++)
+					nearest_in_cell (self, latitude, longitude,
+					                 row + dr, column + dc,
+					                 &nearest, &nearest_haversine);
+			} else {
+				if (radius < GAZETTEER_N_COLUMNS / 2)
+					nearest_in_cell (self, latitude, longitude,
+					                 row + dr, column - radius,
+					                 &nearest, &nearest_haversine);
+				nearest_in_cell (self, latitude, longitude,
+				                 row + dr, column + radius,
+				                 &nearest, &nearest_haversine);
+			}
+		}
+
+		bound = ring_distance_bound (latitude, longitude, row, column,
+		                             radius + 1);
+		if (bound == G_MAXDOUBLE ||
+		    (nearest != NULL &&
+		     2.0 * asin (sqrt (MIN (nearest_haversine, 1.0))) <= bound))
+			break;
+	}
+
+	return nearest;
+}
+
+static GList *
+geocode_gazetteer_reverse_resolve (GeocodeBackend  *backend,
+                                   GHashTable      *params,
+                                   GCancellable    *cancellable,
+                                   GError         **error)
+{
+	GeocodeGazetteer *self = GEOCODE_GAZETTEER (backend);
+	const GazetteerRecord *record;
+	gdouble latitude, longitude;
+
+	if (g_cancellable_set_error_if_cancelled (cancellable, error))
+		return NULL;
+
+	if (!_geocode_params_lookup_double (params, "lat", &latitude) ||
+	    !_geocode_params_lookup_double (params, "lon", &longitude) ||
+	    !coordinates_are_valid (latitude, longitude)) {
+		g_set_error (error, GEOCODE_ERROR, GEOCODE_ERROR_INVALID_ARGUMENTS,
+		             "Only following parameters supported: lat, lon");
+		return NULL;
+	}
+
+	record = find_nearest (self, latitude, longitude);
+
+	if (record == NULL) {
+		g_set_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED,
+		             "No matches found for request");
+		return NULL;
+	}
+
+	return g_list_prepend (NULL, place_from_record (self, record));
+}
+
+static void
+geocode_gazetteer_reverse_resolve_async (GeocodeBackend      *backend,
+                                         GHashTable          *params,
+                                         GCancellable        *cancellable,
+                                         GAsyncReadyCallback  callback,
+                                         gpointer             user_data)
+{
+	g_autoptr (GTask) task = NULL;
+	GList *places;
+	GError *error = NULL;
+
+	task = g_task_new (backend, cancellable, callback, user_data);
+	g_task_set_source_tag (task, geocode_gazetteer_reverse_resolve_async);
+
+	places = geocode_gazetteer_reverse_resolve (backend, params,
+	                                            cancellable, &error);
+	if (error != NULL)
+		g_task_return_error (task, error);
+	else
+		g_task_return_pointer (task, places,
+		                       (GDestroyNotify) places_list_free);
+}
+
+static GList *
+geocode_gazetteer_reverse_resolve_finish (GeocodeBackend  *backend,
+                                          GAsyncResult    *result,
+                                          GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/******************************************************************************/
+
+static gboolean
+section_is_valid (gsize   file_size,
+                  guint64 offset,
+                  guint64 n_elements,
+                  gsize   element_size,
+                  gsize   alignment)
+{
+	return (offset % alignment == 0 &&
+	        offset <= file_size &&
+	        n_elements <= (file_size - offset) / element_size);
+}
+
+static gboolean
+load_file (GeocodeGazetteer  *self,
+           GMappedFile       *file,
+           GError           **error)
+{
+	const char *contents;
+	const GazetteerHeader *header;
+	gsize size;
+	guint i;
+
+	size = g_mapped_file_get_length (file);
+	contents = g_mapped_file_get_contents (file);
+
+	if (size < sizeof (GazetteerHeader) ||
+	    memcmp (contents, GAZETTEER_MAGIC, sizeof (header->magic)) != 0) {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		                     "Not a gazetteer file");
+		return FALSE;
+	}
+
+	header = (const GazetteerHeader *) contents;
+
+	if (header->byte_order != GAZETTEER_BYTE_ORDER) {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		                     "Gazetteer file was built for a different byte order");
+		return FALSE;
+	}
+
+	if (header->version != GAZETTEER_VERSION) {
+		g_set_error (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		             "Unsupported gazetteer file version %u", header->version);
+		return FALSE;
+	}
+
+	if (!section_is_valid (size, header->records_offset, header->n_records,
+	                       sizeof (GazetteerRecord), 8) ||
+	    !section_is_valid (size, header->names_offset, header->n_names,
+	                       sizeof (GazetteerName), 4) ||
+	    !section_is_valid (size, header->cells_offset, GAZETTEER_N_CELLS + 1,
+	                       sizeof (guint32), 4) ||
+	    !section_is_valid (size, header->cell_entries_offset, header->n_records,
+	                       sizeof (guint32), 4) ||
+	    !section_is_valid (size, header->strings_offset, header->strings_size,
+	                       1, 1) ||
+	    header->strings_size == 0 ||
+	    contents[header->strings_offset] != '\0' ||
+	    contents[header->strings_offset + header->strings_size - 1] != '\0') {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		                     "Gazetteer file is truncated or corrupt");
+		return FALSE;
+	}
+
+	self->records = (const GazetteerRecord *) (contents + header->records_offset);
+	self->n_records = header->n_records;
+	self->names = (const GazetteerName *) (contents + header->names_offset);
+	self->n_names = header->n_names;
+	self->cells = (const guint32 *) (contents + header->cells_offset);
+	self->cell_entries = (const guint32 *) (contents + header->cell_entries_offset);
+	self->strings = contents + header->strings_offset;
+	self->strings_size = header->strings_size;
+
+	/* The cell offsets are the only part of the file which is not checked
+	 * lazily; their number does not depend on the size of the gazetteer. */
+	for (i = 0; i < GAZETTEER_N_CELLS; i++) {
+		if (self->cells[i] > self->cells[i + 1])
+			break;
+	}
+
+	if (i < GAZETTEER_N_CELLS || self->cells[GAZETTEER_N_CELLS] != self->n_records) {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		                     "Gazetteer file is truncated or corrupt");
+		return FALSE;
+	}
+
+	self->file = g_mapped_file_ref (file);
+
+	return TRUE;
+}
+
+/**
+ * geocode_gazetteer_new:
+ * @path: (type filename): path of the gazetteer file to load
+ * @error: return location for a #GError, or %NULL
+ *
+ * Creates a new backend which answers queries from the gazetteer file at
+ * @path. The file is mapped into memory for the lifetime of the backend, so
+ * it must not be modified in place while the backend is in use; replace it
+ * with a new file instead.
+ *
+ * If the file cannot be opened, a #GFileError is returned. If it is not a
+ * valid gazetteer file, %GEOCODE_ERROR_PARSE is returned.
+ *
+ * Returns: (transfer full) (nullable): a new #GeocodeGazetteer, or %NULL on
+ * error. Use g_object_unref() when done.
+ *
+ * Since: 3.28
+ */
+GeocodeGazetteer *
+geocode_gazetteer_new (const char  *path,
+                       GError     **error)
+{
+	g_autoptr (GeocodeGazetteer) self = NULL;
+	GMappedFile *file;
+	gboolean loaded;
+
+	g_return_val_if_fail (path != NULL, NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	file = g_mapped_file_new (path, FALSE, error);
+	if (file == NULL)
+		return NULL;
+
+	self = g_object_new (GEOCODE_TYPE_GAZETTEER, NULL);
+	loaded = load_file (self, file, error);
+	g_mapped_file_unref (file);
+
+	if (!loaded)
+		return NULL;
+
+	return g_steal_pointer (&self);
+}
+
+/**
+ * geocode_gazetteer_get_n_places:
+ * @self: a #GeocodeGazetteer
+ *
+ * Gets the number of places in the gazetteer file.
+ *
+ * Returns: the number of places
+ *
+ * Since: 3.28
+ */
+guint
+geocode_gazetteer_get_n_places (GeocodeGazetteer *self)
+{
+	g_return_val_if_fail (GEOCODE_IS_GAZETTEER (self), 0);
+
+	return self->n_records;
+}
+
+static void
+geocode_gazetteer_init (GeocodeGazetteer *self)
+{
+}
+
+static void
+geocode_gazetteer_finalize (GObject *object)
+{
+	GeocodeGazetteer *self = GEOCODE_GAZETTEER (object);
+
+	g_clear_pointer (&self->file, g_mapped_file_unref);
+
+	G_OBJECT_CLASS (geocode_gazetteer_parent_class)->finalize (object);
+}
+
+static void
+geocode_backend_iface_init (GeocodeBackendInterface *iface)
+{
+	iface->forward_search = geocode_gazetteer_forward_search;
+	iface->forward_search_async = geocode_gazetteer_forward_search_async;
+	iface->forward_search_finish = geocode_gazetteer_forward_search_finish;
+	iface->reverse_resolve = geocode_gazetteer_reverse_resolve;
+	iface->reverse_resolve_async = geocode_gazetteer_reverse_resolve_async;
+	iface->reverse_resolve_finish = geocode_gazetteer_reverse_resolve_finish;
+}
+
+static void
+geocode_gazetteer_class_init (GeocodeGazetteerClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->finalize = geocode_gazetteer_finalize;
+}
+
+/******************************************************************************/
+
+struct _GeocodeGazetteerWriter {
+	GArray *records;  /* (element-type GazetteerRecord) */
+	GArray *names;  /* (element-type GazetteerName) */
+	GString *strings;
+
+	/* Open-addressed hash table of the offsets of the strings in the pool,
+	 * so each string is stored once without keeping a second copy of it
+	 * as a key. Empty slots are zero, which is the offset of the empty
+	 * string, and that is never added. */
+	guint32 *string_slots;  /* (owned) (array length=n_string_slots) */
+	guint n_string_slots;  /* a power of two */
+	guint n_strings;
+
+	gboolean too_large;
+};
+
+#define WRITER_INITIAL_STRING_SLOTS 1024
+
+/**
+ * _geocode_gazetteer_writer_new:
+ *
+ * Creates a writer for a new gazetteer file which can be loaded with
+ * geocode_gazetteer_new(). Places are held in memory in the same compact
+ * form as in the file until _geocode_gazetteer_writer_write() is called.
+ * Writers are not thread-safe.
+ *
+ * Returns: (transfer full): a new writer; free with
+ * _geocode_gazetteer_writer_free()
+ */
+GeocodeGazetteerWriter *
+_geocode_gazetteer_writer_new (void)
+{
+	GeocodeGazetteerWriter *writer;
+
+	writer = g_new0 (GeocodeGazetteerWriter, 1);
+	writer->records = g_array_new (FALSE, FALSE, sizeof (GazetteerRecord));
+	writer->names = g_array_new (FALSE, FALSE, sizeof (GazetteerName));
+	writer->strings = g_string_new_len ("", 1);
+	writer->n_string_slots = WRITER_INITIAL_STRING_SLOTS;
+	writer->string_slots = g_new0 (guint32, writer->n_string_slots);
+
+	return writer;
+}
+
+void
+_geocode_gazetteer_writer_free (GeocodeGazetteerWriter *writer)
+{
+	if (writer == NULL)
+		return;
+
+	g_array_unref (writer->records);
+	g_array_unref (writer->names);
+	g_string_free (writer->strings, TRUE);
+	g_free (writer->string_slots);
+	g_free (writer);
+}
+
+/* Returns the slot which holds the offset of @str, or the empty slot where
+ * it should be added. */
+static guint32 *
+writer_find_string_slot (GeocodeGazetteerWriter *writer,
+                         const char             *str)
+{
+	guint mask = writer->n_string_slots - 1;
+	guint i = g_str_hash (str) & mask;
+
+	while (writer->string_slots[i] != 0 &&
+	       strcmp (writer->strings->str + writer->string_slots[i], str) != 0)
+		i = (i + 1) & mask;
+
+	return &writer->string_slots[i];
+}
+
+static void
+writer_grow_string_slots (GeocodeGazetteerWriter *writer)
+{
+	g_autofree guint32 *old_slots = writer->string_slots;
+	guint n_old_slots = writer->n_string_slots;
+	guint i;
+
+	writer->n_string_slots *= 2;
+	writer->string_slots = g_new0 (guint32, writer->n_string_slots);
+
+	for (i = 0; i < n_old_slots; i++) {
+		if (old_slots[i] != 0)
+			*writer_find_string_slot (writer, writer->strings->str + old_slots[i]) = old_slots[i];
+	}
+}
+
+/* Adds @str to the string pool once, however often it is used. */
+static guint32
+writer_intern (GeocodeGazetteerWriter *writer,
+               const char             *str)
+{
+	guint32 *slot, offset;
+	gsize len;
+
+	if (str == NULL || *str == '\0')
+		return 0;
+
+	slot = writer_find_string_slot (writer, str);
+	if (*slot != 0)
+		return *slot;
+
+	len = strlen (str) + 1;
+	if (writer->strings->len + len > G_MAXUINT32) {
+		writer->too_large = TRUE;
+		return 0;
+	}
+
+	offset = writer->strings->len;
+	g_string_append_len (writer->strings, str, len);
+	*slot = offset;
+
+	/* Keep the table at most half full, so probe sequences stay short. */
+	if (++writer->n_strings > writer->n_string_slots / 2)
+		writer_grow_string_slots (writer);
+
+	return offset;
+}
+
+/**
+ * _geocode_gazetteer_writer_add_place:
+ * @writer: a gazetteer writer
+ * @place: the place to add
+ *
+ * Adds @place to the gazetteer. Places which are added earlier are returned
+ * earlier by forward queries which match several places with the same name,
+ * so they should be added in order of importance.
+ *
+ * Returns: %FALSE if @place has no location, and so was not added
+ */
+gboolean
+_geocode_gazetteer_writer_add_place (GeocodeGazetteerWriter *writer,
+                                     GeocodePlace           *place)
+{
+	GazetteerRecord record = { 0, };
+	GeocodeLocation *location;
+	GeocodeBoundingBox *bbox;
+	const char *osm_id;
+	g_autofree char *key = NULL;
+
+	g_return_val_if_fail (writer != NULL, FALSE);
+	g_return_val_if_fail (GEOCODE_IS_PLACE (place), FALSE);
+
+	location = geocode_place_get_location (place);
+	if (location == NULL)
+		return FALSE;
+
+	if (writer->records->len == G_MAXUINT32) {
+		writer->too_large = TRUE;
+		return FALSE;
+	}
+
+	record.latitude = geocode_location_get_latitude (location);
+	record.longitude = geocode_location_get_longitude (location);
+
+	bbox = geocode_place_get_bounding_box (place);
+	if (bbox != NULL) {
+		record.bbox[0] = geocode_bounding_box_get_top (bbox);
+		record.bbox[1] = geocode_bounding_box_get_bottom (bbox);
+		record.bbox[2] = geocode_bounding_box_get_left (bbox);
+		record.bbox[3] = geocode_bounding_box_get_right (bbox);
+		record.has_bbox = TRUE;
+	}
+
+	record.strings[FIELD_NAME] = writer_intern (writer, geocode_place_get_name (place));
+	record.strings[FIELD_STREET_ADDRESS] = writer_intern (writer, geocode_place_get_street_address (place));
+	record.strings[FIELD_STREET] = writer_intern (writer, geocode_place_get_street (place));
+	record.strings[FIELD_BUILDING] = writer_intern (writer, geocode_place_get_building (place));
+	record.strings[FIELD_POSTAL_CODE] = writer_intern (writer, geocode_place_get_postal_code (place));
+	record.strings[FIELD_AREA] = writer_intern (writer, geocode_place_get_area (place));
+	record.strings[FIELD_TOWN] = writer_intern (writer, geocode_place_get_town (place));
+	record.strings[FIELD_COUNTY] = writer_intern (writer, geocode_place_get_county (place));
+	record.strings[FIELD_STATE] = writer_intern (writer, geocode_place_get_state (place));
+	record.strings[FIELD_ADMINISTRATIVE_AREA] = writer_intern (writer, geocode_place_get_administrative_area (place));
+	record.strings[FIELD_COUNTRY_CODE] = writer_intern (writer, geocode_place_get_country_code (place));
+	record.strings[FIELD_COUNTRY] = writer_intern (writer, geocode_place_get_country (place));
+	record.strings[FIELD_CONTINENT] = writer_intern (writer, geocode_place_get_continent (place));
+
+	record.place_type = geocode_place_get_place_type (place);
+	record.osm_type = geocode_place_get_osm_type (place);
+
+	osm_id = geocode_place_get_osm_id (place);
+	if (osm_id != NULL)
+		record.osm_id = g_ascii_strtoull (osm_id, NULL, 10);
+
+	key = _geocode_normalize_name (geocode_place_get_name (place));
+	if (key != NULL && *key != '\0') {
+		GazetteerName name;
+
+		name.key = writer_intern (writer, key);
+		name.record = writer->records->len;
+		g_array_append_val (writer->names, name);
+	}
+
+	g_array_append_val (writer->records, record);
+
+	return TRUE;
+}
+
+/**
+ * _geocode_gazetteer_writer_get_n_places:
+ * @writer: a gazetteer writer
+ *
+ * Returns: the number of places added to @writer so far
+ */
+guint
+_geocode_gazetteer_writer_get_n_places (GeocodeGazetteerWriter *writer)
+{
+	g_return_val_if_fail (writer != NULL, 0);
+
+	return writer->records->len;
+}
+
+static gint
+compare_names (gconstpointer a,
+               gconstpointer b,
+               gpointer      user_data)
+{
+	const char *strings = user_data;
+	const GazetteerName *name_a = a, *name_b = b;
+	gint ret;
+
+	ret = strcmp (strings + name_a->key, strings + name_b->key);
+	if (ret != 0)
+		return ret;
+
+	return (name_a->record > name_b->record) - (name_a->record < name_b->record);
+}
+
+/**
+ * _geocode_gazetteer_writer_write:
+ * @writer: a gazetteer writer
+ * @path: (type filename): path of the file to write
+ * @error: return location for a #GError, or %NULL
+ *
+ * Writes all the places added to @writer to a gazetteer file at @path. An
+ * existing file at @path is replaced atomically, so backends which have
+ * the old file loaded keep working.
+ *
+ * Returns: %TRUE on success, %FALSE otherwise
+ */
+gboolean
+_geocode_gazetteer_writer_write (GeocodeGazetteerWriter  *writer,
+                                 const char              *path,
+                                 GError                 **error)
+{
+	GazetteerHeader header = { { 0, }, };
+	g_autofree guint32 *cells = NULL;
+	g_autofree guint32 *cursors = NULL;
+	g_autofree guint32 *cell_entries = NULL;
+	g_autoptr (GFile) file = NULL;
+	g_autoptr (GFileOutputStream) stream = NULL;
+	GOutputStream *output;
+	guint i;
+
+	g_return_val_if_fail (writer != NULL, FALSE);
+	g_return_val_if_fail (path != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	if (writer->too_large) {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_INVALID_ARGUMENTS,
+		                     "Too many places for a single gazetteer file");
+		return FALSE;
+	}
+
+	g_array_sort_with_data (writer->names, compare_names, writer->strings->str);
+
+	/* Bucket the records by cell, keeping them in order within each
+	 * cell. */
+	cells = g_new0 (guint32, GAZETTEER_N_CELLS + 1);
+	cursors = g_new (guint32, GAZETTEER_N_CELLS);
+	cell_entries = g_new (guint32, MAX (writer->records->len, 1));
+
+	for (i = 0; i < writer->records->len; i++) {
+		const GazetteerRecord *record = &g_array_index (writer->records, GazetteerRecord, i);
+
+		cells[cell_row (record->latitude) * GAZETTEER_N_COLUMNS +
+		      cell_column (record->longitude) + 1]++;
+	}
+
+	for (i = 0; i < GAZETTEER_N_CELLS; i++)
+		cells[i + 1] += cells[i];
+
+	memcpy (cursors, cells, GAZETTEER_N_CELLS * sizeof (guint32));
+
+	for (i = 0; i < writer->records->len; i++) {
+		const GazetteerRecord *record = &g_array_index (writer->records, GazetteerRecord, i);
+		guint cell = cell_row (record->latitude) * GAZETTEER_N_COLUMNS +
+		             cell_column (record->longitude);
+
+		cell_entries[cursors[cell]++] = i;
+	}
+
+	memcpy (header.magic, GAZETTEER_MAGIC, sizeof (header.magic));
+	header.byte_order = GAZETTEER_BYTE_ORDER;
+	header.version = GAZETTEER_VERSION;
+	header.n_records = writer->records->len;
+	header.n_names = writer->names->len;
+	header.records_offset = sizeof (GazetteerHeader);
+	header.names_offset = header.records_offset +
+	                      (guint64) header.n_records * sizeof (GazetteerRecord);
+	header.cells_offset = header.names_offset +
+	                      (guint64) header.n_names * sizeof (GazetteerName);
+	header.cell_entries_offset = header.cells_offset +
+	                             (GAZETTEER_N_CELLS + 1) * sizeof (guint32);
+	header.strings_offset = header.cell_entries_offset +
+	                        (guint64) header.n_records * sizeof (guint32);
+	header.strings_size = writer->strings->len;
+
+	file = g_file_new_for_path (path);
+	stream = g_file_replace (file, NULL, FALSE, G_FILE_CREATE_NONE, NULL, error);
+	if (stream == NULL)
+		return FALSE;
+
+	output = G_OUTPUT_STREAM (stream);
+
+	if (!g_output_stream_write_all (output, &header, sizeof (header),
+	                                NULL, NULL, error) ||
+	    !g_output_stream_write_all (output, writer->records->data,
+	                                (gsize) header.n_records * sizeof (GazetteerRecord),
+	                                NULL, NULL, error) ||
+	    !g_output_stream_write_all (output, writer->names->data,
+	                                (gsize) header.n_names * sizeof (GazetteerName),
+	                                NULL, NULL, error) ||
+	    !g_output_stream_write_all (output, cells,
+	                                (GAZETTEER_N_CELLS + 1) * sizeof (guint32),
+	                                NULL, NULL, error) ||
+	    !g_output_stream_write_all (output, cell_entries,
+	                                (gsize) header.n_records * sizeof (guint32),
+	                                NULL, NULL, error) ||
+	    !g_output_stream_write_all (output, writer->strings->str,
+	                                writer->strings->len, NULL, NULL, error)) {
+		g_autoptr (GCancellable) cancellable = g_cancellable_new ();
+
+		/* Closing a cancelled stream leaves any existing file at @path
+		 * untouched, rather than replacing it with a partial one. */
+		g_cancellable_cancel (cancellable);
+		g_output_stream_close (output, cancellable, NULL);
+
+		return FALSE;
+	}
+
+	return g_output_stream_close (output, NULL, error);
+}
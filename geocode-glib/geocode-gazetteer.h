@@ -0,0 +1,56 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#ifndef GEOCODE_GAZETTEER_H
+#define GEOCODE_GAZETTEER_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GeocodeGazetteer:
+ *
+ * All the fields in the #GeocodeGazetteer structure are private and should
+ * never be accessed directly.
+ *
+ * Since: 3.28
+ */
+#define GEOCODE_TYPE_GAZETTEER (geocode_gazetteer_get_type ())
+G_DECLARE_FINAL_TYPE (GeocodeGazetteer, geocode_gazetteer,
+                      GEOCODE, GAZETTEER, GObject)
+
+/**
+ * GEOCODE_TYPE_GAZETTEER:
+ *
+ * See #GeocodeGazetteer.
+ *
+ * Since: 3.28
+ */
+
+GeocodeGazetteer *geocode_gazetteer_new       (const char        *path,
+                                               GError           **error);
+
+guint             geocode_gazetteer_get_n_places (GeocodeGazetteer *self);
+
+G_END_DECLS
+
+#endif /* GEOCODE_GAZETTEER_H */
@@ -0,0 +1,681 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "geocode-error.h"
+#include "geocode-geo-uri.h"
+#include "geocode-location.h"
+
+/**
+ * SECTION:geocode-geo-uri
+ * @short_description: Geo URI parser and formatter
+ * @include: geocode-glib/geocode-glib.h
+ *
+ * geocode_geo_uri_parse() parses a geo URI (RFC 5870) into a
+ * #GeocodeGeoUri, without allocating any memory unless it has to report an
+ * error. It accepts exactly the URIs which geocode_location_set_from_uri()
+ * accepts, and is what that function uses.
+ *
+ * To parse a large number of URIs at once, use
+ * geocode_geo_uri_parse_batch().
+ *
+ * In the other direction, geocode_geo_uri_format() and
+ * geocode_geo_uri_append() write the URI which geocode_location_to_uri()
+ * would return into a caller-provided buffer or #GString, and
+ * geocode_geo_uri_append_batch() writes one for each of an array of
+ * coordinates.
+ *
+ * Since: 3.28
+ */
+
+/*
+   From RFC 5870:
+      geo-URI       = geo-scheme ":" geo-path
+      geo-scheme    = "geo"
+      geo-path      = coordinates p
+      coordinates   = coord-a "," coord-b [ "," coord-c ]
+
+      [...]
+
+      The value of "-0" for <num> is allowed and is identical to "0".
+
+      In case the URI identifies a location in the default CRS of WGS-84,
+      the <coordinates> sub-components are further restricted as follows:
+
+      coord-a        = latitude
+      coord-b        = longitude
+      coord-c        = altitude
+
+      latitude       = [ "-" ] 1*2DIGIT [ "." 1*DIGIT ]
+      longitude      = [ "-" ] 1*3DIGIT [ "." 1*DIGIT ]
+      altitude       = [ "-" ] 1*DIGIT [ "." 1*DIGIT ]
+
+       p             = [ crsp ] [ uncp ] *parameter
+       crsp          = ";crs=" crslabel
+       crslabel      = "wgs84" / labeltext
+       uncp          = ";u=" uval
+       uval          = pnum
+
+       parameter     = ";" pname [ "=" pvalue ]
+       pname         = labeltext
+       pvalue        = 1*paramchar
+       paramchar     = p-unreserved / unreserved / pct-encoded
+
+       labeltext     = 1*( alphanum / "-" )
+       pnum          = 1*DIGIT [ "." 1*DIGIT ]
+       num           = [ "-" ] pnum
+       unreserved    = alphanum / mark
+       mark          = "-" / "_" / "." / "!" / "~" / "*" /
+                        "'" / "(" / ")"
+       pct-encoded   = "%" HEXDIG HEXDIG
+
+   Numbers are accepted in any form g_ascii_strtod() accepts, other than
+   with leading whitespace, which is not allowed anywhere in the URI.
+*/
+
+/* Powers of ten which are exactly representable as doubles */
+static const gdouble exact_powers_of_ten[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Parses a number at @s as g_ascii_strtod() would, and returns the end of
+ * it, which is @s if there is no number there.
+ *
+ * Plain decimals of up to 15 digits take a fast path: their digits, read
+ * as an integer, and the power of ten to divide them by are both exact
+ * doubles, so a single division gives the correctly rounded result
+ * (Clinger’s fast path). Anything else, such as exponents, hexadecimal or
+ * long mantissas, is left to g_ascii_strtod(). */
+static const char *
+parse_number (const char *s,
+              gdouble    *value)
+{
+	const char *p = s;
+	gboolean negative = FALSE;
+	guint64 mantissa = 0;
+	guint n_digits = 0;
+	guint n_fraction_digits = 0;
+	char *end;
+
+	if (g_ascii_isspace (*p)) {
+		*value = 0;
+		return s;
+	}
+
+	if (*p == '-' || *p == '+')
+		negative = (*p++ == '-');
+
+	for (; g_ascii_isdigit (*p); p++, n_digits++) {
+		if (n_digits < 19)
+			mantissa = mantissa * 10 + (*p - '0');
+	}
+
+	if (*p == '.') {
+		for (p++; g_ascii_isdigit (*p); p++, n_digits++, n_fraction_digits++) {
+			if (n_digits < 19)
+				mantissa = mantissa * 10 + (*p - '0');
+		}
+	}
+
+	if (n_digits > 0 && n_digits <= 15 &&
+	    *p != 'e' && *p != 'E' && *p != 'x' && *p != 'X') {
+		*value = (gdouble) mantissa / exact_powers_of_ten[n_fraction_digits];
+		if (negative)
+			*value = -*value;
+		return p;
+	}
+
+	*value = g_ascii_strtod (s, &end);
+	return end;
+}
+
+static gboolean
+has_whitespace (const char *s)
+{
+	for (; *s != '\0'; s++) {
+		if (g_ascii_isspace (*s))
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+/*
+  From RFC 5870:
+      Both 'crs' and 'u' parameters MUST NOT appear more than once each.
+      The 'crs' and 'u' parameters MUST be given before any other
+      parameters that may be defined in future extensions.  The 'crs'
+      parameter MUST be given first if both 'crs' and 'u' are used.
+ */
+static gboolean
+parse_parameters (const char    *params,
+                  GeocodeGeoUri *geo_uri)
+{
+	const char *p = params;
+	const char *u = NULL;
+	const char *crs = NULL;
+	const char *crs_end = NULL;
+	guint i;
+
+	if (*p == '\0')
+		return FALSE;
+
+	for (i = 0; ; i++) {
+		const char *token = p;
+
+		/* Stop splitting after 255 separators, for compatibility with
+		 * the g_strsplit (params, ";", 256) this used to be */
+		while (*p != '\0' && (*p != ';' || i == 255)) {
+			if (g_ascii_isspace (*p))
+				return FALSE;
+			p++;
+		}
+
+		if (strncmp (token, "crs=", 4) == 0) {
+			/* if crs parameter is given, it has to be the first one */
+			if (i != 0)
+				return FALSE;
+
+			crs = token + 4;
+			crs_end = p;
+		} else if (strncmp (token, "u=", 2) == 0) {
+			/* u parameter is either first one or after crs parameter
+			 * and has to appear only once in the parameter list */
+			if ((crs == NULL && i != 0) || (crs != NULL && i != 1) || u != NULL)
+				return FALSE;
+
+			u = token + 2;
+		}
+
+		if (*p == '\0')
+			break;
+		p++;
+	}
+
+	/* An empty value is accepted, as an accuracy of 0 */
+	if (u != NULL) {
+		const char *end = parse_number (u, &geo_uri->accuracy);
+
+		if (*end != '\0' && *end != ';')
+			return FALSE;
+		geo_uri->has_accuracy = TRUE;
+	}
+
+	if (crs != NULL &&
+	    ((gsize) (crs_end - crs) != strlen ("wgs84") || strncmp (crs, "wgs84", crs_end - crs) != 0))
+		return FALSE;
+
+	return TRUE;
+}
+
+/* The Android extension: geo:0,0?q=latitude,longitude(description) */
+static gboolean
+parse_special_parameters (const char    *params,
+                          GeocodeGeoUri *geo_uri)
+{
+	const char *p, *end, *description;
+
+	if (geo_uri->latitude != 0 || geo_uri->longitude != 0)
+		return FALSE;
+
+	if (strncmp (params, "q=", 2) != 0)
+		return FALSE;
+
+	/* An empty latitude is accepted, as 0 */
+	p = params + 2;
+	end = parse_number (p, &geo_uri->latitude);
+	if (*end != ',')
+		return FALSE;
+
+	p = end + 1;
+	end = parse_number (p, &geo_uri->longitude);
+	if (end == p || *end != '(')
+		return FALSE;
+
+	description = end + 1;
+	for (p = description; *p != ')'; p++) {
+		if (*p == '\0' || g_ascii_isspace (*p))
+			return FALSE;
+	}
+	if (p == description)
+		return FALSE;
+
+	geo_uri->description = description;
+	geo_uri->description_len = p - description;
+
+	/* Anything after the description is ignored */
+	return !has_whitespace (p + 1);
+}
+
+static gboolean
+parse_geo_uri (const char     *uri,
+               GeocodeGeoUri  *geo_uri,
+               GError        **error)
+{
+	GeocodeGeoUri result = { 0, };
+	const char *p, *end;
+
+	if (g_ascii_strncasecmp (uri, "geo:", 4) != 0) {
+		g_set_error_literal (error,
+		                     GEOCODE_ERROR,
+		                     GEOCODE_ERROR_NOT_SUPPORTED,
+		                     "Unsupported or invalid URI scheme");
+		return FALSE;
+	}
+
+	p = uri + 4;
+	end = parse_number (p, &result.latitude);
+	if (end == p || *end != ',')
+		goto err;
+
+	p = end + 1;
+	end = parse_number (p, &result.longitude);
+	if (end == p)
+		goto err;
+
+	if (*end == ',') {
+		p = end + 1;
+		end = parse_number (p, &result.altitude);
+		if (end == p)
+			goto err;
+		result.has_altitude = TRUE;
+	}
+
+	switch (*end) {
+	case '\0':
+		break;
+	case ';':
+		if (!parse_parameters (end + 1, &result))
+			goto err_params;
+		break;
+	case '?':
+		if (!parse_special_parameters (end + 1, &result))
+			goto err_params;
+		break;
+	default:
+		goto err;
+	}
+
+	*geo_uri = result;
+	return TRUE;
+
+ err_params:
+	/* Whitespace anywhere is reported as a problem with the URI as a
+	 * whole, rather than with its parameters */
+	if (!has_whitespace (uri)) {
+		g_set_error_literal (error,
+		                     GEOCODE_ERROR,
+		                     GEOCODE_ERROR_PARSE,
+		                     "Failed to parse geo URI parameters");
+		return FALSE;
+	}
+ err:
+	g_set_error_literal (error,
+	                     GEOCODE_ERROR,
+	                     GEOCODE_ERROR_PARSE,
+	                     "Failed to parse geo URI");
+	return FALSE;
+}
+
+/**
+ * geocode_geo_uri_parse:
+ * @uri: a geo URI
+ * @geo_uri: (out caller-allocates): return location for the parsed URI
+ * @error: #GError for error reporting, or %NULL to ignore
+ *
+ * Parses @uri, which should be in the geo scheme (RFC 5870), and possibly
+ * use the Android extension for descriptions, as described for
+ * geocode_location_set_from_uri().
+ *
+ * If @uri is not a geo URI, %GEOCODE_ERROR_NOT_SUPPORTED is returned. If it
+ * is invalid, %GEOCODE_ERROR_PARSE is returned. @geo_uri is only modified
+ * on success. Its @description points into @uri.
+ *
+ * Returns: %TRUE on success and %FALSE on error.
+ *
+ * Since: 3.28
+ */
+gboolean
+geocode_geo_uri_parse (const char     *uri,
+                       GeocodeGeoUri  *geo_uri,
+                       GError        **error)
+{
+	g_return_val_if_fail (uri != NULL, FALSE);
+	g_return_val_if_fail (geo_uri != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	return parse_geo_uri (uri, geo_uri, error);
+}
+
+/**
+ * geocode_geo_uri_parse_batch:
+ * @uris: (array length=n_uris): geo URIs
+ * @n_uris: the number of URIs
+ * @geo_uris: (out caller-allocates) (array length=n_uris): return location
+ *    for the parsed URIs
+ * @valid: (out caller-allocates) (array length=n_uris) (optional): return
+ *    location for whether each URI was valid, or %NULL
+ *
+ * Parses each of @uris as geocode_geo_uri_parse() does. The elements of
+ * @geo_uris for invalid URIs are not modified.
+ *
+ * Returns: the number of valid URIs
+ *
+ * Since: 3.28
+ */
+gsize
+geocode_geo_uri_parse_batch (const char * const *uris,
+                             gsize               n_uris,
+                             GeocodeGeoUri      *geo_uris,
+                             gboolean           *valid)
+{
+	gsize i, n_valid = 0;
+
+	g_return_val_if_fail (n_uris == 0 || uris != NULL, 0);
+	g_return_val_if_fail (n_uris == 0 || geo_uris != NULL, 0);
+
+	for (i = 0; i < n_uris; i++) {
+		gboolean ok;
+
+		ok = parse_geo_uri (uris[i], &geo_uris[i], NULL);
+		if (valid != NULL)
+			valid[i] = ok;
+		n_valid += ok;
+	}
+
+	return n_valid;
+}
+
+/* Writes the decimal digits of @n to @out, and returns the end of them */
+static char *
+format_unsigned (char    *out,
+                 guint64  n)
+{
+	char digits[20];
+	guint i = 0;
+
+	do {
+		digits[i++] = '0' + n % 10;
+		n /= 10;
+	} while (n != 0);
+
+	while (i > 0)
+		*out++ = digits[--i];
+
+	return out;
+}
+
+static char *
+format_with_g_ascii_formatd (char        *out,
+                             const char  *format,
+                             gdouble      value)
+{
+	char buffer[G_ASCII_DTOSTR_BUF_SIZE];
+	gsize len;
+
+	g_ascii_formatd (buffer, sizeof (buffer), format, value);
+	len = strlen (buffer);
+	memcpy (out, buffer, len);
+
+	return out + len;
+}
+
+/* Writes @coord rounded to 6 decimal places (0.1 metre) in "%.6f" format.
+ * Once @coord has been rounded to a whole number of millionths, printing
+ * it only needs integer arithmetic. Values too large for that, which are
+ * not valid coordinates anyway, are printed as they always were. */
+static char *
+format_coordinate (char    *out,
+                   gdouble  coord)
+{
+	gdouble millionths;
+	guint64 n, fraction;
+	gint i;
+
+	millionths = round (coord * 1e6);
+	if (!(fabs (millionths) < 1e15))
+		return format_with_g_ascii_formatd (out, "%.6f", millionths / 1e6);
+
+	if (signbit (millionths))
+		*out++ = '-';
+
+	n = (guint64) fabs (millionths);
+	out = format_unsigned (out, n / 1000000);
+	*out++ = '.';
+
+	fraction = n % 1000000;
+	for (i = 5; i >= 0; i--) {
+		out[i] = '0' + fraction % 10;
+		fraction /= 10;
+	}
+
+	return out + 6;
+}
+
+/* Writes the shortest decimal representation of @value which parses back
+ * to the same double. Whole numbers, which most altitudes and accuracies
+ * are, are written directly. */
+static char *
+format_shortest (char    *out,
+                 gdouble  value)
+{
+	char buffer[G_ASCII_DTOSTR_BUF_SIZE];
+	static const char * const formats[] = { "%.15g", "%.16g" };
+	guint i;
+
+	if (value == floor (value) && fabs (value) < 1e15) {
+		if (signbit (value))
+			*out++ = '-';
+		return format_unsigned (out, (guint64) fabs (value));
+	}
+
+	for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+		g_ascii_formatd (buffer, sizeof (buffer), formats[i], value);
+		if (g_ascii_strtod (buffer, NULL) == value) {
+			gsize len = strlen (buffer);
+
+			memcpy (out, buffer, len);
+			return out + len;
+		}
+	}
+
+	return format_with_g_ascii_formatd (out, "%.17g", value);
+}
+
+/* Writes the URI and a nul terminator to @out, which must have room for
+ * GEOCODE_GEO_URI_BUFFER_SIZE bytes, and returns its length */
+static gsize
+format_geo_uri (char    *out,
+                gdouble  latitude,
+                gdouble  longitude,
+                gdouble  altitude,
+                gdouble  accuracy)
+{
+	char *p = out;
+
+	memcpy (p, "geo:", 4);
+	p = format_coordinate (p + 4, latitude);
+	*p++ = ',';
+	p = format_coordinate (p, longitude);
+
+	if (altitude != GEOCODE_LOCATION_ALTITUDE_UNKNOWN) {
+		*p++ = ',';
+		p = format_shortest (p, altitude);
+	}
+
+	memcpy (p, ";crs=wgs84", 10);
+	p += 10;
+
+	if (accuracy != GEOCODE_LOCATION_ACCURACY_UNKNOWN) {
+		memcpy (p, ";u=", 3);
+		p = format_shortest (p + 3, accuracy);
+	}
+
+	*p = '\0';
+
+	return p - out;
+}
+
+/**
+ * geocode_geo_uri_format:
+ * @latitude: the latitude, in degrees
+ * @longitude: the longitude, in degrees
+ * @altitude: the altitude, in metres, or
+ *    %GEOCODE_LOCATION_ALTITUDE_UNKNOWN to leave it out
+ * @accuracy: the accuracy, in metres, or
+ *    %GEOCODE_LOCATION_ACCURACY_UNKNOWN to leave it out
+ * @buffer: (out caller-allocates) (array length=buffer_size): return
+ *    location for the URI
+ * @buffer_size: the size of @buffer, in bytes
+ *
+ * Writes a geo URI (RFC 5870) for the given coordinates to @buffer,
+ * without allocating any memory. This is the URI geocode_location_to_uri()
+ * returns for a #GeocodeLocation with these coordinates: the latitude and
+ * longitude are rounded to 6 decimal places, and the altitude and accuracy
+ * are written with as few digits as will parse back to the same values.
+ *
+ * If @buffer_size is at least %GEOCODE_GEO_URI_BUFFER_SIZE, the URI always
+ * fits. Otherwise, if it does not fit, @buffer is set to an empty string.
+ *
+ * Returns: the length of the URI, not including the nul terminator. If this
+ *    is not less than @buffer_size, the URI did not fit.
+ *
+ * Since: 3.28
+ */
+gsize
+geocode_geo_uri_format (gdouble  latitude,
+                        gdouble  longitude,
+                        gdouble  altitude,
+                        gdouble  accuracy,
+                        char    *buffer,
+                        gsize    buffer_size)
+{
+	char tmp[GEOCODE_GEO_URI_BUFFER_SIZE];
+	gsize len;
+
+	g_return_val_if_fail (buffer != NULL || buffer_size == 0, 0);
+
+	if (buffer_size >= GEOCODE_GEO_URI_BUFFER_SIZE)
+		return format_geo_uri (buffer, latitude, longitude, altitude, accuracy);
+
+	len = format_geo_uri (tmp, latitude, longitude, altitude, accuracy);
+	if (len < buffer_size)
+		memcpy (buffer, tmp, len + 1);
+	else if (buffer_size > 0)
+		buffer[0] = '\0';
+
+	return len;
+}
+
+static void
+append_geo_uri (GString *string,
+                gdouble  latitude,
+                gdouble  longitude,
+                gdouble  altitude,
+                gdouble  accuracy)
+{
+	gsize old_len = string->len;
+	gsize len;
+
+	/* Only reallocates when the string has to grow */
+	g_string_set_size (string, old_len + GEOCODE_GEO_URI_BUFFER_SIZE);
+	len = format_geo_uri (string->str + old_len,
+	                      latitude, longitude, altitude, accuracy);
+	g_string_truncate (string, old_len + len);
+}
+
+/**
+ * geocode_geo_uri_append:
+ * @string: a #GString
+ * @latitude: the latitude, in degrees
+ * @longitude: the longitude, in degrees
+ * @altitude: the altitude, in metres, or
+ *    %GEOCODE_LOCATION_ALTITUDE_UNKNOWN to leave it out
+ * @accuracy: the accuracy, in metres, or
+ *    %GEOCODE_LOCATION_ACCURACY_UNKNOWN to leave it out
+ *
+ * Appends the geo URI for the given coordinates, as written by
+ * geocode_geo_uri_format(), to @string. No memory is allocated unless
+ * @string has to grow.
+ *
+ * Since: 3.28
+ */
+void
+geocode_geo_uri_append (GString *string,
+                        gdouble  latitude,
+                        gdouble  longitude,
+                        gdouble  altitude,
+                        gdouble  accuracy)
+{
+	g_return_if_fail (string != NULL);
+
+	append_geo_uri (string, latitude, longitude, altitude, accuracy);
+}
+
+/**
+ * geocode_geo_uri_append_batch:
+ * @string: a #GString
+ * @latitudes: (array length=n_points): latitudes of the points, in degrees
+ * @longitudes: (array length=n_points): longitudes of the points, in degrees
+ * @altitudes: (array length=n_points) (nullable): altitudes of the points,
+ *    in metres, or %NULL to leave them all out
+ * @accuracies: (array length=n_points) (nullable): accuracies of the points,
+ *    in metres, or %NULL to leave them all out
+ * @n_points: the number of points
+ * @separator: (nullable): string to append between URIs, or %NULL
+ *
+ * Appends the geo URI for each of @n_points points to @string, as
+ * geocode_geo_uri_append() does, with @separator between them. Individual
+ * altitudes and accuracies may also be %GEOCODE_LOCATION_ALTITUDE_UNKNOWN
+ * or %GEOCODE_LOCATION_ACCURACY_UNKNOWN.
+ *
+ * Since: 3.28
+ */
+void
+geocode_geo_uri_append_batch (GString       *string,
+                              const gdouble *latitudes,
+                              const gdouble *longitudes,
+                              const gdouble *altitudes,
+                              const gdouble *accuracies,
+                              gsize          n_points,
+                              const char    *separator)
+{
+	gsize separator_len;
+	gsize i;
+
+	g_return_if_fail (string != NULL);
+	g_return_if_fail (n_points == 0 || (latitudes != NULL && longitudes != NULL));
+
+	separator_len = (separator != NULL) ? strlen (separator) : 0;
+
+	for (i = 0; i < n_points; i++) {
+		if (i > 0 && separator_len > 0)
+			g_string_append_len (string, separator, separator_len);
+
+		append_geo_uri (string,
+		                latitudes[i],
+		                longitudes[i],
+		                altitudes ? altitudes[i] : GEOCODE_LOCATION_ALTITUDE_UNKNOWN,
+		                accuracies ? accuracies[i] : GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+	}
+}
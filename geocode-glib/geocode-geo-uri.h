@@ -0,0 +1,95 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#ifndef GEOCODE_GEO_URI_H
+#define GEOCODE_GEO_URI_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GeocodeGeoUri:
+ * @latitude: the latitude, in degrees
+ * @longitude: the longitude, in degrees
+ * @has_altitude: whether the URI gave an altitude
+ * @altitude: the altitude, in metres, if @has_altitude is %TRUE
+ * @has_accuracy: whether the URI gave an uncertainty (`u=` parameter)
+ * @accuracy: the accuracy, in metres, if @has_accuracy is %TRUE
+ * @description: (nullable): the description given in a
+ *    `geo:0,0?q=lat,lon(description)` URI, still percent-encoded and not
+ *    nul-terminated, pointing into the parsed URI; or %NULL
+ * @description_len: the length of @description in bytes
+ *
+ * The contents of a geo URI (RFC 5870), as parsed by geocode_geo_uri_parse().
+ *
+ * Since: 3.28
+ */
+typedef struct {
+	gdouble latitude;
+	gdouble longitude;
+	gboolean has_altitude;
+	gdouble altitude;
+	gboolean has_accuracy;
+	gdouble accuracy;
+	const char *description;
+	gsize description_len;
+} GeocodeGeoUri;
+
+gboolean geocode_geo_uri_parse       (const char         *uri,
+                                      GeocodeGeoUri      *geo_uri,
+                                      GError            **error);
+gsize    geocode_geo_uri_parse_batch (const char * const *uris,
+                                      gsize               n_uris,
+                                      GeocodeGeoUri      *geo_uris,
+                                      gboolean           *valid);
+
+/**
+ * GEOCODE_GEO_URI_BUFFER_SIZE:
+ *
+ * A buffer of this size is always large enough for the geo URIs written
+ * by geocode_geo_uri_format(), including the nul terminator.
+ *
+ * Since: 3.28
+ */
+#define GEOCODE_GEO_URI_BUFFER_SIZE 144
+
+gsize geocode_geo_uri_format       (gdouble        latitude,
+                                    gdouble        longitude,
+                                    gdouble        altitude,
+                                    gdouble        accuracy,
+                                    char          *buffer,
+                                    gsize          buffer_size);
+void  geocode_geo_uri_append       (GString       *string,
+                                    gdouble        latitude,
+                                    gdouble        longitude,
+                                    gdouble        altitude,
+                                    gdouble        accuracy);
+void  geocode_geo_uri_append_batch (GString       *string,
+                                    const gdouble *latitudes,
+                                    const gdouble *longitudes,
+                                    const gdouble *altitudes,
+                                    const gdouble *accuracies,
+                                    gsize          n_points,
+                                    const char    *separator);
+
+G_END_DECLS
+
+#endif /* GEOCODE_GEO_URI_H */
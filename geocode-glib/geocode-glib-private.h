@@ -24,10 +24,12 @@
 #define GEOCODE_GLIB_PRIVATE_H
 
 #include <glib.h>
+#include <gio/gio.h>
 #include <libsoup/soup.h>
 #include <json-glib/json-glib.h>
 #include <geocode-glib/geocode-location.h>
 #include <geocode-glib/geocode-place.h>
+#include <geocode-glib/geocode-stats.h>
 
 G_BEGIN_DECLS
 
@@ -38,19 +40,127 @@ typedef enum {
 	GEOCODE_GLIB_RESOLVE_REVERSE
 } GeocodeLookupType;
 
-GList      *_geocode_parse_search_json  (const char *contents,
-					 GError    **error);
+typedef struct _GeocodeResultSet GeocodeResultSet;
+
+GeocodeResultSet *_geocode_result_set_new (void);
+void _geocode_result_set_free (GeocodeResultSet *set);
+GHashTable *_geocode_result_set_new_attributes (GeocodeResultSet *set);
+const char *_geocode_result_set_insert (GeocodeResultSet *set,
+                                        const char       *str);
+const char *_geocode_result_set_insert_printf (GeocodeResultSet *set,
+                                               const char       *format,
+                                               ...) G_GNUC_PRINTF (2, 3);
+GString *_geocode_result_set_get_scratch (GeocodeResultSet *set);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GeocodeResultSet, _geocode_result_set_free)
+
+GList      *_geocode_parse_search_json  (const char        *contents,
+					 GError           **error);
+GHashTable *_geocode_parse_resolve_json (const char        *contents,
+					 GeocodeResultSet  *set,
+					 GError           **error);
+GList      *_geocode_parse_place_json   (const char        *contents,
+					 gssize             length,
+					 GError           **error);
 
 char       *_geocode_object_get_lang (void);
 
+gdouble _geocode_haversine_distance (gdouble latitude1,
+                                     gdouble longitude1,
+                                     gdouble latitude2,
+                                     gdouble longitude2);
+
 char *_geocode_glib_cache_path_for_query (SoupMessage *query);
 gboolean _geocode_glib_cache_save (SoupMessage *query,
                                    const char  *contents);
-gboolean _geocode_glib_cache_load (SoupMessage *query,
-                                   char       **contents);
+gboolean _geocode_glib_cache_load (SoupMessage  *query,
+                                   GCancellable *cancellable,
+                                   char        **contents);
 GHashTable *_geocode_glib_dup_hash_table (GHashTable *ht);
 gboolean _geocode_object_is_number_after_street (void);
-SoupSession *_geocode_glib_build_soup_session (const gchar *user_agent_override);
+SoupSession *_geocode_glib_build_soup_session (const gchar *user_agent_override,
+                                               guint        timeout);
+
+#define GEOCODE_STATS_N_LATENCY_BUCKETS 18
+
+/* Live counters are only ever accessed atomically, or under the lock for
+ * the 64-bit ones. */
+struct _GeocodeStats {
+	guint requests;
+	guint cache_hits;
+	guint cache_misses;
+	guint status_classes[6];  /* 0 for no response, then 1xx to 5xx */
+	guint64 bytes_received;  /* protected by a lock in geocode-stats.c */
+	guint parses;
+	guint64 parse_time;  /* microseconds, protected like @bytes_received */
+	guint latency[GEOCODE_STATS_N_LATENCY_BUCKETS];
+};
+
+void _geocode_stats_record_query (GeocodeStats *stats,
+                                  gboolean      cache_hit);
+void _geocode_stats_record_response (GeocodeStats *stats,
+                                     guint         status,
+                                     gsize         n_bytes,
+                                     gint64        latency);
+void _geocode_stats_record_parse (GeocodeStats *stats,
+                                  gint64        parse_time);
+void _geocode_stats_snapshot (GeocodeStats *stats,
+                              GeocodeStats *snapshot);
+void _geocode_stats_reset (GeocodeStats *stats);
+
+typedef struct _GeocodeGazetteerWriter GeocodeGazetteerWriter;
+
+GeocodeGazetteerWriter *_geocode_gazetteer_writer_new (void);
+void _geocode_gazetteer_writer_free (GeocodeGazetteerWriter *writer);
+gboolean _geocode_gazetteer_writer_add_place (GeocodeGazetteerWriter *writer,
+                                              GeocodePlace           *place);
+guint _geocode_gazetteer_writer_get_n_places (GeocodeGazetteerWriter *writer);
+gboolean _geocode_gazetteer_writer_write (GeocodeGazetteerWriter  *writer,
+                                          const char              *path,
+                                          GError                 **error);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GeocodeGazetteerWriter, _geocode_gazetteer_writer_free)
+
+typedef struct _GeocodeDeadline GeocodeDeadline;
+
+GeocodeDeadline *_geocode_deadline_new (guint         timeout_ms,
+                                        GCancellable *cancellable,
+                                        GMainContext *context);
+GCancellable *_geocode_deadline_get_cancellable (GeocodeDeadline *deadline);
+void _geocode_deadline_translate_error (GeocodeDeadline  *deadline,
+                                        GError          **error);
+void _geocode_deadline_finish (GeocodeDeadline *deadline);
+
+GHashTable *_geocode_params_copy (GHashTable *params);
+guint _geocode_params_hash (gconstpointer params);
+gboolean _geocode_params_equal (gconstpointer params_a,
+                                gconstpointer params_b);
+
+const char *_geocode_params_lookup_string (GHashTable *params,
+                                           const char *key);
+gboolean _geocode_params_lookup_double (GHashTable *params,
+                                        const char *key,
+                                        gdouble    *out);
+guint _geocode_params_lookup_limit (GHashTable *params);
+
+void _geocode_params_to_json (JsonBuilder *builder,
+                              GHashTable  *params);
+GHashTable *_geocode_params_from_json (JsonObject  *object,
+                                       GError     **error);
+void _geocode_place_to_json (JsonBuilder  *builder,
+                             GeocodePlace *place);
+GeocodePlace *_geocode_place_from_json (JsonNode  *node,
+                                        GError   **error);
+
+const char *_geocode_json_get_string_member (JsonObject *object,
+                                             const char *member_name);
+gboolean _geocode_json_get_int_member (JsonObject *object,
+                                       const char *member_name,
+                                       gint64     *out);
+JsonObject *_geocode_json_get_object_member (JsonObject *object,
+                                             const char *member_name);
+
+char *_geocode_normalize_name (const char *name);
 
 G_END_DECLS
 
@@ -30,6 +30,8 @@
 #ifndef G_OS_WIN32
 #include <langinfo.h>
 #endif
+#include <geocode-glib/geocode-error.h>
+#include <geocode-glib/geocode-enum-types.h>
 #include <geocode-glib/geocode-glib-private.h>
 
 /**
@@ -42,7 +44,8 @@
  **/
 
 SoupSession *
-_geocode_glib_build_soup_session (const gchar *user_agent_override)
+_geocode_glib_build_soup_session (const gchar *user_agent_override,
+                                  guint        timeout)
 {
 	const char *user_agent;
 	g_autofree gchar *user_agent_allocated = NULL;
@@ -68,8 +71,9 @@ _geocode_glib_build_soup_session (const gchar *user_agent_override)
 
 	g_debug ("%s: user_agent = %s", G_STRFUNC, user_agent);
 
-	return soup_session_new_with_options ("user-agent",
-	                                      user_agent, NULL);
+	return soup_session_new_with_options ("user-agent", user_agent,
+	                                      "timeout", timeout,
+	                                      NULL);
 }
 
 char *
@@ -136,20 +140,943 @@ _geocode_glib_cache_save (SoupMessage *query,
 }
 
 gboolean
-_geocode_glib_cache_load (SoupMessage *query,
-			  char  **contents)
+_geocode_glib_cache_load (SoupMessage  *query,
+			  GCancellable *cancellable,
+			  char        **contents)
 {
 	char *path;
+	GFile *file;
 	gboolean ret;
 
 	path = _geocode_glib_cache_path_for_query (query);
+	if (path == NULL)
+		return FALSE;
+
 	g_debug ("Loading cache file '%s'", path);
-	ret = g_file_get_contents (path, contents, NULL, NULL);
+	file = g_file_new_for_path (path);
+	ret = g_file_load_contents (file, cancellable, contents, NULL, NULL, NULL);
 
+	g_object_unref (file);
 	g_free (path);
 	return ret;
 }
 
+/* A result set owns everything allocated while parsing one response which
+ * does not outlive it: attribute tables, their keys and values, and
+ * scratch space for building strings. The strings are packed into a few
+ * large chunks, with duplicates (such as the same attribute names in every
+ * result) stored once, and it is all freed at once by
+ * _geocode_result_set_free(). */
+struct _GeocodeResultSet {
+	GStringChunk *strings;
+	GPtrArray    *attributes;  /* (element-type GHashTable) */
+	GString      *scratch;
+};
+
+GeocodeResultSet *
+_geocode_result_set_new (void)
+{
+	GeocodeResultSet *set;
+
+	set = g_new0 (GeocodeResultSet, 1);
+	set->strings = g_string_chunk_new (4096);
+	set->attributes = g_ptr_array_new_with_free_func ((GDestroyNotify) g_hash_table_unref);
+	set->scratch = g_string_sized_new (256);
+
+	return set;
+}
+
+void
+_geocode_result_set_free (GeocodeResultSet *set)
+{
+	if (set == NULL)
+		return;
+
+	g_string_chunk_free (set->strings);
+	g_ptr_array_unref (set->attributes);
+	g_string_free (set->scratch, TRUE);
+	g_free (set);
+}
+
+/* Returns a new table of attributes, whose keys and values must be owned
+ * by @set. The table is only valid as long as @set is. */
+GHashTable *
+_geocode_result_set_new_attributes (GeocodeResultSet *set)
+{
+	GHashTable *ht;
+
+	ht = g_hash_table_new (g_str_hash, g_str_equal);
+	g_ptr_array_add (set->attributes, ht);
+
+	return ht;
+}
+
+const char *
+_geocode_result_set_insert (GeocodeResultSet *set,
+                            const char       *str)
+{
+	return g_string_chunk_insert_const (set->strings, str);
+}
+
+const char *
+_geocode_result_set_insert_printf (GeocodeResultSet *set,
+                                   const char       *format,
+                                   ...)
+{
+	va_list args;
+
+	va_start (args, format);
+	g_string_vprintf (set->scratch, format, args);
+	va_end (args);
+
+	return g_string_chunk_insert_const (set->strings, set->scratch->str);
+}
+
+/* Returns a #GString which can be used for building temporary strings,
+ * until the next call into @set */
+GString *
+_geocode_result_set_get_scratch (GeocodeResultSet *set)
+{
+	g_string_truncate (set->scratch, 0);
+
+	return set->scratch;
+}
+
+struct _GeocodeDeadline {
+	gint          ref_count;  /* atomic */
+	gint          expired;    /* atomic */
+	GCancellable *cancellable;
+	GCancellable *parent;
+	gulong        parent_handler;
+	GSource      *source;
+};
+
+static gpointer
+deadline_thread_func (gpointer data)
+{
+	GMainContext *context = data;
+	GMainLoop *loop;
+
+	loop = g_main_loop_new (context, FALSE);
+	g_main_loop_run (loop);
+
+	return NULL;
+}
+
+static gpointer
+create_deadline_context (gpointer data)
+{
+	GMainContext *context;
+
+	context = g_main_context_new ();
+	g_thread_unref (g_thread_new ("geocode-deadline",
+	                              deadline_thread_func,
+	                              context));
+
+	return context;
+}
+
+/* Blocking queries cannot dispatch their own timeout source, so their
+ * deadlines fire from a shared thread instead. */
+static GMainContext *
+get_deadline_context (void)
+{
+	static GOnce once = G_ONCE_INIT;
+
+	g_once (&once, create_deadline_context, NULL);
+	return once.retval;
+}
+
+static GeocodeDeadline *
+deadline_ref (GeocodeDeadline *deadline)
+{
+	g_atomic_int_inc (&deadline->ref_count);
+	return deadline;
+}
+
+static void
+deadline_unref (GeocodeDeadline *deadline)
+{
+	if (!g_atomic_int_dec_and_test (&deadline->ref_count))
+		return;
+
+	g_object_unref (deadline->cancellable);
+	g_free (deadline);
+}
+
+static void
+on_deadline_parent_cancelled (GCancellable *parent,
+                              GCancellable *cancellable)
+{
+	g_cancellable_cancel (cancellable);
+}
+
+static gboolean
+on_deadline_expired (gpointer user_data)
+{
+	GeocodeDeadline *deadline = user_data;
+
+	g_atomic_int_set (&deadline->expired, TRUE);
+	g_cancellable_cancel (deadline->cancellable);
+
+	return G_SOURCE_REMOVE;
+}
+
+/*
+ * _geocode_deadline_new:
+ * @timeout_ms: time allowed for the operation, in milliseconds
+ * @cancellable: (nullable): the caller's #GCancellable
+ * @context: (nullable): context to run the timer in, or %NULL for blocking
+ *   calls
+ *
+ * Creates a deadline whose cancellable (see
+ * _geocode_deadline_get_cancellable()) is cancelled either when
+ * @cancellable is, or once @timeout_ms has elapsed. Pass that cancellable
+ * to the backend, then use _geocode_deadline_translate_error() on the
+ * result and release the deadline with _geocode_deadline_finish().
+ */
+GeocodeDeadline *
+_geocode_deadline_new (guint         timeout_ms,
+                       GCancellable *cancellable,
+                       GMainContext *context)
+{
+	GeocodeDeadline *deadline;
+
+	deadline = g_new0 (GeocodeDeadline, 1);
+	deadline->ref_count = 1;
+	deadline->cancellable = g_cancellable_new ();
+
+	if (cancellable != NULL) {
+		deadline->parent = g_object_ref (cancellable);
+		deadline->parent_handler =
+			g_cancellable_connect (cancellable,
+			                       G_CALLBACK (on_deadline_parent_cancelled),
+			                       g_object_ref (deadline->cancellable),
+			                       g_object_unref);
+	}
+
+	deadline->source = g_timeout_source_new (timeout_ms);
+	g_source_set_callback (deadline->source,
+	                       on_deadline_expired,
+	                       deadline_ref (deadline),
+	                       (GDestroyNotify) deadline_unref);
+	g_source_attach (deadline->source,
+	                 context != NULL ? context : get_deadline_context ());
+
+	return deadline;
+}
+
+GCancellable *
+_geocode_deadline_get_cancellable (GeocodeDeadline *deadline)
+{
+	return deadline->cancellable;
+}
+
+/* Turns the cancellation caused by an expired deadline into
+ * %GEOCODE_ERROR_TIMED_OUT; other errors are left untouched. */
+void
+_geocode_deadline_translate_error (GeocodeDeadline  *deadline,
+                                   GError          **error)
+{
+	if (deadline == NULL || error == NULL || *error == NULL)
+		return;
+
+	if (!g_atomic_int_get (&deadline->expired) ||
+	    !g_error_matches (*error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+		return;
+
+	g_clear_error (error);
+	g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_TIMED_OUT,
+	                     "Deadline expired before the query completed");
+}
+
+void
+_geocode_deadline_finish (GeocodeDeadline *deadline)
+{
+	g_source_destroy (deadline->source);
+	g_clear_pointer (&deadline->source, g_source_unref);
+
+	/* Not g_cancellable_disconnect(), which must not be called from a
+	 * handler of the parent's ::cancelled signal. */
+	if (deadline->parent_handler != 0)
+		g_signal_handler_disconnect (deadline->parent,
+		                             deadline->parent_handler);
+	g_clear_object (&deadline->parent);
+
+	deadline_unref (deadline);
+}
+
+static void
+params_value_free (GValue *value)
+{
+	g_value_unset (value);
+	g_free (value);
+}
+
+/* Copies the parameters passed to a #GeocodeBackend, so that they can be
+ * kept after the query returns. */
+GHashTable *
+_geocode_params_copy (GHashTable *params)
+{
+	g_autoptr (GHashTable) output = NULL;
+	GHashTableIter iter;
+	const gchar *key;
+	const GValue *value;
+
+	output = g_hash_table_new_full (g_str_hash, g_str_equal,
+	                                g_free, (GDestroyNotify) params_value_free);
+
+	g_hash_table_iter_init (&iter, params);
+
+	while (g_hash_table_iter_next (&iter, (gpointer *) &key,
+	                               (gpointer *) &value)) {
+		GValue *value_copy = NULL;
+
+		value_copy = g_new0 (GValue, 1);
+		g_value_init (value_copy, G_VALUE_TYPE (value));
+		g_value_copy (value, value_copy);
+
+		g_hash_table_insert (output, g_strdup (key),
+		                     g_steal_pointer (&value_copy));
+	}
+
+	return g_steal_pointer (&output);
+}
+
+static gboolean
+value_equal (const GValue *a,
+             const GValue *b)
+{
+	GValue a_string = G_VALUE_INIT, b_string = G_VALUE_INIT;
+	gboolean equal;
+
+	g_return_val_if_fail (a != NULL, FALSE);
+	g_return_val_if_fail (b != NULL, FALSE);
+
+	if (G_VALUE_TYPE (a) != G_VALUE_TYPE (b))
+		return FALSE;
+
+	/* Doubles can’t be converted to strings, so special-case comparison
+	 * of them. */
+	if (G_VALUE_TYPE (a) == G_TYPE_DOUBLE) {
+		return g_value_get_double (a) == g_value_get_double (b);
+	}
+
+	g_value_init (&a_string, G_TYPE_STRING);
+	g_value_init (&b_string, G_TYPE_STRING);
+
+	/* We assume that all GValue types can be converted to strings for the
+	 * purpose of comparison. Strings may be %NULL. */
+	equal = (g_value_transform (a, &a_string) &&
+	         g_value_transform (b, &b_string) &&
+	         g_strcmp0 (g_value_get_string (&a_string),
+	                    g_value_get_string (&b_string)) == 0);
+
+	g_value_unset (&b_string);
+	g_value_unset (&a_string);
+
+	return equal;
+}
+
+/* Hashes @value consistently with value_equal(). */
+static guint
+value_hash (const GValue *value)
+{
+	GValue string = G_VALUE_INIT;
+	guint hash = g_direct_hash ((gconstpointer) G_VALUE_TYPE (value));
+
+	if (G_VALUE_TYPE (value) == G_TYPE_DOUBLE) {
+		gdouble d = g_value_get_double (value);
+
+		/* -0.0 == 0.0, so they must hash the same. */
+		if (d == 0.0)
+			d = 0.0;
+
+		return hash ^ g_double_hash (&d);
+	}
+
+	g_value_init (&string, G_TYPE_STRING);
+
+	if (g_value_transform (value, &string) &&
+	    g_value_get_string (&string) != NULL)
+		hash ^= g_str_hash (g_value_get_string (&string));
+
+	g_value_unset (&string);
+
+	return hash;
+}
+
+/* Hashes the parameters passed to a #GeocodeBackend consistently with
+ * _geocode_params_equal(), so that answers to queries can be looked up in
+ * a #GHashTable keyed by their parameters. Pairs are combined by addition,
+ * which does not depend on the order the hash table iterates in. */
+guint
+_geocode_params_hash (gconstpointer params)
+{
+	GHashTableIter iter;
+	const gchar *key;
+	const GValue *value;
+	guint hash = g_hash_table_size ((GHashTable *) params);
+
+	g_hash_table_iter_init (&iter, (GHashTable *) params);
+
+	while (g_hash_table_iter_next (&iter, (gpointer *) &key,
+	                               (gpointer *) &value))
+		hash += g_str_hash (key) * 31 + value_hash (value);
+
+	return hash;
+}
+
+/* Whether two sets of parameters have the same keys, with values of the same
+ * types which compare equal. */
+gboolean
+_geocode_params_equal (gconstpointer params_a,
+                       gconstpointer params_b)
+{
+	GHashTable *a = (GHashTable *) params_a, *b = (GHashTable *) params_b;
+	GHashTableIter iter_a;
+	const gchar *key;
+	const GValue *value_a, *value_b;
+
+	if (g_hash_table_size (a) != g_hash_table_size (b))
+		return FALSE;
+
+	g_hash_table_iter_init (&iter_a, a);
+
+	while (g_hash_table_iter_next (&iter_a, (gpointer *) &key,
+	                               (gpointer *) &value_a)) {
+		if (!g_hash_table_lookup_extended (b, key, NULL,
+		                                   (gpointer *) &value_b) ||
+		    !value_equal (value_a, value_b))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Returns the string parameter @key passed to a #GeocodeBackend, or %NULL if
+ * it is not set or is not a string. */
+const char *
+_geocode_params_lookup_string (GHashTable *params,
+                               const char *key)
+{
+	const GValue *value = g_hash_table_lookup (params, key);
+
+	if (value == NULL || !G_VALUE_HOLDS_STRING (value))
+		return NULL;
+
+	return g_value_get_string (value);
+}
+
+/* Reads a number from the parameters passed to a #GeocodeBackend, such as
+ * the `lat` and `lon` which geocode_reverse_resolve() sets as doubles, or
+ * strings holding numbers as built by hand in tests. */
+gboolean
+_geocode_params_lookup_double (GHashTable *params,
+                               const char *key,
+                               gdouble    *out)
+{
+	const GValue *value = g_hash_table_lookup (params, key);
+
+	if (value != NULL && G_VALUE_HOLDS_DOUBLE (value)) {
+		*out = g_value_get_double (value);
+		return TRUE;
+	} else if (value != NULL && G_VALUE_HOLDS_STRING (value) &&
+	           g_value_get_string (value) != NULL) {
+		const char *str = g_value_get_string (value);
+		char *end;
+
+		*out = g_ascii_strtod (str, &end);
+		return (end != str && *end == '\0');
+	}
+
+	return FALSE;
+}
+
+/* Reads the `limit` parameter set by geocode_forward_set_answer_count(),
+ * falling back to %DEFAULT_ANSWER_COUNT if it is missing or zero. */
+guint
+_geocode_params_lookup_limit (GHashTable *params)
+{
+	const GValue *value = g_hash_table_lookup (params, "limit");
+	guint64 limit = 0;
+
+	if (value == NULL)
+		return DEFAULT_ANSWER_COUNT;
+	else if (G_VALUE_HOLDS_UINT (value))
+		limit = g_value_get_uint (value);
+	else if (G_VALUE_HOLDS_INT (value))
+		limit = MAX (g_value_get_int (value), 0);
+	else if (G_VALUE_HOLDS_STRING (value) && g_value_get_string (value) != NULL)
+		limit = g_ascii_strtoull (g_value_get_string (value), NULL, 10);
+
+	return (limit > 0) ? (guint) MIN (limit, G_MAXUINT) : DEFAULT_ANSWER_COUNT;
+}
+
+/* String properties of #GeocodePlace which are written to and read from
+ * traces as they are. */
+static const char * const place_string_properties[] = {
+	"street-address",
+	"street",
+	"building",
+	"postal-code",
+	"area",
+	"town",
+	"county",
+	"state",
+	"administrative-area",
+	"country-code",
+	"country",
+	"continent",
+	"osm-id",
+};
+
+static void
+json_add_enum_nick (JsonBuilder *builder,
+                    const char  *member_name,
+                    GType        enum_type,
+                    gint         value)
+{
+	GEnumClass *enum_class;
+	GEnumValue *enum_value;
+
+	enum_class = g_type_class_ref (enum_type);
+	enum_value = g_enum_get_value (enum_class, value);
+
+	if (enum_value != NULL) {
+		json_builder_set_member_name (builder, member_name);
+		json_builder_add_string_value (builder, enum_value->value_nick);
+	}
+
+	g_type_class_unref (enum_class);
+}
+
+static void
+json_add_double (JsonBuilder *builder,
+                 const char  *member_name,
+                 gdouble      value)
+{
+	json_builder_set_member_name (builder, member_name);
+	json_builder_add_double_value (builder, value);
+}
+
+static void
+json_add_location (JsonBuilder     *builder,
+                   GeocodeLocation *location)
+{
+	json_builder_set_member_name (builder, "location");
+	json_builder_begin_object (builder);
+
+	json_add_double (builder, "latitude", geocode_location_get_latitude (location));
+	json_add_double (builder, "longitude", geocode_location_get_longitude (location));
+	json_add_double (builder, "accuracy", geocode_location_get_accuracy (location));
+
+	if (geocode_location_get_altitude (location) != GEOCODE_LOCATION_ALTITUDE_UNKNOWN)
+		json_add_double (builder, "altitude",
+		                 geocode_location_get_altitude (location));
+
+	if (geocode_location_get_description (location) != NULL) {
+		json_builder_set_member_name (builder, "description");
+		json_builder_add_string_value (builder,
+		                               geocode_location_get_description (location));
+	}
+
+	json_builder_set_member_name (builder, "timestamp");
+	json_builder_add_int_value (builder,
+	                            (gint64) geocode_location_get_timestamp (location));
+
+	json_builder_end_object (builder);
+}
+
+static void
+json_add_bounding_box (JsonBuilder        *builder,
+                       GeocodeBoundingBox *bbox)
+{
+	json_builder_set_member_name (builder, "bounding-box");
+	json_builder_begin_object (builder);
+
+	json_add_double (builder, "top", geocode_bounding_box_get_top (bbox));
+	json_add_double (builder, "bottom", geocode_bounding_box_get_bottom (bbox));
+	json_add_double (builder, "left", geocode_bounding_box_get_left (bbox));
+	json_add_double (builder, "right", geocode_bounding_box_get_right (bbox));
+
+	json_builder_end_object (builder);
+}
+
+/* Adds @place to @builder as an object, in the format read back by
+ * _geocode_place_from_json(). */
+void
+_geocode_place_to_json (JsonBuilder  *builder,
+                        GeocodePlace *place)
+{
+	gsize i;
+
+	json_builder_begin_object (builder);
+
+	json_builder_set_member_name (builder, "name");
+	json_builder_add_string_value (builder, geocode_place_get_name (place));
+	json_add_enum_nick (builder, "place-type", GEOCODE_TYPE_PLACE_TYPE,
+	                    geocode_place_get_place_type (place));
+
+	if (geocode_place_get_location (place) != NULL)
+		json_add_location (builder, geocode_place_get_location (place));
+	if (geocode_place_get_bounding_box (place) != NULL)
+		json_add_bounding_box (builder, geocode_place_get_bounding_box (place));
+
+	for (i = 0; i < G_N_ELEMENTS (place_string_properties); i++) {
+		g_autofree char *value = NULL;
+
+		g_object_get (place, place_string_properties[i], &value, NULL);
+		if (value == NULL)
+			continue;
+
+		json_builder_set_member_name (builder, place_string_properties[i]);
+		json_builder_add_string_value (builder, value);
+	}
+
+	json_add_enum_nick (builder, "osm-type", GEOCODE_TYPE_PLACE_OSM_TYPE,
+	                    geocode_place_get_osm_type (place));
+
+	json_builder_end_object (builder);
+}
+
+/* Adds the parameters passed to a #GeocodeBackend to @builder as an object,
+ * in the format read back by _geocode_params_from_json(). Each parameter is
+ * a pair of its type name and its value, converted to a type JSON can hold;
+ * parameters of other types than strings, booleans and numbers are skipped. */
+void
+_geocode_params_to_json (JsonBuilder *builder,
+                         GHashTable  *params)
+{
+	GHashTableIter iter;
+	const gchar *key;
+	const GValue *value;
+
+	json_builder_begin_object (builder);
+
+	g_hash_table_iter_init (&iter, params);
+
+	while (g_hash_table_iter_next (&iter, (gpointer *) &key,
+	                               (gpointer *) &value)) {
+		GType type = G_VALUE_TYPE (value);
+		GValue json_value = G_VALUE_INIT;
+
+		if (G_VALUE_HOLDS_STRING (value) || G_VALUE_HOLDS_BOOLEAN (value))
+			g_value_init (&json_value, type);
+		else if (G_VALUE_HOLDS_DOUBLE (value) || G_VALUE_HOLDS_FLOAT (value))
+			g_value_init (&json_value, G_TYPE_DOUBLE);
+		else if (G_TYPE_IS_FUNDAMENTAL (type) &&
+		         g_value_type_transformable (type, G_TYPE_INT64))
+			g_value_init (&json_value, G_TYPE_INT64);
+
+		if (!G_IS_VALUE (&json_value) ||
+		    !g_value_transform (value, &json_value)) {
+			g_debug ("Not serializing parameter ‘%s’ of type %s",
+			         key, g_type_name (type));
+			if (G_IS_VALUE (&json_value))
+				g_value_unset (&json_value);
+			continue;
+		}
+
+		json_builder_set_member_name (builder, key);
+		json_builder_begin_array (builder);
+		json_builder_add_string_value (builder, g_type_name (type));
+
+		if (G_VALUE_HOLDS_STRING (&json_value)) {
+			if (g_value_get_string (&json_value) != NULL)
+				json_builder_add_string_value (builder, g_value_get_string (&json_value));
+			else
+				json_builder_add_null_value (builder);
+		} else if (G_VALUE_HOLDS_BOOLEAN (&json_value)) {
+			json_builder_add_boolean_value (builder, g_value_get_boolean (&json_value));
+		} else if (G_VALUE_HOLDS_DOUBLE (&json_value)) {
+			json_builder_add_double_value (builder, g_value_get_double (&json_value));
+		} else {
+			json_builder_add_int_value (builder, g_value_get_int64 (&json_value));
+		}
+
+		json_builder_end_array (builder);
+		g_value_unset (&json_value);
+	}
+
+	json_builder_end_object (builder);
+}
+
+/* Returns the string in @member_name, or %NULL if it is missing or is not a
+ * string. */
+const char *
+_geocode_json_get_string_member (JsonObject *object,
+                                 const char *member_name)
+{
+	JsonNode *node = json_object_get_member (object, member_name);
+
+	if (node == NULL || !JSON_NODE_HOLDS_VALUE (node) ||
+	    json_node_get_value_type (node) != G_TYPE_STRING)
+		return NULL;
+
+	return json_node_get_string (node);
+}
+
+/* Reads a number, which JSON may hold as an integer or a double. */
+static gboolean
+json_get_double_member (JsonObject *object,
+                        const char *member_name,
+                        gdouble    *out)
+{
+	JsonNode *node = json_object_get_member (object, member_name);
+
+	if (node == NULL || !JSON_NODE_HOLDS_VALUE (node) ||
+	    (json_node_get_value_type (node) != G_TYPE_INT64 &&
+	     json_node_get_value_type (node) != G_TYPE_DOUBLE))
+		return FALSE;
+
+	*out = json_node_get_double (node);
+	return TRUE;
+}
+
+/* Reads the integer in @member_name, returning %FALSE and leaving @out
+ * unchanged if it is missing or is not an integer. */
+gboolean
+_geocode_json_get_int_member (JsonObject *object,
+                              const char *member_name,
+                              gint64     *out)
+{
+	JsonNode *node = json_object_get_member (object, member_name);
+
+	if (node == NULL || !JSON_NODE_HOLDS_VALUE (node) ||
+	    json_node_get_value_type (node) != G_TYPE_INT64)
+		return FALSE;
+
+	*out = json_node_get_int (node);
+	return TRUE;
+}
+
+/* Returns the object in @member_name, or %NULL if it is missing or is not an
+ * object. */
+JsonObject *
+_geocode_json_get_object_member (JsonObject *object,
+                                 const char *member_name)
+{
+	JsonNode *node = json_object_get_member (object, member_name);
+
+	if (node == NULL || !JSON_NODE_HOLDS_OBJECT (node))
+		return NULL;
+
+	return json_node_get_object (node);
+}
+
+/* Reads the enum value with the nick in @member_name, leaving @out
+ * unchanged if the member is missing. */
+static gboolean
+json_get_enum_member (JsonObject *object,
+                      const char *member_name,
+                      GType       enum_type,
+                      gint       *out)
+{
+	const char *nick = _geocode_json_get_string_member (object, member_name);
+	GEnumClass *enum_class;
+	GEnumValue *value;
+
+	if (!json_object_has_member (object, member_name))
+		return TRUE;
+	if (nick == NULL)
+		return FALSE;
+
+	enum_class = g_type_class_ref (enum_type);
+	value = g_enum_get_value_by_nick (enum_class, nick);
+	if (value != NULL)
+		*out = value->value;
+	g_type_class_unref (enum_class);
+
+	return (value != NULL);
+}
+
+/* Reads back parameters written by _geocode_params_to_json(), with the
+ * types they had when they were written. */
+GHashTable *
+_geocode_params_from_json (JsonObject  *object,
+                           GError     **error)
+{
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (GList) members = NULL;
+	GList *l;
+
+	params = g_hash_table_new_full (g_str_hash, g_str_equal,
+	                                g_free, (GDestroyNotify) params_value_free);
+	members = json_object_get_members (object);
+
+	for (l = members; l != NULL; l = l->next) {
+		const char *key = l->data;
+		JsonNode *node = json_object_get_member (object, key);
+		JsonArray *pair = NULL;
+		JsonNode *type_node, *value_node;
+		GType type = G_TYPE_INVALID;
+		GValue json_value = G_VALUE_INIT;
+		GValue *value;
+		gboolean valid;
+
+		/* Each parameter is a pair of its type name and its value. */
+		if (JSON_NODE_HOLDS_ARRAY (node) &&
+		    json_array_get_length (pair = json_node_get_array (node)) == 2 &&
+		    JSON_NODE_HOLDS_VALUE (type_node = json_array_get_element (pair, 0)) &&
+		    json_node_get_value_type (type_node) == G_TYPE_STRING)
+			type = g_type_from_name (json_node_get_string (type_node));
+
+		if (type == G_TYPE_INVALID || !G_TYPE_IS_VALUE_TYPE (type)) {
+			g_set_error (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+			             "Invalid type for parameter ‘%s’", key);
+			return NULL;
+		}
+
+		value = g_new0 (GValue, 1);
+		g_value_init (value, type);
+		value_node = json_array_get_element (pair, 1);
+
+		if (JSON_NODE_HOLDS_NULL (value_node)) {
+			valid = G_VALUE_HOLDS_STRING (value);
+		} else if (JSON_NODE_HOLDS_VALUE (value_node)) {
+			json_node_get_value (value_node, &json_value);
+			valid = g_value_transform (&json_value, value);
+			g_value_unset (&json_value);
+		} else {
+			valid = FALSE;
+		}
+
+		if (!valid) {
+			params_value_free (value);
+			g_set_error (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+			             "Invalid value for parameter ‘%s’", key);
+			return NULL;
+		}
+
+		g_hash_table_insert (params, g_strdup (key), value);
+	}
+
+	return g_steal_pointer (&params);
+}
+
+static GeocodeLocation *
+location_from_json (JsonObject  *object,
+                    GError     **error)
+{
+	gdouble latitude, longitude;
+	gdouble accuracy = GEOCODE_LOCATION_ACCURACY_UNKNOWN;
+	gdouble altitude = GEOCODE_LOCATION_ALTITUDE_UNKNOWN;
+	gint64 timestamp = 0;
+
+	if (!json_get_double_member (object, "latitude", &latitude) ||
+	    !json_get_double_member (object, "longitude", &longitude) ||
+	    !(latitude >= -90.0 && latitude <= 90.0) ||
+	    !(longitude >= -180.0 && longitude <= 180.0)) {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		                     "Invalid location coordinates");
+		return NULL;
+	}
+
+	json_get_double_member (object, "accuracy", &accuracy);
+	json_get_double_member (object, "altitude", &altitude);
+	_geocode_json_get_int_member (object, "timestamp", &timestamp);
+
+	return g_object_new (GEOCODE_TYPE_LOCATION,
+	                     "latitude", latitude,
+	                     "longitude", longitude,
+	                     "accuracy", MAX (accuracy, GEOCODE_LOCATION_ACCURACY_UNKNOWN),
+	                     "altitude", altitude,
+	                     "description", _geocode_json_get_string_member (object, "description"),
+	                     "timestamp", (guint64) MAX (timestamp, 0),
+	                     NULL);
+}
+
+/* Reads back a place written by _geocode_place_to_json(). */
+GeocodePlace *
+_geocode_place_from_json (JsonNode  *node,
+                          GError   **error)
+{
+	g_autoptr (GeocodePlace) place = NULL;
+	JsonObject *object, *location_object, *bbox_object;
+	const char *name;
+	gint place_type = GEOCODE_PLACE_TYPE_UNKNOWN;
+	gint osm_type = GEOCODE_PLACE_OSM_TYPE_UNKNOWN;
+	gsize i;
+
+	if (!JSON_NODE_HOLDS_OBJECT (node) ||
+	    (name = _geocode_json_get_string_member (json_node_get_object (node), "name")) == NULL) {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		                     "Expected a place with a name");
+		return NULL;
+	}
+
+	object = json_node_get_object (node);
+
+	if (!json_get_enum_member (object, "place-type", GEOCODE_TYPE_PLACE_TYPE,
+	                           &place_type) ||
+	    !json_get_enum_member (object, "osm-type", GEOCODE_TYPE_PLACE_OSM_TYPE,
+	                           &osm_type)) {
+		g_set_error (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		             "Invalid type for place ‘%s’", name);
+		return NULL;
+	}
+
+	place = geocode_place_new (name, place_type);
+	g_object_set (place, "osm-type", osm_type, NULL);
+
+	location_object = _geocode_json_get_object_member (object, "location");
+	if (location_object != NULL) {
+		g_autoptr (GeocodeLocation) location = NULL;
+
+		location = location_from_json (location_object, error);
+		if (location == NULL)
+			return NULL;
+
+		geocode_place_set_location (place, location);
+	}
+
+	bbox_object = _geocode_json_get_object_member (object, "bounding-box");
+	if (bbox_object != NULL) {
+		g_autoptr (GeocodeBoundingBox) bbox = NULL;
+		gdouble top, bottom, left, right;
+
+		if (!json_get_double_member (bbox_object, "top", &top) ||
+		    !json_get_double_member (bbox_object, "bottom", &bottom) ||
+		    !json_get_double_member (bbox_object, "left", &left) ||
+		    !json_get_double_member (bbox_object, "right", &right)) {
+			g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+			                     "Invalid bounding box");
+			return NULL;
+		}
+
+		bbox = geocode_bounding_box_new (top, bottom, left, right);
+		geocode_place_set_bounding_box (place, bbox);
+	}
+
+	for (i = 0; i < G_N_ELEMENTS (place_string_properties); i++) {
+		const char *value = _geocode_json_get_string_member (object, place_string_properties[i]);
+
+		if (value != NULL)
+			g_object_set (place, place_string_properties[i], value, NULL);
+	}
+
+	return g_steal_pointer (&place);
+}
+
+/* Normalizes a place name for matching against names from local indexes,
+ * so that differences in case, composition and surrounding whitespace are
+ * ignored. Returns %NULL if @name is %NULL or not valid UTF-8. */
+char *
+_geocode_normalize_name (const char *name)
+{
+	g_autofree char *normalized = NULL;
+
+	if (name == NULL || !g_utf8_validate (name, -1, NULL))
+		return NULL;
+
+	normalized = g_utf8_normalize (name, -1, G_NORMALIZE_ALL);
+	if (normalized == NULL)
+		return NULL;
+
+	return g_strstrip (g_utf8_casefold (normalized, -1));
+}
+
 static gboolean
 parse_lang (const char *locale,
 	    char      **language_codep,
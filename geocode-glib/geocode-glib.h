@@ -35,5 +35,16 @@
 #include <geocode-glib/geocode-backend.h>
 #include <geocode-glib/geocode-nominatim.h>
 #include <geocode-glib/geocode-mock-backend.h>
+#include <geocode-glib/geocode-place-index.h>
+#include <geocode-glib/geocode-stats.h>
+#include <geocode-glib/geocode-geo-uri.h>
+#include <geocode-glib/geocode-coordinate.h>
+#include <geocode-glib/geocode-gazetteer.h>
+#include <geocode-glib/geocode-boundary-backend.h>
+#include <geocode-glib/geocode-completion-backend.h>
+#include <geocode-glib/geocode-layered-backend.h>
+#include <geocode-glib/geocode-racing-backend.h>
+#include <geocode-glib/geocode-recording-backend.h>
+#include <geocode-glib/geocode-replay-backend.h>
 
 #endif /* GEOCODE_GLIB_H */
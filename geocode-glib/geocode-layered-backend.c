@@ -0,0 +1,726 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include <gio/gio.h>
+
+#include "geocode-glib-private.h"
+#include "geocode-glib.h"
+#include "geocode-layered-backend.h"
+
+/**
+ * SECTION:geocode-layered-backend
+ * @short_description: Geocode backend combining a local and a remote backend
+ * @include: geocode-glib/geocode-glib.h
+ *
+ * #GeocodeLayeredBackend answers queries from a fast local backend, such as
+ * a #GeocodeGazetteer or a #GeocodeCompletionBackend, and only queries a
+ * slower remote backend, such as a #GeocodeNominatim, when the local
+ * backend can’t answer. That is when the local backend has no matches for
+ * the query, does not support it, or returns fewer than
+ * #GeocodeLayeredBackend:min-results places.
+ *
+ * If the remote backend fails, any places returned by the local backend are
+ * returned instead, unless the query was cancelled. Places are returned as
+ * the backend which answered returned them, without being copied.
+ *
+ * After the remote backend answers a query, the
+ * #GeocodeLayeredBackend::write-back signal is emitted so that its answer
+ * can be stored in the local backend for next time. The signal is emitted
+ * from an idle callback in the thread-default main context of the thread
+ * which made the query, for blocking and asynchronous queries alike, so
+ * storing the answer does not delay the query. If the local backend is a
+ * #GeocodeMockBackend, the answer is added to it by default.
+ *
+ * |[<!-- language="C" -->
+ * g_autoptr (GeocodeGazetteer) gazetteer = NULL;
+ * g_autoptr (GeocodeNominatim) nominatim = NULL;
+ * g_autoptr (GeocodeLayeredBackend) backend = NULL;
+ *
+ * gazetteer = geocode_gazetteer_new (path, &error);
+ * nominatim = geocode_nominatim_get_gnome ();
+ * backend = geocode_layered_backend_new (GEOCODE_BACKEND (gazetteer),
+ *                                        GEOCODE_BACKEND (nominatim));
+ * geocode_forward_set_backend (forward, GEOCODE_BACKEND (backend));
+ * ]|
+ *
+ * Since: 3.28
+ */
+
+struct _GeocodeLayeredBackend {
+	GObject parent;
+
+	GeocodeBackend *local;  /* (owned) */
+	GeocodeBackend *remote;  /* (owned) */
+	guint min_results;  /* (atomic) */
+};
+
+typedef enum {
+	PROP_LOCAL = 1,
+	PROP_REMOTE,
+	PROP_MIN_RESULTS,
+} GeocodeLayeredBackendProperty;
+
+static GParamSpec *properties[PROP_MIN_RESULTS + 1];
+
+typedef enum {
+	SIGNAL_WRITE_BACK,
+} GeocodeLayeredBackendSignal;
+
+static guint signals[SIGNAL_WRITE_BACK + 1];
+
+static void geocode_backend_iface_init (GeocodeBackendInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GeocodeLayeredBackend, geocode_layered_backend, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (GEOCODE_TYPE_BACKEND,
+                                                geocode_backend_iface_init))
+
+/******************************************************************************/
+
+static void
+places_list_free (GList *places)
+{
+	g_list_free_full (places, g_object_unref);
+}
+
+static GList *
+backend_query (GeocodeBackend  *backend,
+               gboolean         is_forward,
+               GHashTable      *params,
+               GCancellable    *cancellable,
+               GError         **error)
+{
+	if (is_forward)
+		return geocode_backend_forward_search (backend, params,
+		                                       cancellable, error);
+	else
+		return geocode_backend_reverse_resolve (backend, params,
+		                                        cancellable, error);
+}
+
+static void
+backend_query_async (GeocodeBackend      *backend,
+                     gboolean             is_forward,
+                     GHashTable          *params,
+                     GCancellable        *cancellable,
+                     GAsyncReadyCallback  callback,
+                     gpointer             user_data)
+{
+	if (is_forward)
+		geocode_backend_forward_search_async (backend, params, cancellable,
+		                                      callback, user_data);
+	else
+		geocode_backend_reverse_resolve_async (backend, params, cancellable,
+		                                       callback, user_data);
+}
+
+static GList *
+backend_query_finish (GeocodeBackend  *backend,
+                      gboolean         is_forward,
+                      GAsyncResult    *result,
+                      GError         **error)
+{
+	if (is_forward)
+		return geocode_backend_forward_search_finish (backend, result, error);
+	else
+		return geocode_backend_reverse_resolve_finish (backend, result, error);
+}
+
+/* Whether the local backend’s answer means that the remote backend should
+ * be queried. Backends report an empty result as %GEOCODE_ERROR_NO_MATCHES
+ * for forward queries and %GEOCODE_ERROR_NOT_SUPPORTED for reverse ones. */
+static gboolean
+is_local_miss (GeocodeLayeredBackend *self,
+               GList                 *places,
+               const GError          *error)
+{
+	if (error != NULL)
+		return g_error_matches (error, GEOCODE_ERROR, GEOCODE_ERROR_NO_MATCHES) ||
+		       g_error_matches (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED) ||
+		       g_error_matches (error, GEOCODE_ERROR, GEOCODE_ERROR_INVALID_ARGUMENTS);
+
+	return g_list_length (places) < (guint) g_atomic_int_get (&self->min_results);
+}
+
+typedef struct {
+	GeocodeLayeredBackend *self;  /* (owned) */
+	gboolean is_forward;
+	GHashTable *params;  /* (owned) */
+	GList *places;  /* (owned) (element-type GeocodePlace) */
+} WriteBack;
+
+static void
+write_back_free (WriteBack *write_back)
+{
+	g_object_unref (write_back->self);
+	g_hash_table_unref (write_back->params);
+	places_list_free (write_back->places);
+	g_free (write_back);
+}
+
+static gboolean
+write_back_cb (gpointer user_data)
+{
+	WriteBack *write_back = user_data;
+
+	g_signal_emit (write_back->self, signals[SIGNAL_WRITE_BACK], 0,
+	               write_back->is_forward, write_back->params,
+	               write_back->places);
+
+	return G_SOURCE_REMOVE;
+}
+
+/* The caller owns @places once the query returns, so only references to
+ * them are kept for the write back. @context is the thread-default main
+ * context of the query, captured when it started. */
+static void
+schedule_write_back (GeocodeLayeredBackend *self,
+                     GMainContext          *context,
+                     gboolean               is_forward,
+                     GHashTable            *params,
+                     GList                 *places)
+{
+	g_autoptr (GSource) source = NULL;
+	WriteBack *write_back;
+
+	write_back = g_new0 (WriteBack, 1);
+	write_back->self = g_object_ref (self);
+	write_back->is_forward = is_forward;
+	write_back->params = _geocode_params_copy (params);
+	write_back->places = g_list_copy_deep (places, (GCopyFunc) g_object_ref, NULL);
+
+	source = g_idle_source_new ();
+	g_source_set_callback (source, write_back_cb, write_back,
+	                       (GDestroyNotify) write_back_free);
+	g_source_set_name (source, "GeocodeLayeredBackend write back");
+	g_source_attach (source, context);
+}
+
+static GList *
+layered_query (GeocodeLayeredBackend  *self,
+               gboolean                is_forward,
+               GHashTable             *params,
+               GCancellable           *cancellable,
+               GError                **error)
+{
+	GList *local_places, *remote_places;
+	GError *local_error = NULL, *remote_error = NULL;
+	g_autoptr (GMainContext) context = g_main_context_ref_thread_default ();
+
+	local_places = backend_query (self->local, is_forward, params,
+	                              cancellable, &local_error);
+
+	if (!is_local_miss (self, local_places, local_error)) {
+		if (local_error != NULL)
+			g_propagate_error (error, local_error);
+		return local_places;
+	}
+
+	g_clear_error (&local_error);
+
+	remote_places = backend_query (self->remote, is_forward, params,
+	                               cancellable, &remote_error);
+
+	if (remote_error != NULL && local_places != NULL &&
+	    !g_error_matches (remote_error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+		g_error_free (remote_error);
+		return local_places;
+	} else if (remote_error != NULL) {
+		places_list_free (local_places);
+		g_propagate_error (error, remote_error);
+		return NULL;
+	}
+
+	places_list_free (local_places);
+
+	schedule_write_back (self, context, is_forward, params, remote_places);
+
+	return remote_places;
+}
+
+typedef struct {
+	gboolean is_forward;
+	GHashTable *params;  /* (owned) */
+	GList *local_places;  /* (owned) (nullable) (element-type GeocodePlace) */
+} QueryData;
+
+static void
+query_data_free (QueryData *data)
+{
+	g_hash_table_unref (data->params);
+	places_list_free (data->local_places);
+	g_free (data);
+}
+
+static void
+remote_query_cb (GObject      *source_object,
+                 GAsyncResult *result,
+                 gpointer      user_data)
+{
+	g_autoptr (GTask) task = G_TASK (user_data);
+	GeocodeLayeredBackend *self = g_task_get_source_object (task);
+	QueryData *data = g_task_get_task_data (task);
+	GList *places;
+	GError *error = NULL;
+
+	places = backend_query_finish (GEOCODE_BACKEND (source_object),
+	                               data->is_forward, result, &error);
+
+	if (error != NULL && data->local_places != NULL &&
+	    !g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+		g_error_free (error);
+		g_task_return_pointer (task, g_steal_pointer (&data->local_places),
+		                       (GDestroyNotify) places_list_free);
+	} else if (error != NULL) {
+		g_task_return_error (task, error);
+	} else {
+		schedule_write_back (self, g_task_get_context (task),
+		                     data->is_forward, data->params, places);
+		g_task_return_pointer (task, places,
+		                       (GDestroyNotify) places_list_free);
+	}
+}
+
+static void
+local_query_cb (GObject      *source_object,
+                GAsyncResult *result,
+                gpointer      user_data)
+{
+	g_autoptr (GTask) task = G_TASK (user_data);
+	GeocodeLayeredBackend *self = g_task_get_source_object (task);
+	QueryData *data = g_task_get_task_data (task);
+	GList *places;
+	GError *error = NULL;
+
+	places = backend_query_finish (GEOCODE_BACKEND (source_object),
+	                               data->is_forward, result, &error);
+
+	if (!is_local_miss (self, places, error)) {
+		if (error != NULL)
+			g_task_return_error (task, error);
+		else
+			g_task_return_pointer (task, places,
+			                       (GDestroyNotify) places_list_free);
+		return;
+	}
+
+	g_clear_error (&error);
+	data->local_places = places;
+
+	backend_query_async (self->remote, data->is_forward, data->params,
+	                     g_task_get_cancellable (task),
+	                     remote_query_cb, g_steal_pointer (&task));
+}
+
+static void
+layered_query_async (GeocodeLayeredBackend *self,
+                     gboolean               is_forward,
+                     gpointer               source_tag,
+                     GHashTable            *params,
+                     GCancellable          *cancellable,
+                     GAsyncReadyCallback    callback,
+                     gpointer               user_data)
+{
+	g_autoptr (GTask) task = NULL;
+	QueryData *data;
+
+	task = g_task_new (self, cancellable, callback, user_data);
+	g_task_set_source_tag (task, source_tag);
+
+	data = g_new0 (QueryData, 1);
+	data->is_forward = is_forward;
+	data->params = g_hash_table_ref (params);
+	g_task_set_task_data (task, data, (GDestroyNotify) query_data_free);
+
+	backend_query_async (self->local, is_forward, params, cancellable,
+	                     local_query_cb, g_steal_pointer (&task));
+}
+
+/******************************************************************************/
+
+static GList *
+geocode_layered_backend_forward_search (GeocodeBackend  *backend,
+                                        GHashTable      *params,
+                                        GCancellable    *cancellable,
+                                        GError         **error)
+{
+	return layered_query (GEOCODE_LAYERED_BACKEND (backend), TRUE, params,
+	                      cancellable, error);
+}
+
+static void
+geocode_layered_backend_forward_search_async (GeocodeBackend      *backend,
+                                              GHashTable          *params,
+                                              GCancellable        *cancellable,
+                                              GAsyncReadyCallback  callback,
+                                              gpointer             user_data)
+{
+	layered_query_async (GEOCODE_LAYERED_BACKEND (backend), TRUE,
+	                     geocode_layered_backend_forward_search_async,
+	                     params, cancellable, callback, user_data);
+}
+
+static GList *
+geocode_layered_backend_forward_search_finish (GeocodeBackend  *backend,
+                                               GAsyncResult    *result,
+                                               GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static GList *
+geocode_layered_backend_reverse_resolve (GeocodeBackend  *backend,
+                                         GHashTable      *params,
+                                         GCancellable    *cancellable,
+                                         GError         **error)
+{
+	return layered_query (GEOCODE_LAYERED_BACKEND (backend), FALSE, params,
+	                      cancellable, error);
+}
+
+static void
+geocode_layered_backend_reverse_resolve_async (GeocodeBackend      *backend,
+                                               GHashTable          *params,
+                                               GCancellable        *cancellable,
+                                               GAsyncReadyCallback  callback,
+                                               gpointer             user_data)
+{
+	layered_query_async (GEOCODE_LAYERED_BACKEND (backend), FALSE,
+	                     geocode_layered_backend_reverse_resolve_async,
+	                     params, cancellable, callback, user_data);
+}
+
+static GList *
+geocode_layered_backend_reverse_resolve_finish (GeocodeBackend  *backend,
+                                                GAsyncResult    *result,
+                                                GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/******************************************************************************/
+
+static void
+geocode_layered_backend_real_write_back (GeocodeLayeredBackend *self,
+                                         gboolean               is_forward,
+                                         GHashTable            *params,
+                                         GList                 *places)
+{
+	if (!GEOCODE_IS_MOCK_BACKEND (self->local))
+		return;
+
+	if (is_forward)
+		geocode_mock_backend_add_forward_result (GEOCODE_MOCK_BACKEND (self->local),
+		                                         params, places, NULL);
+	else
+		geocode_mock_backend_add_reverse_result (GEOCODE_MOCK_BACKEND (self->local),
+		                                         params, places, NULL);
+}
+
+/**
+ * geocode_layered_backend_new:
+ * @local: backend to query first
+ * @remote: backend to query when @local can’t answer
+ *
+ * Creates a new backend which queries @remote only when @local can’t answer.
+ *
+ * Returns: (transfer full): a new #GeocodeLayeredBackend. Use
+ * g_object_unref() when done.
+ *
+ * Since: 3.28
+ */
+GeocodeLayeredBackend *
+geocode_layered_backend_new (GeocodeBackend *local,
+                             GeocodeBackend *remote)
+{
+	g_return_val_if_fail (GEOCODE_IS_BACKEND (local), NULL);
+	g_return_val_if_fail (GEOCODE_IS_BACKEND (remote), NULL);
+
+	return GEOCODE_LAYERED_BACKEND (g_object_new (GEOCODE_TYPE_LAYERED_BACKEND,
+	                                              "local", local,
+	                                              "remote", remote,
+	                                              NULL));
+}
+
+/**
+ * geocode_layered_backend_get_local:
+ * @self: a #GeocodeLayeredBackend
+ *
+ * Gets the #GeocodeLayeredBackend:local backend.
+ *
+ * Returns: (transfer none): the local backend
+ *
+ * Since: 3.28
+ */
+GeocodeBackend *
+geocode_layered_backend_get_local (GeocodeLayeredBackend *self)
+{
+	g_return_val_if_fail (GEOCODE_IS_LAYERED_BACKEND (self), NULL);
+
+	return self->local;
+}
+
+/**
+ * geocode_layered_backend_get_remote:
+ * @self: a #GeocodeLayeredBackend
+ *
+ * Gets the #GeocodeLayeredBackend:remote backend.
+ *
+ * Returns: (transfer none): the remote backend
+ *
+ * Since: 3.28
+ */
+GeocodeBackend *
+geocode_layered_backend_get_remote (GeocodeLayeredBackend *self)
+{
+	g_return_val_if_fail (GEOCODE_IS_LAYERED_BACKEND (self), NULL);
+
+	return self->remote;
+}
+
+/**
+ * geocode_layered_backend_get_min_results:
+ * @self: a #GeocodeLayeredBackend
+ *
+ * Gets the #GeocodeLayeredBackend:min-results property.
+ *
+ * Returns: the fewest local results which are returned without querying
+ *    the remote backend
+ *
+ * Since: 3.28
+ */
+guint
+geocode_layered_backend_get_min_results (GeocodeLayeredBackend *self)
+{
+	g_return_val_if_fail (GEOCODE_IS_LAYERED_BACKEND (self), 0);
+
+	return g_atomic_int_get (&self->min_results);
+}
+
+/**
+ * geocode_layered_backend_set_min_results:
+ * @self: a #GeocodeLayeredBackend
+ * @min_results: the fewest local results which are returned without querying
+ *    the remote backend
+ *
+ * Sets the #GeocodeLayeredBackend:min-results property. This may be called
+ * while queries are running.
+ *
+ * Since: 3.28
+ */
+void
+geocode_layered_backend_set_min_results (GeocodeLayeredBackend *self,
+                                         guint                  min_results)
+{
+	g_return_if_fail (GEOCODE_IS_LAYERED_BACKEND (self));
+
+	if ((guint) g_atomic_int_get (&self->min_results) == min_results)
+		return;
+
+	g_atomic_int_set (&self->min_results, min_results);
+	g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MIN_RESULTS]);
+}
+
+static void
+geocode_layered_backend_init (GeocodeLayeredBackend *self)
+{
+	self->min_results = 1;
+}
+
+static void
+geocode_layered_backend_get_property (GObject    *object,
+                                      guint       property_id,
+                                      GValue     *value,
+                                      GParamSpec *pspec)
+{
+	GeocodeLayeredBackend *self = GEOCODE_LAYERED_BACKEND (object);
+
+	switch ((GeocodeLayeredBackendProperty) property_id) {
+	case PROP_LOCAL:
+		g_value_set_object (value, self->local);
+		break;
+	case PROP_REMOTE:
+		g_value_set_object (value, self->remote);
+		break;
+	case PROP_MIN_RESULTS:
+		g_value_set_uint (value, geocode_layered_backend_get_min_results (self));
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+		break;
+	}
+}
+
+static void
+geocode_layered_backend_set_property (GObject      *object,
+                                      guint         property_id,
+                                      const GValue *value,
+                                      GParamSpec   *pspec)
+{
+	GeocodeLayeredBackend *self = GEOCODE_LAYERED_BACKEND (object);
+
+	switch ((GeocodeLayeredBackendProperty) property_id) {
+	case PROP_LOCAL:
+		/* Construct only. */
+		g_assert (self->local == NULL);
+		self->local = g_value_dup_object (value);
+		break;
+	case PROP_REMOTE:
+		/* Construct only. */
+		g_assert (self->remote == NULL);
+		self->remote = g_value_dup_object (value);
+		break;
+	case PROP_MIN_RESULTS:
+		geocode_layered_backend_set_min_results (self, g_value_get_uint (value));
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+		break;
+	}
+}
+
+static void
+geocode_layered_backend_constructed (GObject *object)
+{
+	GeocodeLayeredBackend *self = GEOCODE_LAYERED_BACKEND (object);
+
+	G_OBJECT_CLASS (geocode_layered_backend_parent_class)->constructed (object);
+
+	g_assert (self->local != NULL);
+	g_assert (self->remote != NULL);
+}
+
+static void
+geocode_layered_backend_finalize (GObject *object)
+{
+	GeocodeLayeredBackend *self = GEOCODE_LAYERED_BACKEND (object);
+
+	g_clear_object (&self->local);
+	g_clear_object (&self->remote);
+
+	G_OBJECT_CLASS (geocode_layered_backend_parent_class)->finalize (object);
+}
+
+static void
+geocode_backend_iface_init (GeocodeBackendInterface *iface)
+{
+	iface->forward_search = geocode_layered_backend_forward_search;
+	iface->forward_search_async = geocode_layered_backend_forward_search_async;
+	iface->forward_search_finish = geocode_layered_backend_forward_search_finish;
+	iface->reverse_resolve = geocode_layered_backend_reverse_resolve;
+	iface->reverse_resolve_async = geocode_layered_backend_reverse_resolve_async;
+	iface->reverse_resolve_finish = geocode_layered_backend_reverse_resolve_finish;
+}
+
+static void
+geocode_layered_backend_class_init (GeocodeLayeredBackendClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->get_property = geocode_layered_backend_get_property;
+	object_class->set_property = geocode_layered_backend_set_property;
+	object_class->constructed = geocode_layered_backend_constructed;
+	object_class->finalize = geocode_layered_backend_finalize;
+
+	/**
+	 * GeocodeLayeredBackend:local:
+	 *
+	 * The backend which is queried first.
+	 *
+	 * Since: 3.28
+	 */
+	properties[PROP_LOCAL] = g_param_spec_object ("local",
+	                                              "Local",
+	                                              "Backend which is queried first",
+	                                              GEOCODE_TYPE_BACKEND,
+	                                              (G_PARAM_READWRITE |
+	                                               G_PARAM_CONSTRUCT_ONLY |
+	                                               G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * GeocodeLayeredBackend:remote:
+	 *
+	 * The backend which is queried when the local backend can’t answer.
+	 *
+	 * Since: 3.28
+	 */
+	properties[PROP_REMOTE] = g_param_spec_object ("remote",
+	                                               "Remote",
+	                                               "Backend which is queried when the local backend can’t answer",
+	                                               GEOCODE_TYPE_BACKEND,
+	                                               (G_PARAM_READWRITE |
+	                                                G_PARAM_CONSTRUCT_ONLY |
+	                                                G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * GeocodeLayeredBackend:min-results:
+	 *
+	 * The fewest places the local backend must return for its answer to be
+	 * used. If it returns fewer, the remote backend is queried too, and
+	 * its answer is used if it succeeds. Zero means that any successful
+	 * local answer is used.
+	 *
+	 * Since: 3.28
+	 */
+	properties[PROP_MIN_RESULTS] = g_param_spec_uint ("min-results",
+	                                                  "Minimum Results",
+	                                                  "Fewest local places which are used without querying the remote backend",
+	                                                  0, G_MAXUINT, 1,
+	                                                  (G_PARAM_READWRITE |
+	                                                   G_PARAM_EXPLICIT_NOTIFY |
+	                                                   G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_properties (object_class,
+	                                   G_N_ELEMENTS (properties), properties);
+
+	/**
+	 * GeocodeLayeredBackend::write-back:
+	 * @self: a #GeocodeLayeredBackend
+	 * @is_forward: %TRUE for a forward query, %FALSE for a reverse one
+	 * @params: (element-type utf8 GValue): the query parameters
+	 * @places: (element-type GeocodePlace): the places returned by the remote
+	 *    backend
+	 *
+	 * Emitted after the remote backend has answered a query, so that the
+	 * answer can be stored in the local backend. It is emitted from an idle
+	 * callback in the thread-default main context of the thread which made
+	 * the query, after the query has returned, so it is only emitted once
+	 * that context is iterated.
+	 *
+	 * If the local backend is a #GeocodeMockBackend, the default handler
+	 * adds the answer to it. Call g_signal_stop_emission_by_name() from a
+	 * handler to prevent that.
+	 *
+	 * Since: 3.28
+	 */
+	signals[SIGNAL_WRITE_BACK] =
+	    g_signal_new_class_handler ("write-back",
+	                                G_TYPE_FROM_CLASS (klass),
+	                                G_SIGNAL_RUN_LAST,
+	                                G_CALLBACK (geocode_layered_backend_real_write_back),
+	                                NULL, NULL, NULL,
+	                                G_TYPE_NONE, 3,
+	                                G_TYPE_BOOLEAN,
+	                                G_TYPE_HASH_TABLE,
+	                                G_TYPE_POINTER);
+}
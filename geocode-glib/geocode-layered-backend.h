@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#ifndef GEOCODE_LAYERED_BACKEND_H
+#define GEOCODE_LAYERED_BACKEND_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "geocode-backend.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GeocodeLayeredBackend:
+ *
+ * All the fields in the #GeocodeLayeredBackend structure are private and
+ * should never be accessed directly.
+ *
+ * Since: 3.28
+ */
+#define GEOCODE_TYPE_LAYERED_BACKEND (geocode_layered_backend_get_type ())
+G_DECLARE_FINAL_TYPE (GeocodeLayeredBackend, geocode_layered_backend,
+                      GEOCODE, LAYERED_BACKEND, GObject)
+
+/**
+ * GEOCODE_TYPE_LAYERED_BACKEND:
+ *
+ * See #GeocodeLayeredBackend.
+ *
+ * Since: 3.28
+ */
+
+GeocodeLayeredBackend *geocode_layered_backend_new (GeocodeBackend *local,
+                                                    GeocodeBackend *remote);
+
+GeocodeBackend *geocode_layered_backend_get_local  (GeocodeLayeredBackend *self);
+GeocodeBackend *geocode_layered_backend_get_remote (GeocodeLayeredBackend *self);
+
+guint geocode_layered_backend_get_min_results (GeocodeLayeredBackend *self);
+void  geocode_layered_backend_set_min_results (GeocodeLayeredBackend *self,
+                                               guint                  min_results);
+
+G_END_DECLS
+
+#endif /* GEOCODE_LAYERED_BACKEND_H */
@@ -26,6 +26,8 @@
 #include <math.h>
 #include <string.h>
 #include "geocode-location.h"
+#include "geocode-geo-uri.h"
+#include "geocode-glib-private.h"
 
 #define EARTH_RADIUS_KM 6372.795
 
@@ -290,269 +292,6 @@ geocode_location_set_property(GObject      *object,
         }
 }
 
-static gboolean
-parse_geo_uri_special_parameters (GeocodeLocation *loc,
-                                  const char      *params,
-                                  GError         **error)
-{
-        GeocodeLocationPrivate *priv;
-        char *end_ptr;
-        char *next_token;
-        char *description;
-        char *token_end;
-        int description_len;
-
-        priv = geocode_location_get_instance_private (loc);
-
-        if (priv->latitude != 0 || priv->longitude != 0)
-            goto err;
-
-        if (strncmp (params, "q=", 2) != 0)
-                goto err;
-
-        next_token = ((char *)params) + 2;
-
-        priv->latitude = g_ascii_strtod (next_token, &end_ptr);
-        if (*end_ptr != ',' || *end_ptr == *params)
-                goto err;
-        next_token = end_ptr + 1;
-
-        priv->longitude = g_ascii_strtod (next_token, &end_ptr);
-        if (*end_ptr == *next_token)
-                goto err;
-
-        if (*end_ptr != '(' || *end_ptr == *next_token)
-                goto err;
-        next_token = end_ptr + 1;
-
-        if ((token_end = strchr (next_token, ')')) == NULL)
-                goto err;
-
-        description_len = token_end - next_token;
-        if (description_len <= 0)
-            goto err;
-
-        description = g_uri_unescape_segment (next_token,
-                                              next_token + description_len,
-                                              NULL);
-        geocode_location_set_description (loc, description);
-        g_free (description);
-        return TRUE;
-
- err:
-        g_set_error_literal (error,
-                             GEOCODE_ERROR,
-                             GEOCODE_ERROR_PARSE,
-                             "Failed to parse geo URI parameters");
-        return FALSE;
-}
-
-/*
-  From RFC 5870:
-      Both 'crs' and 'u' parameters MUST NOT appear more than once each.
-      The 'crs' and 'u' parameters MUST be given before any other
-      parameters that may be defined in future extensions.  The 'crs'
-      parameter MUST be given first if both 'crs' and 'u' are used.
- */
-static gboolean
-parse_geo_uri_parameters (GeocodeLocation *loc,
-                          const char      *params,
-                          GError         **error)
-{
-        GeocodeLocationPrivate *priv;
-        char **parameters;
-        char *endptr;
-        char *val;
-        char *u = NULL;
-        char *crs = NULL;
-        int i;
-        int ret = TRUE;
-
-        priv = geocode_location_get_instance_private (loc);
-        parameters = g_strsplit (params, ";", 256);
-        if (parameters[0] == NULL)
-                goto err;
-
-        for (i = 0; parameters[i] != NULL; i++) {
-                if (g_str_has_prefix (parameters[i], "crs=")) {
-                        /*
-                         * if crs parameter is given, it has to be the first one
-                         */
-                        if (i != 0)
-                                goto err;
-
-                        crs = parameters[i];
-                } else if (g_str_has_prefix (parameters[i], "u=")) {
-                        /*
-                         * u parameter is either first one or after crs parameter and
-                         * has to appear only once in the parameter list
-                         */
-                        if ((crs == NULL && i != 0) || (crs != NULL && i != 1) || u != NULL)
-                                goto err;
-
-                        u = parameters[i];
-                }
-        }
-
-        if (u != NULL) {
-                val = u + 2; /* len of 'u=' */
-                priv->accuracy = g_ascii_strtod (val, &endptr);
-                if (*endptr != '\0' && *endptr != ';')
-                        goto err;
-        }
-
-        if (crs != NULL) {
-                val = crs + 4; /* len of 'crs=' */
-                if (g_strcmp0 (val, "wgs84"))
-                        goto err;
-        }
-        goto out;
-
- err:
-        ret = FALSE;
-        g_set_error_literal (error,
-                             GEOCODE_ERROR,
-                             GEOCODE_ERROR_PARSE,
-                             "Failed to parse geo URI parameters");
- out:
-       g_strfreev (parameters);
-       return ret;
-}
-
-/*
-   From RFC 5870:
-      geo-URI       = geo-scheme ":" geo-path
-      geo-scheme    = "geo"
-      geo-path      = coordinates p
-      coordinates   = coord-a "," coord-b [ "," coord-c ]
-
-      [...]
-
-      The value of "-0" for <num> is allowed and is identical to "0".
-
-      In case the URI identifies a location in the default CRS of WGS-84,
-      the <coordinates> sub-components are further restricted as follows:
-
-      coord-a        = latitude
-      coord-b        = longitude
-      coord-c        = altitude
-
-      latitude       = [ "-" ] 1*2DIGIT [ "." 1*DIGIT ]
-      longitude      = [ "-" ] 1*3DIGIT [ "." 1*DIGIT ]
-      altitude       = [ "-" ] 1*DIGIT [ "." 1*DIGIT ]
-
-       p             = [ crsp ] [ uncp ] *parameter
-       crsp          = ";crs=" crslabel
-       crslabel      = "wgs84" / labeltext
-       uncp          = ";u=" uval
-       uval          = pnum
-
-       parameter     = ";" pname [ "=" pvalue ]
-       pname         = labeltext
-       pvalue        = 1*paramchar
-       paramchar     = p-unreserved / unreserved / pct-encoded
-
-       labeltext     = 1*( alphanum / "-" )
-       pnum          = 1*DIGIT [ "." 1*DIGIT ]
-       num           = [ "-" ] pnum
-       unreserved    = alphanum / mark
-       mark          = "-" / "_" / "." / "!" / "~" / "*" /
-                        "'" / "(" / ")"
-       pct-encoded   = "%" HEXDIG HEXDIG
-*/
-static gboolean
-parse_geo_uri (GeocodeLocation *loc,
-               const char      *uri,
-               GError         **error)
-{
-        GeocodeLocationPrivate *priv;
-        const char *uri_part;
-        char *end_ptr;
-        char *next_token;
-        const char *s;
-
-        priv = geocode_location_get_instance_private (loc);
-        /* bail out if we encounter whitespace in uri */
-        s = uri;
-        while (*s) {
-                if (g_ascii_isspace (*s++))
-                        goto err;
-        }
-
-        uri_part = (const char *) uri + strlen("geo") + 1;
-
-        /* g_ascii_strtod is locale safe */
-        priv->latitude = g_ascii_strtod (uri_part, &end_ptr);
-        if (*end_ptr != ',' || *end_ptr == *uri_part) {
-                goto err;
-        }
-        next_token = end_ptr + 1;
-
-        priv->longitude = g_ascii_strtod (next_token, &end_ptr);
-        if (*end_ptr == *next_token) {
-                goto err;
-        }
-        if (*end_ptr == ',') {
-                next_token = end_ptr + 1;
-                priv->altitude = g_ascii_strtod (next_token, &end_ptr);
-                if (*end_ptr == *next_token) {
-                        goto err;
-                }
-        }
-        if (*end_ptr == ';') {
-                next_token = end_ptr + 1;
-                return parse_geo_uri_parameters (loc, next_token, error);
-        } else if (*end_ptr == '?') {
-                next_token = end_ptr + 1;
-                return parse_geo_uri_special_parameters (loc,
-                                                         next_token,
-                                                         error);
-        } else if (*end_ptr == '\0') {
-                return TRUE;
-        }
- err:
-        g_set_error_literal (error,
-                             GEOCODE_ERROR,
-                             GEOCODE_ERROR_PARSE,
-                             "Failed to parse geo URI");
-        return FALSE;
-}
-
-static gboolean
-parse_uri (GeocodeLocation *location,
-           const char      *uri,
-           GError         **error)
-{
-        char *scheme;
-        int ret = TRUE;
-
-        scheme = g_uri_parse_scheme (uri);
-        if (scheme == NULL) {
-                ret = FALSE;
-                goto err;
-        }
-
-        if (g_strcmp0 (scheme, "geo") == 0) {
-                if (!parse_geo_uri (location, uri, error))
-                        ret = FALSE;
-                goto out;
-        } else {
-                ret = FALSE;
-                goto err;
-        }
-
- err:
-        if (error) {
-                g_set_error_literal (error,
-                                     GEOCODE_ERROR,
-                                     GEOCODE_ERROR_NOT_SUPPORTED,
-                                     "Unsupported or invalid URI scheme");
-        }
- out:
-        g_free (scheme);
-        return ret;
-}
-
 static void
 geocode_location_finalize (GObject *glocation)
 {
@@ -746,6 +485,56 @@ geocode_location_new_with_description (gdouble     latitude,
                              NULL);
 }
 
+/**
+ * geocode_location_new_for_coordinate:
+ * @coord: a #GeocodeCoordinate with a valid latitude and longitude
+ *
+ * Creates a new #GeocodeLocation object with the coordinates of @coord,
+ * including its altitude.
+ *
+ * Returns: a new #GeocodeLocation object. Use g_object_unref() when done.
+ *
+ * Since: 3.28
+ **/
+GeocodeLocation *
+geocode_location_new_for_coordinate (const GeocodeCoordinate *coord)
+{
+        g_return_val_if_fail (coord != NULL, NULL);
+
+        return g_object_new (GEOCODE_TYPE_LOCATION,
+                             "latitude", coord->latitude,
+                             "longitude", coord->longitude,
+                             "altitude", coord->altitude,
+                             "accuracy", coord->accuracy,
+                             NULL);
+}
+
+/**
+ * geocode_location_get_coordinate:
+ * @loc: a #GeocodeLocation
+ * @coord: (out caller-allocates): return location for the coordinates
+ *
+ * Copies the latitude, longitude, altitude and accuracy of @loc to @coord.
+ *
+ * Since: 3.28
+ **/
+void
+geocode_location_get_coordinate (GeocodeLocation   *loc,
+                                 GeocodeCoordinate *coord)
+{
+        GeocodeLocationPrivate *priv;
+
+        g_return_if_fail (GEOCODE_IS_LOCATION (loc));
+        g_return_if_fail (coord != NULL);
+
+        priv = geocode_location_get_instance_private (loc);
+
+        coord->latitude = priv->latitude;
+        coord->longitude = priv->longitude;
+        coord->altitude = priv->altitude;
+        coord->accuracy = priv->accuracy;
+}
+
 /**
  * geocode_location_set_from_uri:
  * @loc: a #GeocodeLocation
@@ -765,6 +554,9 @@ geocode_location_new_with_description (gdouble     latitude,
  *
  * - geo:0,0?q=latitude,longitude(description)
  *
+ * @loc is only modified if @uri is valid. See geocode_geo_uri_parse() to
+ * parse a URI without a #GeocodeLocation.
+ *
  * Returns: %TRUE on success and %FALSE on error.
  **/
 gboolean
@@ -772,7 +564,36 @@ geocode_location_set_from_uri (GeocodeLocation *loc,
                                const char      *uri,
                                GError         **error)
 {
-        return parse_uri (loc, uri, error);
+        GeocodeLocationPrivate *priv;
+        GeocodeGeoUri geo_uri;
+
+        g_return_val_if_fail (GEOCODE_IS_LOCATION (loc), FALSE);
+        g_return_val_if_fail (uri != NULL, FALSE);
+
+        if (!geocode_geo_uri_parse (uri, &geo_uri, error))
+                return FALSE;
+
+        priv = geocode_location_get_instance_private (loc);
+
+        priv->latitude = geo_uri.latitude;
+        priv->longitude = geo_uri.longitude;
+        if (geo_uri.has_altitude)
+                priv->altitude = geo_uri.altitude;
+        if (geo_uri.has_accuracy)
+                priv->accuracy = geo_uri.accuracy;
+
+        if (geo_uri.description != NULL) {
+                char *description;
+
+                description = g_uri_unescape_segment (geo_uri.description,
+                                                      geo_uri.description +
+                                                      geo_uri.description_len,
+                                                      NULL);
+                geocode_location_set_description (loc, description);
+                g_free (description);
+        }
+
+        return TRUE;
 }
 
 /**
@@ -924,61 +745,22 @@ geocode_location_get_timestamp (GeocodeLocation *loc)
         return priv->timestamp;
 }
 
-static gdouble
-round_coord_n (gdouble coord, guint n)
-{
-  gdouble fac = pow (10, n);
-
-  return round (coord * fac) / fac;
-}
-
 static char *
 geo_uri_from_location (GeocodeLocation *loc)
 {
         GeocodeLocationPrivate *priv;
-        guint precision = 6; /* 0.1 meter precision */
-        char *uri;
-        char *coords;
-        char *params;
-        const char *crs = "wgs84";
-        char lat[G_ASCII_DTOSTR_BUF_SIZE];
-        char lon[G_ASCII_DTOSTR_BUF_SIZE];
-        char alt[G_ASCII_DTOSTR_BUF_SIZE];
-        char acc[G_ASCII_DTOSTR_BUF_SIZE];
-
-        g_return_val_if_fail (GEOCODE_IS_LOCATION (loc), NULL);
+        char uri[GEOCODE_GEO_URI_BUFFER_SIZE];
+        gsize len;
 
         priv = geocode_location_get_instance_private (loc);
-        g_ascii_formatd (lat,
-                         G_ASCII_DTOSTR_BUF_SIZE,
-                         "%.6f",
-                         round_coord_n (priv->latitude, precision));
-        g_ascii_formatd (lon,
-                         G_ASCII_DTOSTR_BUF_SIZE,
-                         "%.6f",
-                         round_coord_n (priv->longitude, precision));
-
-        if (priv->altitude != GEOCODE_LOCATION_ALTITUDE_UNKNOWN) {
-                g_ascii_dtostr (alt, G_ASCII_DTOSTR_BUF_SIZE,
-                                priv->altitude);
-                coords = g_strdup_printf ("%s,%s,%s", lat, lon, alt);
-        } else {
-                coords = g_strdup_printf ("%s,%s", lat, lon);
-        }
-
-        if (priv->accuracy != GEOCODE_LOCATION_ACCURACY_UNKNOWN) {
-                g_ascii_dtostr (acc, G_ASCII_DTOSTR_BUF_SIZE,
-                                priv->accuracy);
-                params = g_strdup_printf (";crs=%s;u=%s", crs, acc);
-        } else {
-                params = g_strdup_printf (";crs=%s", crs);
-        }
-
-        uri = g_strconcat ("geo:", coords, params, NULL);
-        g_free (coords);
-        g_free (params);
-
-        return uri;
+        len = geocode_geo_uri_format (priv->latitude,
+                                      priv->longitude,
+                                      priv->altitude,
+                                      priv->accuracy,
+                                      uri,
+                                      sizeof (uri));
+
+        return g_strndup (uri, len);
 }
 
 /**
@@ -988,6 +770,9 @@ geo_uri_from_location (GeocodeLocation *loc)
  *
  * Creates a URI representing @loc in the scheme specified in @scheme.
  *
+ * To write the URI into an existing buffer or #GString instead, see
+ * geocode_geo_uri_format() and geocode_geo_uri_append().
+ *
  * Returns: a URI representing the location. The returned string should be freed
  * with g_free() when no longer needed.
  **/
@@ -1015,11 +800,9 @@ geocode_location_to_uri (GeocodeLocation *loc,
 double
 geocode_location_get_distance_from (GeocodeLocation *loca,
                                     GeocodeLocation *locb)
-{       
+{
         GeocodeLocationPrivate *priv_a;
         GeocodeLocationPrivate *priv_b;
-        gdouble dlat, dlon, lat1, lat2;
-        gdouble a, c;
 
         g_return_val_if_fail (GEOCODE_IS_LOCATION (loca), 0.0);
         g_return_val_if_fail (GEOCODE_IS_LOCATION (locb), 0.0);
@@ -1027,16 +810,335 @@ geocode_location_get_distance_from (GeocodeLocation *loca,
         priv_a = geocode_location_get_instance_private (loca);
         priv_b = geocode_location_get_instance_private (locb);
 
+        return _geocode_haversine_distance (priv_a->latitude, priv_a->longitude,
+                                            priv_b->latitude, priv_b->longitude);
+}
+
+/* Distance in km between two points, shared with GeocodeCoordinate */
+gdouble
+_geocode_haversine_distance (gdouble latitude1,
+                             gdouble longitude1,
+                             gdouble latitude2,
+                             gdouble longitude2)
+{
+        gdouble dlat, dlon, lat1, lat2;
+        gdouble a, c;
+
         /* Algorithm from:
          * http://www.movable-type.co.uk/scripts/latlong.html */
 
-        dlat = (priv_b->latitude - priv_a->latitude) * M_PI / 180.0;
-        dlon = (priv_b->longitude - priv_a->longitude) * M_PI / 180.0;
-        lat1 = priv_a->latitude * M_PI / 180.0;
-        lat2 = priv_b->latitude * M_PI / 180.0;
+        dlat = (latitude2 - latitude1) * M_PI / 180.0;
+        dlon = (longitude2 - longitude1) * M_PI / 180.0;
+        lat1 = latitude1 * M_PI / 180.0;
+        lat2 = latitude2 * M_PI / 180.0;
 
         a = sin (dlat / 2) * sin (dlat / 2) +
             sin (dlon / 2) * sin (dlon / 2) * cos (lat1) * cos (lat2);
         c = 2 * atan2 (sqrt (a), sqrt (1-a));
         return EARTH_RADIUS_KM * c;
 }
+
+/* Taylor polynomials for sin(x) and cos(x), accurate to better than 1e-17
+ * for |x| <= π/2. Unlike sin() and cos() from libm these have no branches
+ * or range reduction, so the loops below which use them can be
+ * auto-vectorised. */
+static inline gdouble
+poly_sin (gdouble x)
+{
+        gdouble x2 = x * x;
+
+        return x * (1.0 + x2 * (-1.0 / 6 + x2 * (1.0 / 120 +
+                    x2 * (-1.0 / 5040 + x2 * (1.0 / 362880 +
+                    x2 * (-1.0 / 39916800 + x2 * (1.0 / 6227020800.0 +
+                    x2 * (-1.0 / 1307674368000.0 + x2 * (1.0 / 355687428096000.0 +
+                    x2 * (-1.0 / 121645100408832000.0 +
+                    x2 * (1.0 / 51090942171709440000.0)))))))))));
+}
+
+static inline gdouble
+poly_cos (gdouble x)
+{
+        gdouble x2 = x * x;
+
+        return 1.0 + x2 * (-1.0 / 2 + x2 * (1.0 / 24 + x2 * (-1.0 / 720 +
+               x2 * (1.0 / 40320 + x2 * (-1.0 / 3628800 +
+               x2 * (1.0 / 479001600 + x2 * (-1.0 / 87178291200.0 +
+               x2 * (1.0 / 20922789888000.0 + x2 * (-1.0 / 6402373705728000.0 +
+               x2 * (1.0 / 2432902008176640000.0 +
+               x2 * (-1.0 / 1124000727777607680000.0)))))))))));
+}
+
+/* Converts haversines of central angles to distances along the surface, in
+ * place. */
+static void
+haversines_to_distances (gdouble *values,
+                         gsize    n_values)
+{
+        gsize i;
+
+        for (i = 0; i < n_values; i++) {
+                gdouble a = values[i];
+
+                values[i] = EARTH_RADIUS_KM * 2 * atan2 (sqrt (a), sqrt (1 - a));
+        }
+}
+
+/* Haversine distances from (@latitude, @longitude) to each of @n_points
+ * points, in km. This is the same formula as
+ * geocode_location_get_distance_from(), split into a branch-free first pass
+ * which computes the haversine of the central angle of each pair, and a
+ * second pass which converts those to distances. */
+static void
+distances_from_point (gdouble        latitude,
+                      gdouble        longitude,
+                      const gdouble *latitudes,
+                      const gdouble *longitudes,
+                      gsize          n_points,
+                      gdouble       *distances)
+{
+        const gdouble to_half_rad = M_PI / 360.0;
+        gdouble cos_lat1;
+        gsize i;
+
+        cos_lat1 = cos (latitude * M_PI / 180.0);
+
+        for (i = 0; i < n_points; i++) {
+                gdouble dlon, s_dlat, s_dlon, cos_lat2;
+
+                /* sin² (dlon / 2) has a period of 360°, so wrapping dlon
+                 * into [-180°, 180°] keeps the polynomial argument within
+                 * ±π/2 without changing the result. */
+                dlon = longitudes[i] - longitude;
+                dlon -= 360.0 * ((dlon > 180.0) - (dlon < -180.0));
+
+                s_dlat = poly_sin ((latitudes[i] - latitude) * to_half_rad);
+                s_dlon = poly_sin (dlon * to_half_rad);
+                cos_lat2 = poly_cos (latitudes[i] * M_PI / 180.0);
+
+                distances[i] = s_dlat * s_dlat +
+                               s_dlon * s_dlon * cos_lat1 * cos_lat2;
+        }
+
+        haversines_to_distances (distances, n_points);
+}
+
+/**
+ * geocode_location_get_distances_from:
+ * @loc: a #GeocodeLocation
+ * @latitudes: (array length=n_points): latitudes of the points, in degrees
+ * @longitudes: (array length=n_points): longitudes of the points, in degrees
+ * @n_points: the number of points
+ * @distances: (out caller-allocates) (array length=n_points): return location
+ *    for the distance to each point, in km
+ *
+ * Calculates the distance in km, along the curvature of the Earth, between
+ * @loc and each of @n_points points, given as separate arrays of latitudes
+ * and longitudes. This is much faster than calling
+ * geocode_location_get_distance_from() for each point, and does not require
+ * a #GeocodeLocation for each of them.
+ *
+ * The latitudes and longitudes must be within the ranges accepted by
+ * #GeocodeLocation. The results agree with those of
+ * geocode_location_get_distance_from() to within 1e-9 km for points more
+ * than 100 km from the antipode of @loc. Closer to the antipode, both
+ * calculations become ill-conditioned and may differ slightly more.
+ *
+ * Since: 3.28
+ **/
+void
+geocode_location_get_distances_from (GeocodeLocation *loc,
+                                     const gdouble   *latitudes,
+                                     const gdouble   *longitudes,
+                                     gsize            n_points,
+                                     gdouble         *distances)
+{
+        GeocodeLocationPrivate *priv;
+
+        g_return_if_fail (GEOCODE_IS_LOCATION (loc));
+        g_return_if_fail (n_points == 0 || latitudes != NULL);
+        g_return_if_fail (n_points == 0 || longitudes != NULL);
+        g_return_if_fail (n_points == 0 || distances != NULL);
+
+        priv = geocode_location_get_instance_private (loc);
+
+        distances_from_point (priv->latitude, priv->longitude,
+                              latitudes, longitudes, n_points, distances);
+}
+
+/* Points per side of the tiles the distance matrix is computed in. A tile
+ * of columns (latitude, longitude and cos (latitude)) fits in L1 cache. */
+#define MATRIX_TILE_ROWS 32
+#define MATRIX_TILE_COLUMNS 512
+
+/* Minimum number of cells worth handing to another thread */
+#define MATRIX_MIN_CELLS_PER_THREAD (128 * 1024)
+
+typedef struct {
+        const gdouble *row_latitudes;
+        const gdouble *row_longitudes;
+        const gdouble *row_cos_latitudes;
+        const gdouble *column_latitudes;
+        const gdouble *column_longitudes;
+        const gdouble *column_cos_latitudes;
+        gsize n_columns;
+        gdouble *distances;
+        gsize first_row;
+        gsize last_row;  /* exclusive */
+} DistanceMatrixJob;
+
+static gpointer
+distance_matrix_job_run (gpointer data)
+{
+        DistanceMatrixJob *job = data;
+        const gdouble to_half_rad = M_PI / 360.0;
+        gsize row_tile, column_tile, row, column;
+
+        for (row_tile = job->first_row;
+             row_tile < job->last_row;
+             row_tile += MATRIX_TILE_ROWS) {
+                gsize row_end = MIN (row_tile + MATRIX_TILE_ROWS, job->last_row);
+
+                for (column_tile = 0;
+                     column_tile < job->n_columns;
+                     column_tile += MATRIX_TILE_COLUMNS) {
+                        gsize column_end = MIN (column_tile + MATRIX_TILE_COLUMNS,
+                                                job->n_columns);
+
+                        for (row = row_tile; row < row_end; row++) {
+                                gdouble latitude = job->row_latitudes[row];
+                                gdouble longitude = job->row_longitudes[row];
+                                gdouble cos_lat1 = job->row_cos_latitudes[row];
+                                gdouble *out = job->distances + row * job->n_columns;
+
+                                for (column = column_tile; column < column_end; column++) {
+                                        gdouble dlon, s_dlat, s_dlon;
+
+                                        dlon = job->column_longitudes[column] - longitude;
+                                        dlon -= 360.0 * ((dlon > 180.0) - (dlon < -180.0));
+
+                                        s_dlat = poly_sin ((job->column_latitudes[column] - latitude) * to_half_rad);
+                                        s_dlon = poly_sin (dlon * to_half_rad);
+
+                                        out[column] = s_dlat * s_dlat +
+                                                      s_dlon * s_dlon * cos_lat1 *
+                                                      job->column_cos_latitudes[column];
+                                }
+
+                                haversines_to_distances (out + column_tile,
+                                                         column_end - column_tile);
+                        }
+                }
+        }
+
+        return NULL;
+}
+
+static gdouble *
+cos_latitudes_new (const gdouble *latitudes,
+                   gsize          n_points)
+{
+        gdouble *cos_latitudes;
+        gsize i;
+
+        cos_latitudes = g_new (gdouble, n_points);
+        for (i = 0; i < n_points; i++)
+                cos_latitudes[i] = cos (latitudes[i] * M_PI / 180.0);
+
+        return cos_latitudes;
+}
+
+/**
+ * geocode_location_get_distance_matrix:
+ * @row_latitudes: (array length=n_rows): latitudes of the first set of
+ *    points, in degrees
+ * @row_longitudes: (array length=n_rows): longitudes of the first set of
+ *    points, in degrees
+ * @n_rows: the number of points in the first set
+ * @column_latitudes: (array length=n_columns): latitudes of the second set
+ *    of points, in degrees
+ * @column_longitudes: (array length=n_columns): longitudes of the second set
+ *    of points, in degrees
+ * @n_columns: the number of points in the second set
+ * @distances: (out caller-allocates): return location for @n_rows ×
+ *    @n_columns distances, in km
+ *
+ * Calculates the distance in km, along the curvature of the Earth, between
+ * every point of the first set and every point of the second set. The
+ * distance between row point `i` and column point `j` is stored in
+ * `distances[i * n_columns + j]`.
+ *
+ * Large matrices are split between several threads. The accuracy is the
+ * same as for geocode_location_get_distances_from().
+ *
+ * Since: 3.28
+ **/
+void
+geocode_location_get_distance_matrix (const gdouble *row_latitudes,
+                                      const gdouble *row_longitudes,
+                                      gsize          n_rows,
+                                      const gdouble *column_latitudes,
+                                      const gdouble *column_longitudes,
+                                      gsize          n_columns,
+                                      gdouble       *distances)
+{
+        g_autofree gdouble *row_cos_latitudes = NULL;
+        g_autofree gdouble *column_cos_latitudes = NULL;
+        g_autofree DistanceMatrixJob *jobs = NULL;
+        g_autofree GThread **threads = NULL;
+        guint n_jobs, i;
+        gsize rows_per_job;
+
+        g_return_if_fail (n_rows == 0 || (row_latitudes != NULL && row_longitudes != NULL));
+        g_return_if_fail (n_columns == 0 || (column_latitudes != NULL && column_longitudes != NULL));
+        g_return_if_fail (n_rows == 0 || n_columns == 0 || distances != NULL);
+        g_return_if_fail (n_columns == 0 || n_rows <= G_MAXSIZE / n_columns);
+
+        if (n_rows == 0 || n_columns == 0)
+                return;
+
+        row_cos_latitudes = cos_latitudes_new (row_latitudes, n_rows);
+        column_cos_latitudes = cos_latitudes_new (column_latitudes, n_columns);
+
+        /* Split the rows between threads in whole tiles */
+        n_jobs = MIN ((n_rows * n_columns) / MATRIX_MIN_CELLS_PER_THREAD,
+                      (n_rows + MATRIX_TILE_ROWS - 1) / MATRIX_TILE_ROWS);
+        n_jobs = CLAMP (n_jobs, 1, g_get_num_processors ());
+        rows_per_job = (n_rows + n_jobs - 1) / n_jobs;
+        rows_per_job = (rows_per_job + MATRIX_TILE_ROWS - 1) / MATRIX_TILE_ROWS * MATRIX_TILE_ROWS;
+
+        jobs = g_new0 (DistanceMatrixJob, n_jobs);
+        threads = g_new0 (GThread *, n_jobs);
+
+        for (i = 0; i < n_jobs; i++) {
+                DistanceMatrixJob *job = &jobs[i];
+
+                job->row_latitudes = row_latitudes;
+                job->row_longitudes = row_longitudes;
+                job->row_cos_latitudes = row_cos_latitudes;
+                job->column_latitudes = column_latitudes;
+                job->column_longitudes = column_longitudes;
+                job->column_cos_latitudes = column_cos_latitudes;
+                job->n_columns = n_columns;
+                job->distances = distances;
+                job->first_row = MIN (i * rows_per_job, n_rows);
+                job->last_row = MIN (job->first_row + rows_per_job, n_rows);
+
+                /* The calling thread takes the first job itself, and any
+                 * which could not be given a thread of their own. */
+                if (i > 0 && job->first_row < job->last_row) {
+                        threads[i] = g_thread_try_new ("geocode-distances",
+                                                       distance_matrix_job_run,
+                                                       job,
+                                                       NULL);
+                        if (threads[i] == NULL)
+                                distance_matrix_job_run (job);
+                }
+        }
+
+        distance_matrix_job_run (&jobs[0]);
+
+        for (i = 1; i < n_jobs; i++) {
+                if (threads[i] != NULL)
+                        g_thread_join (threads[i]);
+        }
+}
@@ -25,6 +25,7 @@
 #define GEOCODE_LOCATION_H
 
 #include <glib-object.h>
+#include <geocode-glib/geocode-coordinate.h>
 
 G_BEGIN_DECLS
 
@@ -144,6 +145,11 @@ GeocodeLocation *geocode_location_new_with_description (gdouble     latitude,
                                                         gdouble     accuracy,
                                                         const char *description);
 
+GeocodeLocation *geocode_location_new_for_coordinate   (const GeocodeCoordinate *coord);
+
+void geocode_location_get_coordinate                   (GeocodeLocation   *loc,
+                                                        GeocodeCoordinate *coord);
+
 gboolean geocode_location_equal                        (GeocodeLocation *a,
                                                         GeocodeLocation *b);
 
@@ -157,6 +163,20 @@ char * geocode_location_to_uri                         (GeocodeLocation *loc,
 double geocode_location_get_distance_from              (GeocodeLocation *loca,
                                                         GeocodeLocation *locb);
 
+void geocode_location_get_distances_from               (GeocodeLocation *loc,
+                                                        const gdouble   *latitudes,
+                                                        const gdouble   *longitudes,
+                                                        gsize            n_points,
+                                                        gdouble         *distances);
+
+void geocode_location_get_distance_matrix              (const gdouble   *row_latitudes,
+                                                        const gdouble   *row_longitudes,
+                                                        gsize            n_rows,
+                                                        const gdouble   *column_latitudes,
+                                                        const gdouble   *column_longitudes,
+                                                        gsize            n_columns,
+                                                        gdouble         *distances);
+
 void geocode_location_set_description                  (GeocodeLocation *loc,
                                                         const char      *description);
 
@@ -22,6 +22,7 @@
 #include <gio/gio.h>
 #include <json-glib/json-glib.h>
 #include <libsoup/soup.h>
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -49,6 +50,19 @@
  * geocode_mock_backend_get_query_log(). The backend can be reset using
  * geocode_mock_backend_clear() and new queries added for the next test.
  *
+ * Results are looked up by a hash of their query parameters, so a mock
+ * backend holding tens of thousands of results, such as one standing in for
+ * Nominatim in a load test, answers as quickly as one holding a few. For such
+ * tests, the query log can be limited to the most recent queries, or to
+ * counts and timings only, with geocode_mock_backend_set_query_log_capacity().
+ *
+ * To check how the code under test copes with a slow or unreliable service,
+ * queries can be given a latency drawn from a distribution with
+ * geocode_mock_backend_set_latency(), and made to fail at random with
+ * geocode_mock_backend_set_error_rate(). Asynchronous queries wait for their
+ * latency in the caller’s main context rather than in a thread, so many of
+ * them can be outstanding at once.
+ *
  * |[<!-- language="C" -->
  * static void
  * place_list_free (GList *l)
@@ -113,9 +127,31 @@
 struct _GeocodeMockBackend {
 	GObject parent;
 
-	GPtrArray *forward_results;  /* (owned) (element-type owned GeocodeMockBackendQuery) */
-	GPtrArray *reverse_results;  /* (owned) (element-type owned GeocodeMockBackendQuery) */
+	/* Keyed by the params of the query, which the query owns. */
+	GHashTable *forward_results;  /* (owned) (element-type GHashTable owned GeocodeMockBackendQuery) */
+	GHashTable *reverse_results;  /* (owned) (element-type GHashTable owned GeocodeMockBackendQuery) */
+
+	/* Queries may arrive from several threads, and results may be added
+	 * from another one (such as by a #GeocodeLayeredBackend), so the
+	 * results, the query log and the latency and failure injection are
+	 * protected by @lock. */
+	GMutex lock;
+
+	/* Ring buffer of the most recent queries, oldest at @query_log_start
+	 * once it is full. */
 	GPtrArray *query_log;  /* (owned) (element-type owned GeocodeMockBackendQuery) */
+	guint query_log_start;
+	guint query_log_capacity;
+	GeocodeStats stats;  /* atomic */
+
+	GRand *rand;  /* (owned) */
+	GeocodeMockLatency latency_distribution;
+	gdouble latency;  /* milliseconds */
+	gdouble latency_spread;
+	gdouble jitter;  /* milliseconds */
+	GHashTable *query_latencies;  /* (owned) (element-type GHashTable gdouble) */
+	gdouble error_rate;
+	GError *injected_error;  /* (owned) (nullable) */
 };
 
 static void geocode_backend_iface_init (GeocodeBackendInterface *iface);
@@ -126,47 +162,18 @@ G_DEFINE_TYPE_WITH_CODE (GeocodeMockBackend, geocode_mock_backend, G_TYPE_OBJECT
 
 /******************************************************************************/
 
-static void
-value_free (GValue *value)
-{
-	g_value_unset (value);
-	g_free (value);
-}
-
-static GHashTable *
-params_copy_deep (GHashTable *params)
-{
-	g_autoptr (GHashTable) output = NULL;
-	GHashTableIter iter;
-	const gchar *key;
-	const GValue *value;
-
-	output = g_hash_table_new_full (g_str_hash, g_str_equal,
-	                                g_free, (GDestroyNotify) value_free);
-
-	g_hash_table_iter_init (&iter, params);
-
-	while (g_hash_table_iter_next (&iter, (gpointer *) &key,
-	                               (gpointer *) &value)) {
-		GValue *value_copy = NULL;
-
-		value_copy = g_new0 (GValue, 1);
-		g_value_init (value_copy, G_VALUE_TYPE (value));
-		g_value_copy (value, value_copy);
-
-		g_hash_table_insert (output, g_strdup (key),
-		                     g_steal_pointer (&value_copy));
-	}
-
-	return g_steal_pointer (&output);
-}
-
 static GList *
 results_copy_deep (GList *results)
 {
 	return g_list_copy_deep (results, (GCopyFunc) g_object_ref, NULL);
 }
 
+static void
+places_list_free (GList *places)
+{
+	g_list_free_full (places, g_object_unref);
+}
+
 /******************************************************************************/
 
 static void
@@ -198,7 +205,7 @@ geocode_mock_backend_query_new (GHashTable   *params,
 
 	query = g_new0 (GeocodeMockBackendQuery, 1);
 
-	query->params = params_copy_deep (params);
+	query->params = _geocode_params_copy (params);
 	query->is_forward = is_forward;
 	query->results = results_copy_deep (results);
 	query->error = (error != NULL) ? g_error_copy (error) : NULL;
@@ -208,88 +215,6 @@ geocode_mock_backend_query_new (GHashTable   *params,
 
 /******************************************************************************/
 
-static gboolean
-value_equal (const GValue *a,
-             const GValue *b)
-{
-	GValue a_string = G_VALUE_INIT, b_string = G_VALUE_INIT;
-	gboolean equal;
-
-	g_return_val_if_fail (a != NULL, FALSE);
-	g_return_val_if_fail (b != NULL, FALSE);
-
-	if (G_VALUE_TYPE (a) != G_VALUE_TYPE (b))
-		return FALSE;
-
-	/* Doubles can’t be converted to strings, so special-case comparison
-	 * of them. */
-	if (G_VALUE_TYPE (a) == G_TYPE_DOUBLE) {
-		return g_value_get_double (a) == g_value_get_double (b);
-	}
-
-	g_value_init (&a_string, G_TYPE_STRING);
-	g_value_init (&b_string, G_TYPE_STRING);
-
-	/* We assume that all GValue types can be converted to strings for the
-	 * purpose of comparison. */
-	if (!g_value_transform (a, &a_string) ||
-	    !g_value_transform (b, &b_string))
-		return FALSE;
-
-	equal = g_str_equal (g_value_get_string (&a_string),
-	                     g_value_get_string (&b_string));
-
-	g_value_unset (&b_string);
-	g_value_unset (&a_string);
-
-	return equal;
-}
-
-static gboolean
-hash_table_equal (GHashTable *a,
-                  GHashTable *b)
-{
-	GHashTableIter iter_a;
-	const gchar *key;
-	const GValue *value_a, *value_b;
-
-	if (g_hash_table_size (a) != g_hash_table_size (b))
-		return FALSE;
-
-	g_hash_table_iter_init (&iter_a, a);
-
-	while (g_hash_table_iter_next (&iter_a, (gpointer *) &key,
-	                               (gpointer *) &value_a)) {
-		if (!g_hash_table_lookup_extended (b, key, NULL,
-		                                   (gpointer *) &value_b) ||
-		    !value_equal (value_a, value_b))
-			return FALSE;
-	}
-
-	return TRUE;
-}
-
-static const GeocodeMockBackendQuery *
-find_query (GPtrArray  *queries,
-            GHashTable *params,
-            gsize      *index)
-{
-	gsize i;
-
-	for (i = 0; i < queries->len; i++) {
-		const GeocodeMockBackendQuery *query = queries->pdata[i];
-
-		if (hash_table_equal (query->params, params)) {
-			if (index != NULL)
-				*index = i;
-
-			return query;
-		}
-	}
-
-	return NULL;
-}
-
 static void
 debug_print_params (GHashTable *params)
 {
@@ -325,26 +250,95 @@ debug_print_params (GHashTable *params)
 	g_debug ("%s", output_str);
 }
 
+/* Draws the delay, in microseconds, before answering a query for @params.
+ * Must be called with @self->lock held. */
+static gint64
+draw_delay_locked (GeocodeMockBackend *self,
+                   GHashTable         *params)
+{
+	const gdouble *query_latency;
+	gdouble latency = 0.0;
+
+	/* A per-query latency replaces the distribution and jitter. */
+	query_latency = g_hash_table_lookup (self->query_latencies, params);
+	if (query_latency != NULL)
+		return (gint64) (*query_latency * 1000.0);
+
+	switch (self->latency_distribution) {
+	case GEOCODE_MOCK_LATENCY_NONE:
+		break;
+	case GEOCODE_MOCK_LATENCY_FIXED:
+		latency = self->latency;
+		break;
+	case GEOCODE_MOCK_LATENCY_UNIFORM:
+		latency = (self->latency_spread > self->latency) ?
+		          g_rand_double_range (self->rand, self->latency,
+		                               self->latency_spread) :
+		          self->latency;
+		break;
+	case GEOCODE_MOCK_LATENCY_LOG_NORMAL: {
+		gdouble u1, u2, z;
+
+		/* Box–Muller transform to a standard normal variate; @u1 is
+		 * in (0, 1] so the logarithm is finite. */
+		u1 = 1.0 - g_rand_double (self->rand);
+		u2 = g_rand_double (self->rand);
+		z = sqrt (-2.0 * log (u1)) * cos (2.0 * G_PI * u2);
+
+		latency = self->latency * exp (self->latency_spread * z);
+		break;
+	}
+	default:
+		g_assert_not_reached ();
+	}
+
+	if (self->jitter > 0.0)
+		latency += g_rand_double_range (self->rand, -self->jitter,
+		                                self->jitter);
+
+	return (gint64) (MAX (latency, 0.0) * 1000.0);
+}
+
+/* Works out the answer to a query for @params, including any injected
+ * failure, and logs it. The answer should be delivered after @delay_out
+ * microseconds. */
 static GList *
 forward_or_reverse (GeocodeMockBackend  *self,
-                    GPtrArray           *results,
+                    GHashTable          *results,
                     GeocodeError         no_results_error,
                     GHashTable          *params,
-                    GCancellable        *cancellable,
+                    gint64              *delay_out,
                     GError             **error)
 {
 	const GeocodeMockBackendQuery *query;
+	gboolean matched;
 	g_autoptr (GeocodeMockBackendQuery) logged_query = NULL;
 	GList *output_results = NULL;  /* (element-type GeocodePlace) */
 	g_autoptr (GError) output_error = NULL;
+	g_autoptr (GError) injected_error = NULL;
 
 	/* Log the query; helpful during development. */
 	debug_print_params (params);
 
-	/* Do we have a mock result for this query? */
-	query = find_query (results, params, NULL);
-
-	if (query == NULL) {
+	/* Should the query be slow, or fail? */
+	g_mutex_lock (&self->lock);
+	*delay_out = draw_delay_locked (self, params);
+	if (self->error_rate > 0.0 &&
+	    g_rand_double (self->rand) < self->error_rate)
+		injected_error = (self->injected_error != NULL) ?
+		                 g_error_copy (self->injected_error) :
+		                 g_error_new (GEOCODE_ERROR,
+		                              GEOCODE_ERROR_INTERNAL_SERVER,
+		                              "Injected failure for request");
+
+	/* Do we have a mock result for this query? It may be replaced as soon
+	 * as the lock is released, so copy the answer first. */
+	query = g_hash_table_lookup (results, params);
+	matched = (query != NULL);
+
+	if (injected_error != NULL) {
+		output_error = g_steal_pointer (&injected_error);
+	} else if (query == NULL) {
 		output_error = g_error_new (GEOCODE_ERROR, no_results_error,
 		                            "No matches found for request");
 	} else if (query->error != NULL) {
@@ -353,11 +347,32 @@ forward_or_reverse (GeocodeMockBackend  *self,
 		output_results = results_copy_deep (query->results);
 	}
 
-	/* Log the query. */
-	logged_query = geocode_mock_backend_query_new (params, TRUE,
-	                                               output_results,
-	                                               output_error);
-	g_ptr_array_add (self->query_log, g_steal_pointer (&logged_query));
+	g_mutex_unlock (&self->lock);
+
+	/* Log the query, overwriting the oldest one if the log is full. */
+	_geocode_stats_record_query (&self->stats, matched);
+	_geocode_stats_record_response (&self->stats,
+	                                (output_error == NULL) ? 200 : 0,
+	                                0, *delay_out);
+
+	g_mutex_lock (&self->lock);
+
+	if (self->query_log_capacity > 0)
+		logged_query = geocode_mock_backend_query_new (params, TRUE,
+		                                               output_results,
+		                                               output_error);
+
+	if (logged_query == NULL) {
+		/* Only counting queries. */
+	} else if (self->query_log->len < self->query_log_capacity) {
+		g_ptr_array_add (self->query_log, g_steal_pointer (&logged_query));
+	} else {
+		geocode_mock_backend_query_free (self->query_log->pdata[self->query_log_start]);
+		self->query_log->pdata[self->query_log_start] = g_steal_pointer (&logged_query);
+		self->query_log_start = (self->query_log_start + 1) % self->query_log->len;
+	}
+
+	g_mutex_unlock (&self->lock);
 
 	/* Output either the results or the error. */
 	g_assert ((output_results == NULL) != (output_error == NULL));
@@ -368,6 +383,183 @@ forward_or_reverse (GeocodeMockBackend  *self,
 	return g_steal_pointer (&output_results);
 }
 
+/* Blocks for @delay microseconds, returning early if @cancellable is
+ * cancelled. */
+static void
+sleep_cancellable (gint64        delay,
+                   GCancellable *cancellable)
+{
+	GPollFD pollfd;
+	gint64 end_time;
+
+	if (delay <= 0)
+		return;
+
+	if (!g_cancellable_make_pollfd (cancellable, &pollfd)) {
+		g_usleep (delay);
+		return;
+	}
+
+	end_time = g_get_monotonic_time () + delay;
+
+	while (!g_cancellable_is_cancelled (cancellable)) {
+		gint64 remaining = end_time - g_get_monotonic_time ();
+
+		if (remaining <= 0)
+			break;
+
+		g_poll (&pollfd, 1, (gint) ((remaining + 999) / 1000));
+	}
+
+	g_cancellable_release_fd (cancellable);
+}
+
+static GList *
+forward_or_reverse_sync (GeocodeMockBackend  *self,
+                         GHashTable          *results,
+                         GeocodeError         no_results_error,
+                         GHashTable          *params,
+                         GCancellable        *cancellable,
+                         GError             **error)
+{
+	GList *output_results;
+	GError *output_error = NULL;
+	gint64 delay;
+
+	output_results = forward_or_reverse (self, results, no_results_error,
+	                                     params, &delay, &output_error);
+
+	sleep_cancellable (delay, cancellable);
+
+	if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+		places_list_free (output_results);
+		g_clear_error (&output_error);
+		return NULL;
+	}
+
+	if (output_error != NULL)
+		g_propagate_error (error, output_error);
+
+	return output_results;
+}
+
+typedef struct {
+	GTask *task;  /* (owned) */
+	GList *results;  /* (owned) (element-type GeocodePlace) (nullable) */
+	GError *error;  /* (owned) (nullable) */
+	GSource *timeout_source;  /* (owned) */
+	GSource *cancel_source;  /* (owned) (nullable) */
+} DelayedAnswer;
+
+static void
+delayed_answer_free (DelayedAnswer *answer)
+{
+	g_source_destroy (answer->timeout_source);
+	g_source_unref (answer->timeout_source);
+
+	if (answer->cancel_source != NULL) {
+		g_source_destroy (answer->cancel_source);
+		g_source_unref (answer->cancel_source);
+	}
+
+	places_list_free (answer->results);
+	g_clear_error (&answer->error);
+	g_object_unref (answer->task);
+	g_free (answer);
+}
+
+static void
+task_return_answer (GTask  *task,
+                    GList  *results,
+                    GError *error)
+{
+	if (error != NULL)
+		g_task_return_error (task, error);
+	else
+		g_task_return_pointer (task, results,
+		                       (GDestroyNotify) places_list_free);
+}
+
+static gboolean
+delayed_answer_timeout_cb (gpointer user_data)
+{
+	DelayedAnswer *answer = user_data;
+
+	task_return_answer (answer->task, g_steal_pointer (&answer->results),
+	                    g_steal_pointer (&answer->error));
+	delayed_answer_free (answer);
+
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean
+delayed_answer_cancelled_cb (GCancellable *cancellable,
+                             gpointer      user_data)
+{
+	DelayedAnswer *answer = user_data;
+
+	g_task_return_error_if_cancelled (answer->task);
+	delayed_answer_free (answer);
+
+	return G_SOURCE_REMOVE;
+}
+
+/* Answers the query from a timeout in the task’s main context, rather than
+ * blocking a thread for the injected latency. */
+static void
+forward_or_reverse_async (GeocodeMockBackend  *self,
+                          GHashTable          *results,
+                          GeocodeError         no_results_error,
+                          gpointer             source_tag,
+                          GHashTable          *params,
+                          GCancellable        *cancellable,
+                          GAsyncReadyCallback  callback,
+                          gpointer             user_data)
+{
+	g_autoptr (GTask) task = NULL;
+	GList *output_results;
+	GError *output_error = NULL;
+	DelayedAnswer *answer;
+	gint64 delay;
+
+	task = g_task_new (self, cancellable, callback, user_data);
+	g_task_set_source_tag (task, source_tag);
+
+	output_results = forward_or_reverse (self, results, no_results_error,
+	                                     params, &delay, &output_error);
+
+	if (delay <= 0) {
+		if (g_task_return_error_if_cancelled (task)) {
+			places_list_free (output_results);
+			g_clear_error (&output_error);
+		} else {
+			task_return_answer (task, output_results, output_error);
+		}
+
+		return;
+	}
+
+	answer = g_new0 (DelayedAnswer, 1);
+	answer->task = g_steal_pointer (&task);
+	answer->results = output_results;
+	answer->error = output_error;
+
+	answer->timeout_source = g_timeout_source_new ((guint) ((delay + 999) / 1000));
+	g_source_set_callback (answer->timeout_source, delayed_answer_timeout_cb,
+	                       answer, NULL);
+	g_source_attach (answer->timeout_source,
+	                 g_task_get_context (answer->task));
+
+	if (cancellable != NULL) {
+		answer->cancel_source = g_cancellable_source_new (cancellable);
+		g_source_set_callback (answer->cancel_source,
+		                       (GSourceFunc) delayed_answer_cancelled_cb,
+		                       answer, NULL);
+		g_source_attach (answer->cancel_source,
+		                 g_task_get_context (answer->task));
+	}
+}
+
 static GList *
 geocode_mock_backend_forward_search (GeocodeBackend  *backend,
                                      GHashTable      *params,
@@ -376,9 +568,34 @@ geocode_mock_backend_forward_search (GeocodeBackend  *backend,
 {
 	GeocodeMockBackend *self = GEOCODE_MOCK_BACKEND (backend);
 
-	return forward_or_reverse (self, self->forward_results,
-	                           GEOCODE_ERROR_NO_MATCHES, params,
-	                           cancellable, error);
+	return forward_or_reverse_sync (self, self->forward_results,
+	                                GEOCODE_ERROR_NO_MATCHES, params,
+	                                cancellable, error);
+}
+
+static void
+geocode_mock_backend_forward_search_async (GeocodeBackend      *backend,
+                                           GHashTable          *params,
+                                           GCancellable        *cancellable,
+                                           GAsyncReadyCallback  callback,
+                                           gpointer             user_data)
+{
+	GeocodeMockBackend *self = GEOCODE_MOCK_BACKEND (backend);
+
+	forward_or_reverse_async (self, self->forward_results,
+	                          GEOCODE_ERROR_NO_MATCHES,
+	                          geocode_mock_backend_forward_search_async,
+	                          params, cancellable, callback, user_data);
+}
+
+static GList *
+geocode_mock_backend_forward_search_finish (GeocodeBackend  *backend,
+                                            GAsyncResult    *result,
+                                            GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
 }
 
 static GList *
@@ -389,9 +606,67 @@ geocode_mock_backend_reverse_resolve (GeocodeBackend  *backend,
 {
 	GeocodeMockBackend *self = GEOCODE_MOCK_BACKEND (backend);
 
-	return forward_or_reverse (self, self->reverse_results,
-	                           GEOCODE_ERROR_NOT_SUPPORTED,
-	                           params, cancellable, error);
+	return forward_or_reverse_sync (self, self->reverse_results,
+	                                GEOCODE_ERROR_NOT_SUPPORTED,
+	                                params, cancellable, error);
+}
+
+static void
+geocode_mock_backend_reverse_resolve_async (GeocodeBackend      *backend,
+                                            GHashTable          *params,
+                                            GCancellable        *cancellable,
+                                            GAsyncReadyCallback  callback,
+                                            gpointer             user_data)
+{
+	GeocodeMockBackend *self = GEOCODE_MOCK_BACKEND (backend);
+
+	forward_or_reverse_async (self, self->reverse_results,
+	                          GEOCODE_ERROR_NOT_SUPPORTED,
+	                          geocode_mock_backend_reverse_resolve_async,
+	                          params, cancellable, callback, user_data);
+}
+
+static GList *
+geocode_mock_backend_reverse_resolve_finish (GeocodeBackend  *backend,
+                                             GAsyncResult    *result,
+                                             GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/******************************************************************************/
+
+static void
+reverse_pointers (gpointer *pdata,
+                  guint     start,
+                  guint     end)
+{
+	for (; start + 1 < end; start++, end--) {
+		gpointer tmp = pdata[start];
+
+		pdata[start] = pdata[end - 1];
+		pdata[end - 1] = tmp;
+	}
+}
+
+/* Rotates the query log ring buffer in place so that the oldest query is
+ * first. Must be called with @self->lock held. */
+static void
+query_log_rotate_locked (GeocodeMockBackend *self)
+{
+	gpointer *pdata = self->query_log->pdata;
+	guint len = self->query_log->len;
+
+	if (self->query_log_start == 0)
+		return;
+
+	reverse_pointers (pdata, 0, self->query_log_start);
+	reverse_pointers (pdata, self->query_log_start, len);
+	reverse_pointers (pdata, 0, len);
+
+	self->query_log_start = 0;
 }
 
 /******************************************************************************/
@@ -444,18 +719,18 @@ geocode_mock_backend_add_forward_result (GeocodeMockBackend *self,
                                          GList              *results,
                                          const GError       *error)
 {
-	g_autoptr (GeocodeMockBackendQuery) query = NULL;
-	gsize idx;
+	GeocodeMockBackendQuery *query;
 
 	g_return_if_fail (GEOCODE_IS_MOCK_BACKEND (self));
 	g_return_if_fail (params != NULL);
 	g_return_if_fail (results == NULL || error == NULL);
 
-	if (find_query (self->forward_results, params, &idx))
-		g_ptr_array_remove_index_fast (self->forward_results, idx);
-
+	/* Replaces any existing query with equal params. */
 	query = geocode_mock_backend_query_new (params, TRUE, results, error);
-	g_ptr_array_add (self->forward_results, g_steal_pointer (&query));
+
+	g_mutex_lock (&self->lock);
+	g_hash_table_replace (self->forward_results, query->params, query);
+	g_mutex_unlock (&self->lock);
 }
 
 /**
@@ -489,18 +764,18 @@ geocode_mock_backend_add_reverse_result (GeocodeMockBackend *self,
                                          GList              *results,
                                          const GError       *error)
 {
-	g_autoptr (GeocodeMockBackendQuery) query = NULL;
-	gsize idx;
+	GeocodeMockBackendQuery *query;
 
 	g_return_if_fail (GEOCODE_IS_MOCK_BACKEND (self));
 	g_return_if_fail (params != NULL);
 	g_return_if_fail (results == NULL || error == NULL);
 
-	if (find_query (self->reverse_results, params, &idx))
-		g_ptr_array_remove_index_fast (self->reverse_results, idx);
-
+	/* Replaces any existing query with equal params. */
 	query = geocode_mock_backend_query_new (params, FALSE, results, error);
-	g_ptr_array_add (self->reverse_results, g_steal_pointer (&query));
+
+	g_mutex_lock (&self->lock);
+	g_hash_table_replace (self->reverse_results, query->params, query);
+	g_mutex_unlock (&self->lock);
 }
 
 /**
@@ -510,9 +785,12 @@ geocode_mock_backend_add_reverse_result (GeocodeMockBackend *self,
  * Clear the set of stored results in the mock backend which have been added
  * using geocode_mock_backend_add_forward_result() and
  * geocode_mock_backend_add_reverse_result(). Additionally, clear the query log
- * so far (see geocode_mock_backend_get_query_log()).
+ * so far (see geocode_mock_backend_get_query_log()), the counters returned by
+ * geocode_mock_backend_get_stats(), and the latencies set with
+ * geocode_mock_backend_set_query_latency().
  *
- * This effectively resets the mock backend to its initial state.
+ * This effectively resets the mock backend to its initial state, apart from
+ * the query log capacity, latency distribution, jitter and error rate.
  *
  * Since: 3.23.1
  */
@@ -521,9 +799,15 @@ geocode_mock_backend_clear (GeocodeMockBackend *self)
 {
 	g_return_if_fail (GEOCODE_MOCK_BACKEND (self));
 
+	g_mutex_lock (&self->lock);
+	g_hash_table_remove_all (self->forward_results);
+	g_hash_table_remove_all (self->reverse_results);
 	g_ptr_array_set_size (self->query_log, 0);
-	g_ptr_array_set_size (self->forward_results, 0);
-	g_ptr_array_set_size (self->reverse_results, 0);
+	self->query_log_start = 0;
+	g_hash_table_remove_all (self->query_latencies);
+	g_mutex_unlock (&self->lock);
+
+	_geocode_stats_reset (&self->stats);
 }
 
 /**
@@ -540,7 +824,11 @@ geocode_mock_backend_clear (GeocodeMockBackend *self)
  *
  * The results are provided in the order in which calls were made to
  * geocode_backend_forward_search() and geocode_backend_reverse_resolve().
- * Results for forward and reverse queries may be interleaved.
+ * Results for forward and reverse queries may be interleaved. Only the most
+ * recent queries are kept if the log has a capacity (see
+ * geocode_mock_backend_set_query_log_capacity()).
+ *
+ * The returned array is only valid until the next query on the backend.
  *
  * Returns: (transfer none) (element-type GeocodeMockBackendQuery): potentially
  *     empty sequence of forward and reverse query details
@@ -551,18 +839,279 @@ geocode_mock_backend_get_query_log (GeocodeMockBackend *self)
 {
 	g_return_val_if_fail (GEOCODE_IS_MOCK_BACKEND (self), NULL);
 
+	g_mutex_lock (&self->lock);
+	query_log_rotate_locked (self);
+	g_mutex_unlock (&self->lock);
+
 	return self->query_log;
 }
 
+/**
+ * geocode_mock_backend_get_query_log_capacity:
+ * @self: a #GeocodeMockBackend
+ *
+ * Gets the maximum number of queries kept in the query log. See
+ * geocode_mock_backend_set_query_log_capacity().
+ *
+ * Returns: the query log capacity, or %G_MAXUINT if it is unbounded
+ *
+ * Since: 3.28
+ */
+guint
+geocode_mock_backend_get_query_log_capacity (GeocodeMockBackend *self)
+{
+	guint capacity;
+
+	g_return_val_if_fail (GEOCODE_IS_MOCK_BACKEND (self), 0);
+
+	g_mutex_lock (&self->lock);
+	capacity = self->query_log_capacity;
+	g_mutex_unlock (&self->lock);
+
+	return capacity;
+}
+
+/**
+ * geocode_mock_backend_set_query_log_capacity:
+ * @self: a #GeocodeMockBackend
+ * @capacity: maximum number of queries to keep in the query log, or
+ *     %G_MAXUINT to keep all of them
+ *
+ * Limits the query log to the @capacity most recent queries, so that the
+ * memory a long-running load or soak test uses for it stays bounded. Older
+ * queries are dropped, oldest first, including straight away if more than
+ * @capacity are already logged.
+ *
+ * If @capacity is 0, the details of queries are not logged at all, and only
+ * their counts and timings are kept, in the counters returned by
+ * geocode_mock_backend_get_stats().
+ *
+ * By default the capacity is %G_MAXUINT.
+ *
+ * Since: 3.28
+ */
+void
+geocode_mock_backend_set_query_log_capacity (GeocodeMockBackend *self,
+                                             guint               capacity)
+{
+	g_return_if_fail (GEOCODE_IS_MOCK_BACKEND (self));
+
+	g_mutex_lock (&self->lock);
+
+	self->query_log_capacity = capacity;
+	query_log_rotate_locked (self);
+
+	if (self->query_log->len > capacity) {
+		g_ptr_array_remove_range (self->query_log, 0,
+		                          self->query_log->len - capacity);
+	}
+
+	g_mutex_unlock (&self->lock);
+}
+
+/**
+ * geocode_mock_backend_get_stats:
+ * @self: a #GeocodeMockBackend
+ *
+ * Gets a snapshot of the counters kept about the queries made on the mock
+ * backend since it was created or last cleared, which are updated whatever
+ * the capacity of the query log.
+ *
+ * Queries answered with mock results or errors added for them count as cache
+ * hits, and other queries as cache misses. Queries answered with results
+ * count as HTTP 2xx responses and those answered with an error as no
+ * response. The latency of each query is the injected latency (see
+ * geocode_mock_backend_set_latency()).
+ *
+ * Returns: (transfer full): a new #GeocodeStats. Use geocode_stats_free()
+ * when done.
+ *
+ * Since: 3.28
+ */
+GeocodeStats *
+geocode_mock_backend_get_stats (GeocodeMockBackend *self)
+{
+	GeocodeStats *stats;
+
+	g_return_val_if_fail (GEOCODE_IS_MOCK_BACKEND (self), NULL);
+
+	stats = g_new0 (GeocodeStats, 1);
+	_geocode_stats_snapshot (&self->stats, stats);
+
+	return stats;
+}
+
+/**
+ * geocode_mock_backend_set_latency:
+ * @self: a #GeocodeMockBackend
+ * @distribution: distribution of query latencies
+ * @latency: for %GEOCODE_MOCK_LATENCY_FIXED, the latency; for
+ *     %GEOCODE_MOCK_LATENCY_UNIFORM, the minimum latency; for
+ *     %GEOCODE_MOCK_LATENCY_LOG_NORMAL, the median latency; in milliseconds
+ * @spread: for %GEOCODE_MOCK_LATENCY_UNIFORM, the maximum latency in
+ *     milliseconds; for %GEOCODE_MOCK_LATENCY_LOG_NORMAL, the standard
+ *     deviation of the logarithm of the latency; ignored otherwise
+ *
+ * Set how long the mock backend takes to answer queries, so that the
+ * behaviour of code under test can be checked against a slow or erratic
+ * geocoding service. Each query draws its own latency from @distribution.
+ *
+ * The synchronous methods block for the latency. The asynchronous methods
+ * answer from a timeout in the thread-default main context of the caller,
+ * without blocking a thread. Either returns %G_IO_ERROR_CANCELLED as soon as
+ * the query is cancelled.
+ *
+ * Since: 3.28
+ */
+void
+geocode_mock_backend_set_latency (GeocodeMockBackend *self,
+                                  GeocodeMockLatency  distribution,
+                                  gdouble             latency,
+                                  gdouble             spread)
+{
+	g_return_if_fail (GEOCODE_IS_MOCK_BACKEND (self));
+	g_return_if_fail (distribution <= GEOCODE_MOCK_LATENCY_LOG_NORMAL);
+	g_return_if_fail (latency >= 0.0);
+	g_return_if_fail (spread >= 0.0);
+
+	g_mutex_lock (&self->lock);
+	self->latency_distribution = distribution;
+	self->latency = latency;
+	self->latency_spread = spread;
+	g_mutex_unlock (&self->lock);
+}
+
+/**
+ * geocode_mock_backend_set_jitter:
+ * @self: a #GeocodeMockBackend
+ * @jitter: maximum jitter, in milliseconds
+ *
+ * Add a uniformly distributed offset of up to ±@jitter to the latency of
+ * each query (see geocode_mock_backend_set_latency()). Latencies are never
+ * negative.
+ *
+ * Since: 3.28
+ */
+void
+geocode_mock_backend_set_jitter (GeocodeMockBackend *self,
+                                 gdouble             jitter)
+{
+	g_return_if_fail (GEOCODE_IS_MOCK_BACKEND (self));
+	g_return_if_fail (jitter >= 0.0);
+
+	g_mutex_lock (&self->lock);
+	self->jitter = jitter;
+	g_mutex_unlock (&self->lock);
+}
+
+/**
+ * geocode_mock_backend_set_query_latency:
+ * @self: a #GeocodeMockBackend
+ * @params: (transfer none) (element-type utf8 GValue): query parameters to
+ *     set the latency for
+ * @latency: latency in milliseconds, or a negative value to use the latency
+ *     distribution again
+ *
+ * Set a fixed latency for forward and reverse queries for @params,
+ * replacing the latency distribution and jitter for them. This allows a
+ * test to make one query slow while the others are fast.
+ *
+ * Per-query latencies are removed by geocode_mock_backend_clear().
+ *
+ * Since: 3.28
+ */
+void
+geocode_mock_backend_set_query_latency (GeocodeMockBackend *self,
+                                        GHashTable         *params,
+                                        gdouble             latency)
+{
+	gdouble *query_latency;
+
+	g_return_if_fail (GEOCODE_IS_MOCK_BACKEND (self));
+	g_return_if_fail (params != NULL);
+
+	g_mutex_lock (&self->lock);
+
+	if (latency < 0.0) {
+		g_hash_table_remove (self->query_latencies, params);
+	} else {
+		query_latency = g_new (gdouble, 1);
+		*query_latency = latency;
+		g_hash_table_replace (self->query_latencies,
+		                      _geocode_params_copy (params), query_latency);
+	}
+
+	g_mutex_unlock (&self->lock);
+}
+
+/**
+ * geocode_mock_backend_set_error_rate:
+ * @self: a #GeocodeMockBackend
+ * @error_rate: probability of a query failing, between 0 and 1
+ * @error: (nullable): error to fail queries with, or %NULL for
+ *     %GEOCODE_ERROR_INTERNAL_SERVER
+ *
+ * Make a random fraction of queries fail with @error, whatever results have
+ * been added for them, so that the error handling of code under test can be
+ * exercised. Failed queries are logged with @error, and still take the
+ * latency set with geocode_mock_backend_set_latency().
+ *
+ * Since: 3.28
+ */
+void
+geocode_mock_backend_set_error_rate (GeocodeMockBackend *self,
+                                     gdouble             error_rate,
+                                     const GError       *error)
+{
+	g_return_if_fail (GEOCODE_IS_MOCK_BACKEND (self));
+	g_return_if_fail (error_rate >= 0.0 && error_rate <= 1.0);
+
+	g_mutex_lock (&self->lock);
+	self->error_rate = error_rate;
+	g_clear_error (&self->injected_error);
+	if (error != NULL)
+		self->injected_error = g_error_copy (error);
+	g_mutex_unlock (&self->lock);
+}
+
+/**
+ * geocode_mock_backend_set_seed:
+ * @self: a #GeocodeMockBackend
+ * @seed: seed for the random number generator
+ *
+ * Seed the random number generator used to draw latencies and failures, so
+ * that a test sees the same sequence of them on every run.
+ *
+ * Since: 3.28
+ */
+void
+geocode_mock_backend_set_seed (GeocodeMockBackend *self,
+                               guint32             seed)
+{
+	g_return_if_fail (GEOCODE_IS_MOCK_BACKEND (self));
+
+	g_mutex_lock (&self->lock);
+	g_rand_set_seed (self->rand, seed);
+	g_mutex_unlock (&self->lock);
+}
+
 static void
 geocode_mock_backend_init (GeocodeMockBackend *self)
 {
+	g_mutex_init (&self->lock);
+	self->rand = g_rand_new ();
+	self->query_latencies =
+	    g_hash_table_new_full (_geocode_params_hash, _geocode_params_equal,
+	                           (GDestroyNotify) g_hash_table_unref, g_free);
 	self->query_log =
 	    g_ptr_array_new_with_free_func ((GDestroyNotify) geocode_mock_backend_query_free);
+	self->query_log_capacity = G_MAXUINT;
 	self->forward_results =
-	    g_ptr_array_new_with_free_func ((GDestroyNotify) geocode_mock_backend_query_free);
+	    g_hash_table_new_full (_geocode_params_hash, _geocode_params_equal,
+	                           NULL, (GDestroyNotify) geocode_mock_backend_query_free);
 	self->reverse_results =
-	    g_ptr_array_new_with_free_func ((GDestroyNotify) geocode_mock_backend_query_free);
+	    g_hash_table_new_full (_geocode_params_hash, _geocode_params_equal,
+	                           NULL, (GDestroyNotify) geocode_mock_backend_query_free);
 }
 
 static void
@@ -570,8 +1119,13 @@ geocode_mock_backend_finalize (GObject *object)
 {
 	GeocodeMockBackend *self = GEOCODE_MOCK_BACKEND (object);
 
-	g_clear_pointer (&self->forward_results, g_ptr_array_unref);
-	g_clear_pointer (&self->reverse_results, g_ptr_array_unref);
+	g_clear_pointer (&self->forward_results, g_hash_table_unref);
+	g_clear_pointer (&self->reverse_results, g_hash_table_unref);
+	g_clear_pointer (&self->query_log, g_ptr_array_unref);
+	g_clear_pointer (&self->query_latencies, g_hash_table_unref);
+	g_clear_pointer (&self->rand, g_rand_free);
+	g_clear_error (&self->injected_error);
+	g_mutex_clear (&self->lock);
 
 	G_OBJECT_CLASS (geocode_mock_backend_parent_class)->finalize (object);
 }
@@ -579,10 +1133,12 @@ geocode_mock_backend_finalize (GObject *object)
 static void
 geocode_backend_iface_init (GeocodeBackendInterface *iface)
 {
-	/* We use the default implementation of the asynchronous methods, which
-	 * runs the synchronous version in a thread. */
 	iface->forward_search = geocode_mock_backend_forward_search;
+	iface->forward_search_async = geocode_mock_backend_forward_search_async;
+	iface->forward_search_finish = geocode_mock_backend_forward_search_finish;
 	iface->reverse_resolve = geocode_mock_backend_reverse_resolve;
+	iface->reverse_resolve_async = geocode_mock_backend_reverse_resolve_async;
+	iface->reverse_resolve_finish = geocode_mock_backend_reverse_resolve_finish;
 }
 
 static void
@@ -25,6 +25,8 @@
 #include <glib.h>
 #include <glib-object.h>
 
+#include "geocode-stats.h"
+
 G_BEGIN_DECLS
 
 /**
@@ -60,6 +62,43 @@ void geocode_mock_backend_add_reverse_result (GeocodeMockBackend *self,
 
 void geocode_mock_backend_clear              (GeocodeMockBackend *self);
 
+/**
+ * GeocodeMockLatency:
+ * @GEOCODE_MOCK_LATENCY_NONE: Queries are answered straight away.
+ * @GEOCODE_MOCK_LATENCY_FIXED: Every query takes the same time.
+ * @GEOCODE_MOCK_LATENCY_UNIFORM: Query times are uniformly distributed over
+ *     a range.
+ * @GEOCODE_MOCK_LATENCY_LOG_NORMAL: Query times are log-normally
+ *     distributed, with a long tail of slow queries, as network latencies
+ *     tend to be.
+ *
+ * Distribution of the time a #GeocodeMockBackend takes to answer queries.
+ * See geocode_mock_backend_set_latency().
+ *
+ * Since: 3.28
+ */
+typedef enum {
+	GEOCODE_MOCK_LATENCY_NONE,
+	GEOCODE_MOCK_LATENCY_FIXED,
+	GEOCODE_MOCK_LATENCY_UNIFORM,
+	GEOCODE_MOCK_LATENCY_LOG_NORMAL,
+} GeocodeMockLatency;
+
+void geocode_mock_backend_set_latency       (GeocodeMockBackend *self,
+                                             GeocodeMockLatency  distribution,
+                                             gdouble             latency,
+                                             gdouble             spread);
+void geocode_mock_backend_set_jitter        (GeocodeMockBackend *self,
+                                             gdouble             jitter);
+void geocode_mock_backend_set_query_latency (GeocodeMockBackend *self,
+                                             GHashTable         *params,
+                                             gdouble             latency);
+void geocode_mock_backend_set_error_rate    (GeocodeMockBackend *self,
+                                             gdouble             error_rate,
+                                             const GError       *error);
+void geocode_mock_backend_set_seed          (GeocodeMockBackend *self,
+                                             guint32             seed);
+
 /**
  * GeocodeMockBackendQuery:
  * @params: query parameters, in the format accepted by geocode_forward_search()
@@ -93,6 +132,12 @@ typedef struct {
 
 GPtrArray *geocode_mock_backend_get_query_log (GeocodeMockBackend *self);
 
+guint geocode_mock_backend_get_query_log_capacity (GeocodeMockBackend *self);
+void  geocode_mock_backend_set_query_log_capacity (GeocodeMockBackend *self,
+                                                   guint               capacity);
+
+GeocodeStats *geocode_mock_backend_get_stats (GeocodeMockBackend *self);
+
 G_END_DECLS
 
 #endif /* GEOCODE_MOCK_BACKEND_H */
@@ -31,6 +31,7 @@
 #include "geocode-glib-private.h"
 #include "geocode-glib.h"
 #include "geocode-nominatim.h"
+#include "geocode-trace-private.h"
 
 /**
  * SECTION:geocode-nominatim
@@ -50,14 +51,19 @@ typedef enum {
 	PROP_BASE_URL = 1,
 	PROP_MAINTAINER_EMAIL_ADDRESS,
 	PROP_USER_AGENT,
+	PROP_TIMEOUT,
 } GeocodeNominatimProperty;
 
-static GParamSpec *properties[PROP_USER_AGENT + 1];
+static GParamSpec *properties[PROP_TIMEOUT + 1];
+
+#define DEFAULT_TIMEOUT 30 /* seconds */
 
 typedef struct {
 	char *base_url;
 	char *maintainer_email_address;
 	char *user_agent;
+	guint timeout;
+	GeocodeStats stats;
 } GeocodeNominatimPrivate;
 
 static void geocode_backend_iface_init (GeocodeBackendInterface *iface);
@@ -69,8 +75,9 @@ G_DEFINE_TYPE_WITH_CODE (GeocodeNominatim, geocode_nominatim, G_TYPE_OBJECT,
 
 /******************************************************************************/
 
-static void _geocode_read_nominatim_attributes (JsonReader *reader,
-                                                GHashTable *ht);
+static void _geocode_read_nominatim_attributes (JsonReader       *reader,
+                                                GeocodeResultSet *set,
+                                                GHashTable       *ht);
 
 static struct {
 	const char *tp_attr;
@@ -305,18 +312,6 @@ fill_place_from_entry (const char   *key,
         }
 }
 
-static gboolean
-node_free_func (GNode    *node,
-		gpointer  user_data)
-{
-	/* Leaf nodes are GeocodeLocation objects
-	 * which we reuse for the results */
-	if (G_NODE_IS_LEAF (node) == FALSE)
-		g_free (node->data);
-
-	return FALSE;
-}
-
 static const char *place_attributes[] = {
 	"country",
 	"state",
@@ -441,6 +436,7 @@ _geocode_create_place_from_attributes (GHashTable *ht)
         const char *name, *street, *building, *bbox_corner;
         GeocodePlaceType place_type;
         gdouble longitude, latitude;
+        GEOCODE_TRACE_BEGIN (trace_begin);
 
         place_type = get_place_type_from_attributes (ht);
 
@@ -501,6 +497,8 @@ _geocode_create_place_from_attributes (GHashTable *ht)
         geocode_place_set_location (place, loc);
         g_object_unref (loc);
 
+        GEOCODE_TRACE_MARK (trace_begin, "create-place", "%s", name);
+
         return place;
 }
 
@@ -509,9 +507,10 @@ insert_place_into_tree (GNode *place_tree, GHashTable *ht)
 {
 	GNode *start = place_tree;
         GeocodePlace *place = NULL;
-	char *attr_val = NULL;
+	const char *attr_val = NULL;
 	guint i;
 
+	/* Non-leaf nodes point to attribute values owned by the result set */
 	for (i = 0; i < G_N_ELEMENTS (place_attributes); i++) {
 		GNode *child = NULL;
 
@@ -531,7 +530,7 @@ insert_place_into_tree (GNode *place_tree, GHashTable *ht)
 			}
 			if (!child) {
 				/* create a new node */
-				child = g_node_insert_data (start, -1, g_strdup (attr_val));
+				child = g_node_insert_data (start, -1, (gpointer) attr_val);
 			}
 		}
 		start = child;
@@ -545,10 +544,11 @@ insert_place_into_tree (GNode *place_tree, GHashTable *ht)
 }
 
 static void
-make_place_list_from_tree (GNode  *node,
-                           char  **s_array,
-                           GList **place_list,
-                           int     i)
+make_place_list_from_tree (GNode             *node,
+                           const char       **s_array,
+                           GeocodeResultSet  *set,
+                           GList            **place_list,
+                           int                i)
 {
 	GNode *child;
 
@@ -556,32 +556,31 @@ make_place_list_from_tree (GNode  *node,
 		return;
 
 	if (G_NODE_IS_LEAF (node)) {
-		GPtrArray *rev_s_array;
 		GeocodePlace *place;
 		GeocodeLocation *loc;
-		char *name;
+		const char *name;
+		GString *full_name;
 		int counter = 0;
 
-		rev_s_array = g_ptr_array_new ();
-
 		/* If leaf node, then add all the attributes in the s_array
 		 * and set it to the description of the loc object */
 		place = (GeocodePlace *) node->data;
-		name = (char *) geocode_place_get_name (place);
+		name = geocode_place_get_name (place);
 		loc = geocode_place_get_location (place);
 
 		/* To print the attributes in a meaningful manner
 		 * reverse the s_array */
-		g_ptr_array_add (rev_s_array, (gpointer) name);
-		for (counter = 1; counter <= i; counter++)
-			g_ptr_array_add (rev_s_array, s_array[i - counter]);
-		g_ptr_array_add (rev_s_array, NULL);
-		name = g_strjoinv (", ", (char **) rev_s_array->pdata);
-		g_ptr_array_unref (rev_s_array);
+		full_name = _geocode_result_set_get_scratch (set);
+		if (name != NULL) {
+			g_string_append (full_name, name);
+			for (counter = 1; counter <= i; counter++) {
+				g_string_append (full_name, ", ");
+				g_string_append (full_name, s_array[i - counter]);
+			}
+		}
 
-		geocode_place_set_name (place, name);
-		geocode_location_set_description (loc, name);
-		g_free (name);
+		geocode_place_set_name (place, full_name->str);
+		geocode_location_set_description (loc, full_name->str);
 
 		*place_list = g_list_prepend (*place_list, place);
 	} else {
@@ -599,7 +598,7 @@ make_place_list_from_tree (GNode  *node,
 	}
 
 	for (child = node->children; child != NULL; child = child->next)
-		make_place_list_from_tree (child, s_array, place_list, i);
+		make_place_list_from_tree (child, s_array, set, place_list, i);
 }
 
 GList *
@@ -613,17 +612,21 @@ _geocode_parse_search_json (const char *contents,
 	const GError *err = NULL;
 	int num_places, i;
 	GNode *place_tree;
-	char *s_array[G_N_ELEMENTS (place_attributes)];
+	GeocodeResultSet *set;
+	const char *s_array[G_N_ELEMENTS (place_attributes)];
 
 	g_debug ("%s: contents = %s", G_STRFUNC, contents);
 
 	ret = NULL;
 
+	GEOCODE_TRACE_BEGIN (trace_begin);
 	parser = json_parser_new ();
 	if (json_parser_load_from_data (parser, contents, -1, error) == FALSE) {
 		g_object_unref (parser);
 		return ret;
 	}
+	GEOCODE_TRACE_MARK (trace_begin, "parse-json", "%" G_GSIZE_FORMAT " bytes",
+	                    strlen (contents));
 
 	root = json_parser_get_root (parser);
 	reader = json_reader_new (root);
@@ -639,6 +642,8 @@ _geocode_parse_search_json (const char *contents,
 		goto no_results;
         }
 
+	GEOCODE_TRACE_RESTART (trace_begin);
+	set = _geocode_result_set_new ();
 	place_tree = g_node_new (NULL);
 
 	for (i = 0; i < num_places; i++) {
@@ -646,28 +651,20 @@ _geocode_parse_search_json (const char *contents,
 
 		json_reader_read_element (reader, i);
 
-                ht = g_hash_table_new_full (g_str_hash, g_str_equal,
-				            g_free, g_free);
-                _geocode_read_nominatim_attributes (reader, ht);
+		ht = _geocode_result_set_new_attributes (set);
+		_geocode_read_nominatim_attributes (reader, set, ht);
 
 		/* Populate the tree with place details */
 		insert_place_into_tree (place_tree, ht);
 
-		g_hash_table_unref (ht);
-
 		json_reader_end_element (reader);
 	}
 
-	make_place_list_from_tree (place_tree, s_array, &ret, 0);
-
-	g_node_traverse (place_tree,
-			 G_IN_ORDER,
-			 G_TRAVERSE_ALL,
-			 -1,
-			 (GNodeTraverseFunc) node_free_func,
-			 NULL);
+	make_place_list_from_tree (place_tree, s_array, set, &ret, 0);
+	GEOCODE_TRACE_MARK (trace_begin, "disambiguate", "%d places", num_places);
 
 	g_node_destroy (place_tree);
+	_geocode_result_set_free (set);
 
 	g_object_unref (parser);
 	g_object_unref (reader);
@@ -683,6 +680,25 @@ no_results:
 	return NULL;
 }
 
+static GList *
+parse_search_json (GeocodeNominatim  *self,
+                   const char        *contents,
+                   GError           **error)
+{
+	GeocodeNominatimPrivate *priv;
+	GList *places;  /* (element-type GeocodePlace) */
+	gint64 start_time;
+
+	priv = geocode_nominatim_get_instance_private (self);
+
+	start_time = g_get_monotonic_time ();
+	places = _geocode_parse_search_json (contents, error);
+	_geocode_stats_record_parse (&priv->stats,
+	                             g_get_monotonic_time () - start_time);
+
+	return places;
+}
+
 static GList *
 geocode_nominatim_forward_search (GeocodeBackend  *backend,
                                   GHashTable      *params,
@@ -695,6 +711,7 @@ geocode_nominatim_forward_search (GeocodeBackend  *backend,
 	GList *result = NULL;  /* (element-type GeocodePlace) */
 	gchar *uri = NULL;
 
+	GEOCODE_TRACE_BEGIN (trace_begin);
 	transformed_params = geocode_forward_fill_params (params);
 	uri = get_search_uri_for_params (self, transformed_params, error);
 	g_hash_table_unref (transformed_params);
@@ -702,12 +719,14 @@ geocode_nominatim_forward_search (GeocodeBackend  *backend,
 	if (uri == NULL)
 		return NULL;
 
+	GEOCODE_TRACE_MARK (trace_begin, "build-uri", "%s", uri);
+
 	contents = GEOCODE_NOMINATIM_GET_CLASS (self)->query (self,
 	                                                      uri,
 	                                                      cancellable,
 	                                                      error);
 	if (contents != NULL) {
-		result = _geocode_parse_search_json (contents, error);
+		result = parse_search_json (self, contents, error);
 		g_free (contents);
 	}
 
@@ -732,7 +751,7 @@ on_forward_query_ready (GeocodeNominatim *self,
 		return;
 	}
 
-	places = _geocode_parse_search_json (contents, &error);
+	places = parse_search_json (self, contents, &error);
 	g_free (contents);
 
 	if (places == NULL) {
@@ -758,6 +777,7 @@ geocode_nominatim_forward_search_async (GeocodeBackend      *backend,
 	gchar *uri = NULL;
 	GError *error = NULL;
 
+	GEOCODE_TRACE_BEGIN (trace_begin);
 	transformed_params = geocode_forward_fill_params (params);
 	uri = get_search_uri_for_params (self, transformed_params, &error);
 	g_hash_table_unref (transformed_params);
@@ -767,6 +787,8 @@ geocode_nominatim_forward_search_async (GeocodeBackend      *backend,
 		return;
 	}
 
+	GEOCODE_TRACE_MARK (trace_begin, "build-uri", "%s", uri);
+
 	task = g_task_new (self, cancellable, callback, user_data);
 	GEOCODE_NOMINATIM_GET_CLASS (self)->query_async (self,
 	                                                 uri,
@@ -881,106 +903,276 @@ geocode_nominatim_query_finish (GeocodeNominatim  *self,
 	return g_task_propagate_pointer (G_TASK (res), error);
 }
 
+typedef struct {
+	SoupSession *session;  /* owned; NULL until the query goes to the network */
+	SoupMessage *message;  /* owned */
+	gint64 start_time;  /* monotonic time at which the request was sent */
+#ifdef HAVE_SYSPROF
+	gint64 trace_begin;  /* start of the current stage */
+#endif
+} QueryData;
+
+static void
+query_data_free (QueryData *data)
+{
+	g_clear_object (&data->session);
+	g_object_unref (data->message);
+	g_free (data);
+}
+
+/* Cancellation is reported as-is so that callers can tell an aborted
+ * query apart from a failed one, and an expired #GeocodeNominatim:timeout
+ * as %GEOCODE_ERROR_TIMED_OUT; everything else is a generic failure. */
+static GError *
+query_error_from_transport_error (GError *transport_error)
+{
+	GError *error;
+
+	if (g_error_matches (transport_error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+		return transport_error;
+
+	if (g_error_matches (transport_error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT))
+		error = g_error_new_literal (GEOCODE_ERROR, GEOCODE_ERROR_TIMED_OUT,
+		                             transport_error->message);
+	else
+		error = g_error_new_literal (G_IO_ERROR, G_IO_ERROR_FAILED,
+		                             transport_error->message);
+	g_error_free (transport_error);
+
+	return error;
+}
+
+static guint
+query_get_status (SoupMessage *query)
+{
+#if SOUP_CHECK_VERSION (2, 99, 2)
+	return soup_message_get_status (query);
+#else
+	return query->status_code;
+#endif
+}
+
+static gboolean
+check_query_status (SoupMessage  *query,
+                    GError      **error)
+{
+	const char *reason_phrase;
+
 #if SOUP_CHECK_VERSION (2, 99, 2)
+	reason_phrase = soup_message_get_reason_phrase (query);
+#else
+	reason_phrase = query->reason_phrase;
+#endif
+
+	if (query_get_status (query) != SOUP_STATUS_OK) {
+		g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+		                     reason_phrase ? reason_phrase : "Query failed");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* @body is %NULL if the request failed before a response was received. */
+static void
+record_response (GeocodeNominatim *self,
+                 SoupMessage      *query,
+                 GBytes           *body,
+                 gint64            start_time)
+{
+	GeocodeNominatimPrivate *priv;
+
+	priv = geocode_nominatim_get_instance_private (self);
+	_geocode_stats_record_response (&priv->stats,
+	                                body != NULL ? query_get_status (query) : 0,
+	                                body != NULL ? g_bytes_get_size (body) : 0,
+	                                g_get_monotonic_time () - start_time);
+}
+
+static char *
+contents_from_body (SoupMessage *query,
+                    GBytes      *body)
+{
+	gsize size = 0;
+	gconstpointer data = g_bytes_get_data (body, &size);
+	char *contents = g_utf8_make_valid (data, size);
+	GEOCODE_TRACE_BEGIN (trace_begin);
+
+	_geocode_glib_cache_save (query, contents);
+	GEOCODE_TRACE_MARK (trace_begin, "cache-save", "%" G_GSIZE_FORMAT " bytes", size);
+
+	return contents;
+}
+
+/* Sends @query and reads the whole response body. Unlike
+ * soup_session_send_message(), the libsoup2 code path goes through
+ * soup_session_send() so that @cancellable aborts the connection. */
+static GBytes *
+query_send_and_read (SoupSession   *session,
+                     SoupMessage   *query,
+                     GCancellable  *cancellable,
+                     GError       **error)
+{
+#if SOUP_CHECK_VERSION (2, 99, 2)
+	return soup_session_send_and_read (session, query, cancellable, error);
+#else
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GOutputStream) output = NULL;
+
+	stream = soup_session_send (session, query, cancellable, error);
+	if (stream == NULL)
+		return NULL;
+
+	output = g_memory_output_stream_new_resizable ();
+	if (g_output_stream_splice (output,
+	                            stream,
+	                            G_OUTPUT_STREAM_SPLICE_CLOSE_SOURCE |
+	                            G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET,
+	                            cancellable,
+	                            error) < 0)
+		return NULL;
+
+	return g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (output));
+#endif
+}
+
 static void
 on_query_data_loaded (GObject      *object,
                       GAsyncResult *result,
                       gpointer      user_data)
 {
-	SoupSession *session = SOUP_SESSION (object);
-	SoupMessage *query = soup_session_get_async_result_message (session, result);
-	GError *error = NULL;
-	g_autoptr(GBytes) body = soup_session_send_and_read_finish (session, result, &error);
 	GTask *task = user_data;
+	QueryData *data = g_task_get_task_data (task);
+	GError *error = NULL;
+	g_autoptr(GBytes) body = NULL;
 
-	if (!body) {
-		g_task_return_new_error (task,
-		                         G_IO_ERROR,
-		                         G_IO_ERROR_FAILED,
-		                         "%s",
-		                         error->message);
-		g_clear_error (&error);
-	} else if (soup_message_get_status (query) != SOUP_STATUS_OK) {
-		const char *reason_phrase = soup_message_get_reason_phrase (query);
-		g_task_return_new_error (task,
-		                         G_IO_ERROR,
-		                         G_IO_ERROR_FAILED,
-		                         "%s",
-		                         reason_phrase ? reason_phrase : "Query failed");
-	} else {
-		gsize size = 0;
-		gconstpointer data = g_bytes_get_data (body, &size);
-		gchar *contents = g_utf8_make_valid (data, size);
+#if SOUP_CHECK_VERSION (2, 99, 2)
+	body = soup_session_send_and_read_finish (SOUP_SESSION (object), result, &error);
+#else
+	if (g_output_stream_splice_finish (G_OUTPUT_STREAM (object), result, &error) >= 0)
+		body = g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (object));
+#endif
 
-		_geocode_glib_cache_save (query, contents);
-		g_task_return_pointer (task, contents, g_free);
-	}
+	record_response (g_task_get_source_object (task), data->message, body,
+	                 data->start_time);
+	GEOCODE_TRACE_MARK (data->trace_begin, "http-receive", "%" G_GSIZE_FORMAT " bytes",
+	                    body != NULL ? g_bytes_get_size (body) : 0);
+
+	if (body == NULL)
+		g_task_return_error (task, query_error_from_transport_error (error));
+	else if (!check_query_status (data->message, &error))
+		g_task_return_error (task, error);
+	else
+		g_task_return_pointer (task,
+		                       contents_from_body (data->message, body),
+		                       g_free);
 
 	g_object_unref (task);
 }
-#else
+
+#if !SOUP_CHECK_VERSION (2, 99, 2)
 static void
-on_query_data_loaded (SoupSession *session,
-                      SoupMessage *query,
-                      GTask       *task)
+on_query_sent (GObject      *object,
+               GAsyncResult *result,
+               gpointer      user_data)
 {
-	char *contents;
-
-	if (query->status_code != SOUP_STATUS_OK)
-		g_task_return_new_error (task,
-		                         G_IO_ERROR,
-		                         G_IO_ERROR_FAILED,
-		                         "%s",
-		                         query->reason_phrase ? query->reason_phrase : "Query failed");
-	else {
-		contents = g_utf8_make_valid (query->response_body->data, query->response_body->length);
-		_geocode_glib_cache_save (query, contents);
-		g_task_return_pointer (task, contents, g_free);
+	GTask *task = user_data;
+	QueryData *data = g_task_get_task_data (task);
+	GError *error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GOutputStream) output = NULL;
+
+	stream = soup_session_send_finish (SOUP_SESSION (object), result, &error);
+	GEOCODE_TRACE_MARK (data->trace_begin, "http-send", "status %u",
+	                    query_get_status (data->message));
+	GEOCODE_TRACE_RESTART (data->trace_begin);
+	if (stream == NULL) {
+		record_response (g_task_get_source_object (task), data->message,
+		                 NULL, data->start_time);
+		g_task_return_error (task, query_error_from_transport_error (error));
+		g_object_unref (task);
+		return;
 	}
 
-	g_object_unref (task);
+	output = g_memory_output_stream_new_resizable ();
+	g_output_stream_splice_async (output,
+	                              stream,
+	                              G_OUTPUT_STREAM_SPLICE_CLOSE_SOURCE |
+	                              G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET,
+	                              G_PRIORITY_DEFAULT,
+	                              g_task_get_cancellable (task),
+	                              on_query_data_loaded,
+	                              task);
 }
 #endif
 
+static void
+query_send_async (GTask *task)
+{
+	GeocodeNominatim *self = g_task_get_source_object (task);
+	GeocodeNominatimPrivate *priv;
+	QueryData *data = g_task_get_task_data (task);
+
+	priv = geocode_nominatim_get_instance_private (self);
+	_geocode_stats_record_query (&priv->stats, FALSE);
+
+	data->session = _geocode_glib_build_soup_session (priv->user_agent,
+	                                                  priv->timeout);
+	data->start_time = g_get_monotonic_time ();
+	GEOCODE_TRACE_RESTART (data->trace_begin);
+#if SOUP_CHECK_VERSION (2, 99, 2)
+	soup_session_send_and_read_async (data->session,
+	                                  data->message,
+	                                  G_PRIORITY_DEFAULT,
+	                                  g_task_get_cancellable (task),
+	                                  on_query_data_loaded,
+	                                  task);
+#else
+	soup_session_send_async (data->session,
+	                         data->message,
+	                         g_task_get_cancellable (task),
+	                         on_query_sent,
+	                         task);
+#endif
+}
+
 static void
 on_cache_data_loaded (GFile        *cache,
                       GAsyncResult *res,
                       GTask        *task)
 {
-	GeocodeNominatim *self;
-	GeocodeNominatimPrivate *priv;
 	char *contents;
-	SoupSession *soup_session;
+	GError *error = NULL;
+	G_GNUC_UNUSED QueryData *data = g_task_get_task_data (task);
 
-	self = g_task_get_source_object (task);
-	priv = geocode_nominatim_get_instance_private (self);
+	GEOCODE_TRACE_MARK (data->trace_begin, "cache-load", "%s", g_file_peek_path (cache));
 
 	if (g_file_load_contents_finish (cache,
 	                                 res,
 	                                 &contents,
 	                                 NULL,
 	                                 NULL,
-	                                 NULL)) {
+	                                 &error)) {
+		GeocodeNominatimPrivate *priv;
+
+		priv = geocode_nominatim_get_instance_private (g_task_get_source_object (task));
+		_geocode_stats_record_query (&priv->stats, TRUE);
+
 		g_task_return_pointer (task, contents, g_free);
 		g_object_unref (task);
 		return;
 	}
 
-	soup_session = _geocode_glib_build_soup_session (priv->user_agent);
-#if SOUP_CHECK_VERSION (2, 99, 2)
-	soup_session_send_and_read_async (soup_session,
-	                                  g_task_get_task_data (task),
-	                                  G_PRIORITY_DEFAULT,
-	                                  NULL,
-	                                  on_query_data_loaded,
-	                                  task);
-#else
-	soup_session_queue_message (soup_session,
-	                            g_object_ref (g_task_get_task_data (task)),
-	                            (SoupSessionCallback) on_query_data_loaded,
-	                            task);
-#endif
-	g_object_unref (soup_session);
+	/* A missing cache file is expected; only stop here if the query
+	 * was cancelled while the cache was being read. */
+	if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+		g_task_return_error (task, error);
+		g_object_unref (task);
+		return;
+	}
+	g_error_free (error);
+
+	query_send_async (task);
 }
 
 static void
@@ -991,25 +1183,23 @@ geocode_nominatim_query_async (GeocodeNominatim    *self,
                                gpointer             user_data)
 {
 	GTask *task;
-	SoupSession *soup_session;
-	SoupMessage *soup_query;
+	QueryData *data;
 	char *cache_path;
-	GeocodeNominatimPrivate *priv;
-
-	priv = geocode_nominatim_get_instance_private (self);
 
 	g_debug ("%s: uri = %s", G_STRFUNC, uri);
 
 	task = g_task_new (self, cancellable, callback, user_data);
 
-	soup_query = soup_message_new (SOUP_METHOD_GET, uri);
-	g_task_set_task_data (task, soup_query, g_object_unref);
+	data = g_new0 (QueryData, 1);
+	data->message = soup_message_new (SOUP_METHOD_GET, uri);
+	g_task_set_task_data (task, data, (GDestroyNotify) query_data_free);
 
-	cache_path = _geocode_glib_cache_path_for_query (soup_query);
+	cache_path = _geocode_glib_cache_path_for_query (data->message);
 	if (cache_path != NULL) {
 		GFile *cache;
 
 		cache = g_file_new_for_path (cache_path);
+		GEOCODE_TRACE_RESTART (data->trace_begin);
 		g_file_load_contents_async (cache,
 		                            cancellable,
 		                            (GAsyncReadyCallback) on_cache_data_loaded,
@@ -1019,21 +1209,7 @@ geocode_nominatim_query_async (GeocodeNominatim    *self,
 		return;
 	}
 
-	soup_session = _geocode_glib_build_soup_session (priv->user_agent);
-#if SOUP_CHECK_VERSION (2, 99, 2)
-	soup_session_send_and_read_async (soup_session,
-	                                  soup_query,
-	                                  G_PRIORITY_DEFAULT,
-	                                  NULL,
-	                                  on_query_data_loaded,
-	                                  task);
-#else
-	soup_session_queue_message (soup_session,
-	                            g_object_ref (soup_query),
-	                            (SoupSessionCallback) on_query_data_loaded,
-	                            task);
-#endif
-	g_object_unref (soup_session);
+	query_send_async (task);
 }
 
 static gchar *
@@ -1045,6 +1221,10 @@ geocode_nominatim_query (GeocodeNominatim  *self,
 	SoupSession *soup_session;
 	SoupMessage *soup_query;
 	char *contents;
+	GError *serror = NULL;
+	g_autoptr(GBytes) body = NULL;
+	gint64 start_time;
+	gboolean cache_hit;
 	GeocodeNominatimPrivate *priv;
 
 	priv = geocode_nominatim_get_instance_private (self);
@@ -1054,40 +1234,40 @@ geocode_nominatim_query (GeocodeNominatim  *self,
 	if (g_cancellable_set_error_if_cancelled (cancellable, error))
 		return NULL;
 
-	soup_session = _geocode_glib_build_soup_session (priv->user_agent);
 	soup_query = soup_message_new (SOUP_METHOD_GET, uri);
 
-	if (_geocode_glib_cache_load (soup_query, &contents) == FALSE) {
-#if SOUP_CHECK_VERSION (2, 99, 2)
-		GError *serror = NULL;
-		g_autoptr(GBytes) body = soup_session_send_and_read (soup_session, soup_query, NULL, &serror);
-		if (!body) {
-			g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_FAILED,
-			                     serror->message);
-			g_clear_error (&serror);
-			contents = NULL;
-		} else if (soup_message_get_status (soup_query) != SOUP_STATUS_OK) {
-			const char *reason_phrase = soup_message_get_reason_phrase (soup_query);
-			g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_FAILED,
-			                     reason_phrase ? reason_phrase : "Query failed");
-			contents = NULL;
-		} else {
-			gsize size = 0;
-			gconstpointer data = g_bytes_get_data (body, &size);
-			contents = g_utf8_make_valid (data, size);
+	GEOCODE_TRACE_BEGIN (trace_begin);
+	cache_hit = _geocode_glib_cache_load (soup_query, cancellable, &contents);
+	GEOCODE_TRACE_MARK (trace_begin, "cache-load", "%s", cache_hit ? "hit" : "miss");
 
-			_geocode_glib_cache_save (soup_query, contents);
-		}
-#else
-		if (soup_session_send_message (soup_session, soup_query) != SOUP_STATUS_OK) {
-			g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_FAILED,
-			                     soup_query->reason_phrase ? soup_query->reason_phrase : "Query failed");
-			contents = NULL;
-		} else {
-			contents = g_utf8_make_valid (soup_query->response_body->data, soup_query->response_body->length);
-			_geocode_glib_cache_save (soup_query, contents);
-		}
-#endif
+	if (cache_hit) {
+		_geocode_stats_record_query (&priv->stats, TRUE);
+		g_object_unref (soup_query);
+		return contents;
+	}
+
+	if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+		g_object_unref (soup_query);
+		return NULL;
+	}
+
+	_geocode_stats_record_query (&priv->stats, FALSE);
+
+	soup_session = _geocode_glib_build_soup_session (priv->user_agent,
+	                                                 priv->timeout);
+	start_time = g_get_monotonic_time ();
+	GEOCODE_TRACE_RESTART (trace_begin);
+	body = query_send_and_read (soup_session, soup_query, cancellable, &serror);
+	record_response (self, soup_query, body, start_time);
+	GEOCODE_TRACE_MARK (trace_begin, "http-send-receive", "%s", uri);
+
+	if (body == NULL) {
+		g_propagate_error (error, query_error_from_transport_error (serror));
+		contents = NULL;
+	} else if (!check_query_status (soup_query, error)) {
+		contents = NULL;
+	} else {
+		contents = contents_from_body (soup_query, body);
 	}
 
 	g_object_unref (soup_query);
@@ -1106,35 +1286,44 @@ geocode_nominatim_reverse_resolve_finish (GeocodeBackend  *backend,
 	return g_task_propagate_pointer (G_TASK (res), error);
 }
 
+/* @name must be a static string */
 static void
-insert_bounding_box_element (GHashTable *ht,
-                             GType       value_type,
-                             const char *name,
-                             JsonReader *reader)
+insert_bounding_box_element (GeocodeResultSet *set,
+                             GHashTable       *ht,
+                             GType             value_type,
+                             const char       *name,
+                             JsonReader       *reader)
 {
+	const char *value;
+
 	if (value_type == G_TYPE_STRING) {
 		const char *bbox_val;
 
 		bbox_val = json_reader_get_string_value (reader);
-		g_hash_table_insert (ht, g_strdup (name), g_strdup (bbox_val));
+		value = _geocode_result_set_insert (set, bbox_val);
+		g_hash_table_insert (ht, (gpointer) name, (gpointer) value);
 	} else if (value_type == G_TYPE_DOUBLE) {
 		gdouble bbox_val;
 
 		bbox_val = json_reader_get_double_value (reader);
-		g_hash_table_insert(ht, g_strdup (name), g_strdup_printf ("%lf", bbox_val));
+		value = _geocode_result_set_insert_printf (set, "%lf", bbox_val);
+		g_hash_table_insert (ht, (gpointer) name, (gpointer) value);
 	} else if (value_type == G_TYPE_INT64) {
 		gint64 bbox_val;
 
 		bbox_val = json_reader_get_double_value (reader);
-		g_hash_table_insert(ht, g_strdup (name), g_strdup_printf ("%"G_GINT64_FORMAT, bbox_val));
+		value = _geocode_result_set_insert_printf (set, "%"G_GINT64_FORMAT, bbox_val);
+		g_hash_table_insert (ht, (gpointer) name, (gpointer) value);
 	} else {
 		g_debug ("Unhandled node type %s for %s", g_type_name (value_type), name);
 	}
 }
 
+/* The keys and values inserted into @ht are owned by @set */
 static void
-_geocode_read_nominatim_attributes (JsonReader *reader,
-                                    GHashTable *ht)
+_geocode_read_nominatim_attributes (JsonReader       *reader,
+                                    GeocodeResultSet *set,
+                                    GHashTable       *ht)
 {
 	char **members;
 	guint i;
@@ -1150,42 +1339,46 @@ _geocode_read_nominatim_attributes (JsonReader *reader,
 	}
 
 	for (i = 0; members[i] != NULL; i++) {
-		char *value = NULL;
+		const char *value = NULL;
 
 		json_reader_read_member (reader, members[i]);
 
 		if (json_reader_is_value (reader)) {
 			JsonNode *node = json_reader_get_value (reader);
 			if (json_node_get_value_type (node) == G_TYPE_STRING) {
-				value = g_strdup (json_node_get_string (node));
+				value = json_node_get_string (node);
 				if (value && *value == '\0')
-					g_clear_pointer (&value, g_free);
+					value = NULL;
+				else if (value)
+					value = _geocode_result_set_insert (set, value);
 			} else if (json_node_get_value_type (node) == G_TYPE_INT64) {
 				gint64 int_value = json_node_get_int (node);
-				value = g_strdup_printf ("%"G_GINT64_FORMAT, int_value);
+				value = _geocode_result_set_insert_printf (set, "%"G_GINT64_FORMAT, int_value);
 			}
 		}
 
 		if (value != NULL) {
-			g_hash_table_insert (ht, g_strdup (members[i]), value);
+			g_hash_table_insert (ht,
+			                     (gpointer) _geocode_result_set_insert (set, members[i]),
+			                     (gpointer) value);
 
 			if (i == 0 && is_address) {
 				if (g_strcmp0 (members[i], "house_number") != 0)
 					/* Since Nominatim doesn't give us a short name,
 					 * we use the first component of address as name.
 					 */
-					g_hash_table_insert (ht, g_strdup ("name"), g_strdup (value));
+					g_hash_table_insert (ht, (gpointer) "name", (gpointer) value);
 				else
 					house_number = value;
 			} else if (house_number != NULL && g_strcmp0 (members[i], "road") == 0) {
 				gboolean number_after;
-				char *name;
+				const char *name;
 
 				number_after = _geocode_object_is_number_after_street ();
-				name = g_strdup_printf ("%s %s",
-				                        number_after ? value : house_number,
-				                        number_after ? house_number : value);
-				g_hash_table_insert (ht, g_strdup ("name"), name);
+				name = _geocode_result_set_insert_printf (set, "%s %s",
+				                                          number_after ? value : house_number,
+				                                          number_after ? house_number : value);
+				g_hash_table_insert (ht, (gpointer) "name", (gpointer) name);
 			}
 		} else if (g_strcmp0 (members[i], "boundingbox") == 0) {
 			JsonNode *node;
@@ -1195,19 +1388,19 @@ _geocode_read_nominatim_attributes (JsonReader *reader,
 			node = json_reader_get_value (reader);
 			value_type = json_node_get_value_type (node);
 
-			insert_bounding_box_element (ht, value_type, "boundingbox-bottom", reader);
+			insert_bounding_box_element (set, ht, value_type, "boundingbox-bottom", reader);
 			json_reader_end_element (reader);
 
 			json_reader_read_element (reader, 1);
-			insert_bounding_box_element (ht, value_type, "boundingbox-top", reader);
+			insert_bounding_box_element (set, ht, value_type, "boundingbox-top", reader);
 			json_reader_end_element (reader);
 
 			json_reader_read_element (reader, 2);
-			insert_bounding_box_element (ht, value_type, "boundingbox-left", reader);
+			insert_bounding_box_element (set, ht, value_type, "boundingbox-left", reader);
 			json_reader_end_element (reader);
 
 			json_reader_read_element (reader, 3);
-			insert_bounding_box_element (ht, value_type, "boundingbox-right", reader);
+			insert_bounding_box_element (set, ht, value_type, "boundingbox-right", reader);
 			json_reader_end_element (reader);
 		}
 		json_reader_end_member (reader);
@@ -1216,13 +1409,15 @@ _geocode_read_nominatim_attributes (JsonReader *reader,
 	g_strfreev (members);
 
 	if (json_reader_read_member (reader, "address"))
-		_geocode_read_nominatim_attributes (reader, ht);
+		_geocode_read_nominatim_attributes (reader, set, ht);
 	json_reader_end_member (reader);
 }
 
-static GHashTable *
-resolve_json (const char  *contents,
-              GError     **error)
+/* The returned attributes are owned by @set */
+GHashTable *
+_geocode_parse_resolve_json (const char        *contents,
+                             GeocodeResultSet  *set,
+                             GError           **error)
 {
 	GHashTable *ret = NULL;
 	JsonParser *parser;
@@ -1231,11 +1426,14 @@ resolve_json (const char  *contents,
 
 	g_debug ("%s: contents = %s", G_STRFUNC, contents);
 
+	GEOCODE_TRACE_BEGIN (trace_begin);
 	parser = json_parser_new ();
 	if (json_parser_load_from_data (parser, contents, -1, error) == FALSE) {
 		g_object_unref (parser);
 		return ret;
 	}
+	GEOCODE_TRACE_MARK (trace_begin, "parse-json", "%" G_GSIZE_FORMAT " bytes",
+	                    strlen (contents));
 
 	root = json_parser_get_root (parser);
 	reader = json_reader_new (root);
@@ -1257,8 +1455,8 @@ resolve_json (const char  *contents,
 		return NULL;
 	}
 
-	ret = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
-	_geocode_read_nominatim_attributes (reader, ret);
+	ret = _geocode_result_set_new_attributes (set);
+	_geocode_read_nominatim_attributes (reader, set, ret);
 
 	g_object_unref (parser);
 	g_object_unref (reader);
@@ -1266,6 +1464,106 @@ resolve_json (const char  *contents,
 	return ret;
 }
 
+static GList *
+prepend_place_from_reader (JsonReader       *reader,
+                           GeocodeResultSet *set,
+                           GList            *places)
+{
+	GHashTable *ht;
+	const char *lat, *lon;
+	gdouble latitude, longitude;
+
+	ht = _geocode_result_set_new_attributes (set);
+	_geocode_read_nominatim_attributes (reader, set, ht);
+
+	/* Skip error objects and anything else which can’t be located. */
+	lat = g_hash_table_lookup (ht, "lat");
+	lon = g_hash_table_lookup (ht, "lon");
+	if (lat == NULL || lon == NULL)
+		return places;
+
+	latitude = g_ascii_strtod (lat, NULL);
+	longitude = g_ascii_strtod (lon, NULL);
+	if (!(latitude >= -90.0 && latitude <= 90.0) ||
+	    !(longitude >= -180.0 && longitude <= 180.0))
+		return places;
+
+	return g_list_prepend (places, _geocode_create_place_from_attributes (ht));
+}
+
+/* Converts each result in @contents, which may be a single jsonv2 result
+ * object or an array of them, to a #GeocodePlace. Unlike
+ * _geocode_parse_search_json(), the names are not changed to tell apart
+ * results in the same list. Results without coordinates are skipped, so
+ * %NULL is returned without an error if there are none. */
+GList *
+_geocode_parse_place_json (const char  *contents,
+                           gssize       length,
+                           GError     **error)
+{
+	JsonParser *parser;
+	JsonNode *root;
+	JsonReader *reader;
+	GeocodeResultSet *set;
+	GList *places = NULL;  /* (element-type GeocodePlace) */
+
+	parser = json_parser_new ();
+	if (json_parser_load_from_data (parser, contents, length, error) == FALSE) {
+		g_object_unref (parser);
+		return NULL;
+	}
+
+	root = json_parser_get_root (parser);
+	if (root == NULL) {
+		g_object_unref (parser);
+		return NULL;
+	}
+
+	reader = json_reader_new (root);
+	set = _geocode_result_set_new ();
+
+	if (JSON_NODE_HOLDS_ARRAY (root)) {
+		gint n_places, i;
+
+		n_places = json_reader_count_elements (reader);
+
+		for (i = 0; i < n_places; i++) {
+			json_reader_read_element (reader, i);
+			if (json_reader_is_object (reader))
+				places = prepend_place_from_reader (reader, set, places);
+			json_reader_end_element (reader);
+		}
+	} else if (JSON_NODE_HOLDS_OBJECT (root)) {
+		places = prepend_place_from_reader (reader, set, places);
+	}
+
+	_geocode_result_set_free (set);
+	g_object_unref (reader);
+	g_object_unref (parser);
+
+	return g_list_reverse (places);
+}
+
+static GHashTable *
+parse_resolve_json (GeocodeNominatim  *self,
+                    const char        *contents,
+                    GeocodeResultSet  *set,
+                    GError           **error)
+{
+	GeocodeNominatimPrivate *priv;
+	GHashTable *attributes;
+	gint64 start_time;
+
+	priv = geocode_nominatim_get_instance_private (self);
+
+	start_time = g_get_monotonic_time ();
+	attributes = _geocode_parse_resolve_json (contents, set, error);
+	_geocode_stats_record_parse (&priv->stats,
+	                             g_get_monotonic_time () - start_time);
+
+	return attributes;
+}
+
 static void
 places_list_free (GList *places)
 {
@@ -1280,6 +1578,7 @@ on_reverse_query_ready (GeocodeNominatim *self,
 	GError *error = NULL;
 	char *contents;
 	g_autoptr (GeocodePlace) place = NULL;
+	g_autoptr (GeocodeResultSet) set = NULL;
 	GHashTable *attributes;
 
 	contents = GEOCODE_NOMINATIM_GET_CLASS (self)->query_finish (GEOCODE_NOMINATIM (self), res, &error);
@@ -1289,7 +1588,8 @@ on_reverse_query_ready (GeocodeNominatim *self,
 		return;
 	}
 
-	attributes = resolve_json (contents, &error);
+	set = _geocode_result_set_new ();
+	attributes = parse_resolve_json (self, contents, set, &error);
 	g_free (contents);
 
 	if (attributes == NULL) {
@@ -1299,7 +1599,6 @@ on_reverse_query_ready (GeocodeNominatim *self,
 	}
 
 	place = _geocode_create_place_from_attributes (attributes);
-	g_hash_table_unref (attributes);
 
 	g_task_return_pointer (task,
 	                       g_list_prepend (NULL, g_object_ref (place)),
@@ -1321,6 +1620,7 @@ geocode_nominatim_reverse_resolve_async (GeocodeBackend      *self,
 	g_return_if_fail (GEOCODE_IS_BACKEND (self));
 	g_return_if_fail (params != NULL);
 
+	GEOCODE_TRACE_BEGIN (trace_begin);
 	uri = get_resolve_uri_for_params (GEOCODE_NOMINATIM (self), params,
 	                                  &error);
 
@@ -1329,6 +1629,8 @@ geocode_nominatim_reverse_resolve_async (GeocodeBackend      *self,
 		return;
 	}
 
+	GEOCODE_TRACE_MARK (trace_begin, "build-uri", "%s", uri);
+
 	task = g_task_new (self, cancellable, callback, user_data);
 	GEOCODE_NOMINATIM_GET_CLASS (self)->query_async (GEOCODE_NOMINATIM (self),
 	                                                 uri,
@@ -1348,23 +1650,28 @@ geocode_nominatim_reverse_resolve (GeocodeBackend  *self,
 	char *contents;
 	GHashTable *result = NULL;
 	g_autoptr (GeocodePlace) place = NULL;
+	g_autoptr (GeocodeResultSet) set = NULL;
 	gchar *uri = NULL;
 
 	g_return_val_if_fail (GEOCODE_IS_BACKEND (self), NULL);
 	g_return_val_if_fail (params != NULL, NULL);
 
+	GEOCODE_TRACE_BEGIN (trace_begin);
 	uri = get_resolve_uri_for_params (GEOCODE_NOMINATIM (self), params,
 	                                  error);
 
 	if (uri == NULL)
 		return NULL;
 
+	GEOCODE_TRACE_MARK (trace_begin, "build-uri", "%s", uri);
+
 	contents = GEOCODE_NOMINATIM_GET_CLASS (self)->query (GEOCODE_NOMINATIM (self),
 	                                                      uri,
 	                                                      cancellable,
 	                                                      error);
 	if (contents != NULL) {
-		result = resolve_json (contents, error);
+		set = _geocode_result_set_new ();
+		result = parse_resolve_json (GEOCODE_NOMINATIM (self), contents, set, error);
 		g_free (contents);
 	}
 
@@ -1374,7 +1681,6 @@ geocode_nominatim_reverse_resolve (GeocodeBackend  *self,
 		return NULL;
 
 	place = _geocode_create_place_from_attributes (result);
-	g_hash_table_unref (result);
 
 	return g_list_prepend (NULL, g_object_ref (place));
 }
@@ -1412,6 +1718,57 @@ geocode_nominatim_get_gnome (void)
 	return backend;
 }
 
+/**
+ * geocode_nominatim_get_stats:
+ * @self: a #GeocodeNominatim
+ *
+ * Takes a snapshot of the counters @self keeps about the queries it has
+ * handled since it was created, or since geocode_nominatim_reset_stats()
+ * was last called. Queries made through the #GeocodeNominatimClass
+ * virtual methods of a derived class are only counted by the default
+ * implementations of those methods.
+ *
+ * Returns: (transfer full): a new #GeocodeStats. Use geocode_stats_free()
+ * when done.
+ *
+ * Since: 3.28
+ */
+GeocodeStats *
+geocode_nominatim_get_stats (GeocodeNominatim *self)
+{
+	GeocodeNominatimPrivate *priv;
+	GeocodeStats *stats;
+
+	g_return_val_if_fail (GEOCODE_IS_NOMINATIM (self), NULL);
+
+	priv = geocode_nominatim_get_instance_private (self);
+
+	stats = g_new0 (GeocodeStats, 1);
+	_geocode_stats_snapshot (&priv->stats, stats);
+
+	return stats;
+}
+
+/**
+ * geocode_nominatim_reset_stats:
+ * @self: a #GeocodeNominatim
+ *
+ * Resets all the counters returned by geocode_nominatim_get_stats() to
+ * zero.
+ *
+ * Since: 3.28
+ */
+void
+geocode_nominatim_reset_stats (GeocodeNominatim *self)
+{
+	GeocodeNominatimPrivate *priv;
+
+	g_return_if_fail (GEOCODE_IS_NOMINATIM (self));
+
+	priv = geocode_nominatim_get_instance_private (self);
+	_geocode_stats_reset (&priv->stats);
+}
+
 /******************************************************************************/
 
 /**
@@ -1443,6 +1800,10 @@ geocode_nominatim_new (const char *base_url,
 static void
 geocode_nominatim_init (GeocodeNominatim *object)
 {
+	GeocodeNominatimPrivate *priv;
+
+	priv = geocode_nominatim_get_instance_private (object);
+	priv->timeout = DEFAULT_TIMEOUT;
 }
 
 static void
@@ -1480,6 +1841,9 @@ geocode_nominatim_get_property (GObject    *object,
 	case PROP_USER_AGENT:
 		g_value_set_string (value, priv->user_agent);
 		break;
+	case PROP_TIMEOUT:
+		g_value_set_uint (value, priv->timeout);
+		break;
 	default:
 		/* We don't have any other property... */
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -1516,6 +1880,13 @@ geocode_nominatim_set_property (GObject      *object,
 			                          properties[PROP_USER_AGENT]);
 		}
 		break;
+	case PROP_TIMEOUT:
+		if (priv->timeout != g_value_get_uint (value)) {
+			priv->timeout = g_value_get_uint (value);
+			g_object_notify_by_pspec (object,
+			                          properties[PROP_TIMEOUT]);
+		}
+		break;
 	default:
 		/* We don't have any other property... */
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -1621,6 +1992,27 @@ geocode_nominatim_class_init (GeocodeNominatimClass *klass)
 	                                                   (G_PARAM_READWRITE |
 	                                                    G_PARAM_STATIC_STRINGS));
 
+	/**
+	 * GeocodeNominatim:timeout:
+	 *
+	 * Time, in seconds, to wait for the Nominatim server when connecting
+	 * to it or waiting for a response, or 0 to wait indefinitely. Queries
+	 * which hit this timeout fail with %GEOCODE_ERROR_TIMED_OUT.
+	 *
+	 * Changes only apply to queries started afterwards.
+	 *
+	 * Since: 3.28
+	 */
+	properties[PROP_TIMEOUT] = g_param_spec_uint ("timeout",
+	                                              "Timeout",
+	                                              "Connection and read timeout, in seconds",
+	                                              0,
+	                                              G_MAXUINT,
+	                                              DEFAULT_TIMEOUT,
+	                                              (G_PARAM_READWRITE |
+	                                               G_PARAM_EXPLICIT_NOTIFY |
+	                                               G_PARAM_STATIC_STRINGS));
+
 	g_object_class_install_properties (object_class,
 	                                   G_N_ELEMENTS (properties), properties);
 }
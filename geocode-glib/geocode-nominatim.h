@@ -28,6 +28,7 @@
 #include <glib.h>
 #include <gio/gio.h>
 #include "geocode-place.h"
+#include "geocode-stats.h"
 
 G_BEGIN_DECLS
 
@@ -91,6 +92,9 @@ GeocodeNominatim *geocode_nominatim_new (const gchar *base_url,
 
 GeocodeNominatim *geocode_nominatim_get_gnome (void);
 
+GeocodeStats *geocode_nominatim_get_stats (GeocodeNominatim *self);
+void geocode_nominatim_reset_stats (GeocodeNominatim *self);
+
 G_END_DECLS
 
 #endif /* GEOCODE_NOMINATIM_H */
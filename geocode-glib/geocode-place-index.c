@@ -0,0 +1,628 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "geocode-location.h"
+#include "geocode-place-index.h"
+
+/**
+ * SECTION:geocode-place-index
+ * @short_description: Spatial index over places or coordinates
+ * @include: geocode-glib/geocode-glib.h
+ *
+ * A #GeocodePlaceIndex answers “which are the nearest N places to this
+ * point” and “which places are within R km of this point” without scanning
+ * every place. It is built once, from a list of #GeocodePlace objects or from
+ * arrays of coordinates, and cannot be modified afterwards.
+ *
+ * Items are identified by their position in the list or arrays the index
+ * was built from. Places which have no location are never returned by
+ * queries, but still take up an index.
+ *
+ * Queries take O(log n) time for a small number of results, and do not
+ * modify the index, so they can be run from several threads at once.
+ *
+ * |[<!-- language="C" -->
+ * g_autoptr (GeocodePlaceIndex) index = NULL;
+ * g_autoptr (GArray) nearest = NULL;
+ * guint i;
+ *
+ * index = geocode_place_index_new_for_places (places);
+ * nearest = geocode_place_index_find_nearest (index, 48.8566, 2.3522, 5);
+ *
+ * for (i = 0; i < nearest->len; i++) {
+ *   GeocodePlace *place;
+ *
+ *   place = geocode_place_index_get_place (index, g_array_index (nearest, guint, i));
+ *   g_print ("%s\n", geocode_place_get_name (place));
+ * }
+ * ]|
+ *
+ * Since: 3.28
+ */
+
+/* As in geocode-location.c */
+#define EARTH_RADIUS_KM 6372.795
+
+struct _GeocodePlaceIndex {
+	GObject parent;
+
+	GPtrArray *places;  /* (owned) (nullable) (element-type GeocodePlace) */
+	guint n_items;
+
+	/* Unit vectors on the sphere, 3 per item, by item index. Straight-line
+	 * distances between these increase with great-circle distance, so the
+	 * tree can be searched in Cartesian space. */
+	gdouble *points;  /* (owned) */
+
+	/* Implicit k-d tree: the node for the subtree covering
+	 * order[lo, hi) is at mid = lo + (hi - lo) / 2, and splits it along
+	 * axes[mid]. Items before mid are not above it on that axis; items
+	 * after it are not below. */
+	guint *order;  /* (owned) item indices */
+	guint8 *axes;  /* (owned) */
+	guint n_nodes;
+};
+
+G_DEFINE_TYPE (GeocodePlaceIndex, geocode_place_index, G_TYPE_OBJECT)
+
+typedef struct {
+	gdouble distance2;  /* squared chord length between unit vectors */
+	guint index;
+} Candidate;
+
+static inline const gdouble *
+get_point (GeocodePlaceIndex *self,
+           guint              item)
+{
+	return self->points + 3 * item;
+}
+
+static void
+to_unit_vector (gdouble  latitude,
+                gdouble  longitude,
+                gdouble *v)
+{
+	gdouble lat = latitude * M_PI / 180.0;
+	gdouble lon = longitude * M_PI / 180.0;
+
+	v[0] = cos (lat) * cos (lon);
+	v[1] = cos (lat) * sin (lon);
+	v[2] = sin (lat);
+}
+
+static inline gdouble
+distance2 (const gdouble *a,
+           const gdouble *b)
+{
+	gdouble dx = a[0] - b[0];
+	gdouble dy = a[1] - b[1];
+	gdouble dz = a[2] - b[2];
+
+	return dx * dx + dy * dy + dz * dz;
+}
+
+/* Squared chord length corresponding to a distance along the surface */
+static gdouble
+radius_to_distance2 (gdouble radius)
+{
+	gdouble chord;
+
+	chord = 2 * sin (MIN (radius / EARTH_RADIUS_KM, M_PI) / 2);
+
+	return chord * chord;
+}
+
+static inline void
+swap_items (guint *order,
+            guint  a,
+            guint  b)
+{
+	guint tmp = order[a];
+
+	order[a] = order[b];
+	order[b] = tmp;
+}
+
+/* Quickselect: reorders order[lo, hi) so that order[nth] is the item
+ * which would be there if the range was sorted along @axis, with nothing
+ * above it before it and nothing below it after it. */
+static void
+select_nth (GeocodePlaceIndex *self,
+            guint              lo,
+            guint              hi,
+            guint              nth,
+            guint              axis)
+{
+	while (hi - lo > 1) {
+		gdouble a, b, c, pivot;
+		guint lt, i, gt;
+
+		/* Median of three */
+		a = get_point (self, self->order[lo])[axis];
+		b = get_point (self, self->order[lo + (hi - lo) / 2])[axis];
+		c = get_point (self, self->order[hi - 1])[axis];
+		pivot = MAX (MIN (a, b), MIN (MAX (a, b), c));
+
+		/* Three-way partition, so runs of equal coordinates terminate */
+		lt = lo;
+		i = lo;
+		gt = hi;
+		while (i < gt) {
+			gdouble v = get_point (self, self->order[i])[axis];
+
+			if (v < pivot)
+				swap_items (self->order, lt++, i++);
+			else if (v > pivot)
+				swap_items (self->order, i, --gt);
+			else
+				i++;
+		}
+
+		if (nth < lt)
+			hi = lt;
+		else if (nth >= gt)
+			lo = gt;
+		else
+			return;
+	}
+}
+
+static void
+build_tree (GeocodePlaceIndex *self,
+            guint              lo,
+            guint              hi)
+{
+	while (hi - lo > 1) {
+		gdouble min[3] = { G_MAXDOUBLE, G_MAXDOUBLE, G_MAXDOUBLE };
+		gdouble max[3] = { -G_MAXDOUBLE, -G_MAXDOUBLE, -G_MAXDOUBLE };
+		guint i, axis, mid;
+
+		/* Split along the axis with the widest spread */
+		for (i = lo; i < hi; i++) {
+			const gdouble *p = get_point (self, self->order[i]);
+
+			min[0] = MIN (min[0], p[0]);
+			max[0] = MAX (max[0], p[0]);
+			min[1] = MIN (min[1], p[1]);
+			max[1] = MAX (max[1], p[1]);
+			min[2] = MIN (min[2], p[2]);
+			max[2] = MAX (max[2], p[2]);
+		}
+
+		axis = 0;
+		for (i = 1; i < 3; i++) {
+			if (max[i] - min[i] > max[axis] - min[axis])
+				axis = i;
+		}
+
+		mid = lo + (hi - lo) / 2;
+		select_nth (self, lo, hi, mid, axis);
+		self->axes[mid] = axis;
+
+		build_tree (self, lo, mid);
+		lo = mid + 1;
+	}
+}
+
+static void
+geocode_place_index_build (GeocodePlaceIndex *self)
+{
+	/* Leaves are never split, so their axes are left as 0 */
+	self->axes = g_new0 (guint8, self->n_nodes);
+	build_tree (self, 0, self->n_nodes);
+}
+
+/**
+ * geocode_place_index_new_for_places:
+ * @places: (element-type GeocodePlace): the places to index
+ *
+ * Creates a new #GeocodePlaceIndex over @places. Each place is referenced
+ * by the index, and is identified in query results by its position in
+ * @places.
+ *
+ * Returns: (transfer full): a new #GeocodePlaceIndex
+ *
+ * Since: 3.28
+ */
+GeocodePlaceIndex *
+geocode_place_index_new_for_places (GList *places)
+{
+	GeocodePlaceIndex *self;
+	GList *l;
+	guint i;
+
+	for (l = places; l != NULL; l = l->next)
+		g_return_val_if_fail (GEOCODE_IS_PLACE (l->data), NULL);
+
+	self = g_object_new (GEOCODE_TYPE_PLACE_INDEX, NULL);
+
+	self->n_items = g_list_length (places);
+	self->places = g_ptr_array_new_full (self->n_items, g_object_unref);
+	self->points = g_new (gdouble, 3 * (gsize) self->n_items);
+	self->order = g_new (guint, self->n_items);
+
+	for (l = places, i = 0; l != NULL; l = l->next, i++) {
+		GeocodePlace *place = l->data;
+		GeocodeLocation *location;
+
+		g_ptr_array_add (self->places, g_object_ref (place));
+
+		location = geocode_place_get_location (place);
+		if (location == NULL)
+			continue;
+
+		to_unit_vector (geocode_location_get_latitude (location),
+		                geocode_location_get_longitude (location),
+		                self->points + 3 * i);
+		self->order[self->n_nodes++] = i;
+	}
+
+	geocode_place_index_build (self);
+
+	return self;
+}
+
+/**
+ * geocode_place_index_new_for_coordinates:
+ * @latitudes: (array length=n_points): latitudes of the points, in degrees
+ * @longitudes: (array length=n_points): longitudes of the points, in degrees
+ * @n_points: the number of points
+ *
+ * Creates a new #GeocodePlaceIndex over the given points, which are
+ * identified in query results by their position in @latitudes and
+ * @longitudes. The arrays are not needed once this returns.
+ *
+ * Returns: (transfer full): a new #GeocodePlaceIndex
+ *
+ * Since: 3.28
+ */
+GeocodePlaceIndex *
+geocode_place_index_new_for_coordinates (const gdouble *latitudes,
+                                         const gdouble *longitudes,
+                                         guint          n_points)
+{
+	GeocodePlaceIndex *self;
+	guint i;
+
+	g_return_val_if_fail (n_points == 0 || latitudes != NULL, NULL);
+	g_return_val_if_fail (n_points == 0 || longitudes != NULL, NULL);
+
+	self = g_object_new (GEOCODE_TYPE_PLACE_INDEX, NULL);
+
+	self->n_items = n_points;
+	self->points = g_new (gdouble, 3 * (gsize) n_points);
+	self->order = g_new (guint, n_points);
+
+	for (i = 0; i < n_points; i++) {
+		to_unit_vector (latitudes[i], longitudes[i], self->points + 3 * i);
+		self->order[i] = i;
+	}
+	self->n_nodes = n_points;
+
+	geocode_place_index_build (self);
+
+	return self;
+}
+
+/**
+ * geocode_place_index_get_n_items:
+ * @self: a #GeocodePlaceIndex
+ *
+ * Gets the number of places or points the index was built from, including
+ * places without a location.
+ *
+ * Returns: the number of items in @self
+ *
+ * Since: 3.28
+ */
+guint
+geocode_place_index_get_n_items (GeocodePlaceIndex *self)
+{
+	g_return_val_if_fail (GEOCODE_IS_PLACE_INDEX (self), 0);
+
+	return self->n_items;
+}
+
+/**
+ * geocode_place_index_get_place:
+ * @self: a #GeocodePlaceIndex
+ * @index: the index of an item in @self
+ *
+ * Gets the place at @index, as returned by a query.
+ *
+ * Returns: (transfer none) (nullable): the place at @index, or %NULL if
+ *    @self was built with geocode_place_index_new_for_coordinates()
+ *
+ * Since: 3.28
+ */
+GeocodePlace *
+geocode_place_index_get_place (GeocodePlaceIndex *self,
+                               guint              index)
+{
+	g_return_val_if_fail (GEOCODE_IS_PLACE_INDEX (self), NULL);
+	g_return_val_if_fail (index < self->n_items, NULL);
+
+	if (self->places == NULL)
+		return NULL;
+
+	return g_ptr_array_index (self->places, index);
+}
+
+/* The best candidates found so far, as a binary max-heap on distance, so
+ * that the worst of them is at the top. */
+typedef struct {
+	const gdouble *query;
+	Candidate *heap;
+	guint len;
+	guint capacity;
+} NearestSearch;
+
+static void
+heap_sift_down (Candidate *heap,
+                guint      len,
+                guint      i)
+{
+	while (TRUE) {
+		guint largest = i;
+		guint left = 2 * i + 1;
+		guint right = left + 1;
+		Candidate tmp;
+
+		if (left < len && heap[left].distance2 > heap[largest].distance2)
+			largest = left;
+		if (right < len && heap[right].distance2 > heap[largest].distance2)
+			largest = right;
+		if (largest == i)
+			return;
+
+		tmp = heap[i];
+		heap[i] = heap[largest];
+		heap[largest] = tmp;
+		i = largest;
+	}
+}
+
+static void
+nearest_search_add (NearestSearch *search,
+                    gdouble        distance2,
+                    guint          index)
+{
+	guint i;
+
+	if (search->len < search->capacity) {
+		/* Sift up */
+		i = search->len++;
+		while (i > 0 && search->heap[(i - 1) / 2].distance2 < distance2) {
+			search->heap[i] = search->heap[(i - 1) / 2];
+			i = (i - 1) / 2;
+		}
+		search->heap[i].distance2 = distance2;
+		search->heap[i].index = index;
+	} else if (distance2 < search->heap[0].distance2) {
+		search->heap[0].distance2 = distance2;
+		search->heap[0].index = index;
+		heap_sift_down (search->heap, search->len, 0);
+	}
+}
+
+static void
+search_nearest (GeocodePlaceIndex *self,
+                NearestSearch     *search,
+                guint              lo,
+                guint              hi)
+{
+	while (lo < hi) {
+		guint mid = lo + (hi - lo) / 2;
+		guint item = self->order[mid];
+		const gdouble *p = get_point (self, item);
+		gdouble diff;
+
+		nearest_search_add (search, distance2 (search->query, p), item);
+
+		/* Search the side of the split containing the query first, then
+		 * the other side only if it could contain anything closer */
+		diff = search->query[self->axes[mid]] - p[self->axes[mid]];
+		if (diff < 0) {
+			search_nearest (self, search, lo, mid);
+			lo = mid + 1;
+		} else {
+			search_nearest (self, search, mid + 1, hi);
+			hi = mid;
+		}
+
+		if (search->len == search->capacity &&
+		    diff * diff >= search->heap[0].distance2)
+			return;
+	}
+}
+
+static void
+search_within (GeocodePlaceIndex *self,
+               const gdouble     *query,
+               gdouble            max_distance2,
+               GArray            *results,
+               guint              lo,
+               guint              hi)
+{
+	while (lo < hi) {
+		guint mid = lo + (hi - lo) / 2;
+		guint item = self->order[mid];
+		const gdouble *p = get_point (self, item);
+		gdouble d2, diff;
+
+		d2 = distance2 (query, p);
+		if (d2 <= max_distance2) {
+			Candidate candidate = { d2, item };
+
+			g_array_append_val (results, candidate);
+		}
+
+		diff = query[self->axes[mid]] - p[self->axes[mid]];
+		if (diff < 0) {
+			search_within (self, query, max_distance2, results, lo, mid);
+			lo = mid + 1;
+		} else {
+			search_within (self, query, max_distance2, results, mid + 1, hi);
+			hi = mid;
+		}
+
+		if (diff * diff > max_distance2)
+			return;
+	}
+}
+
+static gint
+compare_candidates (gconstpointer a,
+                    gconstpointer b)
+{
+	const Candidate *ca = a;
+	const Candidate *cb = b;
+
+	if (ca->distance2 != cb->distance2)
+		return (ca->distance2 > cb->distance2) - (ca->distance2 < cb->distance2);
+
+	return (ca->index > cb->index) - (ca->index < cb->index);
+}
+
+static GArray *
+candidates_to_indices (Candidate *candidates,
+                       guint      n_candidates)
+{
+	GArray *indices;
+	guint i;
+
+	qsort (candidates, n_candidates, sizeof (Candidate), compare_candidates);
+
+	indices = g_array_sized_new (FALSE, FALSE, sizeof (guint), n_candidates);
+	for (i = 0; i < n_candidates; i++)
+		g_array_append_val (indices, candidates[i].index);
+
+	return indices;
+}
+
+/**
+ * geocode_place_index_find_nearest:
+ * @self: a #GeocodePlaceIndex
+ * @latitude: latitude of the query point, in degrees
+ * @longitude: longitude of the query point, in degrees
+ * @n_results: the maximum number of results to return
+ *
+ * Finds the @n_results items closest to the given point, along the
+ * curvature of the Earth. Fewer are returned if the index contains fewer
+ * items with a location.
+ *
+ * Returns: (transfer full) (element-type guint): the indices of the
+ *    nearest items, closest first
+ *
+ * Since: 3.28
+ */
+GArray *
+geocode_place_index_find_nearest (GeocodePlaceIndex *self,
+                                  gdouble            latitude,
+                                  gdouble            longitude,
+                                  guint              n_results)
+{
+	NearestSearch search;
+	gdouble query[3];
+	g_autofree Candidate *heap = NULL;
+
+	g_return_val_if_fail (GEOCODE_IS_PLACE_INDEX (self), NULL);
+
+	n_results = MIN (n_results, self->n_nodes);
+	heap = g_new (Candidate, MAX (n_results, 1));
+
+	to_unit_vector (latitude, longitude, query);
+	search.query = query;
+	search.heap = heap;
+	search.len = 0;
+	search.capacity = n_results;
+
+	if (n_results > 0)
+		search_nearest (self, &search, 0, self->n_nodes);
+
+	return candidates_to_indices (heap, search.len);
+}
+
+/**
+ * geocode_place_index_find_within:
+ * @self: a #GeocodePlaceIndex
+ * @latitude: latitude of the query point, in degrees
+ * @longitude: longitude of the query point, in degrees
+ * @radius: the maximum distance from the query point, in km
+ *
+ * Finds all the items within @radius km of the given point, along the
+ * curvature of the Earth. Distances are calculated as by
+ * geocode_location_get_distance_from(), though items at almost exactly
+ * @radius km may be included or not due to rounding.
+ *
+ * Returns: (transfer full) (element-type guint): the indices of the items
+ *    found, closest first
+ *
+ * Since: 3.28
+ */
+GArray *
+geocode_place_index_find_within (GeocodePlaceIndex *self,
+                                 gdouble            latitude,
+                                 gdouble            longitude,
+                                 gdouble            radius)
+{
+	g_autoptr(GArray) candidates = NULL;
+	gdouble query[3];
+
+	g_return_val_if_fail (GEOCODE_IS_PLACE_INDEX (self), NULL);
+	g_return_val_if_fail (radius >= 0, NULL);
+
+	to_unit_vector (latitude, longitude, query);
+	candidates = g_array_new (FALSE, FALSE, sizeof (Candidate));
+	search_within (self, query, radius_to_distance2 (radius), candidates,
+	               0, self->n_nodes);
+
+	return candidates_to_indices ((Candidate *) candidates->data,
+	                              candidates->len);
+}
+
+static void
+geocode_place_index_finalize (GObject *object)
+{
+	GeocodePlaceIndex *self = GEOCODE_PLACE_INDEX (object);
+
+	g_clear_pointer (&self->places, g_ptr_array_unref);
+	g_free (self->points);
+	g_free (self->order);
+	g_free (self->axes);
+
+	G_OBJECT_CLASS (geocode_place_index_parent_class)->finalize (object);
+}
+
+static void
+geocode_place_index_class_init (GeocodePlaceIndexClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->finalize = geocode_place_index_finalize;
+}
+
+static void
+geocode_place_index_init (GeocodePlaceIndex *self)
+{
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#ifndef GEOCODE_PLACE_INDEX_H
+#define GEOCODE_PLACE_INDEX_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "geocode-place.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GeocodePlaceIndex:
+ *
+ * All the fields in the #GeocodePlaceIndex structure are private and should
+ * never be accessed directly.
+ *
+ * Since: 3.28
+ */
+#define GEOCODE_TYPE_PLACE_INDEX (geocode_place_index_get_type ())
+G_DECLARE_FINAL_TYPE (GeocodePlaceIndex, geocode_place_index,
+                      GEOCODE, PLACE_INDEX, GObject)
+
+/**
+ * GEOCODE_TYPE_PLACE_INDEX:
+ *
+ * See #GeocodePlaceIndex.
+ *
+ * Since: 3.28
+ */
+
+GeocodePlaceIndex *geocode_place_index_new_for_places      (GList         *places);
+GeocodePlaceIndex *geocode_place_index_new_for_coordinates (const gdouble *latitudes,
+                                                            const gdouble *longitudes,
+                                                            guint          n_points);
+
+guint         geocode_place_index_get_n_items  (GeocodePlaceIndex *self);
+GeocodePlace *geocode_place_index_get_place    (GeocodePlaceIndex *self,
+                                                guint              index);
+
+GArray *geocode_place_index_find_nearest (GeocodePlaceIndex *self,
+                                          gdouble            latitude,
+                                          gdouble            longitude,
+                                          guint              n_results);
+GArray *geocode_place_index_find_within  (GeocodePlaceIndex *self,
+                                          gdouble            latitude,
+                                          gdouble            longitude,
+                                          gdouble            radius);
+
+G_END_DECLS
+
+#endif /* GEOCODE_PLACE_INDEX_H */
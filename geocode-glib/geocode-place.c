@@ -50,12 +50,16 @@ struct _GeocodePlacePrivate {
         char *postal_code;
         char *area;
         char *town;
-        char *county;
-        char *state;
-        char *admin_area;
-        char *country_code;
-        char *country;
-        char *continent;
+
+        /* These are repeated across most places, so are interned and
+         * shared rather than owned by each place. */
+        const char *county;
+        const char *state;
+        const char *admin_area;
+        const char *country_code;
+        const char *country;
+        const char *continent;
+
         char *osm_id;
         GeocodePlaceOsmType osm_type;
 };
@@ -307,12 +311,6 @@ geocode_place_dispose (GObject *gplace)
         g_clear_pointer (&priv->postal_code, g_free);
         g_clear_pointer (&priv->area, g_free);
         g_clear_pointer (&priv->town, g_free);
-        g_clear_pointer (&priv->county, g_free);
-        g_clear_pointer (&priv->state, g_free);
-        g_clear_pointer (&priv->admin_area, g_free);
-        g_clear_pointer (&priv->country_code, g_free);
-        g_clear_pointer (&priv->country, g_free);
-        g_clear_pointer (&priv->continent, g_free);
 
         G_OBJECT_CLASS (geocode_place_parent_class)->dispose (gplace);
 }
@@ -683,12 +681,13 @@ geocode_place_equal (GeocodePlace *a,
                 g_strcmp0 (priv_a->postal_code, priv_b->postal_code) == 0 &&
                 g_strcmp0 (priv_a->area, priv_b->area) == 0 &&
                 g_strcmp0 (priv_a->town, priv_b->town) == 0 &&
-                g_strcmp0 (priv_a->county, priv_b->county) == 0 &&
-                g_strcmp0 (priv_a->state, priv_b->state) == 0 &&
-                g_strcmp0 (priv_a->admin_area, priv_b->admin_area) == 0 &&
-                g_strcmp0 (priv_a->country_code, priv_b->country_code) == 0 &&
-                g_strcmp0 (priv_a->country, priv_b->country) == 0 &&
-                g_strcmp0 (priv_a->continent, priv_b->continent) == 0 &&
+                /* Interned, so equal strings are the same pointer */
+                priv_a->county == priv_b->county &&
+                priv_a->state == priv_b->state &&
+                priv_a->admin_area == priv_b->admin_area &&
+                priv_a->country_code == priv_b->country_code &&
+                priv_a->country == priv_b->country &&
+                priv_a->continent == priv_b->continent &&
                 g_strcmp0 (priv_a->osm_id, priv_b->osm_id) == 0 &&
                 priv_a->osm_type == priv_b->osm_type);
 }
@@ -1036,8 +1035,7 @@ geocode_place_set_county (GeocodePlace *place,
         g_return_if_fail (county != NULL);
 
         priv = geocode_place_get_instance_private (place);
-        g_free (priv->county);
-        priv->county = g_strdup (county);
+        priv->county = g_intern_string (county);
 }
 
 /**
@@ -1074,8 +1072,7 @@ geocode_place_set_state (GeocodePlace *place,
         g_return_if_fail (state != NULL);
 
         priv = geocode_place_get_instance_private (place);
-        g_free (priv->state);
-        priv->state = g_strdup (state);
+        priv->state = g_intern_string (state);
 }
 
 /**
@@ -1112,8 +1109,7 @@ geocode_place_set_administrative_area (GeocodePlace *place,
         g_return_if_fail (admin_area != NULL);
 
         priv = geocode_place_get_instance_private (place);
-        g_free (priv->admin_area);
-        priv->admin_area = g_strdup (admin_area);
+        priv->admin_area = g_intern_string (admin_area);
 }
 
 /**
@@ -1146,12 +1142,13 @@ geocode_place_set_country_code (GeocodePlace *place,
                                 const char   *country_code)
 {
         GeocodePlacePrivate *priv;
+        g_autofree char *upper = NULL;
         g_return_if_fail (GEOCODE_IS_PLACE (place));
         g_return_if_fail (country_code != NULL);
 
         priv = geocode_place_get_instance_private (place);
-        g_free (priv->country_code);
-        priv->country_code = g_utf8_strup (country_code, -1);
+        upper = g_utf8_strup (country_code, -1);
+        priv->country_code = g_intern_string (upper);
 }
 
 /**
@@ -1188,8 +1185,7 @@ geocode_place_set_country (GeocodePlace *place,
         g_return_if_fail (country != NULL);
 
         priv = geocode_place_get_instance_private (place);
-        g_free (priv->country);
-        priv->country = g_strdup (country);
+        priv->country = g_intern_string (country);
 }
 
 /**
@@ -1226,8 +1222,7 @@ geocode_place_set_continent (GeocodePlace *place,
         g_return_if_fail (continent != NULL);
 
         priv = geocode_place_get_instance_private (place);
-        g_free (priv->continent);
-        priv->continent = g_strdup (continent);
+        priv->continent = g_intern_string (continent);
 }
 
 /**
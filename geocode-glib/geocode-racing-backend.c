@@ -0,0 +1,734 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include <gio/gio.h>
+
+#include "geocode-glib-private.h"
+#include "geocode-glib.h"
+#include "geocode-racing-backend.h"
+
+/**
+ * SECTION:geocode-racing-backend
+ * @short_description: Geocode backend racing several backends
+ * @include: geocode-glib/geocode-glib.h
+ *
+ * #GeocodeRacingBackend sends each query to several backends, and returns
+ * the first answer which is not an error. This trades extra requests for
+ * lower latency when one of the backends is slow.
+ *
+ * Each query starts with one backend, picked at random in proportion to the
+ * weights given to geocode_racing_backend_add_backend(). If it has not
+ * answered after #GeocodeRacingBackend:hedge-delay milliseconds, the query
+ * is also sent to a second backend, and so on, until one of them answers.
+ * A backend which fails is replaced straight away. Once one answers, the
+ * queries to the others are cancelled through their #GCancellable. If they
+ * all fail, the error from the first one to be queried is returned, even if
+ * a later one failed sooner.
+ *
+ * Backends with a weight of zero are never queried first, so they only
+ * hedge against the others. A hedge delay of zero sends each query to all
+ * the backends at once.
+ *
+ * geocode_racing_backend_get_n_wins() counts how many queries each backend
+ * answered first, which shows whether the hedging pays off.
+ *
+ * Blocking queries run the race in a private main context, and return once
+ * the cancelled backends have finished, which is immediate for backends
+ * which honour cancellation, such as #GeocodeNominatim.
+ *
+ * Since: 3.28
+ */
+
+#define DEFAULT_HEDGE_DELAY 100 /* milliseconds */
+
+typedef struct {
+	GeocodeBackend *backend;  /* (owned) */
+	guint weight;
+	guint n_wins;  /* (atomic) */
+} Child;
+
+struct _GeocodeRacingBackend {
+	GObject parent;
+
+	GMutex lock;
+	GPtrArray *children;  /* (owned) (element-type Child); locked by @lock */
+	guint hedge_delay;  /* (atomic) milliseconds */
+};
+
+typedef enum {
+	PROP_HEDGE_DELAY = 1,
+} GeocodeRacingBackendProperty;
+
+static GParamSpec *properties[PROP_HEDGE_DELAY + 1];
+
+static void geocode_backend_iface_init (GeocodeBackendInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GeocodeRacingBackend, geocode_racing_backend, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (GEOCODE_TYPE_BACKEND,
+                                                geocode_backend_iface_init))
+
+/******************************************************************************/
+
+static void
+child_free (Child *child)
+{
+	g_object_unref (child->backend);
+	g_free (child);
+}
+
+static void
+places_list_free (GList *places)
+{
+	g_list_free_full (places, g_object_unref);
+}
+
+/* State of one query. Children are only freed when the backend is
+ * finalized, and each task holds a reference on the backend, so @order
+ * does not need references. */
+typedef struct {
+	gboolean is_forward;
+	GHashTable *params;  /* (owned) */
+	GPtrArray *order;  /* (owned) (element-type Child) */
+	guint next;  /* index in @order of the next child to query */
+	guint n_running;
+	gboolean done;
+
+	/* Cancelled when the race is decided, or when the caller’s
+	 * cancellable is. */
+	GCancellable *cancellable;  /* (owned) */
+	GCancellable *caller_cancellable;  /* (owned) (nullable) */
+	gulong cancelled_id;
+
+	GSource *hedge_source;  /* (owned) (nullable) */
+
+	/* The error from the child earliest in @order to have failed. */
+	GError *first_error;  /* (owned) (nullable) */
+	guint first_error_index;
+} Race;
+
+typedef struct {
+	GTask *task;  /* (owned) */
+	Child *child;  /* (unowned) */
+	guint index;  /* of @child in the race’s order */
+} Attempt;
+
+static void
+race_free (Race *race)
+{
+	g_hash_table_unref (race->params);
+	g_ptr_array_unref (race->order);
+
+	if (race->caller_cancellable != NULL) {
+		g_cancellable_disconnect (race->caller_cancellable,
+		                          race->cancelled_id);
+		g_object_unref (race->caller_cancellable);
+	}
+	g_object_unref (race->cancellable);
+
+	if (race->hedge_source != NULL) {
+		g_source_destroy (race->hedge_source);
+		g_source_unref (race->hedge_source);
+	}
+
+	g_clear_error (&race->first_error);
+	g_free (race);
+}
+
+/* Orders the children for a query by weighted sampling without
+ * replacement, so that each is first with a probability proportional to its
+ * weight. Children with a weight of zero keep the order they were added
+ * in. */
+static GPtrArray *
+pick_order (GeocodeRacingBackend *self)
+{
+	g_autoptr (GPtrArray) remaining = NULL;
+	GPtrArray *order;
+	guint64 total_weight = 0;
+	guint i;
+
+	g_mutex_lock (&self->lock);
+
+	remaining = g_ptr_array_sized_new (self->children->len);
+	for (i = 0; i < self->children->len; i++) {
+		Child *child = g_ptr_array_index (self->children, i);
+
+		g_ptr_array_add (remaining, child);
+		total_weight += child->weight;
+	}
+
+	g_mutex_unlock (&self->lock);
+
+	order = g_ptr_array_sized_new (remaining->len);
+
+	while (remaining->len > 0) {
+		guint chosen = 0;
+
+		if (total_weight > 0) {
+			gdouble r = g_random_double () * total_weight;
+
+			for (chosen = 0; chosen < remaining->len - 1; chosen++) {
+				Child *child = g_ptr_array_index (remaining, chosen);
+
+				if (r < child->weight)
+					break;
+				r -= child->weight;
+			}
+
+			/* Skip children with no weight if rounding left
+			 * @chosen on one. */
+			while (((Child *) g_ptr_array_index (remaining, chosen))->weight == 0)
+				chosen--;
+		}
+
+		total_weight -= ((Child *) g_ptr_array_index (remaining, chosen))->weight;
+		g_ptr_array_add (order, g_ptr_array_index (remaining, chosen));
+		g_ptr_array_remove_index (remaining, chosen);
+	}
+
+	return order;
+}
+
+static void attempt_cb (GObject      *source_object,
+                        GAsyncResult *result,
+                        gpointer      user_data);
+static gboolean hedge_timeout_cb (gpointer user_data);
+
+/* Queries the next child, and schedules the hedge after it if there are
+ * more children left. */
+static void
+race_start_next (GTask *task)
+{
+	GeocodeRacingBackend *self = g_task_get_source_object (task);
+	Race *race = g_task_get_task_data (task);
+	guint hedge_delay = g_atomic_int_get (&self->hedge_delay);
+	Attempt *attempt;
+
+	if (race->hedge_source != NULL) {
+		g_source_destroy (race->hedge_source);
+		g_clear_pointer (&race->hedge_source, g_source_unref);
+	}
+
+	do {
+		attempt = g_new0 (Attempt, 1);
+		attempt->task = g_object_ref (task);
+		attempt->index = race->next++;
+		attempt->child = g_ptr_array_index (race->order, attempt->index);
+		race->n_running++;
+
+		if (race->is_forward)
+			geocode_backend_forward_search_async (attempt->child->backend,
+			                                      race->params,
+			                                      race->cancellable,
+			                                      attempt_cb, attempt);
+		else
+			geocode_backend_reverse_resolve_async (attempt->child->backend,
+			                                       race->params,
+			                                       race->cancellable,
+			                                       attempt_cb, attempt);
+	} while (hedge_delay == 0 && race->next < race->order->len && !race->done);
+
+	/* A child may have answered synchronously and decided the race. */
+	if (race->done || race->next >= race->order->len)
+		return;
+
+	race->hedge_source = g_timeout_source_new (hedge_delay);
+	g_source_set_callback (race->hedge_source, hedge_timeout_cb,
+	                       task, NULL);
+	g_source_set_name (race->hedge_source, "GeocodeRacingBackend hedge");
+	g_source_attach (race->hedge_source, g_task_get_context (task));
+}
+
+static gboolean
+hedge_timeout_cb (gpointer user_data)
+{
+	GTask *task = G_TASK (user_data);
+	Race *race = g_task_get_task_data (task);
+
+	/* race_start_next() destroys the source, so keep it alive until this
+	 * callback returns. */
+	g_autoptr (GSource) source = g_steal_pointer (&race->hedge_source);
+
+	race_start_next (task);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+race_finish (Race *race)
+{
+	race->done = TRUE;
+
+	if (race->hedge_source != NULL) {
+		g_source_destroy (race->hedge_source);
+		g_clear_pointer (&race->hedge_source, g_source_unref);
+	}
+
+	/* Abort the losers. */
+	g_cancellable_cancel (race->cancellable);
+}
+
+static void
+attempt_cb (GObject      *source_object,
+            GAsyncResult *result,
+            gpointer      user_data)
+{
+	Attempt *attempt = user_data;
+	g_autoptr (GTask) task = g_steal_pointer (&attempt->task);
+	Child *child = attempt->child;
+	guint index = attempt->index;
+	Race *race = g_task_get_task_data (task);
+	GList *places;
+	GError *error = NULL;
+
+	g_free (attempt);
+	race->n_running--;
+
+	if (race->is_forward)
+		places = geocode_backend_forward_search_finish (GEOCODE_BACKEND (source_object),
+		                                                result, &error);
+	else
+		places = geocode_backend_reverse_resolve_finish (GEOCODE_BACKEND (source_object),
+		                                                 result, &error);
+
+	if (race->done) {
+		/* A loser. */
+		places_list_free (places);
+		g_clear_error (&error);
+		return;
+	}
+
+	if (error == NULL) {
+		g_atomic_int_inc (&child->n_wins);
+		race_finish (race);
+		g_task_return_pointer (task, places,
+		                       (GDestroyNotify) places_list_free);
+		return;
+	}
+
+	/* With hedging, a later child may fail before an earlier one. */
+	if (race->first_error == NULL || index < race->first_error_index) {
+		g_clear_error (&race->first_error);
+		race->first_error = g_steal_pointer (&error);
+		race->first_error_index = index;
+	}
+	g_clear_error (&error);
+
+	if (g_task_return_error_if_cancelled (task)) {
+		race_finish (race);
+	} else if (race->next < race->order->len) {
+		race_start_next (task);
+	} else if (race->n_running == 0) {
+		race_finish (race);
+		g_task_return_error (task, g_steal_pointer (&race->first_error));
+	}
+}
+
+static void
+caller_cancelled_cb (GCancellable *cancellable,
+                     gpointer      user_data)
+{
+	GCancellable *race_cancellable = user_data;
+
+	g_cancellable_cancel (race_cancellable);
+}
+
+static void
+race_async (GeocodeRacingBackend *self,
+            gboolean              is_forward,
+            gpointer              source_tag,
+            GHashTable           *params,
+            GCancellable         *cancellable,
+            GAsyncReadyCallback   callback,
+            gpointer              user_data)
+{
+	g_autoptr (GTask) task = NULL;
+	Race *race;
+
+	task = g_task_new (self, cancellable, callback, user_data);
+	g_task_set_source_tag (task, source_tag);
+
+	race = g_new0 (Race, 1);
+	race->is_forward = is_forward;
+	race->params = g_hash_table_ref (params);
+	race->order = pick_order (self);
+	race->cancellable = g_cancellable_new ();
+	g_task_set_task_data (task, race, (GDestroyNotify) race_free);
+
+	if (race->order->len == 0) {
+		g_task_return_new_error (task, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED,
+		                         "No backends to query");
+		return;
+	}
+
+	if (g_task_return_error_if_cancelled (task))
+		return;
+
+	if (cancellable != NULL) {
+		race->caller_cancellable = g_object_ref (cancellable);
+		race->cancelled_id = g_cancellable_connect (cancellable,
+		                                            G_CALLBACK (caller_cancelled_cb),
+		                                            g_object_ref (race->cancellable),
+		                                            g_object_unref);
+	}
+
+	race_start_next (task);
+}
+
+static GList *
+race_finish_query (GeocodeRacingBackend  *self,
+                   GAsyncResult          *result,
+                   GError               **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static void
+sync_result_cb (GObject      *source_object,
+                GAsyncResult *result,
+                gpointer      user_data)
+{
+	GAsyncResult **result_out = user_data;
+
+	*result_out = g_object_ref (result);
+}
+
+static GList *
+race_sync (GeocodeRacingBackend  *self,
+           gboolean               is_forward,
+           GHashTable            *params,
+           GCancellable          *cancellable,
+           GError               **error)
+{
+	g_autoptr (GMainContext) context = NULL;
+	g_autoptr (GAsyncResult) result = NULL;
+	Race *race;
+
+	context = g_main_context_new ();
+	g_main_context_push_thread_default (context);
+
+	race_async (self, is_forward, race_sync, params, cancellable,
+	            sync_result_cb, &result);
+
+	while (result == NULL)
+		g_main_context_iteration (context, TRUE);
+
+	/* Wait for the cancelled losers, so that their callbacks are not left
+	 * pending in a context which nobody iterates. */
+	race = g_task_get_task_data (G_TASK (result));
+	while (race->n_running > 0)
+		g_main_context_iteration (context, TRUE);
+
+	g_main_context_pop_thread_default (context);
+
+	return race_finish_query (self, result, error);
+}
+
+/******************************************************************************/
+
+static GList *
+geocode_racing_backend_forward_search (GeocodeBackend  *backend,
+                                       GHashTable      *params,
+                                       GCancellable    *cancellable,
+                                       GError         **error)
+{
+	return race_sync (GEOCODE_RACING_BACKEND (backend), TRUE, params,
+	                  cancellable, error);
+}
+
+static void
+geocode_racing_backend_forward_search_async (GeocodeBackend      *backend,
+                                             GHashTable          *params,
+                                             GCancellable        *cancellable,
+                                             GAsyncReadyCallback  callback,
+                                             gpointer             user_data)
+{
+	race_async (GEOCODE_RACING_BACKEND (backend), TRUE,
+	            geocode_racing_backend_forward_search_async,
+	            params, cancellable, callback, user_data);
+}
+
+static GList *
+geocode_racing_backend_forward_search_finish (GeocodeBackend  *backend,
+                                              GAsyncResult    *result,
+                                              GError         **error)
+{
+	return race_finish_query (GEOCODE_RACING_BACKEND (backend), result, error);
+}
+
+static GList *
+geocode_racing_backend_reverse_resolve (GeocodeBackend  *backend,
+                                        GHashTable      *params,
+                                        GCancellable    *cancellable,
+                                        GError         **error)
+{
+	return race_sync (GEOCODE_RACING_BACKEND (backend), FALSE, params,
+	                  cancellable, error);
+}
+
+static void
+geocode_racing_backend_reverse_resolve_async (GeocodeBackend      *backend,
+                                              GHashTable          *params,
+                                              GCancellable        *cancellable,
+                                              GAsyncReadyCallback  callback,
+                                              gpointer             user_data)
+{
+	race_async (GEOCODE_RACING_BACKEND (backend), FALSE,
+	            geocode_racing_backend_reverse_resolve_async,
+	            params, cancellable, callback, user_data);
+}
+
+static GList *
+geocode_racing_backend_reverse_resolve_finish (GeocodeBackend  *backend,
+                                               GAsyncResult    *result,
+                                               GError         **error)
+{
+	return race_finish_query (GEOCODE_RACING_BACKEND (backend), result, error);
+}
+
+/******************************************************************************/
+
+/**
+ * geocode_racing_backend_new:
+ *
+ * Creates a new racing backend with no backends. Add some with
+ * geocode_racing_backend_add_backend() before using it.
+ *
+ * Returns: (transfer full): a new #GeocodeRacingBackend. Use
+ * g_object_unref() when done.
+ *
+ * Since: 3.28
+ */
+GeocodeRacingBackend *
+geocode_racing_backend_new (void)
+{
+	return GEOCODE_RACING_BACKEND (g_object_new (GEOCODE_TYPE_RACING_BACKEND,
+	                                             NULL));
+}
+
+/**
+ * geocode_racing_backend_add_backend:
+ * @self: a #GeocodeRacingBackend
+ * @backend: a backend to race
+ * @weight: how often @backend should be queried first, relative to the
+ *    other backends
+ *
+ * Adds @backend to the backends which queries are sent to. The chance of it
+ * being queried first is its @weight divided by the total weight of all the
+ * backends. A @weight of zero means it is only queried as a hedge.
+ *
+ * Since: 3.28
+ */
+void
+geocode_racing_backend_add_backend (GeocodeRacingBackend *self,
+                                    GeocodeBackend       *backend,
+                                    guint                 weight)
+{
+	Child *child;
+
+	g_return_if_fail (GEOCODE_IS_RACING_BACKEND (self));
+	g_return_if_fail (GEOCODE_IS_BACKEND (backend));
+	g_return_if_fail (GEOCODE_BACKEND (self) != backend);
+
+	child = g_new0 (Child, 1);
+	child->backend = g_object_ref (backend);
+	child->weight = weight;
+
+	g_mutex_lock (&self->lock);
+	g_ptr_array_add (self->children, child);
+	g_mutex_unlock (&self->lock);
+}
+
+/**
+ * geocode_racing_backend_get_n_wins:
+ * @self: a #GeocodeRacingBackend
+ * @backend: a backend added with geocode_racing_backend_add_backend()
+ *
+ * Gets the number of queries which @backend answered first. If @backend
+ * was added more than once, the wins are summed.
+ *
+ * Returns: the number of queries won by @backend
+ *
+ * Since: 3.28
+ */
+guint
+geocode_racing_backend_get_n_wins (GeocodeRacingBackend *self,
+                                   GeocodeBackend       *backend)
+{
+	guint n_wins = 0;
+	guint i;
+
+	g_return_val_if_fail (GEOCODE_IS_RACING_BACKEND (self), 0);
+	g_return_val_if_fail (GEOCODE_IS_BACKEND (backend), 0);
+
+	g_mutex_lock (&self->lock);
+
+	for (i = 0; i < self->children->len; i++) {
+		Child *child = g_ptr_array_index (self->children, i);
+
+		if (child->backend == backend)
+			n_wins += g_atomic_int_get (&child->n_wins);
+	}
+
+	g_mutex_unlock (&self->lock);
+
+	return n_wins;
+}
+
+/**
+ * geocode_racing_backend_get_hedge_delay:
+ * @self: a #GeocodeRacingBackend
+ *
+ * Gets the #GeocodeRacingBackend:hedge-delay property.
+ *
+ * Returns: the delay before each further backend is queried, in
+ *    milliseconds
+ *
+ * Since: 3.28
+ */
+guint
+geocode_racing_backend_get_hedge_delay (GeocodeRacingBackend *self)
+{
+	g_return_val_if_fail (GEOCODE_IS_RACING_BACKEND (self), 0);
+
+	return g_atomic_int_get (&self->hedge_delay);
+}
+
+/**
+ * geocode_racing_backend_set_hedge_delay:
+ * @self: a #GeocodeRacingBackend
+ * @hedge_delay: the delay before each further backend is queried, in
+ *    milliseconds
+ *
+ * Sets the #GeocodeRacingBackend:hedge-delay property. The new delay
+ * applies to queries started afterwards.
+ *
+ * Since: 3.28
+ */
+void
+geocode_racing_backend_set_hedge_delay (GeocodeRacingBackend *self,
+                                        guint                 hedge_delay)
+{
+	g_return_if_fail (GEOCODE_IS_RACING_BACKEND (self));
+
+	if ((guint) g_atomic_int_get (&self->hedge_delay) == hedge_delay)
+		return;
+
+	g_atomic_int_set (&self->hedge_delay, hedge_delay);
+	g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_HEDGE_DELAY]);
+}
+
+static void
+geocode_racing_backend_init (GeocodeRacingBackend *self)
+{
+	g_mutex_init (&self->lock);
+	self->children = g_ptr_array_new_with_free_func ((GDestroyNotify) child_free);
+	self->hedge_delay = DEFAULT_HEDGE_DELAY;
+}
+
+static void
+geocode_racing_backend_get_property (GObject    *object,
+                                     guint       property_id,
+                                     GValue     *value,
+                                     GParamSpec *pspec)
+{
+	GeocodeRacingBackend *self = GEOCODE_RACING_BACKEND (object);
+
+	switch ((GeocodeRacingBackendProperty) property_id) {
+	case PROP_HEDGE_DELAY:
+		g_value_set_uint (value, geocode_racing_backend_get_hedge_delay (self));
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+		break;
+	}
+}
+
+static void
+geocode_racing_backend_set_property (GObject      *object,
+                                     guint         property_id,
+                                     const GValue *value,
+                                     GParamSpec   *pspec)
+{
+	GeocodeRacingBackend *self = GEOCODE_RACING_BACKEND (object);
+
+	switch ((GeocodeRacingBackendProperty) property_id) {
+	case PROP_HEDGE_DELAY:
+		geocode_racing_backend_set_hedge_delay (self, g_value_get_uint (value));
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+		break;
+	}
+}
+
+static void
+geocode_racing_backend_finalize (GObject *object)
+{
+	GeocodeRacingBackend *self = GEOCODE_RACING_BACKEND (object);
+
+	g_ptr_array_unref (self->children);
+	g_mutex_clear (&self->lock);
+
+	G_OBJECT_CLASS (geocode_racing_backend_parent_class)->finalize (object);
+}
+
+static void
+geocode_backend_iface_init (GeocodeBackendInterface *iface)
+{
+	iface->forward_search = geocode_racing_backend_forward_search;
+	iface->forward_search_async = geocode_racing_backend_forward_search_async;
+	iface->forward_search_finish = geocode_racing_backend_forward_search_finish;
+	iface->reverse_resolve = geocode_racing_backend_reverse_resolve;
+	iface->reverse_resolve_async = geocode_racing_backend_reverse_resolve_async;
+	iface->reverse_resolve_finish = geocode_racing_backend_reverse_resolve_finish;
+}
+
+static void
+geocode_racing_backend_class_init (GeocodeRacingBackendClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->get_property = geocode_racing_backend_get_property;
+	object_class->set_property = geocode_racing_backend_set_property;
+	object_class->finalize = geocode_racing_backend_finalize;
+
+	/**
+	 * GeocodeRacingBackend:hedge-delay:
+	 *
+	 * The time, in milliseconds, to wait for an answer before sending the
+	 * query to another backend as well, or 0 to send each query to all
+	 * the backends at once.
+	 *
+	 * Since: 3.28
+	 */
+	properties[PROP_HEDGE_DELAY] = g_param_spec_uint ("hedge-delay",
+	                                                  "Hedge Delay",
+	                                                  "Time to wait before querying another backend, in milliseconds",
+	                                                  0, G_MAXUINT,
+	                                                  DEFAULT_HEDGE_DELAY,
+	                                                  (G_PARAM_READWRITE |
+	                                                   G_PARAM_EXPLICIT_NOTIFY |
+	                                                   G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_properties (object_class,
+	                                   G_N_ELEMENTS (properties), properties);
+}
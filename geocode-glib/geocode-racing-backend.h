@@ -0,0 +1,66 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#ifndef GEOCODE_RACING_BACKEND_H
+#define GEOCODE_RACING_BACKEND_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "geocode-backend.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GeocodeRacingBackend:
+ *
+ * All the fields in the #GeocodeRacingBackend structure are private and
+ * should never be accessed directly.
+ *
+ * Since: 3.28
+ */
+#define GEOCODE_TYPE_RACING_BACKEND (geocode_racing_backend_get_type ())
+G_DECLARE_FINAL_TYPE (GeocodeRacingBackend, geocode_racing_backend,
+                      GEOCODE, RACING_BACKEND, GObject)
+
+/**
+ * GEOCODE_TYPE_RACING_BACKEND:
+ *
+ * See #GeocodeRacingBackend.
+ *
+ * Since: 3.28
+ */
+
+GeocodeRacingBackend *geocode_racing_backend_new (void);
+
+void geocode_racing_backend_add_backend (GeocodeRacingBackend *self,
+                                         GeocodeBackend       *backend,
+                                         guint                 weight);
+
+guint geocode_racing_backend_get_hedge_delay (GeocodeRacingBackend *self);
+void  geocode_racing_backend_set_hedge_delay (GeocodeRacingBackend *self,
+                                              guint                 hedge_delay);
+
+guint geocode_racing_backend_get_n_wins (GeocodeRacingBackend *self,
+                                         GeocodeBackend       *backend);
+
+G_END_DECLS
+
+#endif /* GEOCODE_RACING_BACKEND_H */
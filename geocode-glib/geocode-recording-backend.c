@@ -0,0 +1,588 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include <gio/gio.h>
+#include <json-glib/json-glib.h>
+#include <string.h>
+
+#include "geocode-glib-private.h"
+#include "geocode-glib.h"
+#include "geocode-recording-backend.h"
+
+/**
+ * SECTION:geocode-recording-backend
+ * @short_description: Geocode backend recording queries to a trace file
+ * @include: geocode-glib/geocode-glib.h
+ *
+ * #GeocodeRecordingBackend passes queries on to another backend, such as a
+ * #GeocodeNominatim, and appends each query, its answer and how long the
+ * answer took to a trace file. The trace can then be served by a
+ * #GeocodeReplayBackend, so that tests and benchmarks run against realistic
+ * traffic without a network connection, and give the same answers on every
+ * run.
+ *
+ * The trace file holds one JSON object per line, which is written as soon
+ * as the query is answered:
+ *
+ * |[
+ * {"forward":true,"time":0,"latency":81234,
+ *  "params":{"location":["gchararray","Paris"],"limit":["guint",1]},
+ *  "places":[{"name":"Paris","place-type":"town",
+ *             "location":{"latitude":48.8566,"longitude":2.3515,…},…}]}
+ * {"forward":false,"time":120345,"latency":90012,
+ *  "params":{"lat":["gdouble",0],"lon":["gdouble",0]},
+ *  "error":{"domain":"geocode_error","code":1,"message":"…"}}
+ * ]|
+ *
+ * `time` is when the query was made and `latency` how long it took to
+ * answer, both in microseconds, `time` being counted from the creation of
+ * the backend. A #GeocodeReplayBackend waits for `latency` before returning
+ * each answer, and gives the `time` of each query through
+ * geocode_replay_backend_get_entries(). Each parameter is stored with the name of its #GType, so
+ * that it is replayed with the same type. Parameters of types other than
+ * strings, booleans and numbers are not recorded.
+ *
+ * Cancelled queries are not recorded. Failing to write to the trace is
+ * reported with g_warning(), and does not affect the query.
+ *
+ * Since: 3.28
+ */
+
+struct _GeocodeRecordingBackend {
+	GObject parent;
+
+	GeocodeBackend *backend;  /* (owned) */
+	gint64 start_time;  /* monotonic, microseconds */
+
+	GMutex lock;  /* protects the fields below */
+	GOutputStream *stream;  /* (owned) */
+	guint n_entries;
+};
+
+typedef enum {
+	PROP_BACKEND = 1,
+	PROP_STREAM,
+} GeocodeRecordingBackendProperty;
+
+static GParamSpec *properties[PROP_STREAM + 1];
+
+static void geocode_backend_iface_init (GeocodeBackendInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GeocodeRecordingBackend, geocode_recording_backend, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (GEOCODE_TYPE_BACKEND,
+                                                geocode_backend_iface_init))
+
+/******************************************************************************/
+
+static void
+places_list_free (GList *places)
+{
+	g_list_free_full (places, g_object_unref);
+}
+
+static GList *
+backend_query (GeocodeBackend  *backend,
+               gboolean         is_forward,
+               GHashTable      *params,
+               GCancellable    *cancellable,
+               GError         **error)
+{
+	if (is_forward)
+		return geocode_backend_forward_search (backend, params,
+		                                       cancellable, error);
+	else
+		return geocode_backend_reverse_resolve (backend, params,
+		                                        cancellable, error);
+}
+
+static void
+backend_query_async (GeocodeBackend      *backend,
+                     gboolean             is_forward,
+                     GHashTable          *params,
+                     GCancellable        *cancellable,
+                     GAsyncReadyCallback  callback,
+                     gpointer             user_data)
+{
+	if (is_forward)
+		geocode_backend_forward_search_async (backend, params, cancellable,
+		                                      callback, user_data);
+	else
+		geocode_backend_reverse_resolve_async (backend, params, cancellable,
+		                                       callback, user_data);
+}
+
+static GList *
+backend_query_finish (GeocodeBackend  *backend,
+                      gboolean         is_forward,
+                      GAsyncResult    *result,
+                      GError         **error)
+{
+	if (is_forward)
+		return geocode_backend_forward_search_finish (backend, result, error);
+	else
+		return geocode_backend_reverse_resolve_finish (backend, result, error);
+}
+
+/******************************************************************************/
+
+/* Appends a line for the query to the trace. */
+static void
+record (GeocodeRecordingBackend *self,
+        gboolean                 is_forward,
+        GHashTable              *params,
+        gint64                   start_time,
+        GList                   *places,
+        const GError            *error)
+{
+	g_autoptr (JsonBuilder) builder = NULL;
+	g_autoptr (JsonGenerator) generator = NULL;
+	g_autoptr (JsonNode) root = NULL;
+	g_autoptr (GError) write_error = NULL;
+	g_autofree char *entry = NULL;
+	g_autofree char *line = NULL;
+	GList *l;
+
+	if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+		return;
+
+	builder = json_builder_new ();
+	json_builder_begin_object (builder);
+
+	json_builder_set_member_name (builder, "forward");
+	json_builder_add_boolean_value (builder, is_forward);
+	json_builder_set_member_name (builder, "time");
+	json_builder_add_int_value (builder, start_time - self->start_time);
+	json_builder_set_member_name (builder, "latency");
+	json_builder_add_int_value (builder, g_get_monotonic_time () - start_time);
+
+	json_builder_set_member_name (builder, "params");
+	_geocode_params_to_json (builder, params);
+
+	if (error != NULL) {
+		json_builder_set_member_name (builder, "error");
+		json_builder_begin_object (builder);
+		json_builder_set_member_name (builder, "domain");
+		json_builder_add_string_value (builder, g_quark_to_string (error->domain));
+		json_builder_set_member_name (builder, "code");
+		json_builder_add_int_value (builder, error->code);
+		json_builder_set_member_name (builder, "message");
+		json_builder_add_string_value (builder, error->message);
+		json_builder_end_object (builder);
+	} else {
+		json_builder_set_member_name (builder, "places");
+		json_builder_begin_array (builder);
+		for (l = places; l != NULL; l = l->next)
+			_geocode_place_to_json (builder, l->data);
+		json_builder_end_array (builder);
+	}
+
+	json_builder_end_object (builder);
+
+	root = json_builder_get_root (builder);
+	generator = json_generator_new ();
+	json_generator_set_root (generator, root);
+	entry = json_generator_to_data (generator, NULL);
+
+	/* Newlines inside strings are escaped, so each entry is one line, and
+	 * is written in one go so that concurrent appends don’t interleave. */
+	line = g_strconcat (entry, "\n", NULL);
+
+	g_mutex_lock (&self->lock);
+
+	if (g_output_stream_write_all (self->stream, line, strlen (line),
+	                               NULL, NULL, &write_error))
+		self->n_entries++;
+
+	g_mutex_unlock (&self->lock);
+
+	if (write_error != NULL)
+		g_warning ("Failed to write geocode trace entry: %s",
+		           write_error->message);
+}
+
+/******************************************************************************/
+
+static GList *
+recording_query (GeocodeRecordingBackend  *self,
+                 gboolean                  is_forward,
+                 GHashTable               *params,
+                 GCancellable             *cancellable,
+                 GError                  **error)
+{
+	GList *places;
+	g_autoptr (GError) local_error = NULL;
+	gint64 start_time = g_get_monotonic_time ();
+
+	places = backend_query (self->backend, is_forward, params, cancellable,
+	                        &local_error);
+	record (self, is_forward, params, start_time, places, local_error);
+
+	if (local_error != NULL)
+		g_propagate_error (error, g_steal_pointer (&local_error));
+
+	return places;
+}
+
+typedef struct {
+	gboolean is_forward;
+	GHashTable *params;  /* (owned) */
+	gint64 start_time;
+} QueryData;
+
+static void
+query_data_free (QueryData *data)
+{
+	g_hash_table_unref (data->params);
+	g_free (data);
+}
+
+static void
+query_cb (GObject      *source_object,
+          GAsyncResult *result,
+          gpointer      user_data)
+{
+	g_autoptr (GTask) task = G_TASK (user_data);
+	GeocodeRecordingBackend *self = g_task_get_source_object (task);
+	QueryData *data = g_task_get_task_data (task);
+	GList *places;
+	GError *error = NULL;
+
+	places = backend_query_finish (GEOCODE_BACKEND (source_object),
+	                               data->is_forward, result, &error);
+	record (self, data->is_forward, data->params, data->start_time,
+	        places, error);
+
+	if (error != NULL)
+		g_task_return_error (task, error);
+	else
+		g_task_return_pointer (task, places,
+		                       (GDestroyNotify) places_list_free);
+}
+
+static void
+recording_query_async (GeocodeRecordingBackend *self,
+                       gboolean                 is_forward,
+                       gpointer                 source_tag,
+                       GHashTable              *params,
+                       GCancellable            *cancellable,
+                       GAsyncReadyCallback      callback,
+                       gpointer                 user_data)
+{
+	g_autoptr (GTask) task = NULL;
+	QueryData *data;
+
+	task = g_task_new (self, cancellable, callback, user_data);
+	g_task_set_source_tag (task, source_tag);
+
+	data = g_new0 (QueryData, 1);
+	data->is_forward = is_forward;
+	data->params = g_hash_table_ref (params);
+	data->start_time = g_get_monotonic_time ();
+	g_task_set_task_data (task, data, (GDestroyNotify) query_data_free);
+
+	backend_query_async (self->backend, is_forward, params, cancellable,
+	                     query_cb, g_steal_pointer (&task));
+}
+
+/******************************************************************************/
+
+static GList *
+geocode_recording_backend_forward_search (GeocodeBackend  *backend,
+                                          GHashTable      *params,
+                                          GCancellable    *cancellable,
+                                          GError         **error)
+{
+	return recording_query (GEOCODE_RECORDING_BACKEND (backend), TRUE,
+	                        params, cancellable, error);
+}
+
+static void
+geocode_recording_backend_forward_search_async (GeocodeBackend      *backend,
+                                                GHashTable          *params,
+                                                GCancellable        *cancellable,
+                                                GAsyncReadyCallback  callback,
+                                                gpointer             user_data)
+{
+	recording_query_async (GEOCODE_RECORDING_BACKEND (backend), TRUE,
+	                       geocode_recording_backend_forward_search_async,
+	                       params, cancellable, callback, user_data);
+}
+
+static GList *
+geocode_recording_backend_forward_search_finish (GeocodeBackend  *backend,
+                                                 GAsyncResult    *result,
+                                                 GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static GList *
+geocode_recording_backend_reverse_resolve (GeocodeBackend  *backend,
+                                           GHashTable      *params,
+                                           GCancellable    *cancellable,
+                                           GError         **error)
+{
+	return recording_query (GEOCODE_RECORDING_BACKEND (backend), FALSE,
+	                        params, cancellable, error);
+}
+
+static void
+geocode_recording_backend_reverse_resolve_async (GeocodeBackend      *backend,
+                                                 GHashTable          *params,
+                                                 GCancellable        *cancellable,
+                                                 GAsyncReadyCallback  callback,
+                                                 gpointer             user_data)
+{
+	recording_query_async (GEOCODE_RECORDING_BACKEND (backend), FALSE,
+	                       geocode_recording_backend_reverse_resolve_async,
+	                       params, cancellable, callback, user_data);
+}
+
+static GList *
+geocode_recording_backend_reverse_resolve_finish (GeocodeBackend  *backend,
+                                                  GAsyncResult    *result,
+                                                  GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/******************************************************************************/
+
+/**
+ * geocode_recording_backend_new:
+ * @backend: backend to pass queries on to
+ * @path: (type filename): path of the trace file to append to
+ * @error: return location for a #GError, or %NULL
+ *
+ * Creates a new backend which passes queries on to @backend, and records
+ * them to the trace file at @path. The file is created if it does not
+ * exist, and appended to otherwise.
+ *
+ * If the file cannot be opened, a #GIOErrorEnum error is returned.
+ *
+ * Returns: (transfer full) (nullable): a new #GeocodeRecordingBackend, or
+ * %NULL on error. Use g_object_unref() when done.
+ *
+ * Since: 3.28
+ */
+GeocodeRecordingBackend *
+geocode_recording_backend_new (GeocodeBackend  *backend,
+                               const char      *path,
+                               GError         **error)
+{
+	g_autoptr (GFile) file = NULL;
+	g_autoptr (GFileOutputStream) stream = NULL;
+
+	g_return_val_if_fail (GEOCODE_IS_BACKEND (backend), NULL);
+	g_return_val_if_fail (path != NULL, NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	file = g_file_new_for_path (path);
+	stream = g_file_append_to (file, G_FILE_CREATE_NONE, NULL, error);
+	if (stream == NULL)
+		return NULL;
+
+	return g_object_new (GEOCODE_TYPE_RECORDING_BACKEND,
+	                     "backend", backend,
+	                     "stream", stream,
+	                     NULL);
+}
+
+/**
+ * geocode_recording_backend_get_backend:
+ * @self: a #GeocodeRecordingBackend
+ *
+ * Gets the #GeocodeRecordingBackend:backend.
+ *
+ * Returns: (transfer none): the backend queries are passed on to
+ *
+ * Since: 3.28
+ */
+GeocodeBackend *
+geocode_recording_backend_get_backend (GeocodeRecordingBackend *self)
+{
+	g_return_val_if_fail (GEOCODE_IS_RECORDING_BACKEND (self), NULL);
+
+	return self->backend;
+}
+
+/**
+ * geocode_recording_backend_get_n_entries:
+ * @self: a #GeocodeRecordingBackend
+ *
+ * Gets the number of queries written to the trace file by this backend.
+ *
+ * Returns: the number of trace entries written
+ *
+ * Since: 3.28
+ */
+guint
+geocode_recording_backend_get_n_entries (GeocodeRecordingBackend *self)
+{
+	guint n_entries;
+
+	g_return_val_if_fail (GEOCODE_IS_RECORDING_BACKEND (self), 0);
+
+	g_mutex_lock (&self->lock);
+	n_entries = self->n_entries;
+	g_mutex_unlock (&self->lock);
+
+	return n_entries;
+}
+
+static void
+geocode_recording_backend_init (GeocodeRecordingBackend *self)
+{
+	g_mutex_init (&self->lock);
+	self->start_time = g_get_monotonic_time ();
+}
+
+static void
+geocode_recording_backend_get_property (GObject    *object,
+                                        guint       property_id,
+                                        GValue     *value,
+                                        GParamSpec *pspec)
+{
+	GeocodeRecordingBackend *self = GEOCODE_RECORDING_BACKEND (object);
+
+	switch ((GeocodeRecordingBackendProperty) property_id) {
+	case PROP_BACKEND:
+		g_value_set_object (value, self->backend);
+		break;
+	case PROP_STREAM:
+		g_value_set_object (value, self->stream);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+		break;
+	}
+}
+
+static void
+geocode_recording_backend_set_property (GObject      *object,
+                                        guint         property_id,
+                                        const GValue *value,
+                                        GParamSpec   *pspec)
+{
+	GeocodeRecordingBackend *self = GEOCODE_RECORDING_BACKEND (object);
+
+	switch ((GeocodeRecordingBackendProperty) property_id) {
+	case PROP_BACKEND:
+		/* Construct only. */
+		g_assert (self->backend == NULL);
+		self->backend = g_value_dup_object (value);
+		break;
+	case PROP_STREAM:
+		/* Construct only. */
+		g_assert (self->stream == NULL);
+		self->stream = g_value_dup_object (value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+		break;
+	}
+}
+
+static void
+geocode_recording_backend_constructed (GObject *object)
+{
+	GeocodeRecordingBackend *self = GEOCODE_RECORDING_BACKEND (object);
+
+	G_OBJECT_CLASS (geocode_recording_backend_parent_class)->constructed (object);
+
+	g_assert (self->backend != NULL);
+	g_assert (self->stream != NULL);
+}
+
+static void
+geocode_recording_backend_finalize (GObject *object)
+{
+	GeocodeRecordingBackend *self = GEOCODE_RECORDING_BACKEND (object);
+
+	if (self->stream != NULL)
+		g_output_stream_close (self->stream, NULL, NULL);
+
+	g_clear_object (&self->stream);
+	g_clear_object (&self->backend);
+	g_mutex_clear (&self->lock);
+
+	G_OBJECT_CLASS (geocode_recording_backend_parent_class)->finalize (object);
+}
+
+static void
+geocode_backend_iface_init (GeocodeBackendInterface *iface)
+{
+	iface->forward_search = geocode_recording_backend_forward_search;
+	iface->forward_search_async = geocode_recording_backend_forward_search_async;
+	iface->forward_search_finish = geocode_recording_backend_forward_search_finish;
+	iface->reverse_resolve = geocode_recording_backend_reverse_resolve;
+	iface->reverse_resolve_async = geocode_recording_backend_reverse_resolve_async;
+	iface->reverse_resolve_finish = geocode_recording_backend_reverse_resolve_finish;
+}
+
+static void
+geocode_recording_backend_class_init (GeocodeRecordingBackendClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->get_property = geocode_recording_backend_get_property;
+	object_class->set_property = geocode_recording_backend_set_property;
+	object_class->constructed = geocode_recording_backend_constructed;
+	object_class->finalize = geocode_recording_backend_finalize;
+
+	/**
+	 * GeocodeRecordingBackend:backend:
+	 *
+	 * The backend which queries are passed on to.
+	 *
+	 * Since: 3.28
+	 */
+	properties[PROP_BACKEND] = g_param_spec_object ("backend",
+	                                                "Backend",
+	                                                "Backend which queries are passed on to",
+	                                                GEOCODE_TYPE_BACKEND,
+	                                                (G_PARAM_READWRITE |
+	                                                 G_PARAM_CONSTRUCT_ONLY |
+	                                                 G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * GeocodeRecordingBackend:stream:
+	 *
+	 * The stream which trace entries are written to. It is closed when the
+	 * backend is finalized. geocode_recording_backend_new() opens it for
+	 * a trace file; objects built with g_object_new() must set it too.
+	 *
+	 * Since: 3.28
+	 */
+	properties[PROP_STREAM] = g_param_spec_object ("stream",
+	                                               "Stream",
+	                                               "Stream which trace entries are written to",
+	                                               G_TYPE_OUTPUT_STREAM,
+	                                               (G_PARAM_READWRITE |
+	                                                G_PARAM_CONSTRUCT_ONLY |
+	                                                G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_properties (object_class,
+	                                   G_N_ELEMENTS (properties), properties);
+}
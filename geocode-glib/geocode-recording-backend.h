@@ -0,0 +1,61 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#ifndef GEOCODE_RECORDING_BACKEND_H
+#define GEOCODE_RECORDING_BACKEND_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "geocode-backend.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GeocodeRecordingBackend:
+ *
+ * All the fields in the #GeocodeRecordingBackend structure are private and
+ * should never be accessed directly.
+ *
+ * Since: 3.28
+ */
+#define GEOCODE_TYPE_RECORDING_BACKEND (geocode_recording_backend_get_type ())
+G_DECLARE_FINAL_TYPE (GeocodeRecordingBackend, geocode_recording_backend,
+                      GEOCODE, RECORDING_BACKEND, GObject)
+
+/**
+ * GEOCODE_TYPE_RECORDING_BACKEND:
+ *
+ * See #GeocodeRecordingBackend.
+ *
+ * Since: 3.28
+ */
+
+GeocodeRecordingBackend *geocode_recording_backend_new (GeocodeBackend  *backend,
+                                                        const char      *path,
+                                                        GError         **error);
+
+GeocodeBackend *geocode_recording_backend_get_backend (GeocodeRecordingBackend *self);
+
+guint geocode_recording_backend_get_n_entries (GeocodeRecordingBackend *self);
+
+G_END_DECLS
+
+#endif /* GEOCODE_RECORDING_BACKEND_H */
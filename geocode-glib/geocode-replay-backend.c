@@ -0,0 +1,926 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include <gio/gio.h>
+#include <json-glib/json-glib.h>
+#include <string.h>
+
+#include "geocode-glib-private.h"
+#include "geocode-glib.h"
+#include "geocode-replay-backend.h"
+
+/**
+ * SECTION:geocode-replay-backend
+ * @short_description: Geocode backend replaying a trace file
+ * @include: geocode-glib/geocode-glib.h
+ *
+ * #GeocodeReplayBackend answers queries from a trace file written by a
+ * #GeocodeRecordingBackend, so that tests and benchmarks can be run
+ * offline against traffic recorded from a real service, with the same
+ * answers on every run.
+ *
+ * Traces are loaded with geocode_replay_backend_load_file() or
+ * geocode_replay_backend_load_data(). Entries are indexed by a hash of
+ * their query parameters, so a query is answered in constant time however
+ * long the trace is. A query matches an entry if its parameters have the
+ * same names, types and values. If the trace holds several entries for the
+ * same query, they are returned in turn, in the order they were recorded,
+ * starting again from the first once they have all been returned. Queries
+ * which are not in the trace fail with %GEOCODE_ERROR_NO_MATCHES (forward)
+ * or %GEOCODE_ERROR_NOT_SUPPORTED (reverse).
+ *
+ * Each answer is returned after the latency it was recorded with, divided
+ * by #GeocodeReplayBackend:speed. Asynchronous queries wait in the
+ * thread-default main context of the caller rather than in a thread.
+ *
+ * The backend only answers queries; it does not make them. To replay the
+ * recorded traffic at the rate it was recorded at, a benchmark can get the
+ * loaded queries and when they were made with
+ * geocode_replay_backend_get_entries().
+ *
+ * Since: 3.28
+ */
+
+#define DEFAULT_SPEED 1.0
+
+/* The longest delay which g_timeout_source_new() can express. */
+#define MAX_DELAY ((gint64) G_MAXUINT * 1000)  /* microseconds */
+
+typedef struct {
+	GList *places;  /* (owned) (element-type GeocodePlace) (nullable) */
+	GError *error;  /* (owned) (nullable) */
+	gint64 latency;  /* microseconds */
+} Answer;
+
+typedef struct {
+	GHashTable *params;  /* (owned) */
+	GPtrArray *answers;  /* (owned) (element-type Answer) */
+	guint next_answer;
+} Entry;
+
+/* An entry parsed from a trace, before it is added to the index. */
+typedef struct {
+	gboolean is_forward;
+	GHashTable *params;  /* (owned) */
+	gint64 time;  /* microseconds */
+	Answer *answer;  /* (owned) */
+} ParsedEntry;
+
+struct _GeocodeReplayBackend {
+	GObject parent;
+
+	GMutex lock;  /* protects the fields below */
+	GHashTable *forward_entries;  /* (owned) (element-type GHashTable Entry) */
+	GHashTable *reverse_entries;  /* (owned) (element-type GHashTable Entry) */
+	GPtrArray *entries;  /* (owned) (element-type GeocodeReplayBackendEntry) */
+	gdouble speed;
+};
+
+typedef enum {
+	PROP_SPEED = 1,
+} GeocodeReplayBackendProperty;
+
+static GParamSpec *properties[PROP_SPEED + 1];
+
+static void geocode_backend_iface_init (GeocodeBackendInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GeocodeReplayBackend, geocode_replay_backend, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (GEOCODE_TYPE_BACKEND,
+                                                geocode_backend_iface_init))
+
+/******************************************************************************/
+
+static void
+places_list_free (GList *places)
+{
+	g_list_free_full (places, g_object_unref);
+}
+
+static void
+answer_free (Answer *answer)
+{
+	places_list_free (answer->places);
+	g_clear_error (&answer->error);
+	g_free (answer);
+}
+
+static void
+entry_free (Entry *entry)
+{
+	g_hash_table_unref (entry->params);
+	g_ptr_array_unref (entry->answers);
+	g_free (entry);
+}
+
+static void
+replay_entry_free (GeocodeReplayBackendEntry *entry)
+{
+	g_hash_table_unref (entry->params);
+	g_free (entry);
+}
+
+static void
+parsed_entry_free (ParsedEntry *parsed)
+{
+	g_clear_pointer (&parsed->params, g_hash_table_unref);
+	g_clear_pointer (&parsed->answer, answer_free);
+	g_free (parsed);
+}
+
+/******************************************************************************/
+
+static Answer *
+parse_answer (JsonObject  *object,
+              GError     **error)
+{
+	GList *places = NULL;  /* (element-type GeocodePlace) */
+	JsonObject *error_object;
+	JsonNode *places_node;
+	Answer *answer;
+	gint64 latency = 0;
+
+	_geocode_json_get_int_member (object, "latency", &latency);
+
+	error_object = _geocode_json_get_object_member (object, "error");
+	places_node = json_object_get_member (object, "places");
+
+	if (error_object != NULL) {
+		const char *domain = _geocode_json_get_string_member (error_object, "domain");
+		const char *message = _geocode_json_get_string_member (error_object, "message");
+		gint64 code;
+
+		if (domain == NULL || message == NULL ||
+		    !_geocode_json_get_int_member (error_object, "code", &code)) {
+			g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+			                     "Invalid error");
+			return NULL;
+		}
+
+		answer = g_new0 (Answer, 1);
+		answer->error = g_error_new_literal (g_quark_from_string (domain),
+		                                     (gint) code, message);
+	} else if (places_node != NULL && JSON_NODE_HOLDS_ARRAY (places_node)) {
+		JsonArray *array = json_node_get_array (places_node);
+		guint i;
+
+		for (i = 0; i < json_array_get_length (array); i++) {
+			GeocodePlace *place;
+
+			place = _geocode_place_from_json (json_array_get_element (array, i), error);
+			if (place == NULL) {
+				places_list_free (places);
+				return NULL;
+			}
+
+			places = g_list_prepend (places, place);
+		}
+
+		answer = g_new0 (Answer, 1);
+		answer->places = g_list_reverse (places);
+	} else {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		                     "Expected places or an error");
+		return NULL;
+	}
+
+	answer->latency = MAX (latency, 0);
+
+	return answer;
+}
+
+static ParsedEntry *
+parse_entry (const char  *line,
+             gsize        length,
+             GError     **error)
+{
+	g_autoptr (JsonParser) parser = NULL;
+	JsonNode *root, *forward_node;
+	JsonObject *object, *params_object;
+	ParsedEntry *parsed;
+	g_autoptr (GHashTable) params = NULL;
+	Answer *answer;
+	gint64 time = 0;
+
+	parser = json_parser_new ();
+	if (!json_parser_load_from_data (parser, line, length, error))
+		return NULL;
+
+	root = json_parser_get_root (parser);
+	if (root == NULL || !JSON_NODE_HOLDS_OBJECT (root)) {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		                     "Expected an object");
+		return NULL;
+	}
+
+	object = json_node_get_object (root);
+	forward_node = json_object_get_member (object, "forward");
+	params_object = _geocode_json_get_object_member (object, "params");
+
+	if (forward_node == NULL || !JSON_NODE_HOLDS_VALUE (forward_node) ||
+	    json_node_get_value_type (forward_node) != G_TYPE_BOOLEAN ||
+	    params_object == NULL) {
+		g_set_error_literal (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE,
+		                     "Expected forward and params members");
+		return NULL;
+	}
+
+	params = _geocode_params_from_json (params_object, error);
+	if (params == NULL)
+		return NULL;
+
+	answer = parse_answer (object, error);
+	if (answer == NULL)
+		return NULL;
+
+	_geocode_json_get_int_member (object, "time", &time);
+
+	parsed = g_new0 (ParsedEntry, 1);
+	parsed->is_forward = json_node_get_boolean (forward_node);
+	parsed->params = g_steal_pointer (&params);
+	parsed->time = MAX (time, 0);
+	parsed->answer = answer;
+
+	return parsed;
+}
+
+/* Must be called with @self->lock held. */
+static void
+add_entry_locked (GeocodeReplayBackend *self,
+                  ParsedEntry          *parsed)
+{
+	GHashTable *entries;
+	Entry *entry;
+	GeocodeReplayBackendEntry *replay_entry;
+
+	replay_entry = g_new0 (GeocodeReplayBackendEntry, 1);
+	replay_entry->params = g_hash_table_ref (parsed->params);
+	replay_entry->is_forward = parsed->is_forward;
+	replay_entry->time = parsed->time;
+	g_ptr_array_add (self->entries, replay_entry);
+
+	entries = parsed->is_forward ? self->forward_entries : self->reverse_entries;
+	entry = g_hash_table_lookup (entries, parsed->params);
+
+	if (entry == NULL) {
+		entry = g_new0 (Entry, 1);
+		entry->params = g_steal_pointer (&parsed->params);
+		entry->answers = g_ptr_array_new_with_free_func ((GDestroyNotify) answer_free);
+		g_hash_table_insert (entries, entry->params, entry);
+	}
+
+	g_ptr_array_add (entry->answers, g_steal_pointer (&parsed->answer));
+}
+
+/******************************************************************************/
+
+/* Looks up the next answer for @params, copying its places or error.
+ * Returns the delay, in microseconds, before the answer should be
+ * returned. */
+static gint64
+replay (GeocodeReplayBackend  *self,
+        gboolean               is_forward,
+        GHashTable            *params,
+        GList                **places_out,
+        GError               **error_out)
+{
+	Entry *entry;
+	const Answer *answer;
+	gint64 delay;
+
+	g_mutex_lock (&self->lock);
+
+	entry = g_hash_table_lookup (is_forward ? self->forward_entries :
+	                             self->reverse_entries, params);
+
+	if (entry == NULL) {
+		g_mutex_unlock (&self->lock);
+
+		*places_out = NULL;
+		*error_out = g_error_new (GEOCODE_ERROR,
+		                          is_forward ? GEOCODE_ERROR_NO_MATCHES :
+		                          GEOCODE_ERROR_NOT_SUPPORTED,
+		                          "No matches found for request");
+		return 0;
+	}
+
+	answer = entry->answers->pdata[entry->next_answer];
+	entry->next_answer = (entry->next_answer + 1) % entry->answers->len;
+
+	*places_out = g_list_copy_deep (answer->places, (GCopyFunc) g_object_ref, NULL);
+	*error_out = (answer->error != NULL) ? g_error_copy (answer->error) : NULL;
+
+	/* A tiny speed or a huge latency in the trace must not overflow. */
+	if (self->speed > 0.0)
+		delay = (gint64) MIN (answer->latency / self->speed, (gdouble) MAX_DELAY);
+	else
+		delay = 0;
+
+	g_mutex_unlock (&self->lock);
+
+	return delay;
+}
+
+/* Blocks for @delay microseconds, returning early if @cancellable is
+ * cancelled. */
+static void
+sleep_cancellable (gint64        delay,
+                   GCancellable *cancellable)
+{
+	GPollFD pollfd;
+	gboolean has_pollfd;
+	gint64 end_time;
+
+	if (delay <= 0)
+		return;
+
+	has_pollfd = g_cancellable_make_pollfd (cancellable, &pollfd);
+	end_time = g_get_monotonic_time () + delay;
+
+	while (!g_cancellable_is_cancelled (cancellable)) {
+		gint64 remaining = end_time - g_get_monotonic_time ();
+
+		if (remaining <= 0)
+			break;
+
+		/* Sleep in steps which fit in a gint, for g_poll(), and in a
+		 * 32-bit gulong, for g_usleep(). */
+		if (has_pollfd)
+			g_poll (&pollfd, 1, (gint) MIN ((remaining + 999) / 1000, G_MAXINT));
+		else
+			g_usleep ((gulong) MIN (remaining, G_MAXINT));
+	}
+
+	if (has_pollfd)
+		g_cancellable_release_fd (cancellable);
+}
+
+static GList *
+replay_sync (GeocodeReplayBackend  *self,
+             gboolean               is_forward,
+             GHashTable            *params,
+             GCancellable          *cancellable,
+             GError               **error)
+{
+	GList *places;
+	GError *local_error;
+	gint64 delay;
+
+	delay = replay (self, is_forward, params, &places, &local_error);
+	sleep_cancellable (delay, cancellable);
+
+	if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+		places_list_free (places);
+		g_clear_error (&local_error);
+		return NULL;
+	}
+
+	if (local_error != NULL)
+		g_propagate_error (error, local_error);
+
+	return places;
+}
+
+typedef struct {
+	GTask *task;  /* (owned) */
+	GList *places;  /* (owned) (element-type GeocodePlace) (nullable) */
+	GError *error;  /* (owned) (nullable) */
+	GSource *timeout_source;  /* (owned) */
+	GSource *cancel_source;  /* (owned) (nullable) */
+} DelayedAnswer;
+
+static void
+delayed_answer_free (DelayedAnswer *answer)
+{
+	g_source_destroy (answer->timeout_source);
+	g_source_unref (answer->timeout_source);
+
+	if (answer->cancel_source != NULL) {
+		g_source_destroy (answer->cancel_source);
+		g_source_unref (answer->cancel_source);
+	}
+
+	places_list_free (answer->places);
+	g_clear_error (&answer->error);
+	g_object_unref (answer->task);
+	g_free (answer);
+}
+
+static void
+task_return_answer (GTask  *task,
+                    GList  *places,
+                    GError *error)
+{
+	if (error != NULL)
+		g_task_return_error (task, error);
+	else
+		g_task_return_pointer (task, places,
+		                       (GDestroyNotify) places_list_free);
+}
+
+static gboolean
+delayed_answer_timeout_cb (gpointer user_data)
+{
+	DelayedAnswer *answer = user_data;
+
+	task_return_answer (answer->task, g_steal_pointer (&answer->places),
+	                    g_steal_pointer (&answer->error));
+	delayed_answer_free (answer);
+
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean
+delayed_answer_cancelled_cb (GCancellable *cancellable,
+                             gpointer      user_data)
+{
+	DelayedAnswer *answer = user_data;
+
+	g_task_return_error_if_cancelled (answer->task);
+	delayed_answer_free (answer);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+replay_async (GeocodeReplayBackend *self,
+              gboolean              is_forward,
+              gpointer              source_tag,
+              GHashTable           *params,
+              GCancellable         *cancellable,
+              GAsyncReadyCallback   callback,
+              gpointer              user_data)
+{
+	g_autoptr (GTask) task = NULL;
+	GList *places;
+	GError *error;
+	DelayedAnswer *answer;
+	gint64 delay;
+
+	task = g_task_new (self, cancellable, callback, user_data);
+	g_task_set_source_tag (task, source_tag);
+
+	delay = replay (self, is_forward, params, &places, &error);
+
+	if (delay <= 0) {
+		if (g_task_return_error_if_cancelled (task)) {
+			places_list_free (places);
+			g_clear_error (&error);
+		} else {
+			task_return_answer (task, places, error);
+		}
+
+		return;
+	}
+
+	answer = g_new0 (DelayedAnswer, 1);
+	answer->task = g_steal_pointer (&task);
+	answer->places = places;
+	answer->error = error;
+
+	answer->timeout_source = g_timeout_source_new ((guint) ((delay + 999) / 1000));
+	g_source_set_callback (answer->timeout_source, delayed_answer_timeout_cb,
+	                       answer, NULL);
+	g_source_attach (answer->timeout_source,
+	                 g_task_get_context (answer->task));
+
+	if (cancellable != NULL) {
+		answer->cancel_source = g_cancellable_source_new (cancellable);
+		g_source_set_callback (answer->cancel_source,
+		                       (GSourceFunc) delayed_answer_cancelled_cb,
+		                       answer, NULL);
+		g_source_attach (answer->cancel_source,
+		                 g_task_get_context (answer->task));
+	}
+}
+
+/******************************************************************************/
+
+static GList *
+geocode_replay_backend_forward_search (GeocodeBackend  *backend,
+                                       GHashTable      *params,
+                                       GCancellable    *cancellable,
+                                       GError         **error)
+{
+	return replay_sync (GEOCODE_REPLAY_BACKEND (backend), TRUE, params,
+	                    cancellable, error);
+}
+
+static void
+geocode_replay_backend_forward_search_async (GeocodeBackend      *backend,
+                                             GHashTable          *params,
+                                             GCancellable        *cancellable,
+                                             GAsyncReadyCallback  callback,
+                                             gpointer             user_data)
+{
+	replay_async (GEOCODE_REPLAY_BACKEND (backend), TRUE,
+	              geocode_replay_backend_forward_search_async,
+	              params, cancellable, callback, user_data);
+}
+
+static GList *
+geocode_replay_backend_forward_search_finish (GeocodeBackend  *backend,
+                                              GAsyncResult    *result,
+                                              GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static GList *
+geocode_replay_backend_reverse_resolve (GeocodeBackend  *backend,
+                                        GHashTable      *params,
+                                        GCancellable    *cancellable,
+                                        GError         **error)
+{
+	return replay_sync (GEOCODE_REPLAY_BACKEND (backend), FALSE, params,
+	                    cancellable, error);
+}
+
+static void
+geocode_replay_backend_reverse_resolve_async (GeocodeBackend      *backend,
+                                              GHashTable          *params,
+                                              GCancellable        *cancellable,
+                                              GAsyncReadyCallback  callback,
+                                              gpointer             user_data)
+{
+	replay_async (GEOCODE_REPLAY_BACKEND (backend), FALSE,
+	              geocode_replay_backend_reverse_resolve_async,
+	              params, cancellable, callback, user_data);
+}
+
+static GList *
+geocode_replay_backend_reverse_resolve_finish (GeocodeBackend  *backend,
+                                               GAsyncResult    *result,
+                                               GError         **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, backend), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/******************************************************************************/
+
+/**
+ * geocode_replay_backend_new:
+ *
+ * Creates a new replay backend with an empty trace, so it returns no
+ * matches for all queries until a trace is loaded.
+ *
+ * Returns: (transfer full): a new #GeocodeReplayBackend. Use
+ * g_object_unref() when done.
+ *
+ * Since: 3.28
+ */
+GeocodeReplayBackend *
+geocode_replay_backend_new (void)
+{
+	return GEOCODE_REPLAY_BACKEND (g_object_new (GEOCODE_TYPE_REPLAY_BACKEND,
+	                                             NULL));
+}
+
+/**
+ * geocode_replay_backend_load_data:
+ * @self: a #GeocodeReplayBackend
+ * @data: contents of a trace written by a #GeocodeRecordingBackend
+ * @length: length of @data in bytes, or -1 if it is nul-terminated
+ * @error: return location for a #GError, or %NULL
+ *
+ * Loads the entries in @data, in addition to any already loaded. Entries
+ * for the same query are returned in the order they are loaded. Blank lines
+ * are ignored.
+ *
+ * If any line of @data is not a valid trace entry, none of the entries in
+ * @data are loaded, and %GEOCODE_ERROR_PARSE or a #JsonParserError is
+ * returned.
+ *
+ * Returns: %TRUE on success, %FALSE otherwise
+ *
+ * Since: 3.28
+ */
+gboolean
+geocode_replay_backend_load_data (GeocodeReplayBackend  *self,
+                                  const char            *data,
+                                  gssize                 length,
+                                  GError               **error)
+{
+	g_autoptr (GPtrArray) parsed = NULL;
+	const char *line, *end;
+	guint line_number, i;
+
+	g_return_val_if_fail (GEOCODE_IS_REPLAY_BACKEND (self), FALSE);
+	g_return_val_if_fail (data != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	if (length < 0)
+		length = strlen (data);
+
+	parsed = g_ptr_array_new_with_free_func ((GDestroyNotify) parsed_entry_free);
+	end = data + length;
+
+	for (line = data, line_number = 1; line < end; line_number++) {
+		const char *line_end = memchr (line, '\n', end - line);
+		const char *p;
+		ParsedEntry *entry;
+
+		if (line_end == NULL)
+			line_end = end;
+
+		for (p = line; p < line_end && g_ascii_isspace (*p); p++);
+
+		if (p < line_end) {
+			entry = parse_entry (line, line_end - line, error);
+			if (entry == NULL) {
+				g_prefix_error (error, "Line %u: ", line_number);
+				return FALSE;
+			}
+
+			g_ptr_array_add (parsed, entry);
+		}
+
+		line = line_end + 1;
+	}
+
+	g_mutex_lock (&self->lock);
+	for (i = 0; i < parsed->len; i++)
+		add_entry_locked (self, parsed->pdata[i]);
+	g_mutex_unlock (&self->lock);
+
+	return TRUE;
+}
+
+/**
+ * geocode_replay_backend_load_file:
+ * @self: a #GeocodeReplayBackend
+ * @path: (type filename): path of a trace file
+ * @error: return location for a #GError, or %NULL
+ *
+ * Loads the entries in the trace file at @path. See
+ * geocode_replay_backend_load_data().
+ *
+ * Returns: %TRUE on success, %FALSE otherwise
+ *
+ * Since: 3.28
+ */
+gboolean
+geocode_replay_backend_load_file (GeocodeReplayBackend  *self,
+                                  const char            *path,
+                                  GError               **error)
+{
+	g_autoptr (GMappedFile) file = NULL;
+
+	g_return_val_if_fail (GEOCODE_IS_REPLAY_BACKEND (self), FALSE);
+	g_return_val_if_fail (path != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	file = g_mapped_file_new (path, FALSE, error);
+	if (file == NULL)
+		return FALSE;
+
+	/* Empty files map to %NULL contents. */
+	return geocode_replay_backend_load_data (self,
+	                                         g_mapped_file_get_contents (file) ?
+	                                         g_mapped_file_get_contents (file) : "",
+	                                         g_mapped_file_get_length (file),
+	                                         error);
+}
+
+/**
+ * geocode_replay_backend_get_n_entries:
+ * @self: a #GeocodeReplayBackend
+ *
+ * Gets the number of trace entries loaded so far.
+ *
+ * Returns: the number of trace entries
+ *
+ * Since: 3.28
+ */
+guint
+geocode_replay_backend_get_n_entries (GeocodeReplayBackend *self)
+{
+	guint n_entries;
+
+	g_return_val_if_fail (GEOCODE_IS_REPLAY_BACKEND (self), 0);
+
+	g_mutex_lock (&self->lock);
+	n_entries = self->entries->len;
+	g_mutex_unlock (&self->lock);
+
+	return n_entries;
+}
+
+/**
+ * geocode_replay_backend_get_entries:
+ * @self: a #GeocodeReplayBackend
+ *
+ * Gets the queries loaded so far, as #GeocodeReplayBackendEntry structures,
+ * in the order they were loaded. This allows a benchmark to send the
+ * recorded queries to the backend at the rate they were recorded at, by
+ * making each one at its @time divided by #GeocodeReplayBackend:speed.
+ *
+ * A #GeocodeRecordingBackend writes each entry when its query is answered,
+ * so the entries of overlapping queries are not necessarily in order of
+ * @time.
+ *
+ * The entries are owned by @self, and stay valid until it is finalized.
+ * Entries loaded after this call are not added to the returned array.
+ *
+ * Returns: (transfer container) (element-type GeocodeReplayBackendEntry):
+ *     potentially empty sequence of loaded queries; free with
+ *     g_ptr_array_unref()
+ *
+ * Since: 3.28
+ */
+GPtrArray *
+geocode_replay_backend_get_entries (GeocodeReplayBackend *self)
+{
+	GPtrArray *entries;
+	guint i;
+
+	g_return_val_if_fail (GEOCODE_IS_REPLAY_BACKEND (self), NULL);
+
+	g_mutex_lock (&self->lock);
+
+	entries = g_ptr_array_sized_new (self->entries->len);
+	for (i = 0; i < self->entries->len; i++)
+		g_ptr_array_add (entries, self->entries->pdata[i]);
+
+	g_mutex_unlock (&self->lock);
+
+	return entries;
+}
+
+/**
+ * geocode_replay_backend_get_speed:
+ * @self: a #GeocodeReplayBackend
+ *
+ * Gets the #GeocodeReplayBackend:speed property.
+ *
+ * Returns: how many times faster than recorded answers are returned, or 0
+ *    if they are returned straight away
+ *
+ * Since: 3.28
+ */
+gdouble
+geocode_replay_backend_get_speed (GeocodeReplayBackend *self)
+{
+	gdouble speed;
+
+	g_return_val_if_fail (GEOCODE_IS_REPLAY_BACKEND (self), DEFAULT_SPEED);
+
+	g_mutex_lock (&self->lock);
+	speed = self->speed;
+	g_mutex_unlock (&self->lock);
+
+	return speed;
+}
+
+/**
+ * geocode_replay_backend_set_speed:
+ * @self: a #GeocodeReplayBackend
+ * @speed: how many times faster than recorded answers are returned, or 0
+ *    to return them straight away
+ *
+ * Sets the #GeocodeReplayBackend:speed property. This may be called while
+ * queries are running, and affects the queries made afterwards.
+ *
+ * Since: 3.28
+ */
+void
+geocode_replay_backend_set_speed (GeocodeReplayBackend *self,
+                                  gdouble               speed)
+{
+	gboolean changed;
+
+	g_return_if_fail (GEOCODE_IS_REPLAY_BACKEND (self));
+	g_return_if_fail (speed >= 0.0);
+
+	g_mutex_lock (&self->lock);
+	changed = (self->speed != speed);
+	self->speed = speed;
+	g_mutex_unlock (&self->lock);
+
+	if (changed)
+		g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_SPEED]);
+}
+
+static void
+geocode_replay_backend_init (GeocodeReplayBackend *self)
+{
+	g_mutex_init (&self->lock);
+	self->forward_entries =
+	    g_hash_table_new_full (_geocode_params_hash, _geocode_params_equal,
+	                           NULL, (GDestroyNotify) entry_free);
+	self->reverse_entries =
+	    g_hash_table_new_full (_geocode_params_hash, _geocode_params_equal,
+	                           NULL, (GDestroyNotify) entry_free);
+	self->entries = g_ptr_array_new_with_free_func ((GDestroyNotify) replay_entry_free);
+	self->speed = DEFAULT_SPEED;
+}
+
+static void
+geocode_replay_backend_get_property (GObject    *object,
+                                     guint       property_id,
+                                     GValue     *value,
+                                     GParamSpec *pspec)
+{
+	GeocodeReplayBackend *self = GEOCODE_REPLAY_BACKEND (object);
+
+	switch ((GeocodeReplayBackendProperty) property_id) {
+	case PROP_SPEED:
+		g_value_set_double (value, geocode_replay_backend_get_speed (self));
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+		break;
+	}
+}
+
+static void
+geocode_replay_backend_set_property (GObject      *object,
+                                     guint         property_id,
+                                     const GValue *value,
+                                     GParamSpec   *pspec)
+{
+	GeocodeReplayBackend *self = GEOCODE_REPLAY_BACKEND (object);
+
+	switch ((GeocodeReplayBackendProperty) property_id) {
+	case PROP_SPEED:
+		geocode_replay_backend_set_speed (self, g_value_get_double (value));
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+		break;
+	}
+}
+
+static void
+geocode_replay_backend_finalize (GObject *object)
+{
+	GeocodeReplayBackend *self = GEOCODE_REPLAY_BACKEND (object);
+
+	g_clear_pointer (&self->forward_entries, g_hash_table_unref);
+	g_clear_pointer (&self->reverse_entries, g_hash_table_unref);
+	g_clear_pointer (&self->entries, g_ptr_array_unref);
+	g_mutex_clear (&self->lock);
+
+	G_OBJECT_CLASS (geocode_replay_backend_parent_class)->finalize (object);
+}
+
+static void
+geocode_backend_iface_init (GeocodeBackendInterface *iface)
+{
+	iface->forward_search = geocode_replay_backend_forward_search;
+	iface->forward_search_async = geocode_replay_backend_forward_search_async;
+	iface->forward_search_finish = geocode_replay_backend_forward_search_finish;
+	iface->reverse_resolve = geocode_replay_backend_reverse_resolve;
+	iface->reverse_resolve_async = geocode_replay_backend_reverse_resolve_async;
+	iface->reverse_resolve_finish = geocode_replay_backend_reverse_resolve_finish;
+}
+
+static void
+geocode_replay_backend_class_init (GeocodeReplayBackendClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->get_property = geocode_replay_backend_get_property;
+	object_class->set_property = geocode_replay_backend_set_property;
+	object_class->finalize = geocode_replay_backend_finalize;
+
+	/**
+	 * GeocodeReplayBackend:speed:
+	 *
+	 * How many times faster than they were recorded answers are returned.
+	 * 1 returns them after their recorded latency, 10 after a tenth of it,
+	 * and 0 straight away.
+	 *
+	 * Since: 3.28
+	 */
+	properties[PROP_SPEED] = g_param_spec_double ("speed",
+	                                              "Speed",
+	                                              "How many times faster than recorded answers are returned",
+	                                              0.0, G_MAXDOUBLE, DEFAULT_SPEED,
+	                                              (G_PARAM_READWRITE |
+	                                               G_PARAM_EXPLICIT_NOTIFY |
+	                                               G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_properties (object_class,
+	                                   G_N_ELEMENTS (properties), properties);
+}
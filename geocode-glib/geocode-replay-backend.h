@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#ifndef GEOCODE_REPLAY_BACKEND_H
+#define GEOCODE_REPLAY_BACKEND_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GeocodeReplayBackend:
+ *
+ * All the fields in the #GeocodeReplayBackend structure are private and
+ * should never be accessed directly.
+ *
+ * Since: 3.28
+ */
+#define GEOCODE_TYPE_REPLAY_BACKEND (geocode_replay_backend_get_type ())
+G_DECLARE_FINAL_TYPE (GeocodeReplayBackend, geocode_replay_backend,
+                      GEOCODE, REPLAY_BACKEND, GObject)
+
+/**
+ * GEOCODE_TYPE_REPLAY_BACKEND:
+ *
+ * See #GeocodeReplayBackend.
+ *
+ * Since: 3.28
+ */
+
+GeocodeReplayBackend *geocode_replay_backend_new (void);
+
+gboolean geocode_replay_backend_load_data (GeocodeReplayBackend  *self,
+                                           const char            *data,
+                                           gssize                 length,
+                                           GError               **error);
+gboolean geocode_replay_backend_load_file (GeocodeReplayBackend  *self,
+                                           const char            *path,
+                                           GError               **error);
+
+guint geocode_replay_backend_get_n_entries (GeocodeReplayBackend *self);
+
+/**
+ * GeocodeReplayBackendEntry:
+ * @params: query parameters, in the format accepted by geocode_forward_search()
+ *     (if @is_forward is %TRUE) or geocode_reverse_resolve() (otherwise)
+ * @is_forward: %TRUE if this represents a call to geocode_forward_search();
+ *     %FALSE if it represents a call to geocode_reverse_resolve()
+ * @time: when the query was made, in microseconds since the
+ *     #GeocodeRecordingBackend which recorded it was created
+ *
+ * A query loaded from a trace into a #GeocodeReplayBackend. See
+ * geocode_replay_backend_get_entries().
+ *
+ * Since: 3.28
+ */
+typedef struct {
+	GHashTable *params;
+	gboolean is_forward;
+	gint64 time;
+} GeocodeReplayBackendEntry;
+
+GPtrArray *geocode_replay_backend_get_entries (GeocodeReplayBackend *self);
+
+gdouble geocode_replay_backend_get_speed (GeocodeReplayBackend *self);
+void    geocode_replay_backend_set_speed (GeocodeReplayBackend *self,
+                                          gdouble               speed);
+
+G_END_DECLS
+
+#endif /* GEOCODE_REPLAY_BACKEND_H */
@@ -45,6 +45,13 @@
 struct _GeocodeReversePrivate {
 	GeocodeLocation *location;
 	GeocodeBackend  *backend;
+	guint            deadline;
+};
+
+enum {
+	PROP_0,
+
+	PROP_DEADLINE
 };
 
 G_DEFINE_TYPE_WITH_CODE (GeocodeReverse, geocode_reverse, G_TYPE_OBJECT,
@@ -64,15 +71,75 @@ geocode_reverse_finalize (GObject *gobject)
 	G_OBJECT_CLASS (geocode_reverse_parent_class)->finalize (gobject);
 }
 
+static void
+geocode_reverse_get_property (GObject    *object,
+                              guint       property_id,
+                              GValue     *value,
+                              GParamSpec *pspec)
+{
+	GeocodeReverse *reverse = GEOCODE_REVERSE (object);
+
+	switch (property_id) {
+	case PROP_DEADLINE:
+		g_value_set_uint (value, geocode_reverse_get_deadline (reverse));
+		break;
+	default:
+		/* We don't have any other property... */
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+		break;
+	}
+}
+
+static void
+geocode_reverse_set_property (GObject      *object,
+                              guint         property_id,
+                              const GValue *value,
+                              GParamSpec   *pspec)
+{
+	GeocodeReverse *reverse = GEOCODE_REVERSE (object);
+
+	switch (property_id) {
+	case PROP_DEADLINE:
+		geocode_reverse_set_deadline (reverse, g_value_get_uint (value));
+		break;
+	default:
+		/* We don't have any other property... */
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+		break;
+	}
+}
+
 static void
 geocode_reverse_class_init (GeocodeReverseClass *klass)
 {
 	GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+	GParamSpec *pspec;
 
 	bindtextdomain (GETTEXT_PACKAGE, GEOCODE_LOCALEDIR);
 	bind_textdomain_codeset (GETTEXT_PACKAGE, "UTF-8");
 
 	gobject_class->finalize = geocode_reverse_finalize;
+	gobject_class->get_property = geocode_reverse_get_property;
+	gobject_class->set_property = geocode_reverse_set_property;
+
+	/**
+	 * GeocodeReverse:deadline:
+	 *
+	 * The time, in milliseconds, a resolution may take before it is
+	 * abandoned and fails with %GEOCODE_ERROR_TIMED_OUT, or 0 for no
+	 * deadline.
+	 *
+	 * Since: 3.28
+	 */
+	pspec = g_param_spec_uint ("deadline",
+	                           "Deadline",
+	                           "Time allowed for a resolution, in milliseconds",
+	                           0,
+	                           G_MAXUINT,
+	                           0,
+	                           G_PARAM_READWRITE |
+	                           G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property (gobject_class, PROP_DEADLINE, pspec);
 }
 
 static void
@@ -104,6 +171,33 @@ geocode_reverse_new_for_location (GeocodeLocation *location)
 	return object;
 }
 
+/**
+ * geocode_reverse_new_for_coordinate:
+ * @coord: a #GeocodeCoordinate with a valid latitude and longitude
+ *
+ * Creates a new #GeocodeReverse to perform reverse geocoding of @coord
+ * with, as geocode_reverse_new_for_location() does for a
+ * #GeocodeLocation.
+ *
+ * Returns: a new #GeocodeReverse. Use g_object_unref() when done.
+ *
+ * Since: 3.28
+ **/
+GeocodeReverse *
+geocode_reverse_new_for_coordinate (const GeocodeCoordinate *coord)
+{
+	GeocodeReverse *object;
+	GeocodeReversePrivate *priv;
+
+	g_return_val_if_fail (coord != NULL, NULL);
+
+	object = g_object_new (GEOCODE_TYPE_REVERSE, NULL);
+	priv = geocode_reverse_get_instance_private (object);
+	priv->location = geocode_location_new_for_coordinate (coord);
+
+	return object;
+}
+
 static void
 ensure_backend (GeocodeReverse *object)
 {
@@ -166,6 +260,7 @@ backend_reverse_resolve_ready (GeocodeBackend *backend,
 
 	/* Extract the first result from the list and return that. */
 	places = geocode_backend_reverse_resolve_finish (backend, res, &error);
+	_geocode_deadline_translate_error (g_task_get_task_data (task), &error);
 	if (places != NULL)
 		g_task_return_pointer (task, g_object_ref (places->data),
 		                       g_object_unref);
@@ -209,6 +304,17 @@ geocode_reverse_resolve_async (GeocodeReverse     *object,
 	params = _geocode_location_to_params (priv->location);
 
 	task = g_task_new (object, cancellable, callback, user_data);
+	if (priv->deadline > 0) {
+		GeocodeDeadline *deadline;
+
+		deadline = _geocode_deadline_new (priv->deadline,
+		                                  cancellable,
+		                                  g_task_get_context (task));
+		g_task_set_task_data (task, deadline,
+		                      (GDestroyNotify) _geocode_deadline_finish);
+		cancellable = _geocode_deadline_get_cancellable (deadline);
+	}
+
 	geocode_backend_reverse_resolve_async (priv->backend,
 	                                       params,
 	                                       cancellable,
@@ -264,6 +370,8 @@ geocode_reverse_resolve (GeocodeReverse *object,
 	GeocodeReversePrivate *priv;
 	GList *places = NULL;  /* (element-type GeocodePlace) */
 	GeocodePlace *place = NULL;
+	GeocodeDeadline *deadline = NULL;
+	GError *local_error = NULL;
 	g_autoptr (GHashTable) params = NULL;
 
 	g_return_val_if_fail (GEOCODE_IS_REVERSE (object), NULL);
@@ -274,10 +382,21 @@ geocode_reverse_resolve (GeocodeReverse *object,
 	g_assert (priv->backend != NULL);
 
 	params = _geocode_location_to_params (priv->location);
+	if (priv->deadline > 0)
+		deadline = _geocode_deadline_new (priv->deadline, NULL, NULL);
+
 	places = geocode_backend_reverse_resolve (priv->backend,
 	                                          params,
-	                                          NULL,
-	                                          error);
+	                                          deadline != NULL ? _geocode_deadline_get_cancellable (deadline) : NULL,
+	                                          &local_error);
+
+	if (deadline != NULL) {
+		_geocode_deadline_translate_error (deadline, &local_error);
+		_geocode_deadline_finish (deadline);
+	}
+
+	if (local_error != NULL)
+		g_propagate_error (error, local_error);
 
 	if (places != NULL)
 		place = g_object_ref (places->data);
@@ -311,3 +430,49 @@ geocode_reverse_set_backend (GeocodeReverse *object,
 
 	g_set_object (&priv->backend, backend);
 }
+
+/**
+ * geocode_reverse_set_deadline:
+ * @object: a #GeocodeReverse representing a query
+ * @deadline: the time allowed for a resolution, in milliseconds, or 0
+ *
+ * Sets the #GeocodeReverse:deadline property. Resolutions which take
+ * longer than @deadline are cancelled and fail with
+ * %GEOCODE_ERROR_TIMED_OUT, so that callers can fall back to another
+ * source of results.
+ *
+ * Since: 3.28
+ */
+void
+geocode_reverse_set_deadline (GeocodeReverse *object,
+                              guint           deadline)
+{
+	GeocodeReversePrivate *priv;
+
+	g_return_if_fail (GEOCODE_IS_REVERSE (object));
+
+	priv = geocode_reverse_get_instance_private (object);
+	priv->deadline = deadline;
+}
+
+/**
+ * geocode_reverse_get_deadline:
+ * @object: a #GeocodeReverse representing a query
+ *
+ * Gets the #GeocodeReverse:deadline property.
+ *
+ * Returns: the time allowed for a resolution, in milliseconds, or 0 if
+ * there is no deadline.
+ *
+ * Since: 3.28
+ */
+guint
+geocode_reverse_get_deadline (GeocodeReverse *object)
+{
+	GeocodeReversePrivate *priv;
+
+	g_return_val_if_fail (GEOCODE_IS_REVERSE (object), 0);
+
+	priv = geocode_reverse_get_instance_private (object);
+	return priv->deadline;
+}
@@ -67,10 +67,15 @@ struct _GeocodeReverseClass {
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (GeocodeReverse, g_object_unref)
 
 GeocodeReverse *geocode_reverse_new_for_location (GeocodeLocation *location);
+GeocodeReverse *geocode_reverse_new_for_coordinate (const GeocodeCoordinate *coord);
 
 void geocode_reverse_set_backend (GeocodeReverse *object,
                                   GeocodeBackend *backend);
 
+guint geocode_reverse_get_deadline (GeocodeReverse *object);
+void geocode_reverse_set_deadline (GeocodeReverse *object,
+                                   guint           deadline);
+
 void geocode_reverse_resolve_async (GeocodeReverse      *object,
 				    GCancellable        *cancellable,
 				    GAsyncReadyCallback  callback,
@@ -0,0 +1,400 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include <string.h>
+
+#include "geocode-glib-private.h"
+#include "geocode-stats.h"
+
+/**
+ * SECTION:geocode-stats
+ * @short_description: Backend instrumentation counters
+ * @include: geocode-glib/geocode-glib.h
+ *
+ * A #GeocodeStats is a snapshot of the counters a backend keeps about the
+ * queries it has handled: how many there were, how many were answered
+ * from the cache, the distribution of HTTP status codes and of network
+ * latencies, the amount of data received and the time spent parsing it.
+ * See geocode_nominatim_get_stats().
+ *
+ * The counters are updated with atomic operations, or under a short lock
+ * for the 64-bit ones, and are cheap enough to leave enabled in
+ * production. A snapshot is taken counter by counter, so it may partially
+ * include queries which complete while it is being taken.
+ *
+ * Since: 3.28
+ */
+
+G_DEFINE_BOXED_TYPE (GeocodeStats, geocode_stats,
+                     geocode_stats_copy, geocode_stats_free)
+
+/* GLib has no 64-bit atomic operations, and pointer-sized ones would wrap
+ * at 4 GiB or about 71 minutes on 32-bit platforms, so the byte and parse
+ * time counters of all the #GeocodeStats are protected by this lock. */
+G_LOCK_DEFINE_STATIC (counters_64);
+
+/* Bucket 0 counts latencies below 1 ms; bucket n, for n > 0, counts
+ * latencies in [2^(n-1), 2^n) ms. The last bucket is open-ended. */
+static guint
+latency_to_bucket (gint64 latency)
+{
+	gint64 latency_ms = latency / 1000;
+
+	if (latency_ms <= 0)
+		return 0;
+
+	return MIN (g_bit_storage ((gulong) latency_ms),
+	            GEOCODE_STATS_N_LATENCY_BUCKETS - 1);
+}
+
+void
+_geocode_stats_record_query (GeocodeStats *stats,
+                             gboolean      cache_hit)
+{
+	g_atomic_int_inc (&stats->requests);
+	if (cache_hit)
+		g_atomic_int_inc (&stats->cache_hits);
+	else
+		g_atomic_int_inc (&stats->cache_misses);
+}
+
+/*
+ * _geocode_stats_record_response:
+ * @stats: live counters
+ * @status: HTTP status of the response, or 0 if none was received
+ * @n_bytes: size of the response body
+ * @latency: time from sending the request to receiving the whole body, in
+ *   microseconds
+ */
+void
+_geocode_stats_record_response (GeocodeStats *stats,
+                                guint         status,
+                                gsize         n_bytes,
+                                gint64        latency)
+{
+	guint status_class = status / 100;
+
+	if (status_class >= G_N_ELEMENTS (stats->status_classes))
+		status_class = 0;
+
+	g_atomic_int_inc (&stats->status_classes[status_class]);
+
+	G_LOCK (counters_64);
+	stats->bytes_received += n_bytes;
+	G_UNLOCK (counters_64);
+
+	g_atomic_int_inc (&stats->latency[latency_to_bucket (latency)]);
+}
+
+void
+_geocode_stats_record_parse (GeocodeStats *stats,
+                             gint64        parse_time)
+{
+	g_atomic_int_inc (&stats->parses);
+
+	G_LOCK (counters_64);
+	stats->parse_time += (guint64) MAX (parse_time, 0);
+	G_UNLOCK (counters_64);
+}
+
+void
+_geocode_stats_snapshot (GeocodeStats *stats,
+                         GeocodeStats *snapshot)
+{
+	guint i;
+
+	snapshot->requests = g_atomic_int_get (&stats->requests);
+	snapshot->cache_hits = g_atomic_int_get (&stats->cache_hits);
+	snapshot->cache_misses = g_atomic_int_get (&stats->cache_misses);
+	for (i = 0; i < G_N_ELEMENTS (stats->status_classes); i++)
+		snapshot->status_classes[i] = g_atomic_int_get (&stats->status_classes[i]);
+	snapshot->parses = g_atomic_int_get (&stats->parses);
+	for (i = 0; i < G_N_ELEMENTS (stats->latency); i++)
+		snapshot->latency[i] = g_atomic_int_get (&stats->latency[i]);
+
+	G_LOCK (counters_64);
+	snapshot->bytes_received = stats->bytes_received;
+	snapshot->parse_time = stats->parse_time;
+	G_UNLOCK (counters_64);
+}
+
+void
+_geocode_stats_reset (GeocodeStats *stats)
+{
+	guint i;
+
+	g_atomic_int_set (&stats->requests, 0);
+	g_atomic_int_set (&stats->cache_hits, 0);
+	g_atomic_int_set (&stats->cache_misses, 0);
+	for (i = 0; i < G_N_ELEMENTS (stats->status_classes); i++)
+		g_atomic_int_set (&stats->status_classes[i], 0);
+	g_atomic_int_set (&stats->parses, 0);
+	for (i = 0; i < G_N_ELEMENTS (stats->latency); i++)
+		g_atomic_int_set (&stats->latency[i], 0);
+
+	G_LOCK (counters_64);
+	stats->bytes_received = 0;
+	stats->parse_time = 0;
+	G_UNLOCK (counters_64);
+}
+
+/**
+ * geocode_stats_copy:
+ * @stats: a #GeocodeStats
+ *
+ * Copies @stats.
+ *
+ * Returns: (transfer full): a copy of @stats. Use geocode_stats_free()
+ * when done.
+ *
+ * Since: 3.28
+ */
+GeocodeStats *
+geocode_stats_copy (const GeocodeStats *stats)
+{
+	GeocodeStats *copy;
+
+	g_return_val_if_fail (stats != NULL, NULL);
+
+	copy = g_new (GeocodeStats, 1);
+	memcpy (copy, stats, sizeof (GeocodeStats));
+
+	return copy;
+}
+
+/**
+ * geocode_stats_free:
+ * @stats: (transfer full): a #GeocodeStats
+ *
+ * Frees @stats.
+ *
+ * Since: 3.28
+ */
+void
+geocode_stats_free (GeocodeStats *stats)
+{
+	g_free (stats);
+}
+
+/**
+ * geocode_stats_get_requests:
+ * @stats: a #GeocodeStats
+ *
+ * Gets the number of queries made on the backend, whether they were
+ * answered from the cache or not.
+ *
+ * Returns: the number of queries.
+ *
+ * Since: 3.28
+ */
+guint
+geocode_stats_get_requests (const GeocodeStats *stats)
+{
+	g_return_val_if_fail (stats != NULL, 0);
+
+	return stats->requests;
+}
+
+/**
+ * geocode_stats_get_cache_hits:
+ * @stats: a #GeocodeStats
+ *
+ * Gets the number of queries which were answered from the cache.
+ *
+ * Returns: the number of cache hits.
+ *
+ * Since: 3.28
+ */
+guint
+geocode_stats_get_cache_hits (const GeocodeStats *stats)
+{
+	g_return_val_if_fail (stats != NULL, 0);
+
+	return stats->cache_hits;
+}
+
+/**
+ * geocode_stats_get_cache_misses:
+ * @stats: a #GeocodeStats
+ *
+ * Gets the number of queries which could not be answered from the cache,
+ * and hence went to the network.
+ *
+ * Returns: the number of cache misses.
+ *
+ * Since: 3.28
+ */
+guint
+geocode_stats_get_cache_misses (const GeocodeStats *stats)
+{
+	g_return_val_if_fail (stats != NULL, 0);
+
+	return stats->cache_misses;
+}
+
+/**
+ * geocode_stats_get_status_count:
+ * @stats: a #GeocodeStats
+ * @status_class: the first digit of an HTTP status code, from 1 to 5, or 0
+ *
+ * Gets the number of network requests whose HTTP status code was in the
+ * given class; for example, a @status_class of 5 counts all server errors.
+ * A @status_class of 0 counts the requests which failed without an HTTP
+ * response, for example because they were cancelled, timed out or could
+ * not connect.
+ *
+ * Returns: the number of requests with a status in @status_class.
+ *
+ * Since: 3.28
+ */
+guint
+geocode_stats_get_status_count (const GeocodeStats *stats,
+                                guint               status_class)
+{
+	g_return_val_if_fail (stats != NULL, 0);
+	g_return_val_if_fail (status_class < G_N_ELEMENTS (stats->status_classes), 0);
+
+	return stats->status_classes[status_class];
+}
+
+/**
+ * geocode_stats_get_bytes_received:
+ * @stats: a #GeocodeStats
+ *
+ * Gets the total size of the response bodies received from the network.
+ *
+ * Returns: the number of bytes received.
+ *
+ * Since: 3.28
+ */
+guint64
+geocode_stats_get_bytes_received (const GeocodeStats *stats)
+{
+	g_return_val_if_fail (stats != NULL, 0);
+
+	return stats->bytes_received;
+}
+
+/**
+ * geocode_stats_get_parses:
+ * @stats: a #GeocodeStats
+ *
+ * Gets the number of responses which were parsed, whether they came from
+ * the cache or from the network.
+ *
+ * Returns: the number of parsed responses.
+ *
+ * Since: 3.28
+ */
+guint
+geocode_stats_get_parses (const GeocodeStats *stats)
+{
+	g_return_val_if_fail (stats != NULL, 0);
+
+	return stats->parses;
+}
+
+/**
+ * geocode_stats_get_parse_time:
+ * @stats: a #GeocodeStats
+ *
+ * Gets the total time spent parsing responses.
+ *
+ * Returns: the parse time, in microseconds.
+ *
+ * Since: 3.28
+ */
+guint64
+geocode_stats_get_parse_time (const GeocodeStats *stats)
+{
+	g_return_val_if_fail (stats != NULL, 0);
+
+	return stats->parse_time;
+}
+
+/**
+ * geocode_stats_get_n_latency_buckets:
+ * @stats: a #GeocodeStats
+ *
+ * Gets the number of buckets in the network latency histogram. See
+ * geocode_stats_get_latency_count().
+ *
+ * Returns: the number of latency buckets.
+ *
+ * Since: 3.28
+ */
+guint
+geocode_stats_get_n_latency_buckets (const GeocodeStats *stats)
+{
+	g_return_val_if_fail (stats != NULL, 0);
+
+	return G_N_ELEMENTS (stats->latency);
+}
+
+/**
+ * geocode_stats_get_latency_count:
+ * @stats: a #GeocodeStats
+ * @bucket: index of a latency bucket
+ *
+ * Gets the number of network requests which completed within the latency
+ * range of @bucket. The buckets grow exponentially: bucket 0 holds the
+ * requests which took less than a millisecond, and each following bucket
+ * holds the requests which took up to twice as long as the previous one
+ * allowed; see geocode_stats_get_latency_bucket_limit(). The last bucket
+ * holds all the slower requests.
+ *
+ * Returns: the number of requests in @bucket.
+ *
+ * Since: 3.28
+ */
+guint
+geocode_stats_get_latency_count (const GeocodeStats *stats,
+                                 guint               bucket)
+{
+	g_return_val_if_fail (stats != NULL, 0);
+	g_return_val_if_fail (bucket < G_N_ELEMENTS (stats->latency), 0);
+
+	return stats->latency[bucket];
+}
+
+/**
+ * geocode_stats_get_latency_bucket_limit:
+ * @stats: a #GeocodeStats
+ * @bucket: index of a latency bucket
+ *
+ * Gets the exclusive upper limit of the latency range of @bucket.
+ *
+ * Returns: the upper limit of @bucket, in microseconds, or %G_MAXUINT64
+ * for the last bucket.
+ *
+ * Since: 3.28
+ */
+guint64
+geocode_stats_get_latency_bucket_limit (const GeocodeStats *stats,
+                                        guint               bucket)
+{
+	g_return_val_if_fail (stats != NULL, 0);
+	g_return_val_if_fail (bucket < G_N_ELEMENTS (stats->latency), 0);
+
+	if (bucket == G_N_ELEMENTS (stats->latency) - 1)
+		return G_MAXUINT64;
+
+	return (G_GUINT64_CONSTANT (1) << bucket) * 1000;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#ifndef GEOCODE_STATS_H
+#define GEOCODE_STATS_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GeocodeStats:
+ *
+ * A snapshot of the instrumentation counters of a backend. All the fields
+ * in the #GeocodeStats structure are private and should never be accessed
+ * directly.
+ *
+ * Since: 3.28
+ */
+typedef struct _GeocodeStats GeocodeStats;
+
+#define GEOCODE_TYPE_STATS (geocode_stats_get_type ())
+
+GType geocode_stats_get_type (void) G_GNUC_CONST;
+
+GeocodeStats *geocode_stats_copy (const GeocodeStats *stats);
+void geocode_stats_free (GeocodeStats *stats);
+
+guint geocode_stats_get_requests (const GeocodeStats *stats);
+guint geocode_stats_get_cache_hits (const GeocodeStats *stats);
+guint geocode_stats_get_cache_misses (const GeocodeStats *stats);
+guint geocode_stats_get_status_count (const GeocodeStats *stats,
+                                      guint               status_class);
+guint64 geocode_stats_get_bytes_received (const GeocodeStats *stats);
+guint geocode_stats_get_parses (const GeocodeStats *stats);
+guint64 geocode_stats_get_parse_time (const GeocodeStats *stats);
+
+guint geocode_stats_get_n_latency_buckets (const GeocodeStats *stats);
+guint geocode_stats_get_latency_count (const GeocodeStats *stats,
+                                       guint               bucket);
+guint64 geocode_stats_get_latency_bucket_limit (const GeocodeStats *stats,
+                                                guint               bucket);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GeocodeStats, geocode_stats_free)
+
+G_END_DECLS
+
+#endif /* GEOCODE_STATS_H */
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#ifndef GEOCODE_TRACE_PRIVATE_H
+#define GEOCODE_TRACE_PRIVATE_H
+
+#include "config.h"
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Trace marks for profiling with Sysprof, enabled with the `sysprof` meson
+ * option. Each mark covers one stage of a query:
+ *
+ * |[<!-- language="C" -->
+ * GEOCODE_TRACE_BEGIN (trace_begin);
+ * uri = get_search_uri_for_params (self, params, error);
+ * GEOCODE_TRACE_MARK (trace_begin, "build-uri", "%s", uri);
+ * ]|
+ *
+ * For stages which span asynchronous callbacks, store the start time in a
+ * field declared under `#ifdef HAVE_SYSPROF` with GEOCODE_TRACE_RESTART().
+ *
+ * When tracing is disabled, all of these expand to nothing, and their
+ * arguments are not evaluated.
+ */
+#ifdef HAVE_SYSPROF
+#include <sysprof-capture.h>
+
+#define GEOCODE_TRACE_BEGIN(begin_time) \
+	gint64 begin_time = SYSPROF_CAPTURE_CURRENT_TIME
+#define GEOCODE_TRACE_RESTART(begin_time) \
+	(begin_time) = SYSPROF_CAPTURE_CURRENT_TIME
+#define GEOCODE_TRACE_MARK(begin_time, name, ...) \
+	sysprof_collector_mark_printf ((begin_time), \
+	                               SYSPROF_CAPTURE_CURRENT_TIME - (begin_time), \
+	                               "geocode-glib", (name), __VA_ARGS__)
+#else
+#define GEOCODE_TRACE_BEGIN(begin_time) G_STMT_START { } G_STMT_END
+#define GEOCODE_TRACE_RESTART(begin_time) G_STMT_START { } G_STMT_END
+#define GEOCODE_TRACE_MARK(begin_time, name, ...) G_STMT_START { } G_STMT_END
+#endif
+
+G_END_DECLS
+
+#endif /* GEOCODE_TRACE_PRIVATE_H */
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#ifndef BACKEND_TEST_UTILS_H
+#define BACKEND_TEST_UTILS_H
+
+#include <geocode-glib/geocode-glib.h>
+#include <gio/gio.h>
+#include <glib.h>
+
+/* Helpers shared by the tests of the #GeocodeBackend implementations. */
+
+static inline void
+place_list_free (GList *l)
+{
+	g_list_free_full (l, g_object_unref);
+}
+
+typedef GList PlaceList;
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (PlaceList, place_list_free)
+
+static inline void
+value_free (GValue *value)
+{
+	g_value_unset (value);
+	g_free (value);
+}
+
+/* Returns the params of a forward query for the static string @location,
+ * as geocode_forward_new_for_string() would build them. */
+static inline GHashTable *
+build_location_params (const char *location)
+{
+	GHashTable *params;
+	GValue *value;
+
+	params = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+	                                (GDestroyNotify) value_free);
+
+	value = g_new0 (GValue, 1);
+	g_value_init (value, G_TYPE_STRING);
+	g_value_set_static_string (value, location);
+	g_hash_table_insert (params, (gpointer) "location", value);
+
+	return params;
+}
+
+/* Stores the result of an asynchronous call in the #GAsyncResult pointed to
+ * by @user_data, for the test to iterate the main context until it is set. */
+static inline void
+async_result_cb (GObject      *source_object,
+                 GAsyncResult *res,
+                 gpointer      user_data)
+{
+	GAsyncResult **result_out = user_data;
+
+	*result_out = g_object_ref (res);
+}
+
+#endif /* BACKEND_TEST_UTILS_H */
@@ -0,0 +1,313 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+/*
+ * Micro-benchmarks for response parsing and geo URI handling.
+ *
+ * Each benchmark is run repeatedly until --min-time has elapsed, and its
+ * result is printed to stdout as one JSON object per line, e.g.:
+ *
+ *   {"benchmark":"parse-search-json","input":"search.json","iterations":4096,
+ *    "ns-per-op":51234.5,"ops-per-sec":19517.8,"allocs-per-op":1234.0,
+ *    "bytes-per-op":45678.0}
+ *
+ * Allocation counts are only available on glibc, where malloc() is wrapped
+ * below; elsewhere they are reported as null.
+ */
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <geocode-glib/geocode-glib.h>
+#include <geocode-glib/geocode-glib-private.h>
+#include "geo-uri-cases.h"
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define COUNT_ALLOCATIONS 1
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t n_members, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+static gsize n_allocs = 0;
+static gsize n_alloc_bytes = 0;
+
+void *
+malloc (size_t size)
+{
+	n_allocs++;
+	n_alloc_bytes += size;
+	return __libc_malloc (size);
+}
+
+void *
+calloc (size_t n_members, size_t size)
+{
+	n_allocs++;
+	n_alloc_bytes += n_members * size;
+	return __libc_calloc (n_members, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+	n_allocs++;
+	n_alloc_bytes += size;
+	return __libc_realloc (ptr, size);
+}
+#endif
+
+typedef void (*BenchmarkFunc) (gconstpointer data);
+
+static gdouble min_time = 0.5;
+static gchar *filter = NULL;
+
+static void
+run_benchmark (const char    *name,
+               const char    *input,
+               BenchmarkFunc  func,
+               gconstpointer  data)
+{
+	guint64 iterations = 0;
+	guint64 batch = 1;
+	guint64 i;
+	gint64 start, elapsed;
+	gdouble ns_per_op;
+#ifdef COUNT_ALLOCATIONS
+	gsize allocs, alloc_bytes;
+#endif
+
+	if (filter != NULL && strstr (name, filter) == NULL)
+		return;
+
+	/* Warm up caches, interned strings and lazily-initialised types */
+	func (data);
+
+#ifdef COUNT_ALLOCATIONS
+	allocs = n_allocs;
+	alloc_bytes = n_alloc_bytes;
+#endif
+	start = g_get_monotonic_time ();
+	do {
+		for (i = 0; i < batch; i++)
+			func (data);
+		iterations += batch;
+		batch *= 2;
+		elapsed = g_get_monotonic_time () - start;
+	} while (elapsed < min_time * G_USEC_PER_SEC);
+
+	ns_per_op = (gdouble) MAX (elapsed, 1) * 1000.0 / iterations;
+
+	printf ("{\"benchmark\":\"%s\",\"input\":\"%s\","
+	        "\"iterations\":%" G_GUINT64_FORMAT ","
+	        "\"ns-per-op\":%.1f,\"ops-per-sec\":%.1f,",
+	        name, input, iterations,
+	        ns_per_op, 1e9 / ns_per_op);
+#ifdef COUNT_ALLOCATIONS
+	printf ("\"allocs-per-op\":%.1f,\"bytes-per-op\":%.1f}\n",
+	        (gdouble) (n_allocs - allocs) / iterations,
+	        (gdouble) (n_alloc_bytes - alloc_bytes) / iterations);
+#else
+	printf ("\"allocs-per-op\":null,\"bytes-per-op\":null}\n");
+#endif
+	fflush (stdout);
+}
+
+static char *
+load_fixture (const char *fname)
+{
+	const char *srcdir;
+	g_autofree char *path = NULL;
+	char *contents;
+	GError *error = NULL;
+
+	srcdir = g_getenv ("G_TEST_SRCDIR");
+	path = g_build_filename (srcdir ? srcdir : ".", fname, NULL);
+	if (!g_file_get_contents (path, &contents, NULL, &error))
+		g_error ("Couldn't load contents of '%s': %s", path, error->message);
+
+	return contents;
+}
+
+static void
+bench_parse_search_json (gconstpointer data)
+{
+	GList *list;
+	GError *error = NULL;
+
+	list = _geocode_parse_search_json (data, &error);
+	g_list_free_full (list, g_object_unref);
+	g_clear_error (&error);
+}
+
+static void
+bench_parse_resolve_json (gconstpointer data)
+{
+	GeocodeResultSet *set;
+	GError *error = NULL;
+
+	set = _geocode_result_set_new ();
+	_geocode_parse_resolve_json (data, set, &error);
+	_geocode_result_set_free (set);
+	g_clear_error (&error);
+}
+
+static void
+bench_set_from_uri (gconstpointer data)
+{
+	static GeocodeLocation *loc = NULL;
+	guint i;
+
+	if (loc == NULL)
+		loc = geocode_location_new (0, 0, 0);
+
+	for (i = 0; i < G_N_ELEMENTS (uris); i++) {
+		GError *error = NULL;
+
+		if (uris[i].valid != GPOINTER_TO_INT (data))
+			continue;
+
+		if (geocode_location_set_from_uri (loc, uris[i].uri, &error) != uris[i].valid)
+			g_error ("Unexpected result parsing '%s'", uris[i].uri);
+		g_clear_error (&error);
+	}
+}
+
+static void
+bench_to_uri (gconstpointer data)
+{
+	GPtrArray *locations = (GPtrArray *) data;
+	guint i;
+
+	for (i = 0; i < locations->len; i++) {
+		char *uri;
+
+		uri = geocode_location_to_uri (g_ptr_array_index (locations, i),
+		                               GEOCODE_LOCATION_URI_SCHEME_GEO);
+		g_free (uri);
+	}
+}
+
+static void
+bench_geo_uri_append (gconstpointer data)
+{
+	GPtrArray *locations = (GPtrArray *) data;
+	static GString *string = NULL;
+	guint i;
+
+	if (string == NULL)
+		string = g_string_sized_new (GEOCODE_GEO_URI_BUFFER_SIZE);
+
+	for (i = 0; i < locations->len; i++) {
+		GeocodeLocation *loc = g_ptr_array_index (locations, i);
+
+		g_string_truncate (string, 0);
+		geocode_geo_uri_append (string,
+		                        geocode_location_get_latitude (loc),
+		                        geocode_location_get_longitude (loc),
+		                        geocode_location_get_altitude (loc),
+		                        geocode_location_get_accuracy (loc));
+	}
+}
+
+static const char *search_fixtures[] = {
+	"search.json",
+	"search_lat_long.json",
+	"nominatim-rio.json",
+	"nominatim-data-type-change.json",
+	"nominatim-place_rank.json",
+	"locale_name.json",
+	"osm_type1.json",
+};
+
+static const char *resolve_fixtures[] = {
+	"rev.json",
+	"rev_fail.json",
+};
+
+int
+main (int argc, char **argv)
+{
+	GOptionContext *context;
+	GError *error = NULL;
+	g_autoptr(GPtrArray) locations = NULL;
+	guint i;
+	const GOptionEntry entries[] = {
+		{ "min-time", 't', 0, G_OPTION_ARG_DOUBLE, &min_time,
+		  "Minimum time to run each benchmark for, in seconds", "SECONDS" },
+		{ "filter", 'f', 0, G_OPTION_ARG_STRING, &filter,
+		  "Only run benchmarks whose name contains FILTER", "FILTER" },
+		{ NULL }
+	};
+
+	setlocale (LC_ALL, "");
+
+	context = g_option_context_new ("- benchmark geocode-glib parsing");
+	g_option_context_add_main_entries (context, entries, NULL);
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_printerr ("%s\n", error->message);
+		return 1;
+	}
+	g_option_context_free (context);
+
+	/* Keep the JSON output machine-readable whatever the locale */
+	setlocale (LC_NUMERIC, "C");
+
+	for (i = 0; i < G_N_ELEMENTS (search_fixtures); i++) {
+		g_autofree char *contents = load_fixture (search_fixtures[i]);
+
+		run_benchmark ("parse-search-json", search_fixtures[i],
+		               bench_parse_search_json, contents);
+	}
+
+	for (i = 0; i < G_N_ELEMENTS (resolve_fixtures); i++) {
+		g_autofree char *contents = load_fixture (resolve_fixtures[i]);
+
+		run_benchmark ("parse-resolve-json", resolve_fixtures[i],
+		               bench_parse_resolve_json, contents);
+	}
+
+	run_benchmark ("location-set-from-uri", "geo-uri-cases.h:valid",
+	               bench_set_from_uri, GINT_TO_POINTER (TRUE));
+	run_benchmark ("location-set-from-uri", "geo-uri-cases.h:invalid",
+	               bench_set_from_uri, GINT_TO_POINTER (FALSE));
+
+	locations = g_ptr_array_new_with_free_func (g_object_unref);
+	for (i = 0; i < G_N_ELEMENTS (uris); i++) {
+		GeocodeLocation *loc;
+
+		if (!uris[i].valid)
+			continue;
+
+		loc = geocode_location_new (0, 0, 0);
+		geocode_location_set_from_uri (loc, uris[i].uri, NULL);
+		g_ptr_array_add (locations, loc);
+	}
+	run_benchmark ("location-to-uri", "geo-uri-cases.h:valid",
+	               bench_to_uri, locations);
+	run_benchmark ("geo-uri-append", "geo-uri-cases.h:valid",
+	               bench_geo_uri_append, locations);
+
+	g_free (filter);
+
+	return 0;
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include "config.h"
+
+#include <geocode-glib/geocode-glib.h>
+#include <gio/gio.h>
+#include <glib.h>
+#include <locale.h>
+
+#include "backend-test-utils.h"
+
+
+/* A country in two parts, containing a state, containing a town with a
+ * hole in it. The features without a name or a polygon are skipped. */
+static const char *boundaries_json =
+	"{"
+	"  \"type\": \"FeatureCollection\","
+	"  \"features\": ["
+	"    {"
+	"      \"type\": \"Feature\","
+	"      \"properties\": { \"name\": \"Testland\", \"admin_level\": 2,"
+	"                        \"country_code\": \"tl\", \"osm_id\": 1,"
+	"                        \"osm_type\": \"relation\" },"
+	"      \"geometry\": {"
+	"        \"type\": \"MultiPolygon\","
+	"        \"coordinates\": ["
+	"          [ [ [0, 40], [10, 40], [10, 50], [0, 50], [0, 40] ] ],"
+	"          [ [ [20, 40], [21, 40], [21, 41], [20, 41], [20, 40] ] ]"
+	"        ]"
+	"      }"
+	"    },"
+	"    {"
+	"      \"type\": \"Feature\","
+	"      \"properties\": { \"name\": \"North\", \"admin_level\": \"4\","
+	"                        \"place_type\": \"state\" },"
+	"      \"geometry\": {"
+	"        \"type\": \"Polygon\","
+	"        \"coordinates\": ["
+	"          [ [0, 45], [10, 45], [10, 50], [0, 50], [0, 45] ]"
+	"        ]"
+	"      }"
+	"    },"
+	"    {"
+	"      \"type\": \"Feature\","
+	"      \"properties\": { \"name\": \"Holeton\", \"place_type\": \"town\" },"
+	"      \"geometry\": {"
+	"        \"type\": \"Polygon\","
+	"        \"coordinates\": ["
+	"          [ [2, 46], [4, 46], [4, 48], [2, 48], [2, 46] ],"
+	"          [ [2.5, 46.5], [3.5, 46.5], [3.5, 47.5], [2.5, 47.5], [2.5, 46.5] ]"
+	"        ]"
+	"      }"
+	"    },"
+	"    {"
+	"      \"type\": \"Feature\","
+	"      \"properties\": { \"name\": \"A Road\" },"
+	"      \"geometry\": {"
+	"        \"type\": \"LineString\","
+	"        \"coordinates\": [ [0, 40], [10, 50] ]"
+	"      }"
+	"    },"
+	"    {"
+	"      \"type\": \"Feature\","
+	"      \"properties\": { },"
+	"      \"geometry\": {"
+	"        \"type\": \"Polygon\","
+	"        \"coordinates\": [ [ [0, 40], [1, 40], [1, 41], [0, 40] ] ]"
+	"      }"
+	"    }"
+	"  ]"
+	"}";
+
+static GeocodeBoundaryBackend *
+create_backend (void)
+{
+	g_autoptr (GeocodeBoundaryBackend) backend = NULL;
+	g_autoptr (GError) error = NULL;
+
+	backend = geocode_boundary_backend_new ();
+	geocode_boundary_backend_load_data (backend, boundaries_json, -1, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (geocode_boundary_backend_get_n_boundaries (backend), ==, 3);
+
+	return g_steal_pointer (&backend);
+}
+
+static GHashTable *
+build_reverse_params (gdouble latitude,
+                      gdouble longitude)
+{
+	GHashTable *params;
+	GValue *value;
+
+	params = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+	                                (GDestroyNotify) g_free);
+
+	value = g_new0 (GValue, 1);
+	g_value_init (value, G_TYPE_DOUBLE);
+	g_value_set_double (value, latitude);
+	g_hash_table_insert (params, (gpointer) "lat", value);
+
+	value = g_new0 (GValue, 1);
+	g_value_init (value, G_TYPE_DOUBLE);
+	g_value_set_double (value, longitude);
+	g_hash_table_insert (params, (gpointer) "lon", value);
+
+	return params;
+}
+
+/* Test that the places are returned most specific first, and that their
+ * address fields are filled in from the boundaries containing them. */
+static void
+test_reverse (void)
+{
+	g_autoptr (GeocodeBoundaryBackend) backend = create_backend ();
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+	GeocodePlace *town, *state, *country;
+
+	params = build_reverse_params (47.8, 3.0);
+	places = geocode_backend_reverse_resolve (GEOCODE_BACKEND (backend),
+	                                          params, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (places), ==, 3);
+
+	town = places->data;
+	state = places->next->data;
+	country = places->next->next->data;
+
+	g_assert_cmpstr (geocode_place_get_name (town), ==, "Holeton");
+	g_assert_cmpint (geocode_place_get_place_type (town), ==, GEOCODE_PLACE_TYPE_TOWN);
+	g_assert_cmpstr (geocode_place_get_town (town), ==, "Holeton");
+	g_assert_cmpstr (geocode_place_get_state (town), ==, "North");
+	g_assert_cmpstr (geocode_place_get_country (town), ==, "Testland");
+	g_assert_cmpstr (geocode_place_get_country_code (town), ==, "tl");
+
+	g_assert_cmpstr (geocode_place_get_name (state), ==, "North");
+	g_assert_cmpint (geocode_place_get_place_type (state), ==, GEOCODE_PLACE_TYPE_STATE);
+	g_assert_null (geocode_place_get_town (state));
+	g_assert_cmpstr (geocode_place_get_country (state), ==, "Testland");
+
+	g_assert_cmpstr (geocode_place_get_name (country), ==, "Testland");
+	g_assert_cmpint (geocode_place_get_place_type (country), ==, GEOCODE_PLACE_TYPE_COUNTRY);
+	g_assert_cmpstr (geocode_place_get_osm_id (country), ==, "1");
+	g_assert_cmpint (geocode_place_get_osm_type (country), ==, GEOCODE_PLACE_OSM_TYPE_RELATION);
+	g_assert_null (geocode_place_get_state (country));
+
+	/* The location is the centroid of the largest part, and the bounding
+	 * box covers all the parts. */
+	g_assert_cmpfloat_with_epsilon (geocode_location_get_latitude (geocode_place_get_location (country)), 45.0, 0.000001);
+	g_assert_cmpfloat_with_epsilon (geocode_location_get_longitude (geocode_place_get_location (country)), 5.0, 0.000001);
+	g_assert_cmpfloat (geocode_bounding_box_get_right (geocode_place_get_bounding_box (country)), ==, 21.0);
+}
+
+static void
+test_reverse_hole (void)
+{
+	g_autoptr (GeocodeBoundaryBackend) backend = create_backend ();
+	struct {
+		gdouble latitude, longitude;
+		const char *expected_name;
+		guint expected_n_places;
+	} queries[] = {
+		{ 47.0, 3.0, "North", 2 },
+		{ 46.2, 3.0, "Holeton", 3 },
+		{ 42.0, 5.0, "Testland", 1 },
+		{ 40.5, 20.5, "Testland", 1 },
+	};
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (queries); i++) {
+		g_autoptr (GHashTable) params = NULL;
+		g_autoptr (PlaceList) places = NULL;
+		g_autoptr (GError) error = NULL;
+
+		params = build_reverse_params (queries[i].latitude,
+		                               queries[i].longitude);
+		places = geocode_backend_reverse_resolve (GEOCODE_BACKEND (backend),
+		                                          params, NULL, &error);
+		g_assert_no_error (error);
+		g_assert_cmpuint (g_list_length (places), ==,
+		                  queries[i].expected_n_places);
+		g_assert_cmpstr (geocode_place_get_name (places->data), ==,
+		                 queries[i].expected_name);
+	}
+}
+
+static void
+test_reverse_no_matches (void)
+{
+	g_autoptr (GeocodeBoundaryBackend) backend = create_backend ();
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	params = build_reverse_params (20.0, 5.0);
+	places = geocode_backend_reverse_resolve (GEOCODE_BACKEND (backend),
+	                                          params, NULL, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED);
+	g_assert_null (places);
+}
+
+static void
+test_reverse_async (void)
+{
+	g_autoptr (GeocodeBoundaryBackend) backend = create_backend ();
+	g_autoptr (GeocodeLocation) location = NULL;
+	g_autoptr (GeocodeReverse) reverse = NULL;
+	g_autoptr (GeocodePlace) place = NULL;
+	g_autoptr (GAsyncResult) result = NULL;
+	g_autoptr (GError) error = NULL;
+
+	location = geocode_location_new (47.8, 3.0, GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+	reverse = geocode_reverse_new_for_location (location);
+	geocode_reverse_set_backend (reverse, GEOCODE_BACKEND (backend));
+
+	geocode_reverse_resolve_async (reverse, NULL, async_result_cb, &result);
+
+	while (result == NULL)
+		g_main_context_iteration (NULL, TRUE);
+
+	place = geocode_reverse_resolve_finish (reverse, result, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (place), ==, "Holeton");
+	g_assert_cmpstr (geocode_place_get_country (place), ==, "Testland");
+}
+
+static void
+test_forward (void)
+{
+	g_autoptr (GeocodeBoundaryBackend) backend = create_backend ();
+	g_autoptr (GeocodeForward) forward = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	forward = geocode_forward_new_for_string ("Holeton");
+	geocode_forward_set_backend (forward, GEOCODE_BACKEND (backend));
+
+	places = geocode_forward_search (forward, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED);
+	g_assert_null (places);
+}
+
+/* Test that invalid data is rejected without loading any of it. */
+static void
+test_invalid_data (void)
+{
+	g_autoptr (GeocodeBoundaryBackend) backend = create_backend ();
+	g_autoptr (GError) error = NULL;
+
+	geocode_boundary_backend_load_data (backend, "not json", -1, &error);
+	g_assert_nonnull (error);
+	g_clear_error (&error);
+
+	geocode_boundary_backend_load_data (backend,
+	                                    "{ \"type\": \"FeatureCollection\", \"features\": ["
+	                                    "  { \"type\": \"Feature\","
+	                                    "    \"properties\": { \"name\": \"Good\" },"
+	                                    "    \"geometry\": { \"type\": \"Polygon\","
+	                                    "      \"coordinates\": [ [ [0, 0], [1, 0], [1, 1], [0, 0] ] ] } },"
+	                                    "  { \"type\": \"Feature\","
+	                                    "    \"properties\": { \"name\": \"Bad\" },"
+	                                    "    \"geometry\": { \"type\": \"Polygon\","
+	                                    "      \"coordinates\": [ [ [0, 0], [\"x\", 0], [1, 1] ] ] } } ] }",
+	                                    -1, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE);
+	g_assert_cmpuint (geocode_boundary_backend_get_n_boundaries (backend), ==, 3);
+	g_clear_error (&error);
+
+	geocode_boundary_backend_load_file (backend, "/nonexistent/boundaries.geojson", &error);
+	g_assert_error (error, G_FILE_ERROR, G_FILE_ERROR_NOENT);
+}
+
+int
+main (int argc, char **argv)
+{
+	setlocale (LC_ALL, "");
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add_func ("/boundary-backend/reverse", test_reverse);
+	g_test_add_func ("/boundary-backend/reverse/hole", test_reverse_hole);
+	g_test_add_func ("/boundary-backend/reverse/no-matches", test_reverse_no_matches);
+	g_test_add_func ("/boundary-backend/reverse/async", test_reverse_async);
+	g_test_add_func ("/boundary-backend/forward", test_forward);
+	g_test_add_func ("/boundary-backend/invalid-data", test_invalid_data);
+
+	return g_test_run ();
+}
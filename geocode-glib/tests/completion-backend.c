@@ -0,0 +1,259 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include "config.h"
+
+#include <geocode-glib/geocode-glib.h>
+#include <gio/gio.h>
+#include <glib.h>
+#include <locale.h>
+
+#include "backend-test-utils.h"
+
+static GeocodeCompletionBackend *
+create_backend (GeocodeBackend *fallback)
+{
+	g_autoptr (GeocodeCompletionBackend) backend = NULL;
+	struct {
+		const char *name;
+		gdouble importance;
+	} places[] = {
+		{ "Parisot", 0.3 },
+		{ "Paris", 0.9 },
+		{ "Parma", 0.6 },
+		{ "London", 0.8 },
+		{ "Pärnu", 0.4 },
+		{ "Paris", 0.5 },
+	};
+	guint i;
+
+	backend = geocode_completion_backend_new (fallback);
+
+	for (i = 0; i < G_N_ELEMENTS (places); i++) {
+		g_autoptr (GeocodePlace) place = NULL;
+
+		place = geocode_place_new (places[i].name, GEOCODE_PLACE_TYPE_TOWN);
+		geocode_completion_backend_add_place (backend, place,
+		                                      places[i].importance);
+	}
+
+	g_assert_cmpuint (geocode_completion_backend_get_n_places (backend), ==,
+	                  G_N_ELEMENTS (places));
+
+	return g_steal_pointer (&backend);
+}
+
+static void
+assert_names (GList       *places,
+              const char **expected_names)
+{
+	GList *l;
+	guint i;
+
+	for (l = places, i = 0; l != NULL; l = l->next, i++)
+		g_assert_cmpstr (geocode_place_get_name (l->data), ==,
+		                 expected_names[i]);
+
+	g_assert_null (expected_names[i]);
+}
+
+/* Test that completions are ordered by importance, and limited. */
+static void
+test_complete (void)
+{
+	g_autoptr (GeocodeCompletionBackend) backend = create_backend (NULL);
+	struct {
+		const char *prefix;
+		guint n_results;
+		const char *expected_names[6];
+	} queries[] = {
+		{ "par", 10, { "Paris", "Parma", "Paris", "Parisot", NULL } },
+		{ "PAR", 2, { "Paris", "Parma", NULL } },
+		{ "  Pari ", 10, { "Paris", "Paris", "Parisot", NULL } },
+		{ "pä", 10, { "Pärnu", NULL } },
+		{ "", 3, { "Paris", "London", "Parma", NULL } },
+		{ "parisots", 10, { NULL } },
+		{ "x", 10, { NULL } },
+	};
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (queries); i++) {
+		g_autoptr (PlaceList) places = NULL;
+
+		places = geocode_completion_backend_complete (backend,
+		                                              queries[i].prefix,
+		                                              queries[i].n_results);
+		assert_names (places, queries[i].expected_names);
+	}
+}
+
+/* Test that places added after a query are found by the next one. */
+static void
+test_complete_add (void)
+{
+	g_autoptr (GeocodeCompletionBackend) backend = create_backend (NULL);
+	g_autoptr (GeocodePlace) place = NULL;
+	g_autoptr (PlaceList) before = NULL;
+	g_autoptr (PlaceList) after = NULL;
+
+	before = geocode_completion_backend_complete (backend, "pa", 1);
+	g_assert_cmpstr (geocode_place_get_name (before->data), ==, "Paris");
+
+	place = geocode_place_new ("Padua", GEOCODE_PLACE_TYPE_TOWN);
+	geocode_completion_backend_add_place (backend, place, 1.0);
+
+	after = geocode_completion_backend_complete (backend, "pa", 1);
+	g_assert_true (after->data == place);
+}
+
+static void
+test_forward (void)
+{
+	g_autoptr (GeocodeCompletionBackend) backend = create_backend (NULL);
+	g_autoptr (GeocodeForward) forward = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+	const char *expected_names[] = { "Paris", "Parma", NULL };
+
+	forward = geocode_forward_new_for_string ("Par");
+	geocode_forward_set_backend (forward, GEOCODE_BACKEND (backend));
+	geocode_forward_set_answer_count (forward, 2);
+
+	places = geocode_forward_search (forward, &error);
+	g_assert_no_error (error);
+	assert_names (places, expected_names);
+	g_clear_pointer (&places, place_list_free);
+
+	g_clear_object (&forward);
+	forward = geocode_forward_new_for_string ("Tokyo");
+	geocode_forward_set_backend (forward, GEOCODE_BACKEND (backend));
+
+	places = geocode_forward_search (forward, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NO_MATCHES);
+	g_assert_null (places);
+}
+
+/* Test that queries with no completions are passed to the fallback. */
+static void
+test_fallback (void)
+{
+	g_autoptr (GeocodeMockBackend) mock = NULL;
+	g_autoptr (GeocodeCompletionBackend) backend = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (GeocodePlace) tokyo = NULL;
+	g_autoptr (PlaceList) results = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	mock = geocode_mock_backend_new ();
+	backend = create_backend (GEOCODE_BACKEND (mock));
+	g_assert_true (geocode_completion_backend_get_fallback (backend) ==
+	               GEOCODE_BACKEND (mock));
+
+	params = build_location_params ("Tokyo");
+	tokyo = geocode_place_new ("Tokyo", GEOCODE_PLACE_TYPE_TOWN);
+	results = g_list_prepend (NULL, g_object_ref (tokyo));
+	geocode_mock_backend_add_forward_result (mock, params, results, NULL);
+
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (backend),
+	                                         params, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (places), ==, 1);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Tokyo");
+	g_clear_pointer (&places, place_list_free);
+
+	/* Completions are answered without the fallback. */
+	g_clear_pointer (&params, g_hash_table_unref);
+	params = build_location_params ("Lon");
+
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (backend),
+	                                         params, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "London");
+	g_assert_cmpuint (geocode_mock_backend_get_query_log (mock)->len, ==, 1);
+}
+
+static void
+test_fallback_async (void)
+{
+	g_autoptr (GeocodeMockBackend) mock = NULL;
+	g_autoptr (GeocodeCompletionBackend) backend = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (GeocodePlace) tokyo = NULL;
+	g_autoptr (PlaceList) results = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GAsyncResult) result = NULL;
+	g_autoptr (GError) error = NULL;
+
+	mock = geocode_mock_backend_new ();
+	backend = create_backend (GEOCODE_BACKEND (mock));
+
+	params = build_location_params ("Tokyo");
+	tokyo = geocode_place_new ("Tokyo", GEOCODE_PLACE_TYPE_TOWN);
+	results = g_list_prepend (NULL, g_object_ref (tokyo));
+	geocode_mock_backend_add_forward_result (mock, params, results, NULL);
+
+	geocode_backend_forward_search_async (GEOCODE_BACKEND (backend), params,
+	                                      NULL, async_result_cb, &result);
+
+	while (result == NULL)
+		g_main_context_iteration (NULL, TRUE);
+
+	places = geocode_backend_forward_search_finish (GEOCODE_BACKEND (backend),
+	                                                result, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (places), ==, 1);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Tokyo");
+}
+
+static void
+test_reverse (void)
+{
+	g_autoptr (GeocodeCompletionBackend) backend = create_backend (NULL);
+	g_autoptr (GeocodeLocation) location = NULL;
+	g_autoptr (GeocodeReverse) reverse = NULL;
+	g_autoptr (GeocodePlace) place = NULL;
+	g_autoptr (GError) error = NULL;
+
+	location = geocode_location_new (48.8566, 2.3522,
+	                                 GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+	reverse = geocode_reverse_new_for_location (location);
+	geocode_reverse_set_backend (reverse, GEOCODE_BACKEND (backend));
+
+	place = geocode_reverse_resolve (reverse, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED);
+	g_assert_null (place);
+}
+
+int
+main (int argc, char **argv)
+{
+	setlocale (LC_ALL, "");
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add_func ("/completion-backend/complete", test_complete);
+	g_test_add_func ("/completion-backend/complete/add", test_complete_add);
+	g_test_add_func ("/completion-backend/forward", test_forward);
+	g_test_add_func ("/completion-backend/fallback", test_fallback);
+	g_test_add_func ("/completion-backend/fallback/async", test_fallback_async);
+	g_test_add_func ("/completion-backend/reverse", test_reverse);
+
+	return g_test_run ();
+}
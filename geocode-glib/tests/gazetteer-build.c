@@ -0,0 +1,136 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include "config.h"
+
+#include <geocode-glib/geocode-glib.h>
+#include <gio/gio.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "backend-test-utils.h"
+
+/* Runs geocode-gazetteer-build, whose path is given on the command line,
+ * over a small Nominatim input, and checks the gazetteer it writes. */
+
+static const char *build_tool;
+static const char *input_path;
+
+/* Test that small batches parsed on several threads are added to the
+ * gazetteer in input order. */
+static void
+test_build (void)
+{
+	g_autoptr (GeocodeGazetteer) gazetteer = NULL;
+	g_autoptr (GeocodeForward) forward = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+	g_autofree char *tmpdir = NULL;
+	g_autofree char *output_path = NULL;
+	g_autoptr (GSubprocess) subprocess = NULL;
+	g_autofree char *standard_output = NULL;
+	g_autofree char *standard_error = NULL;
+	GList *l;
+	guint i;
+	const char * const expected_states[] = {
+		"Illinois", "Massachusetts", "Missouri", "Oregon", "Ohio", "Vermont",
+	};
+
+	tmpdir = g_dir_make_tmp ("geocode-gazetteer-build-XXXXXX", &error);
+	g_assert_no_error (error);
+	output_path = g_build_filename (tmpdir, "test.gazetteer", NULL);
+
+	subprocess = g_subprocess_new (G_SUBPROCESS_FLAGS_STDOUT_PIPE |
+	                               G_SUBPROCESS_FLAGS_STDERR_PIPE,
+	                               &error,
+	                               build_tool, "--threads", "4",
+	                               "--batch-size", "2",
+	                               output_path, input_path, NULL);
+	g_assert_no_error (error);
+
+	g_subprocess_communicate_utf8 (subprocess, NULL, NULL,
+	                               &standard_output, &standard_error, &error);
+	g_assert_no_error (error);
+
+	g_test_message ("Output: %s", standard_output);
+	g_test_message ("Errors: %s", standard_error);
+	g_assert_true (g_subprocess_get_successful (subprocess));
+
+	/* The line which is not JSON is reported, and skipped. */
+	g_assert_nonnull (strstr (standard_error, "gazetteer-build.jsonl:7: "));
+	g_assert_nonnull (strstr (standard_output,
+	                          "10 places from 11 lines written to"));
+	g_assert_nonnull (strstr (standard_output,
+	                          "(1 lines could not be parsed)"));
+
+	gazetteer = geocode_gazetteer_new (output_path, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (geocode_gazetteer_get_n_places (gazetteer), ==, 10);
+
+	/* The Springfields are spread over several batches, and must come back
+	 * in the order of the input. */
+	forward = geocode_forward_new_for_string ("Springfield");
+	geocode_forward_set_backend (forward, GEOCODE_BACKEND (gazetteer));
+	places = geocode_forward_search (forward, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (places), ==, G_N_ELEMENTS (expected_states));
+
+	for (l = places, i = 0; l != NULL; l = l->next, i++) {
+		g_assert_cmpstr (geocode_place_get_name (l->data), ==, "Springfield");
+		g_assert_cmpstr (geocode_place_get_state (l->data), ==, expected_states[i]);
+	}
+	g_clear_pointer (&places, place_list_free);
+	g_clear_object (&forward);
+
+	/* Both places from the line holding an array are added. */
+	forward = geocode_forward_new_for_string ("London");
+	geocode_forward_set_backend (forward, GEOCODE_BACKEND (gazetteer));
+	places = geocode_forward_search (forward, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (places), ==, 2);
+	g_assert_cmpstr (geocode_place_get_country (places->data), ==, "United Kingdom");
+	g_assert_cmpstr (geocode_place_get_country (places->next->data), ==, "Canada");
+
+	g_clear_object (&gazetteer);
+	g_unlink (output_path);
+	g_rmdir (tmpdir);
+}
+
+int
+main (int argc, char **argv)
+{
+	setlocale (LC_ALL, "");
+	g_test_init (&argc, &argv, NULL);
+
+	if (argc != 3) {
+		g_printerr ("Usage: %s GEOCODE-GAZETTEER-BUILD INPUT\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	build_tool = argv[1];
+	input_path = argv[2];
+
+	g_test_add_func ("/gazetteer-build/build", test_build);
+
+	return g_test_run ();
+}
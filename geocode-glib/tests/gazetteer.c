@@ -0,0 +1,338 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include "config.h"
+
+#include <geocode-glib/geocode-glib.h>
+#include <geocode-glib/geocode-glib-private.h>
+#include <gio/gio.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <locale.h>
+#include <stdlib.h>
+
+#include "backend-test-utils.h"
+
+typedef struct {
+	gchar *tmpdir;
+	gchar *path;
+	GeocodeGazetteer *gazetteer;
+} Fixture;
+
+static GeocodePlace *
+build_place (const char       *name,
+             GeocodePlaceType  place_type,
+             gdouble           latitude,
+             gdouble           longitude,
+             const char       *state,
+             const char       *country,
+             const char       *osm_id)
+{
+	g_autoptr (GeocodeLocation) location = NULL;
+	GeocodePlace *place;
+
+	location = geocode_location_new (latitude, longitude,
+	                                 GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+	place = geocode_place_new_with_location (name, place_type, location);
+	geocode_place_set_state (place, state);
+	geocode_place_set_country (place, country);
+	g_object_set (place,
+	              "osm-id", osm_id,
+	              "osm-type", GEOCODE_PLACE_OSM_TYPE_RELATION,
+	              NULL);
+
+	return place;
+}
+
+static void
+fixture_set_up (Fixture       *fixture,
+                gconstpointer  user_data)
+{
+	g_autoptr (GeocodeGazetteerWriter) writer = NULL;
+	g_autoptr (GError) error = NULL;
+	struct {
+		const char *name;
+		GeocodePlaceType place_type;
+		gdouble latitude, longitude;
+		const char *state, *country, *osm_id;
+	} places[] = {
+		{ "Paris", GEOCODE_PLACE_TYPE_TOWN, 48.8566, 2.3522,
+		  "Île-de-France", "France", "7444" },
+		{ "Paris", GEOCODE_PLACE_TYPE_TOWN, 33.6609, -95.5555,
+		  "Texas", "United States", "115357" },
+		{ "Parisot", GEOCODE_PLACE_TYPE_TOWN, 44.2650, 1.8590,
+		  "Occitanie", "France", "158881" },
+		{ "London", GEOCODE_PLACE_TYPE_TOWN, 51.5074, -0.1278,
+		  "England", "United Kingdom", "65606" },
+		{ "Auckland", GEOCODE_PLACE_TYPE_TOWN, -36.8485, 174.7633,
+		  "Auckland", "New Zealand", "2094141" },
+	};
+	guint i;
+
+	fixture->tmpdir = g_dir_make_tmp ("geocode-gazetteer-XXXXXX", &error);
+	g_assert_no_error (error);
+	fixture->path = g_build_filename (fixture->tmpdir, "test.gazetteer", NULL);
+
+	writer = _geocode_gazetteer_writer_new ();
+
+	for (i = 0; i < G_N_ELEMENTS (places); i++) {
+		g_autoptr (GeocodePlace) place = NULL;
+
+		place = build_place (places[i].name, places[i].place_type,
+		                     places[i].latitude, places[i].longitude,
+		                     places[i].state, places[i].country,
+		                     places[i].osm_id);
+		g_assert_true (_geocode_gazetteer_writer_add_place (writer, place));
+	}
+
+	/* Places without a location can't be looked up. */
+	{
+		g_autoptr (GeocodePlace) place = NULL;
+
+		place = geocode_place_new ("Nowhere", GEOCODE_PLACE_TYPE_TOWN);
+		g_assert_false (_geocode_gazetteer_writer_add_place (writer, place));
+	}
+
+	g_assert_cmpuint (_geocode_gazetteer_writer_get_n_places (writer), ==,
+	                  G_N_ELEMENTS (places));
+
+	_geocode_gazetteer_writer_write (writer, fixture->path, &error);
+	g_assert_no_error (error);
+
+	fixture->gazetteer = geocode_gazetteer_new (fixture->path, &error);
+	g_assert_no_error (error);
+	g_assert_nonnull (fixture->gazetteer);
+	g_assert_cmpuint (geocode_gazetteer_get_n_places (fixture->gazetteer), ==,
+	                  G_N_ELEMENTS (places));
+}
+
+static void
+fixture_tear_down (Fixture       *fixture,
+                   gconstpointer  user_data)
+{
+	g_clear_object (&fixture->gazetteer);
+	g_unlink (fixture->path);
+	g_rmdir (fixture->tmpdir);
+	g_free (fixture->path);
+	g_free (fixture->tmpdir);
+}
+
+static GList *
+forward_search (Fixture     *fixture,
+                const char  *location,
+                GError     **error)
+{
+	g_autoptr (GeocodeForward) forward = NULL;
+
+	forward = geocode_forward_new_for_string (location);
+	geocode_forward_set_backend (forward, GEOCODE_BACKEND (fixture->gazetteer));
+
+	return geocode_forward_search (forward, error);
+}
+
+/* Test that exact matches come first, in the order they were added, followed
+ * by prefix matches, and that all the stored fields are returned. */
+static void
+test_forward (Fixture       *fixture,
+              gconstpointer  user_data)
+{
+	g_autoptr (PlaceList) results = NULL;
+	g_autoptr (GError) error = NULL;
+	GeocodePlace *place;
+	GeocodeLocation *location;
+
+	results = forward_search (fixture, "paris", &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (results), ==, 3);
+
+	place = results->data;
+	g_assert_cmpstr (geocode_place_get_name (place), ==, "Paris");
+	g_assert_cmpint (geocode_place_get_place_type (place), ==, GEOCODE_PLACE_TYPE_TOWN);
+	g_assert_cmpstr (geocode_place_get_state (place), ==, "Île-de-France");
+	g_assert_cmpstr (geocode_place_get_country (place), ==, "France");
+	g_assert_cmpstr (geocode_place_get_osm_id (place), ==, "7444");
+	g_assert_cmpint (geocode_place_get_osm_type (place), ==, GEOCODE_PLACE_OSM_TYPE_RELATION);
+	location = geocode_place_get_location (place);
+	g_assert_cmpfloat (geocode_location_get_latitude (location), ==, 48.8566);
+	g_assert_cmpfloat (geocode_location_get_longitude (location), ==, 2.3522);
+
+	g_assert_cmpstr (geocode_place_get_state (results->next->data), ==, "Texas");
+	g_assert_cmpstr (geocode_place_get_name (results->next->next->data), ==, "Parisot");
+}
+
+/* Test that further components of the query filter on the address. */
+static void
+test_forward_constraints (Fixture       *fixture,
+                          gconstpointer  user_data)
+{
+	g_autoptr (PlaceList) results = NULL;
+	g_autoptr (GError) error = NULL;
+
+	results = forward_search (fixture, "Paris, TEXAS", &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (results), ==, 1);
+	g_assert_cmpstr (geocode_place_get_country (results->data), ==, "United States");
+	g_clear_pointer (&results, place_list_free);
+
+	results = forward_search (fixture, "Paris, Germany", &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NO_MATCHES);
+	g_assert_null (results);
+}
+
+static void
+test_forward_limit (Fixture       *fixture,
+                    gconstpointer  user_data)
+{
+	g_autoptr (GeocodeForward) forward = NULL;
+	g_autoptr (PlaceList) results = NULL;
+	g_autoptr (GError) error = NULL;
+
+	forward = geocode_forward_new_for_string ("Paris");
+	geocode_forward_set_backend (forward, GEOCODE_BACKEND (fixture->gazetteer));
+	geocode_forward_set_answer_count (forward, 2);
+
+	results = geocode_forward_search (forward, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (results), ==, 2);
+}
+
+static void
+test_forward_no_matches (Fixture       *fixture,
+                         gconstpointer  user_data)
+{
+	g_autoptr (PlaceList) results = NULL;
+	g_autoptr (GError) error = NULL;
+
+	results = forward_search (fixture, "Pari", &error);
+	g_assert_no_error (error);
+	g_clear_pointer (&results, place_list_free);
+
+	results = forward_search (fixture, "Parisx", &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NO_MATCHES);
+	g_assert_null (results);
+}
+
+static void
+test_forward_async (Fixture       *fixture,
+                    gconstpointer  user_data)
+{
+	g_autoptr (GeocodeForward) forward = NULL;
+	g_autoptr (GAsyncResult) result = NULL;
+	g_autoptr (PlaceList) results = NULL;
+	g_autoptr (GError) error = NULL;
+
+	forward = geocode_forward_new_for_string ("London");
+	geocode_forward_set_backend (forward, GEOCODE_BACKEND (fixture->gazetteer));
+
+	geocode_forward_search_async (forward, NULL, async_result_cb, &result);
+	while (result == NULL)
+		g_main_context_iteration (NULL, TRUE);
+
+	results = geocode_forward_search_finish (forward, result, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (results), ==, 1);
+	g_assert_cmpstr (geocode_place_get_country (results->data), ==, "United Kingdom");
+}
+
+/* Test that reverse queries find the nearest place, including across the
+ * antimeridian. */
+static void
+test_reverse (Fixture       *fixture,
+              gconstpointer  user_data)
+{
+	struct {
+		gdouble latitude, longitude;
+		const char *expected_osm_id;
+	} queries[] = {
+		{ 48.85, 2.35, "7444" },
+		{ 49.0, 0.0, "7444" },
+		{ 50.5, -1.0, "65606" },
+		{ 44.0, 1.0, "158881" },
+		{ 30.0, -100.0, "115357" },
+		{ -40.0, -170.0, "2094141" },
+		{ 90.0, 0.0, "65606" },
+	};
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (queries); i++) {
+		g_autoptr (GeocodeLocation) location = NULL;
+		g_autoptr (GeocodeReverse) reverse = NULL;
+		g_autoptr (GeocodePlace) place = NULL;
+		g_autoptr (GError) error = NULL;
+
+		location = geocode_location_new (queries[i].latitude,
+		                                 queries[i].longitude,
+		                                 GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+		reverse = geocode_reverse_new_for_location (location);
+		geocode_reverse_set_backend (reverse, GEOCODE_BACKEND (fixture->gazetteer));
+
+		place = geocode_reverse_resolve (reverse, &error);
+		g_assert_no_error (error);
+		g_assert_cmpstr (geocode_place_get_osm_id (place), ==,
+		                 queries[i].expected_osm_id);
+	}
+}
+
+static void
+test_invalid_file (void)
+{
+	g_autoptr (GeocodeGazetteer) gazetteer = NULL;
+	g_autoptr (GError) error = NULL;
+	g_autofree gchar *path = NULL;
+
+	gazetteer = geocode_gazetteer_new ("/nonexistent/test.gazetteer", &error);
+	g_assert_error (error, G_FILE_ERROR, G_FILE_ERROR_NOENT);
+	g_assert_null (gazetteer);
+	g_clear_error (&error);
+
+	g_close (g_file_open_tmp ("geocode-gazetteer-XXXXXX", &path, &error), NULL);
+	g_assert_no_error (error);
+	g_file_set_contents (path, "not a gazetteer", -1, &error);
+	g_assert_no_error (error);
+
+	gazetteer = geocode_gazetteer_new (path, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE);
+	g_assert_null (gazetteer);
+
+	g_unlink (path);
+}
+
+int
+main (int argc, char **argv)
+{
+	setlocale (LC_ALL, "");
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add ("/gazetteer/forward", Fixture, NULL,
+	            fixture_set_up, test_forward, fixture_tear_down);
+	g_test_add ("/gazetteer/forward/constraints", Fixture, NULL,
+	            fixture_set_up, test_forward_constraints, fixture_tear_down);
+	g_test_add ("/gazetteer/forward/limit", Fixture, NULL,
+	            fixture_set_up, test_forward_limit, fixture_tear_down);
+	g_test_add ("/gazetteer/forward/no-matches", Fixture, NULL,
+	            fixture_set_up, test_forward_no_matches, fixture_tear_down);
+	g_test_add ("/gazetteer/forward/async", Fixture, NULL,
+	            fixture_set_up, test_forward_async, fixture_tear_down);
+	g_test_add ("/gazetteer/reverse", Fixture, NULL,
+	            fixture_set_up, test_reverse, fixture_tear_down);
+	g_test_add_func ("/gazetteer/invalid-file", test_invalid_file);
+
+	return g_test_run ();
+}
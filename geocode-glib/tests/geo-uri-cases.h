@@ -0,0 +1,72 @@
+/*
+ * Copyright 2013, 2014 Jonas Danielsson
+ *
+ * The Gnome Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The Gnome Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ * Authors: Jonas Danielsson <jonas.danielsson@threetimestwo.org>
+ */
+
+#ifndef GEO_URI_CASES_H
+#define GEO_URI_CASES_H
+
+#include <glib.h>
+
+/* Geo URIs shared by the geo-uri tests and the benchmarks, along with
+ * whether geocode_location_set_from_uri() should accept them. */
+struct uri {
+    const char *uri;
+    gboolean valid;
+};
+
+static struct uri uris[] = {
+    { "geo:13.37,42.42", TRUE },
+    { "geo:13.37373737,42.42424242", TRUE },
+    { "geo:13.37,42.42,12.12", TRUE },
+    { "geo:1,2,3", TRUE },
+    { "geo:-13.37,42.42", TRUE },
+    { "geo:13.37,-42.42", TRUE },
+    { "geo:13.37,42.42;u=-45.5", TRUE },
+    { "geo:13.37,42.42;u=45.5", TRUE },
+    { "geo:13.37,42.42,12.12;u=45.5", TRUE },
+    { "geo:13.37,42.42,12.12;crs=wgs84;u=45.5", TRUE },
+    { "geo:13.37,42.42,12.12;crs=wgs84;u=45.5;u=10", FALSE },
+    { "geo:13.37,42.42,12.12;crs=wgs84;u=45.5;crs=wgs84", FALSE },
+    { "geo:13.37,42.42,12.12;crs=wgs84;u=45.5;z=18", TRUE },
+    { "geo:0.0,0,0", TRUE },
+    { "GEO:13.37,42.42", TRUE },
+    { "Geo:0,0?q=13.36,4242(description)", TRUE },
+    { "geo :0.0,0,0", FALSE },
+    { "geo:0.0 ,0,0", FALSE },
+    { "geo:0.0,0 ,0", FALSE },
+    { "geo: 0.0,0,0", FALSE },
+    { "geo:13.37,42.42,12.12;crs=newcrs;u=45.5", FALSE },
+    { "geo:13.37,42.42,12.12;u=45.5;crs=hej", FALSE },
+    { "geo:13.37,42.42,12.12;u=45.5;u=22", FALSE },
+    { "geo:13.37,42.42,12.12;u=alpha", FALSE },
+    { "gel:13.37,42.42,12.12", FALSE },
+    { "geo:13.37alpha,42.42", FALSE },
+    { "geo:13.37,alpha42.42", FALSE },
+    { "geo:13.37,42.42,12.alpha", FALSE },
+    { "geo:,13.37,42.42", FALSE },
+    { "geo:0,0?q=13.36,4242(description)", TRUE },
+    { "geo:0,0?q=-13.36,4242(description)", TRUE },
+    { "geo:0,0?q=13.36,-4242(description)", TRUE },
+    { "geo:1,2?q=13.36,4242(description)", FALSE },
+    { "geo:0,0?q=13.36,4242(description", FALSE },
+    { "geo:0,0?q=13.36,4242()", FALSE }
+};
+
+#endif /* GEO_URI_CASES_H */
@@ -22,50 +22,11 @@
 #include <glib/gi18n.h>
 #include <glib.h>
 #include <stdlib.h>
+#include <string.h>
 #include <gio/gio.h>
 #include <geocode-glib/geocode-glib.h>
 #include <geocode-glib/geocode-glib-private.h>
-
-struct uri {
-    const char *uri;
-    gboolean valid;
-};
-
-static struct uri uris[] = {
-    { "geo:13.37,42.42", TRUE },
-    { "geo:13.37373737,42.42424242", TRUE },
-    { "geo:13.37,42.42,12.12", TRUE },
-    { "geo:1,2,3", TRUE },
-    { "geo:-13.37,42.42", TRUE },
-    { "geo:13.37,-42.42", TRUE },
-    { "geo:13.37,42.42;u=-45.5", TRUE },
-    { "geo:13.37,42.42;u=45.5", TRUE },
-    { "geo:13.37,42.42,12.12;u=45.5", TRUE },
-    { "geo:13.37,42.42,12.12;crs=wgs84;u=45.5", TRUE },
-    { "geo:13.37,42.42,12.12;crs=wgs84;u=45.5;u=10", FALSE },
-    { "geo:13.37,42.42,12.12;crs=wgs84;u=45.5;crs=wgs84", FALSE },
-    { "geo:13.37,42.42,12.12;crs=wgs84;u=45.5;z=18", TRUE },
-    { "geo:0.0,0,0", TRUE },
-    { "geo :0.0,0,0", FALSE },
-    { "geo:0.0 ,0,0", FALSE },
-    { "geo:0.0,0 ,0", FALSE },
-    { "geo: 0.0,0,0", FALSE },
-    { "geo:13.37,42.42,12.12;crs=newcrs;u=45.5", FALSE },
-    { "geo:13.37,42.42,12.12;u=45.5;crs=hej", FALSE },
-    { "geo:13.37,42.42,12.12;u=45.5;u=22", FALSE },
-    { "geo:13.37,42.42,12.12;u=alpha", FALSE },
-    { "gel:13.37,42.42,12.12", FALSE },
-    { "geo:13.37alpha,42.42", FALSE },
-    { "geo:13.37,alpha42.42", FALSE },
-    { "geo:13.37,42.42,12.alpha", FALSE },
-    { "geo:,13.37,42.42", FALSE },
-    { "geo:0,0?q=13.36,4242(description)", TRUE },
-    { "geo:0,0?q=-13.36,4242(description)", TRUE },
-    { "geo:0,0?q=13.36,-4242(description)", TRUE },
-    { "geo:1,2?q=13.36,4242(description)", FALSE },
-    { "geo:0,0?q=13.36,4242(description", FALSE },
-    { "geo:0,0?q=13.36,4242()", FALSE }
-};
+#include "geo-uri-cases.h"
 
 static void
 test_parse_uri (void)
@@ -187,6 +148,236 @@ test_convert_from_to_location (void)
         g_object_unref (loc);
 }
 
+static void
+test_geo_uri_parse (void)
+{
+        GeocodeGeoUri geo_uri;
+        GError *error = NULL;
+
+        g_assert (geocode_geo_uri_parse ("geo:1.2,-2.3,4.5;crs=wgs84;u=67",
+                                         &geo_uri, &error));
+        g_assert_no_error (error);
+        g_assert_cmpfloat (geo_uri.latitude, ==, 1.2);
+        g_assert_cmpfloat (geo_uri.longitude, ==, -2.3);
+        g_assert (geo_uri.has_altitude);
+        g_assert_cmpfloat (geo_uri.altitude, ==, 4.5);
+        g_assert (geo_uri.has_accuracy);
+        g_assert_cmpfloat (geo_uri.accuracy, ==, 67);
+        g_assert (geo_uri.description == NULL);
+
+        g_assert (geocode_geo_uri_parse ("geo:1,2", &geo_uri, NULL));
+        g_assert (!geo_uri.has_altitude);
+        g_assert (!geo_uri.has_accuracy);
+
+        /* An empty uncertainty is accepted as 0 */
+        g_assert (geocode_geo_uri_parse ("geo:1,2;u=", &geo_uri, NULL));
+        g_assert (geo_uri.has_accuracy);
+        g_assert_cmpfloat (geo_uri.accuracy, ==, 0);
+
+        /* The description is left escaped, pointing into the URI */
+        g_assert (geocode_geo_uri_parse ("geo:0,0,7?q=57.038,12.3982(Tv%C3%A5%C3%A5ker)x",
+                                         &geo_uri, NULL));
+        g_assert_cmpfloat (geo_uri.latitude, ==, 57.038);
+        g_assert_cmpfloat (geo_uri.longitude, ==, 12.3982);
+        g_assert (geo_uri.has_altitude);
+        g_assert_cmpfloat (geo_uri.altitude, ==, 7);
+        g_assert_cmpint (geo_uri.description_len, ==, strlen ("Tv%C3%A5%C3%A5ker"));
+        g_assert (strncmp (geo_uri.description, "Tv%C3%A5%C3%A5ker",
+                           geo_uri.description_len) == 0);
+}
+
+static void
+test_geo_uri_errors (void)
+{
+        GeocodeGeoUri geo_uri;
+        GError *error = NULL;
+
+        g_assert (!geocode_geo_uri_parse ("gel:1,2", &geo_uri, &error));
+        g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED);
+        g_clear_error (&error);
+
+        g_assert (!geocode_geo_uri_parse ("geo:1;2", &geo_uri, &error));
+        g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE);
+        g_assert_cmpstr (error->message, ==, "Failed to parse geo URI");
+        g_clear_error (&error);
+
+        g_assert (!geocode_geo_uri_parse ("geo:1,2;u=1;crs=wgs84", &geo_uri, &error));
+        g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE);
+        g_assert_cmpstr (error->message, ==, "Failed to parse geo URI parameters");
+        g_clear_error (&error);
+
+        /* Whitespace is a problem with the whole URI, wherever it is */
+        g_assert (!geocode_geo_uri_parse ("geo:1,2;crs=wgs84;foo=a b", &geo_uri, &error));
+        g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE);
+        g_assert_cmpstr (error->message, ==, "Failed to parse geo URI");
+        g_clear_error (&error);
+}
+
+static void
+test_geo_uri_batch (void)
+{
+        const char *uri_strings[G_N_ELEMENTS (uris)];
+        GeocodeGeoUri geo_uris[G_N_ELEMENTS (uris)];
+        gboolean valid[G_N_ELEMENTS (uris)];
+        gsize i, n_valid = 0;
+
+        for (i = 0; i < G_N_ELEMENTS (uris); i++) {
+                uri_strings[i] = uris[i].uri;
+                n_valid += uris[i].valid;
+        }
+
+        g_assert_cmpuint (geocode_geo_uri_parse_batch (uri_strings,
+                                                       G_N_ELEMENTS (uris),
+                                                       geo_uris,
+                                                       valid),
+                          ==,
+                          n_valid);
+
+        for (i = 0; i < G_N_ELEMENTS (uris); i++) {
+                GeocodeGeoUri geo_uri;
+
+                g_assert_cmpint (valid[i], ==, uris[i].valid);
+                if (!valid[i])
+                        continue;
+
+                g_assert (geocode_geo_uri_parse (uris[i].uri, &geo_uri, NULL));
+                g_assert_cmpfloat (geo_uri.latitude, ==, geo_uris[i].latitude);
+                g_assert_cmpfloat (geo_uri.longitude, ==, geo_uris[i].longitude);
+                g_assert_cmpint (geo_uri.has_altitude, ==, geo_uris[i].has_altitude);
+                g_assert_cmpint (geo_uri.has_accuracy, ==, geo_uris[i].has_accuracy);
+                g_assert (geo_uri.description == geo_uris[i].description);
+        }
+}
+
+static void
+test_geo_uri_numbers (void)
+{
+        const char *numbers[] = {
+                "0", "-0", "+7", "1.", ".5", "-.25", "90", "-180.000000",
+                "48.198634", "16.371648", "0.1", "0.3", "123456789012345",
+                "1234567.89012345", "0.000000000000001", "-0.999999999999999",
+                /* These take the g_ascii_strtod() path */
+                "1e3", "1.5E-2", "0x1p3", "1234567890123456", "0.12345678901234567",
+        };
+        GRand *rand;
+        guint i;
+
+        for (i = 0; i < G_N_ELEMENTS (numbers); i++) {
+                g_autofree char *uri = NULL;
+                GeocodeGeoUri geo_uri;
+
+                uri = g_strdup_printf ("geo:%s,%s", numbers[i], numbers[i]);
+                g_assert (geocode_geo_uri_parse (uri, &geo_uri, NULL));
+                g_assert_cmpfloat (geo_uri.latitude, ==, g_ascii_strtod (numbers[i], NULL));
+                g_assert_cmpfloat (geo_uri.longitude, ==, g_ascii_strtod (numbers[i], NULL));
+        }
+
+        rand = g_rand_new_with_seed (5870);
+        for (i = 0; i < 10000; i++) {
+                char number[32];
+                g_autofree char *uri = NULL;
+                GeocodeGeoUri geo_uri;
+
+                g_snprintf (number, sizeof (number), "%.*f",
+                            g_rand_int_range (rand, 0, 12),
+                            g_rand_double_range (rand, -180, 180));
+                uri = g_strdup_printf ("geo:%s,0", number);
+                g_assert (geocode_geo_uri_parse (uri, &geo_uri, NULL));
+                g_assert_cmpfloat (geo_uri.latitude, ==, g_ascii_strtod (number, NULL));
+        }
+        g_rand_free (rand);
+}
+
+static void
+test_set_from_invalid_uri (void)
+{
+        GeocodeLocation *loc;
+        GError *error = NULL;
+
+        loc = geocode_location_new (10, 20, 30);
+        g_assert (!geocode_location_set_from_uri (loc, "geo:1,2;crs=foo", &error));
+        g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE);
+        g_clear_error (&error);
+
+        g_assert_cmpfloat (geocode_location_get_latitude (loc), ==, 10);
+        g_assert_cmpfloat (geocode_location_get_longitude (loc), ==, 20);
+        g_assert_cmpfloat (geocode_location_get_accuracy (loc), ==, 30);
+        g_object_unref (loc);
+}
+
+static void
+test_geo_uri_format (void)
+{
+        char buffer[GEOCODE_GEO_URI_BUFFER_SIZE];
+        char small[8];
+        GeocodeGeoUri geo_uri;
+
+        g_assert_cmpuint (geocode_geo_uri_format (48.1986344, -16.3716476, 5, 40,
+                                                  buffer, sizeof (buffer)),
+                          ==, strlen (buffer));
+        g_assert_cmpstr (buffer, ==, "geo:48.198634,-16.371648,5;crs=wgs84;u=40");
+
+        geocode_geo_uri_format (-0.0000001, 0, GEOCODE_LOCATION_ALTITUDE_UNKNOWN,
+                                GEOCODE_LOCATION_ACCURACY_UNKNOWN,
+                                buffer, sizeof (buffer));
+        g_assert_cmpstr (buffer, ==, "geo:-0.000000,0.000000;crs=wgs84");
+
+        /* The altitude and accuracy are written as briefly as possible */
+        geocode_geo_uri_format (1, 2, 0.1, 1.0 / 3, buffer, sizeof (buffer));
+        g_assert_cmpstr (buffer, ==, "geo:1.000000,2.000000,0.1;crs=wgs84;u=0.3333333333333333");
+        g_assert (geocode_geo_uri_parse (buffer, &geo_uri, NULL));
+        g_assert_cmpfloat (geo_uri.altitude, ==, 0.1);
+        g_assert_cmpfloat (geo_uri.accuracy, ==, 1.0 / 3);
+
+        /* Too small a buffer */
+        g_assert_cmpuint (geocode_geo_uri_format (1, 2, 3, 4, small, sizeof (small)),
+                          ==, strlen ("geo:1.000000,2.000000,3;crs=wgs84;u=4"));
+        g_assert_cmpstr (small, ==, "");
+}
+
+static void
+test_geo_uri_append (void)
+{
+        const gdouble latitudes[] = { 57.038, -33.8688 };
+        const gdouble longitudes[] = { 12.3982, 151.2093 };
+        const gdouble altitudes[] = { GEOCODE_LOCATION_ALTITUDE_UNKNOWN, -2.5 };
+        g_autoptr(GString) string = NULL;
+        GeocodeLocation *loc;
+        guint i;
+
+        string = g_string_new ("uri: ");
+        geocode_geo_uri_append (string, 1, 2, GEOCODE_LOCATION_ALTITUDE_UNKNOWN, 3);
+        g_assert_cmpstr (string->str, ==, "uri: geo:1.000000,2.000000;crs=wgs84;u=3");
+
+        g_string_truncate (string, 0);
+        geocode_geo_uri_append_batch (string, latitudes, longitudes, altitudes,
+                                      NULL, G_N_ELEMENTS (latitudes), "\n");
+        g_assert_cmpstr (string->str, ==,
+                         "geo:57.038000,12.398200;crs=wgs84\n"
+                         "geo:-33.868800,151.209300,-2.5;crs=wgs84");
+
+        /* geocode_location_to_uri() gives the same URIs */
+        for (i = 0; i < G_N_ELEMENTS (uris); i++) {
+                g_autofree char *uri = NULL;
+
+                if (!uris[i].valid)
+                        continue;
+
+                loc = geocode_location_new (0, 0, GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+                g_assert (geocode_location_set_from_uri (loc, uris[i].uri, NULL));
+                uri = geocode_location_to_uri (loc, GEOCODE_LOCATION_URI_SCHEME_GEO);
+
+                g_string_truncate (string, 0);
+                geocode_geo_uri_append (string,
+                                        geocode_location_get_latitude (loc),
+                                        geocode_location_get_longitude (loc),
+                                        geocode_location_get_altitude (loc),
+                                        geocode_location_get_accuracy (loc));
+                g_assert_cmpstr (string->str, ==, uri);
+                g_object_unref (loc);
+        }
+}
+
 int main (int argc, char **argv)
 {
         g_test_init (&argc, &argv, NULL);
@@ -196,6 +387,13 @@ int main (int argc, char **argv)
         g_test_add_func ("/geouri/valid_uri", test_valid_uri);
         g_test_add_func ("/geouri/unescape_uri", test_unescape_uri);
         g_test_add_func ("/geouri/convert_uri", test_convert_from_to_location);
+        g_test_add_func ("/geouri/geo_uri_parse", test_geo_uri_parse);
+        g_test_add_func ("/geouri/geo_uri_errors", test_geo_uri_errors);
+        g_test_add_func ("/geouri/geo_uri_batch", test_geo_uri_batch);
+        g_test_add_func ("/geouri/geo_uri_numbers", test_geo_uri_numbers);
+        g_test_add_func ("/geouri/set_from_invalid_uri", test_set_from_invalid_uri);
+        g_test_add_func ("/geouri/geo_uri_format", test_geo_uri_format);
+        g_test_add_func ("/geouri/geo_uri_append", test_geo_uri_append);
 
         return g_test_run ();
 }
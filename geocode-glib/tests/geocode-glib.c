@@ -29,6 +29,8 @@
 #include <glib/gi18n.h>
 #include <glib.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include <gio/gio.h>
 #include <geocode-glib/geocode-glib.h>
 #include <geocode-glib/geocode-glib-private.h>
@@ -684,6 +686,371 @@ test_zero_distance (void)
 	g_assert_cmpfloat (geocode_location_get_distance_from (loca, locb), ==, 0.0);
 }
 
+static void
+test_batch_distance (void)
+{
+	g_autoptr (GeocodeLocation) origin = NULL;
+	g_autoptr (GRand) rand = NULL;
+	gdouble latitudes[1000], longitudes[1000], distances[1000];
+	guint i;
+
+	/* The same points as test_distance() and test_zero_distance() */
+	origin = geocode_location_new (38.898556, -77.037852, GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+	latitudes[0] = 38.897147;
+	longitudes[0] = -77.043934;
+	latitudes[1] = 38.898556;
+	longitudes[1] = -77.037852;
+
+	geocode_location_get_distances_from (origin, latitudes, longitudes, 2, distances);
+	g_assert_cmpfloat (fabs (distances[0] - 0.549311), <, 0.000001);
+	g_assert_cmpfloat (distances[1], ==, 0.0);
+
+	/* Compare against the scalar function over the whole globe, including
+	 * across the antimeridian */
+	rand = g_rand_new_with_seed (42);
+	for (i = 0; i < G_N_ELEMENTS (latitudes); i++) {
+		latitudes[i] = g_rand_double_range (rand, -90.0, 90.0);
+		longitudes[i] = g_rand_double_range (rand, -180.0, 180.0);
+	}
+	longitudes[0] = 180.0;
+	longitudes[1] = -180.0;
+
+	geocode_location_get_distances_from (origin, latitudes, longitudes,
+	                                     G_N_ELEMENTS (latitudes), distances);
+
+	for (i = 0; i < G_N_ELEMENTS (latitudes); i++) {
+		g_autoptr (GeocodeLocation) loc = NULL;
+		gdouble expected;
+
+		loc = geocode_location_new (latitudes[i], longitudes[i],
+		                            GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+		expected = geocode_location_get_distance_from (origin, loc);
+
+		/* Skip points near the antipode, see the documentation */
+		if (expected > 19900.0)
+			continue;
+
+		g_assert_cmpfloat (fabs (distances[i] - expected), <, 1e-9);
+	}
+}
+
+static void
+test_distance_matrix (void)
+{
+	g_autoptr (GRand) rand = NULL;
+	g_autofree gdouble *row_lats = NULL, *row_lons = NULL;
+	g_autofree gdouble *col_lats = NULL, *col_lons = NULL;
+	g_autofree gdouble *matrix = NULL, *row = NULL;
+	/* Large enough to be split between threads */
+	const gsize n_rows = 700, n_cols = 400;
+	gsize i, j;
+
+	rand = g_rand_new_with_seed (42);
+	row_lats = g_new (gdouble, n_rows);
+	row_lons = g_new (gdouble, n_rows);
+	col_lats = g_new (gdouble, n_cols);
+	col_lons = g_new (gdouble, n_cols);
+	for (i = 0; i < n_rows; i++) {
+		row_lats[i] = g_rand_double_range (rand, -90.0, 90.0);
+		row_lons[i] = g_rand_double_range (rand, -180.0, 180.0);
+	}
+	for (j = 0; j < n_cols; j++) {
+		col_lats[j] = g_rand_double_range (rand, -90.0, 90.0);
+		col_lons[j] = g_rand_double_range (rand, -180.0, 180.0);
+	}
+
+	matrix = g_new (gdouble, n_rows * n_cols);
+	row = g_new (gdouble, n_cols);
+	geocode_location_get_distance_matrix (row_lats, row_lons, n_rows,
+	                                      col_lats, col_lons, n_cols,
+	                                      matrix);
+
+	for (i = 0; i < n_rows; i++) {
+		g_autoptr (GeocodeLocation) loc = NULL;
+
+		loc = geocode_location_new (row_lats[i], row_lons[i],
+		                            GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+		geocode_location_get_distances_from (loc, col_lats, col_lons,
+		                                     n_cols, row);
+
+		for (j = 0; j < n_cols; j++) {
+			if (row[j] > 19900.0)
+				continue;
+			g_assert_cmpfloat (fabs (matrix[i * n_cols + j] - row[j]), <, 1e-9);
+		}
+	}
+
+	/* Empty matrices are fine */
+	geocode_location_get_distance_matrix (row_lats, row_lons, n_rows,
+	                                      NULL, NULL, 0, NULL);
+}
+
+static gint
+compare_doubles (gconstpointer a,
+                 gconstpointer b)
+{
+	gdouble x = *(const gdouble *) a;
+	gdouble y = *(const gdouble *) b;
+
+	return (x > y) - (x < y);
+}
+
+static void
+test_place_index (void)
+{
+	g_autoptr (GRand) rand = NULL;
+	g_autoptr (GeocodePlaceIndex) index = NULL;
+	g_autoptr (GeocodeLocation) paris = NULL, london = NULL;
+	g_autoptr (GArray) nearest = NULL, within = NULL;
+	gdouble latitudes[2000], longitudes[2000], distances[2000], sorted[2000];
+	GList *places = NULL;
+	GeocodePlace *place;
+	guint i, q;
+
+	rand = g_rand_new_with_seed (42);
+	for (i = 0; i < G_N_ELEMENTS (latitudes); i++) {
+		latitudes[i] = g_rand_double_range (rand, -90.0, 90.0);
+		longitudes[i] = g_rand_double_range (rand, -180.0, 180.0);
+	}
+	index = geocode_place_index_new_for_coordinates (latitudes, longitudes,
+	                                                 G_N_ELEMENTS (latitudes));
+	g_assert_cmpuint (geocode_place_index_get_n_items (index), ==, G_N_ELEMENTS (latitudes));
+	g_assert_null (geocode_place_index_get_place (index, 0));
+
+	/* Compare against a linear scan */
+	for (q = 0; q < 20; q++) {
+		g_autoptr (GeocodeLocation) origin = NULL;
+		g_autoptr (GArray) q_nearest = NULL;
+		g_autoptr (GArray) q_within = NULL;
+		gdouble radius = g_rand_double_range (rand, 0.0, 3000.0);
+		guint n_within = 0;
+
+		origin = geocode_location_new (g_rand_double_range (rand, -90.0, 90.0),
+		                               g_rand_double_range (rand, -180.0, 180.0),
+		                               GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+		geocode_location_get_distances_from (origin, latitudes, longitudes,
+		                                     G_N_ELEMENTS (latitudes), distances);
+		memcpy (sorted, distances, sizeof (distances));
+		qsort (sorted, G_N_ELEMENTS (sorted), sizeof (gdouble), compare_doubles);
+
+		q_nearest = geocode_place_index_find_nearest (index,
+		                                              geocode_location_get_latitude (origin),
+		                                              geocode_location_get_longitude (origin),
+		                                              10);
+		g_assert_cmpuint (q_nearest->len, ==, 10);
+		for (i = 0; i < q_nearest->len; i++)
+			g_assert_cmpfloat (fabs (distances[g_array_index (q_nearest, guint, i)] - sorted[i]), <, 1e-6);
+
+		q_within = geocode_place_index_find_within (index,
+		                                            geocode_location_get_latitude (origin),
+		                                            geocode_location_get_longitude (origin),
+		                                            radius);
+		for (i = 0; i < q_within->len; i++)
+			g_assert_cmpfloat (distances[g_array_index (q_within, guint, i)], <=, radius + 1e-6);
+		for (i = 0; i < G_N_ELEMENTS (distances); i++) {
+			if (distances[i] < radius - 1e-6)
+				n_within++;
+		}
+		g_assert_cmpuint (q_within->len, >=, n_within);
+	}
+	g_clear_object (&index);
+
+	/* Places are returned by their position in the list, and places
+	 * without a location are never returned */
+	paris = geocode_location_new (48.8566, 2.3522, GEOCODE_LOCATION_ACCURACY_CITY);
+	london = geocode_location_new (51.5074, -0.1278, GEOCODE_LOCATION_ACCURACY_CITY);
+	places = g_list_append (places, geocode_place_new ("Nowhere", GEOCODE_PLACE_TYPE_UNKNOWN));
+	places = g_list_append (places, geocode_place_new_with_location ("Paris", GEOCODE_PLACE_TYPE_TOWN, paris));
+	places = g_list_append (places, geocode_place_new_with_location ("London", GEOCODE_PLACE_TYPE_TOWN, london));
+
+	index = geocode_place_index_new_for_places (places);
+	g_list_free_full (places, g_object_unref);
+	g_assert_cmpuint (geocode_place_index_get_n_items (index), ==, 3);
+
+	/* From Brussels */
+	nearest = geocode_place_index_find_nearest (index, 50.8503, 4.3517, 5);
+	g_assert_cmpuint (nearest->len, ==, 2);
+	place = geocode_place_index_get_place (index, g_array_index (nearest, guint, 0));
+	g_assert_cmpstr (geocode_place_get_name (place), ==, "Paris");
+	place = geocode_place_index_get_place (index, g_array_index (nearest, guint, 1));
+	g_assert_cmpstr (geocode_place_get_name (place), ==, "London");
+
+	within = geocode_place_index_find_within (index, 50.8503, 4.3517, 300.0);
+	g_assert_cmpuint (within->len, ==, 1);
+	g_assert_cmpuint (g_array_index (within, guint, 0), ==, 1);
+}
+
+static void
+assert_bbox (GeocodeBoundingBox *bbox,
+             gdouble             top,
+             gdouble             bottom,
+             gdouble             left,
+             gdouble             right)
+{
+	g_assert_cmpfloat (fabs (geocode_bounding_box_get_top (bbox) - top), <, 1e-9);
+	g_assert_cmpfloat (fabs (geocode_bounding_box_get_bottom (bbox) - bottom), <, 1e-9);
+	g_assert_cmpfloat (fabs (geocode_bounding_box_get_left (bbox) - left), <, 1e-9);
+	g_assert_cmpfloat (fabs (geocode_bounding_box_get_right (bbox) - right), <, 1e-9);
+}
+
+static void
+test_place_interned_strings (void)
+{
+	g_autoptr (GeocodePlace) a = NULL, b = NULL;
+	g_autofree char *country = g_strdup ("United Kingdom");
+
+	a = geocode_place_new ("Cambridge", GEOCODE_PLACE_TYPE_TOWN);
+	b = geocode_place_new ("Oxford", GEOCODE_PLACE_TYPE_TOWN);
+
+	geocode_place_set_country (a, "United Kingdom");
+	geocode_place_set_country (b, country);
+	geocode_place_set_country_code (a, "gb");
+	geocode_place_set_country_code (b, "GB");
+	geocode_place_set_state (a, "England");
+	geocode_place_set_state (b, "England");
+
+	/* Shared between places, and independent of the caller's copy */
+	g_assert_true (geocode_place_get_country (a) == geocode_place_get_country (b));
+	g_assert_true (geocode_place_get_country (b) != country);
+	g_assert_cmpstr (geocode_place_get_country_code (a), ==, "GB");
+	g_assert_true (geocode_place_get_country_code (a) == geocode_place_get_country_code (b));
+	g_assert_true (geocode_place_get_state (a) == geocode_place_get_state (b));
+
+	geocode_place_set_name (b, "Cambridge");
+	g_assert_true (geocode_place_equal (a, b));
+	geocode_place_set_state (b, "Cambridgeshire");
+	g_assert_false (geocode_place_equal (a, b));
+	g_assert_cmpstr (geocode_place_get_state (a), ==, "England");
+}
+
+static void
+test_coordinate (void)
+{
+	g_autoptr (GeocodeLocation) loc = NULL;
+	g_autoptr (GeocodeLocation) paris = NULL;
+	g_autoptr (GeocodeBoundingBox) europe = NULL;
+	g_autoptr (GeocodeCoordinate) copy = NULL;
+	GeocodeCoordinate coord, other, london;
+	GError *error = NULL;
+	char uri[GEOCODE_GEO_URI_BUFFER_SIZE];
+
+	geocode_coordinate_init (&coord, 48.8566, 2.3522, 25.0);
+	g_assert_cmpfloat (coord.altitude, ==, GEOCODE_LOCATION_ALTITUDE_UNKNOWN);
+	coord.altitude = 35.0;
+
+	/* Round trip through #GeocodeLocation */
+	loc = geocode_location_new_for_coordinate (&coord);
+	g_assert_cmpfloat (geocode_location_get_latitude (loc), ==, 48.8566);
+	g_assert_cmpfloat (geocode_location_get_longitude (loc), ==, 2.3522);
+	g_assert_cmpfloat (geocode_location_get_altitude (loc), ==, 35.0);
+	g_assert_cmpfloat (geocode_location_get_accuracy (loc), ==, 25.0);
+
+	memset (&other, 0, sizeof (other));
+	geocode_location_get_coordinate (loc, &other);
+	g_assert_cmpmem (&other, sizeof (other), &coord, sizeof (coord));
+
+	copy = geocode_coordinate_copy (&coord);
+	g_assert_cmpmem (copy, sizeof (*copy), &coord, sizeof (coord));
+
+	/* The same distances as for locations */
+	geocode_coordinate_init (&london, 51.5074, -0.1278, GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+	paris = geocode_location_new (48.8566, 2.3522, GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+	g_clear_object (&loc);
+	loc = geocode_location_new_for_coordinate (&london);
+	g_assert_cmpfloat (geocode_coordinate_get_distance_from (&coord, &london), ==,
+	                   geocode_location_get_distance_from (paris, loc));
+
+	europe = geocode_bounding_box_new (72.0, 35.0, -25.0, 45.0);
+	g_assert_true (geocode_bounding_box_contains_coordinate (europe, &coord));
+	coord.latitude = 80.0;
+	g_assert_false (geocode_bounding_box_contains_coordinate (europe, &coord));
+
+	/* URIs */
+	g_assert_true (geocode_coordinate_set_from_uri (&coord, "geo:1.5,-2.5;u=12", &error));
+	g_assert_no_error (error);
+	g_assert_cmpfloat (coord.latitude, ==, 1.5);
+	g_assert_cmpfloat (coord.longitude, ==, -2.5);
+	g_assert_cmpfloat (coord.altitude, ==, GEOCODE_LOCATION_ALTITUDE_UNKNOWN);
+	g_assert_cmpfloat (coord.accuracy, ==, 12.0);
+
+	g_assert_false (geocode_coordinate_set_from_uri (&coord, "geo:3,4;crs=foo", &error));
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_PARSE);
+	g_clear_error (&error);
+	g_assert_cmpfloat (coord.latitude, ==, 1.5);
+
+	g_assert_cmpuint (geocode_coordinate_format_uri (&coord, uri, sizeof (uri)), ==, strlen (uri));
+	g_assert_cmpstr (uri, ==, "geo:1.500000,-2.500000;crs=wgs84;u=12");
+}
+
+static void
+test_bounding_box_ops (void)
+{
+	g_autoptr (GeocodeBoundingBox) europe = NULL, pacific = NULL, fiji = NULL;
+	g_autoptr (GeocodeBoundingBox) samoa = NULL, bbox = NULL;
+	gdouble lats[] = { 48.8566, 48.8566, -17.7, -17.7, 0.0, 80.0 };
+	gdouble lons[] = { 2.3522, -170.0, 178.0, -179.0, 180.0, 2.0 };
+	gboolean results[G_N_ELEMENTS (lats)];
+
+	europe = geocode_bounding_box_new (72.0, 35.0, -25.0, 45.0);
+	/* Crosses the antimeridian */
+	pacific = geocode_bounding_box_new (30.0, -30.0, 160.0, -160.0);
+	fiji = geocode_bounding_box_new (-12.0, -21.0, 176.0, 180.0);
+	samoa = geocode_bounding_box_new (-13.0, -15.0, -173.0, -171.0);
+
+	g_assert_true (geocode_bounding_box_contains_point (europe, 48.8566, 2.3522));
+	g_assert_false (geocode_bounding_box_contains_point (europe, 80.0, 2.0));
+	g_assert_true (geocode_bounding_box_contains_point (pacific, -17.7, 178.0));
+	g_assert_true (geocode_bounding_box_contains_point (pacific, -17.7, -179.0));
+	g_assert_true (geocode_bounding_box_contains_point (pacific, 0.0, 180.0));
+	g_assert_false (geocode_bounding_box_contains_point (pacific, 0.0, 0.0));
+
+	g_assert_cmpuint (geocode_bounding_box_contains_points (pacific, lats, lons,
+	                                                        G_N_ELEMENTS (lats), results), ==, 3);
+	g_assert_false (results[0]);
+	g_assert_false (results[1]);
+	g_assert_true (results[2]);
+	g_assert_true (results[3]);
+	g_assert_true (results[4]);
+	g_assert_false (results[5]);
+
+	g_assert_true (geocode_bounding_box_intersects (pacific, fiji));
+	g_assert_true (geocode_bounding_box_intersects (fiji, pacific));
+	g_assert_true (geocode_bounding_box_intersects (pacific, samoa));
+	g_assert_false (geocode_bounding_box_intersects (europe, pacific));
+	g_assert_false (geocode_bounding_box_intersects (fiji, samoa));
+
+	/* Joined across the antimeridian, not round the rest of the world */
+	bbox = geocode_bounding_box_union (fiji, samoa);
+	assert_bbox (bbox, -12.0, -21.0, 176.0, -171.0);
+	g_clear_object (&bbox);
+
+	bbox = geocode_bounding_box_union (pacific, fiji);
+	assert_bbox (bbox, 30.0, -30.0, 160.0, -160.0);
+	g_clear_object (&bbox);
+
+	/* Eastwards from Europe is 214° wide; westwards would be 218° */
+	bbox = geocode_bounding_box_union (europe, samoa);
+	assert_bbox (bbox, 72.0, -15.0, -25.0, -171.0);
+	g_clear_object (&bbox);
+
+	/* 1° of latitude is about 111.2 km */
+	bbox = geocode_bounding_box_expand (samoa, 111.2);
+	g_assert_cmpfloat (fabs (geocode_bounding_box_get_top (bbox) - -12.0), <, 0.01);
+	g_assert_cmpfloat (fabs (geocode_bounding_box_get_bottom (bbox) - -16.0), <, 0.01);
+	g_assert_cmpfloat (geocode_bounding_box_get_left (bbox), <, -174.0);
+	g_assert_cmpfloat (geocode_bounding_box_get_right (bbox), >, -170.0);
+	g_clear_object (&bbox);
+
+	bbox = geocode_bounding_box_expand (fiji, 500.0);
+	g_assert_true (geocode_bounding_box_contains_point (bbox, -16.0, -176.0));
+	g_assert_cmpfloat (geocode_bounding_box_get_left (bbox), >, geocode_bounding_box_get_right (bbox));
+	g_clear_object (&bbox);
+
+	bbox = geocode_bounding_box_expand (europe, 2500.0);
+	assert_bbox (bbox, 90.0, geocode_bounding_box_get_bottom (bbox), -180.0, 180.0);
+	g_clear_object (&bbox);
+}
+
 static void
 test_locale_format (void)
 {
@@ -877,6 +1244,35 @@ test_resolve_json (void)
 	}
 }
 
+static void
+test_resolve_attributes_json (void)
+{
+	g_autoptr (GeocodeResultSet) set = NULL;
+	g_autoptr (GError) error = NULL;
+	g_autofree char *contents = NULL;
+	g_autofree gchar *filename = NULL;
+	GHashTable *attributes;
+
+	filename = g_test_build_filename (G_TEST_DIST, "rev.json", NULL);
+	g_assert_true (g_file_get_contents (filename, &contents, NULL, &error));
+
+	set = _geocode_result_set_new ();
+	attributes = _geocode_parse_resolve_json (contents, set, &error);
+	g_assert_no_error (error);
+
+	/* The attributes of the address are merged in, and the first one is
+	 * used as the name */
+	g_assert_cmpstr (g_hash_table_lookup (attributes, "osm_id"), ==, "28393339");
+	g_assert_cmpstr (g_hash_table_lookup (attributes, "name"), ==, "The Astolat");
+	g_assert_cmpstr (g_hash_table_lookup (attributes, "country_code"), ==, "gb");
+	g_assert_cmpstr (g_hash_table_lookup (attributes, "boundingbox-top"), ==, "51.2371361");
+
+	/* Strings in the same result set are stored once */
+	g_assert_true (_geocode_result_set_insert (set, "United Kingdom") ==
+	               g_hash_table_lookup (attributes, "country"));
+	g_assert_cmpstr (_geocode_result_set_insert_printf (set, "%d %s", 7, "NU"), ==, "7 NU");
+}
+
 static void
 test_search_json (void)
 {
@@ -922,6 +1318,188 @@ test_search_json (void)
 	g_free (contents);
 }
 
+static void
+test_place_json (void)
+{
+	g_autoptr (GError) error = NULL;
+	g_autofree char *contents = NULL;
+	g_autofree gchar *filename = NULL;
+	GList *list;
+
+	/* An array of results, whose names are left as they are */
+	filename = g_test_build_filename (G_TEST_DIST, "nominatim-rio.json", NULL);
+	g_assert_true (g_file_get_contents (filename, &contents, NULL, &error));
+
+	list = _geocode_parse_place_json (contents, -1, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (g_list_length (list), ==, 10);
+	g_assert_cmpstr (geocode_place_get_name (list->data), ==, "Rio de Janeiro");
+	g_assert_cmpstr (geocode_place_get_country (list->data), ==, "Brazil");
+	g_list_free_full (list, g_object_unref);
+	g_clear_pointer (&contents, g_free);
+	g_clear_pointer (&filename, g_free);
+
+	/* A single result object */
+	filename = g_test_build_filename (G_TEST_DIST, "rev.json", NULL);
+	g_assert_true (g_file_get_contents (filename, &contents, NULL, &error));
+
+	list = _geocode_parse_place_json (contents, -1, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (g_list_length (list), ==, 1);
+	g_assert_cmpstr (geocode_place_get_name (list->data), ==, "The Astolat");
+	g_assert_cmpstr (geocode_place_get_osm_id (list->data), ==, "28393339");
+	g_list_free_full (list, g_object_unref);
+
+	/* Results without coordinates are skipped */
+	list = _geocode_parse_place_json ("[{\"error\": \"Unable to geocode\"}]", -1, &error);
+	g_assert_no_error (error);
+	g_assert_null (list);
+
+	list = _geocode_parse_place_json ("[{", -1, &error);
+	g_assert_nonnull (error);
+	g_assert_null (list);
+}
+
+/* Returns a listening socket which never accepts, so that HTTP requests
+ * to it stall until they are cancelled. */
+static GSocket *
+listen_without_accepting (guint16 *port)
+{
+	g_autoptr (GError) error = NULL;
+	g_autoptr (GInetAddress) address = NULL;
+	g_autoptr (GSocketAddress) bind_address = NULL;
+	g_autoptr (GSocketAddress) local_address = NULL;
+	GSocket *socket;
+
+	socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_STREAM,
+	                       G_SOCKET_PROTOCOL_TCP, &error);
+	g_assert_no_error (error);
+
+	address = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+	bind_address = g_inet_socket_address_new (address, 0);
+	g_socket_bind (socket, bind_address, TRUE, &error);
+	g_assert_no_error (error);
+	g_socket_listen (socket, &error);
+	g_assert_no_error (error);
+
+	local_address = g_socket_get_local_address (socket, &error);
+	g_assert_no_error (error);
+	*port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (local_address));
+
+	return socket;
+}
+
+static void
+async_result_cb (GObject      *source_object,
+                 GAsyncResult *res,
+                 gpointer      user_data)
+{
+	GAsyncResult **result_out = user_data;
+
+	*result_out = g_object_ref (res);
+}
+
+static void
+test_deadline (void)
+{
+	g_autoptr (GSocket) server = NULL;
+	g_autoptr (GeocodeNominatim) backend = NULL;
+	g_autoptr (GeocodeForward) forward = NULL;
+	g_autoptr (GeocodeReverse) reverse = NULL;
+	g_autoptr (GeocodeLocation) loc = NULL;
+	g_autoptr (GAsyncResult) result = NULL;
+	g_autoptr (GError) error = NULL;
+	g_autofree gchar *base_url = NULL;
+	GeocodePlace *place;
+	GList *places;
+	guint16 port;
+	gint64 start;
+
+	set_up_cache ();
+
+	server = listen_without_accepting (&port);
+	base_url = g_strdup_printf ("http://127.0.0.1:%u", port);
+	backend = geocode_nominatim_new (base_url, "maintainer@example.com");
+
+	/* Blocking search. */
+	forward = geocode_forward_new_for_string ("Paris");
+	geocode_forward_set_backend (forward, GEOCODE_BACKEND (backend));
+	geocode_forward_set_deadline (forward, 200);
+	g_assert_cmpuint (geocode_forward_get_deadline (forward), ==, 200);
+
+	start = g_get_monotonic_time ();
+	places = geocode_forward_search (forward, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_TIMED_OUT);
+	g_assert_null (places);
+	/* Well before the backend's own timeout would have fired. */
+	g_assert_cmpint (g_get_monotonic_time () - start, <, 10 * G_USEC_PER_SEC);
+	g_clear_error (&error);
+
+	/* Asynchronous resolution. */
+	loc = geocode_location_new (51.237070, -0.589669, GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+	reverse = geocode_reverse_new_for_location (loc);
+	geocode_reverse_set_backend (reverse, GEOCODE_BACKEND (backend));
+	g_object_set (reverse, "deadline", 200, NULL);
+
+	geocode_reverse_resolve_async (reverse, NULL, async_result_cb, &result);
+	while (result == NULL)
+		g_main_context_iteration (NULL, TRUE);
+
+	place = geocode_reverse_resolve_finish (reverse, result, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_TIMED_OUT);
+	g_assert_null (place);
+}
+
+static void
+test_nominatim_stats (void)
+{
+	g_autoptr (GSocket) server = NULL;
+	g_autoptr (GeocodeNominatim) backend = NULL;
+	g_autoptr (GeocodeForward) forward = NULL;
+	g_autoptr (GeocodeStats) stats = NULL;
+	g_autoptr (GError) error = NULL;
+	g_autofree gchar *base_url = NULL;
+	GList *places;
+	guint16 port;
+	guint bucket, n_latencies = 0;
+
+	set_up_cache ();
+
+	server = listen_without_accepting (&port);
+	base_url = g_strdup_printf ("http://127.0.0.1:%u", port);
+	backend = geocode_nominatim_new (base_url, "maintainer@example.com");
+
+	forward = geocode_forward_new_for_string ("Paris");
+	geocode_forward_set_backend (forward, GEOCODE_BACKEND (backend));
+	geocode_forward_set_deadline (forward, 100);
+
+	places = geocode_forward_search (forward, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_TIMED_OUT);
+	g_assert_null (places);
+
+	/* The request was sent, but never got a response. */
+	stats = geocode_nominatim_get_stats (backend);
+	g_assert_cmpuint (geocode_stats_get_requests (stats), ==, 1);
+	g_assert_cmpuint (geocode_stats_get_cache_hits (stats), ==, 0);
+	g_assert_cmpuint (geocode_stats_get_cache_misses (stats), ==, 1);
+	g_assert_cmpuint (geocode_stats_get_status_count (stats, 0), ==, 1);
+	g_assert_cmpuint (geocode_stats_get_status_count (stats, 2), ==, 0);
+	g_assert_cmpuint (geocode_stats_get_bytes_received (stats), ==, 0);
+	g_assert_cmpuint (geocode_stats_get_parses (stats), ==, 0);
+
+	for (bucket = 0; bucket < geocode_stats_get_n_latency_buckets (stats); bucket++)
+		n_latencies += geocode_stats_get_latency_count (stats, bucket);
+	g_assert_cmpuint (n_latencies, ==, 1);
+	g_assert_cmpuint (geocode_stats_get_latency_bucket_limit (stats, 0), ==, 1000);
+	g_clear_pointer (&stats, geocode_stats_free);
+
+	geocode_nominatim_reset_stats (backend);
+	stats = geocode_nominatim_get_stats (backend);
+	g_assert_cmpuint (geocode_stats_get_requests (stats), ==, 0);
+	g_assert_cmpuint (geocode_stats_get_cache_misses (stats), ==, 0);
+	g_assert_cmpuint (geocode_stats_get_status_count (stats, 0), ==, 0);
+}
+
 static GeocodeLocation *
 new_loc (void)
 {
@@ -966,7 +1544,9 @@ int main (int argc, char **argv)
 
 	if (command_line_params == NULL) {
 		g_test_add_func ("/geocode/resolve_json", test_resolve_json);
+		g_test_add_func ("/geocode/resolve_attributes_json", test_resolve_attributes_json);
 		g_test_add_func ("/geocode/search_json", test_search_json);
+		g_test_add_func ("/geocode/place_json", test_place_json);
 		g_test_add_func ("/geocode/reverse", test_rev);
 		g_test_add_func ("/geocode/reverse_fail", test_rev_fail);
 		g_test_add_func ("/geocode/pub", test_pub);
@@ -978,7 +1558,15 @@ int main (int argc, char **argv)
 		g_test_add_func ("/geocode/search_lat_long", test_search_lat_long);
 		g_test_add_func ("/geocode/distance", test_distance);
 		g_test_add_func ("/geocode/zero_distance", test_zero_distance);
+		g_test_add_func ("/geocode/batch_distance", test_batch_distance);
+		g_test_add_func ("/geocode/distance_matrix", test_distance_matrix);
+		g_test_add_func ("/geocode/place_index", test_place_index);
+		g_test_add_func ("/geocode/place_interned_strings", test_place_interned_strings);
+		g_test_add_func ("/geocode/coordinate", test_coordinate);
+		g_test_add_func ("/geocode/bounding_box_ops", test_bounding_box_ops);
 		g_test_add_func ("/geocode/osm_type", test_osm_type);
+		g_test_add_func ("/geocode/deadline", test_deadline);
+		g_test_add_func ("/geocode/nominatim-stats", test_nominatim_stats);
 		return g_test_run ();
 	}
 
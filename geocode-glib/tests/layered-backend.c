@@ -0,0 +1,398 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include "config.h"
+
+#include <geocode-glib/geocode-glib.h>
+#include <gio/gio.h>
+#include <glib.h>
+#include <locale.h>
+
+#include "backend-test-utils.h"
+
+/* Adds a forward result for @location to @backend, with one place for each
+ * of the names which follow. */
+static void
+add_forward_result (GeocodeMockBackend *backend,
+                    const char         *location,
+                    ...) G_GNUC_NULL_TERMINATED;
+
+static void
+add_forward_result (GeocodeMockBackend *backend,
+                    const char         *location,
+                    ...)
+{
+	g_autoptr (GHashTable) params = build_location_params (location);
+	g_autoptr (PlaceList) results = NULL;
+	const char *name;
+	va_list ap;
+
+	va_start (ap, location);
+	while ((name = va_arg (ap, const char *)) != NULL)
+		results = g_list_append (results,
+		                         geocode_place_new (name, GEOCODE_PLACE_TYPE_TOWN));
+	va_end (ap);
+
+	geocode_mock_backend_add_forward_result (backend, params, results, NULL);
+}
+
+typedef struct {
+	GeocodeMockBackend *local;
+	GeocodeMockBackend *remote;
+	GeocodeLayeredBackend *backend;
+	guint n_write_backs;
+} Fixture;
+
+static void
+write_back_cb (GeocodeLayeredBackend *backend,
+               gboolean               is_forward,
+               GHashTable            *params,
+               GList                 *places,
+               gpointer               user_data)
+{
+	Fixture *fixture = user_data;
+
+	fixture->n_write_backs++;
+}
+
+static void
+fixture_set_up (Fixture       *fixture,
+                gconstpointer  user_data)
+{
+	fixture->local = geocode_mock_backend_new ();
+	fixture->remote = geocode_mock_backend_new ();
+	fixture->backend = geocode_layered_backend_new (GEOCODE_BACKEND (fixture->local),
+	                                                GEOCODE_BACKEND (fixture->remote));
+	fixture->n_write_backs = 0;
+
+	g_signal_connect (fixture->backend, "write-back",
+	                  G_CALLBACK (write_back_cb), fixture);
+
+	add_forward_result (fixture->local, "Paris", "Paris", NULL);
+	add_forward_result (fixture->remote, "Paris",
+	                    "Paris", "Paris, Texas", NULL);
+	add_forward_result (fixture->remote, "Tokyo", "Tokyo", NULL);
+}
+
+static void
+fixture_tear_down (Fixture       *fixture,
+                   gconstpointer  user_data)
+{
+	/* Run any pending write backs, which hold a reference to the
+	 * backend. */
+	while (g_main_context_iteration (NULL, FALSE));
+
+	g_clear_object (&fixture->backend);
+	g_clear_object (&fixture->local);
+	g_clear_object (&fixture->remote);
+}
+
+static GList *
+forward_search (Fixture     *fixture,
+                const char  *location,
+                GError     **error)
+{
+	g_autoptr (GHashTable) params = build_location_params (location);
+
+	return geocode_backend_forward_search (GEOCODE_BACKEND (fixture->backend),
+	                                       params, NULL, error);
+}
+
+/* Test that local answers are used without querying the remote backend. */
+static void
+test_local_hit (Fixture       *fixture,
+                gconstpointer  user_data)
+{
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	places = forward_search (fixture, "Paris", &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (places), ==, 1);
+	g_assert_cmpuint (geocode_mock_backend_get_query_log (fixture->remote)->len, ==, 0);
+}
+
+/* Test that local misses are answered by the remote backend, and the answer
+ * is written back to the local backend from the thread-default main context
+ * once a blocking query has returned. */
+static void
+test_remote_write_back (Fixture       *fixture,
+                        gconstpointer  user_data)
+{
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	places = forward_search (fixture, "Tokyo", &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (places), ==, 1);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Tokyo");
+	g_assert_cmpuint (geocode_mock_backend_get_query_log (fixture->remote)->len, ==, 1);
+	g_assert_cmpuint (fixture->n_write_backs, ==, 0);
+	g_clear_pointer (&places, place_list_free);
+
+	while (fixture->n_write_backs == 0)
+		g_main_context_iteration (NULL, TRUE);
+
+	places = forward_search (fixture, "Tokyo", &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Tokyo");
+	g_assert_cmpuint (geocode_mock_backend_get_query_log (fixture->remote)->len, ==, 1);
+}
+
+/* Test that too few local results fall through to the remote backend. */
+static void
+test_min_results (Fixture       *fixture,
+                  gconstpointer  user_data)
+{
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	geocode_layered_backend_set_min_results (fixture->backend, 2);
+	g_assert_cmpuint (geocode_layered_backend_get_min_results (fixture->backend), ==, 2);
+
+	places = forward_search (fixture, "Paris", &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (places), ==, 2);
+	g_assert_cmpuint (geocode_mock_backend_get_query_log (fixture->remote)->len, ==, 1);
+}
+
+/* Test that local results are used if the remote backend fails, and that
+ * the remote error is returned if there are none. */
+static void
+test_remote_error (Fixture       *fixture,
+                   gconstpointer  user_data)
+{
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	geocode_mock_backend_clear (fixture->remote);
+	geocode_layered_backend_set_min_results (fixture->backend, 2);
+
+	places = forward_search (fixture, "Paris", &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (places), ==, 1);
+
+	g_clear_pointer (&places, place_list_free);
+	places = forward_search (fixture, "Nowhere", &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NO_MATCHES);
+	g_assert_null (places);
+	g_assert_cmpuint (fixture->n_write_backs, ==, 0);
+}
+
+static void
+test_reverse (Fixture       *fixture,
+              gconstpointer  user_data)
+{
+	g_autoptr (GeocodeLocation) location = NULL;
+	g_autoptr (GeocodeReverse) reverse = NULL;
+	g_autoptr (GeocodePlace) place = NULL;
+	g_autoptr (GError) error = NULL;
+
+	location = geocode_location_new (48.8566, 2.3522,
+	                                 GEOCODE_LOCATION_ACCURACY_UNKNOWN);
+	reverse = geocode_reverse_new_for_location (location);
+	geocode_reverse_set_backend (reverse, GEOCODE_BACKEND (fixture->backend));
+
+	/* Neither backend has an answer, but both are asked. */
+	place = geocode_reverse_resolve (reverse, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED);
+	g_assert_null (place);
+	g_assert_cmpuint (geocode_mock_backend_get_query_log (fixture->local)->len, ==, 1);
+	g_assert_cmpuint (geocode_mock_backend_get_query_log (fixture->remote)->len, ==, 1);
+}
+
+static void
+test_async (Fixture       *fixture,
+            gconstpointer  user_data)
+{
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GAsyncResult) result = NULL;
+	g_autoptr (GError) error = NULL;
+
+	params = build_location_params ("Tokyo");
+	geocode_backend_forward_search_async (GEOCODE_BACKEND (fixture->backend),
+	                                      params, NULL, async_result_cb, &result);
+
+	while (result == NULL || fixture->n_write_backs == 0)
+		g_main_context_iteration (NULL, TRUE);
+
+	places = geocode_backend_forward_search_finish (GEOCODE_BACKEND (fixture->backend),
+	                                                result, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (places), ==, 1);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Tokyo");
+	g_clear_pointer (&places, place_list_free);
+	g_clear_object (&result);
+
+	/* The second query is answered locally. */
+	geocode_backend_forward_search_async (GEOCODE_BACKEND (fixture->backend),
+	                                      params, NULL, async_result_cb, &result);
+
+	while (result == NULL)
+		g_main_context_iteration (NULL, TRUE);
+
+	places = geocode_backend_forward_search_finish (GEOCODE_BACKEND (fixture->backend),
+	                                                result, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Tokyo");
+	g_assert_cmpuint (geocode_mock_backend_get_query_log (fixture->remote)->len, ==, 1);
+	g_assert_cmpuint (fixture->n_write_backs, ==, 1);
+}
+
+/* Test that asynchronous write backs happen in the thread-default main
+ * context of the query, rather than the global default one. */
+static void
+test_async_context (Fixture       *fixture,
+                    gconstpointer  user_data)
+{
+	g_autoptr (GMainContext) context = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GAsyncResult) result = NULL;
+	g_autoptr (GError) error = NULL;
+
+	context = g_main_context_new ();
+	g_main_context_push_thread_default (context);
+
+	params = build_location_params ("Tokyo");
+	geocode_backend_forward_search_async (GEOCODE_BACKEND (fixture->backend),
+	                                      params, NULL, async_result_cb, &result);
+
+	while (result == NULL || fixture->n_write_backs == 0)
+		g_main_context_iteration (context, TRUE);
+
+	g_main_context_pop_thread_default (context);
+
+	places = geocode_backend_forward_search_finish (GEOCODE_BACKEND (fixture->backend),
+	                                                result, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Tokyo");
+	g_assert_cmpuint (fixture->n_write_backs, ==, 1);
+	g_assert_false (g_main_context_pending (NULL));
+}
+
+static gpointer
+cancel_thread_cb (gpointer user_data)
+{
+	g_usleep (50 * 1000);
+	g_cancellable_cancel (G_CANCELLABLE (user_data));
+
+	return NULL;
+}
+
+/* Test that cancelling a query while the remote backend is answering it
+ * returns the cancellation, rather than falling back to the local places. */
+static void
+test_remote_cancelled (Fixture       *fixture,
+                       gconstpointer  user_data)
+{
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (GCancellable) cancellable = NULL;
+	GThread *thread;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	/* Paris has one local place, so it falls through to the remote
+	 * backend, which takes a minute to answer. */
+	geocode_layered_backend_set_min_results (fixture->backend, 2);
+	geocode_mock_backend_set_latency (fixture->remote,
+	                                  GEOCODE_MOCK_LATENCY_FIXED,
+	                                  60000.0, 0.0);
+	params = build_location_params ("Paris");
+	cancellable = g_cancellable_new ();
+
+	thread = g_thread_new ("cancel", cancel_thread_cb, cancellable);
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (fixture->backend),
+	                                         params, cancellable, &error);
+	g_thread_join (thread);
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_assert_null (places);
+	g_assert_cmpuint (geocode_mock_backend_get_query_log (fixture->remote)->len, ==, 1);
+	g_assert_cmpuint (fixture->n_write_backs, ==, 0);
+}
+
+static gboolean
+cancel_cb (gpointer user_data)
+{
+	g_cancellable_cancel (G_CANCELLABLE (user_data));
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+test_remote_cancelled_async (Fixture       *fixture,
+                             gconstpointer  user_data)
+{
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (GCancellable) cancellable = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GAsyncResult) result = NULL;
+	g_autoptr (GError) error = NULL;
+
+	geocode_layered_backend_set_min_results (fixture->backend, 2);
+	geocode_mock_backend_set_latency (fixture->remote,
+	                                  GEOCODE_MOCK_LATENCY_FIXED,
+	                                  60000.0, 0.0);
+	params = build_location_params ("Paris");
+	cancellable = g_cancellable_new ();
+
+	geocode_backend_forward_search_async (GEOCODE_BACKEND (fixture->backend),
+	                                      params, cancellable,
+	                                      async_result_cb, &result);
+	g_timeout_add (50, cancel_cb, cancellable);
+
+	while (result == NULL)
+		g_main_context_iteration (NULL, TRUE);
+
+	places = geocode_backend_forward_search_finish (GEOCODE_BACKEND (fixture->backend),
+	                                                result, &error);
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_assert_null (places);
+	g_assert_cmpuint (geocode_mock_backend_get_query_log (fixture->remote)->len, ==, 1);
+}
+
+int
+main (int argc, char **argv)
+{
+	setlocale (LC_ALL, "");
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add ("/layered-backend/local-hit", Fixture, NULL,
+	            fixture_set_up, test_local_hit, fixture_tear_down);
+	g_test_add ("/layered-backend/remote/write-back", Fixture, NULL,
+	            fixture_set_up, test_remote_write_back, fixture_tear_down);
+	g_test_add ("/layered-backend/remote/cancelled", Fixture, NULL,
+	            fixture_set_up, test_remote_cancelled, fixture_tear_down);
+	g_test_add ("/layered-backend/remote/cancelled-async", Fixture, NULL,
+	            fixture_set_up, test_remote_cancelled_async, fixture_tear_down);
+	g_test_add ("/layered-backend/min-results", Fixture, NULL,
+	            fixture_set_up, test_min_results, fixture_tear_down);
+	g_test_add ("/layered-backend/remote/error", Fixture, NULL,
+	            fixture_set_up, test_remote_error, fixture_tear_down);
+	g_test_add ("/layered-backend/reverse", Fixture, NULL,
+	            fixture_set_up, test_reverse, fixture_tear_down);
+	g_test_add ("/layered-backend/async", Fixture, NULL,
+	            fixture_set_up, test_async, fixture_tear_down);
+	g_test_add ("/layered-backend/async/context", Fixture, NULL,
+	            fixture_set_up, test_async_context, fixture_tear_down);
+
+	return g_test_run ();
+}
@@ -0,0 +1,519 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+/*
+ * End-to-end load test for GeocodeNominatim.
+ *
+ * Starts a SoupServer in-process which answers every request with a
+ * recorded fixture, optionally after an injected delay or with an injected
+ * HTTP 500, and points a GeocodeNominatim at it. --clients asynchronous
+ * clients then issue --requests queries between them, each client starting
+ * its next query as soon as the previous one completes.
+ *
+ * The results are printed to stdout as a single JSON object:
+ *
+ *   {"requests":1000,"clients":8,"errors":0,"elapsed-s":1.234,
+ *    "requests-per-sec":810.4,"latency-p50-ms":8.9,"latency-p99-ms":21.0,
+ *    "latency-max-ms":30.2,"cache-hits":0,"rss-kb":12345,"peak-rss-kb":23456}
+ *
+ * Queries are unique unless --distinct-queries is given, so by default
+ * every query goes through the network path. The response cache is
+ * redirected to a temporary directory which is removed on exit.
+ */
+
+#include <locale.h>
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <libsoup/soup.h>
+#include <geocode-glib/geocode-glib.h>
+
+#if SOUP_CHECK_VERSION (2, 99, 2)
+typedef SoupServerMessage ServerMessage;
+#else
+typedef SoupMessage ServerMessage;
+#endif
+
+typedef struct {
+	GMainLoop *loop;
+	GeocodeBackend *backend;
+	GRand *rand;
+
+	/* Server configuration */
+	GBytes *response;
+	guint latency;
+	guint jitter;
+	gdouble error_rate;
+
+	/* Client state */
+	gboolean reverse;
+	guint n_clients;
+	guint n_requests;
+	guint n_distinct;
+	guint n_started;
+	guint n_finished;
+	guint n_errors;
+	GArray *latencies;  /* gint64, µs */
+} LoadTest;
+
+typedef struct {
+	SoupServer *server;
+	ServerMessage *msg;
+} PausedMessage;
+
+typedef struct {
+	LoadTest *test;
+	gint64 start_time;
+} Query;
+
+static void
+server_message_set_response (ServerMessage *msg,
+                             LoadTest      *test)
+{
+	gsize size;
+	gconstpointer data;
+
+	if (test->error_rate > 0 &&
+	    g_rand_double (test->rand) < test->error_rate) {
+#if SOUP_CHECK_VERSION (2, 99, 2)
+		soup_server_message_set_status (msg, SOUP_STATUS_INTERNAL_SERVER_ERROR, NULL);
+#else
+		soup_message_set_status (msg, SOUP_STATUS_INTERNAL_SERVER_ERROR);
+#endif
+		return;
+	}
+
+	data = g_bytes_get_data (test->response, &size);
+#if SOUP_CHECK_VERSION (2, 99, 2)
+	soup_server_message_set_status (msg, SOUP_STATUS_OK, NULL);
+	soup_server_message_set_response (msg, "application/json",
+	                                  SOUP_MEMORY_STATIC, data, size);
+#else
+	soup_message_set_status (msg, SOUP_STATUS_OK);
+	soup_message_set_response (msg, "application/json",
+	                           SOUP_MEMORY_STATIC, data, size);
+#endif
+}
+
+static gboolean
+unpause_message_cb (gpointer user_data)
+{
+	PausedMessage *paused = user_data;
+
+#if SOUP_CHECK_VERSION (3, 2, 0)
+	soup_server_message_unpause (paused->msg);
+#else
+	soup_server_unpause_message (paused->server, paused->msg);
+#endif
+	g_object_unref (paused->msg);
+	g_object_unref (paused->server);
+	g_free (paused);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+server_handle_message (SoupServer    *server,
+                       ServerMessage *msg,
+                       LoadTest      *test)
+{
+	PausedMessage *paused;
+	guint delay;
+
+	server_message_set_response (msg, test);
+
+	delay = test->latency;
+	if (test->jitter > 0)
+		delay += g_rand_int_range (test->rand, 0, test->jitter + 1);
+	if (delay == 0)
+		return;
+
+	paused = g_new0 (PausedMessage, 1);
+	paused->server = g_object_ref (server);
+	paused->msg = g_object_ref (msg);
+#if SOUP_CHECK_VERSION (3, 2, 0)
+	soup_server_message_pause (msg);
+#else
+	soup_server_pause_message (server, msg);
+#endif
+	g_timeout_add (delay, unpause_message_cb, paused);
+}
+
+#if SOUP_CHECK_VERSION (2, 99, 2)
+static void
+server_cb (SoupServer        *server,
+           SoupServerMessage *msg,
+           const char        *path,
+           GHashTable        *query,
+           gpointer           user_data)
+{
+	server_handle_message (server, msg, user_data);
+}
+#else
+static void
+server_cb (SoupServer        *server,
+           SoupMessage       *msg,
+           const char        *path,
+           GHashTable        *query,
+           SoupClientContext *client,
+           gpointer           user_data)
+{
+	server_handle_message (server, msg, user_data);
+}
+#endif
+
+static char *
+server_get_base_url (SoupServer *server)
+{
+	GSList *uris;
+	char *base_url;
+
+	uris = soup_server_get_uris (server);
+	g_assert (uris != NULL);
+#if SOUP_CHECK_VERSION (2, 99, 2)
+	base_url = g_uri_to_string (uris->data);
+	g_slist_free_full (uris, (GDestroyNotify) g_uri_unref);
+#else
+	base_url = soup_uri_to_string (uris->data, FALSE);
+	g_slist_free_full (uris, (GDestroyNotify) soup_uri_free);
+#endif
+
+	/* Nominatim appends “/search” and “/reverse” itself */
+	if (g_str_has_suffix (base_url, "/"))
+		base_url[strlen (base_url) - 1] = '\0';
+
+	return base_url;
+}
+
+static void
+free_value (GValue *value)
+{
+	g_value_unset (value);
+	g_free (value);
+}
+
+static GHashTable *
+build_params (LoadTest *test,
+              guint     n)
+{
+	GHashTable *params;
+	GValue *value;
+
+	if (test->n_distinct > 0)
+		n %= test->n_distinct;
+
+	params = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+	                                (GDestroyNotify) free_value);
+
+	if (test->reverse) {
+		value = g_new0 (GValue, 1);
+		g_value_init (value, G_TYPE_DOUBLE);
+		g_value_set_double (value, -90.0 + (n % 1800000) * 1e-4);
+		g_hash_table_insert (params, (gpointer) "lat", value);
+
+		value = g_new0 (GValue, 1);
+		g_value_init (value, G_TYPE_DOUBLE);
+		g_value_set_double (value, (gdouble) ((n / 1800000) % 360) - 180.0);
+		g_hash_table_insert (params, (gpointer) "lon", value);
+	} else {
+		value = g_new0 (GValue, 1);
+		g_value_init (value, G_TYPE_STRING);
+		g_value_take_string (value, g_strdup_printf ("Load test query %u", n));
+		g_hash_table_insert (params, (gpointer) "location", value);
+	}
+
+	return params;
+}
+
+static void start_query (LoadTest *test);
+
+static void
+query_done_cb (GObject      *source_object,
+               GAsyncResult *result,
+               gpointer      user_data)
+{
+	Query *query = user_data;
+	LoadTest *test = query->test;
+	GList *places;
+	GError *error = NULL;
+	gint64 latency;
+
+	if (test->reverse)
+		places = geocode_backend_reverse_resolve_finish (test->backend, result, &error);
+	else
+		places = geocode_backend_forward_search_finish (test->backend, result, &error);
+
+	latency = g_get_monotonic_time () - query->start_time;
+	g_free (query);
+	g_array_append_val (test->latencies, latency);
+
+	if (places == NULL) {
+		g_debug ("Query failed: %s", error->message);
+		test->n_errors++;
+		g_error_free (error);
+	}
+	g_list_free_full (places, g_object_unref);
+
+	test->n_finished++;
+	if (test->n_started < test->n_requests)
+		start_query (test);
+	else if (test->n_finished == test->n_requests)
+		g_main_loop_quit (test->loop);
+}
+
+static void
+start_query (LoadTest *test)
+{
+	GHashTable *params;
+	Query *query;
+
+	params = build_params (test, test->n_started++);
+	query = g_new (Query, 1);
+	query->test = test;
+	query->start_time = g_get_monotonic_time ();
+
+	if (test->reverse)
+		geocode_backend_reverse_resolve_async (test->backend, params, NULL,
+		                                       query_done_cb, query);
+	else
+		geocode_backend_forward_search_async (test->backend, params, NULL,
+		                                      query_done_cb, query);
+
+	g_hash_table_unref (params);
+}
+
+static gint
+compare_int64 (gconstpointer a,
+               gconstpointer b)
+{
+	gint64 x = *(const gint64 *) a;
+	gint64 y = *(const gint64 *) b;
+
+	return (x > y) - (x < y);
+}
+
+static gdouble
+percentile_ms (GArray  *sorted,
+               gdouble  percentile)
+{
+	guint index;
+
+	if (sorted->len == 0)
+		return 0;
+
+	index = (guint) (percentile / 100.0 * (sorted->len - 1) + 0.5);
+	return g_array_index (sorted, gint64, index) / 1000.0;
+}
+
+/* Returns the value in kB of the given field of /proc/self/status, or -1
+ * where that is not available. */
+static gint64
+read_proc_status_kb (const char *field)
+{
+	g_autofree char *contents = NULL;
+	g_auto(GStrv) lines = NULL;
+	gsize field_len = strlen (field);
+	guint i;
+
+	if (!g_file_get_contents ("/proc/self/status", &contents, NULL, NULL))
+		return -1;
+
+	lines = g_strsplit (contents, "\n", -1);
+	for (i = 0; lines[i] != NULL; i++) {
+		if (strncmp (lines[i], field, field_len) == 0 &&
+		    lines[i][field_len] == ':')
+			return g_ascii_strtoll (lines[i] + field_len + 1, NULL, 10);
+	}
+
+	return -1;
+}
+
+static void
+print_kb (const char *name,
+          gint64      kb)
+{
+	if (kb < 0)
+		printf (",\"%s\":null", name);
+	else
+		printf (",\"%s\":%" G_GINT64_FORMAT, name, kb);
+}
+
+static void
+remove_cache_dir (const char *path)
+{
+	GDir *dir;
+	const char *name;
+
+	dir = g_dir_open (path, 0, NULL);
+	if (dir == NULL)
+		return;
+
+	while ((name = g_dir_read_name (dir)) != NULL) {
+		g_autofree char *child = g_build_filename (path, name, NULL);
+
+		if (g_file_test (child, G_FILE_TEST_IS_DIR))
+			remove_cache_dir (child);
+		else
+			g_unlink (child);
+	}
+	g_dir_close (dir);
+	g_rmdir (path);
+}
+
+int
+main (int argc, char **argv)
+{
+	LoadTest test = { 0, };
+	GOptionContext *context;
+	GError *error = NULL;
+	SoupServer *server;
+	g_autofree char *base_url = NULL;
+	g_autofree char *cache_dir = NULL;
+	g_autofree char *fixture = NULL;
+	g_autofree char *fixture_path = NULL;
+	g_autoptr(GeocodeStats) stats = NULL;
+	const char *srcdir;
+	char *contents;
+	gsize length;
+	gint seed = 0;
+	gint clients = 8, requests = 1000, latency = 0, jitter = 0, distinct = 0;
+	gint64 start, elapsed;
+	guint i;
+	const GOptionEntry entries[] = {
+		{ "clients", 'c', 0, G_OPTION_ARG_INT, &clients,
+		  "Number of concurrent clients (default: 8)", "N" },
+		{ "requests", 'n', 0, G_OPTION_ARG_INT, &requests,
+		  "Total number of requests (default: 1000)", "N" },
+		{ "reverse", 'r', 0, G_OPTION_ARG_NONE, &test.reverse,
+		  "Issue reverse geocoding queries rather than forward searches", NULL },
+		{ "fixture", 'F', 0, G_OPTION_ARG_FILENAME, &fixture,
+		  "Response to serve (default: search.json, or rev.json with --reverse)", "FILE" },
+		{ "latency", 'l', 0, G_OPTION_ARG_INT, &latency,
+		  "Server latency to inject, in milliseconds", "MS" },
+		{ "jitter", 'j', 0, G_OPTION_ARG_INT, &jitter,
+		  "Random extra latency of up to MS milliseconds", "MS" },
+		{ "error-rate", 'e', 0, G_OPTION_ARG_DOUBLE, &test.error_rate,
+		  "Fraction of requests to answer with HTTP 500", "RATE" },
+		{ "distinct-queries", 'd', 0, G_OPTION_ARG_INT, &distinct,
+		  "Cycle through N distinct queries, so repeats can hit the cache (default: all distinct)", "N" },
+		{ "seed", 's', 0, G_OPTION_ARG_INT, &seed,
+		  "Seed for latency jitter and error injection", "SEED" },
+		{ NULL }
+	};
+
+	setlocale (LC_ALL, "");
+
+	context = g_option_context_new ("- load test GeocodeNominatim against a local server");
+	g_option_context_add_main_entries (context, entries, NULL);
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_printerr ("%s\n", error->message);
+		return 1;
+	}
+	g_option_context_free (context);
+
+	if (clients <= 0 || requests <= 0 || latency < 0 || jitter < 0 || distinct < 0) {
+		g_printerr ("--clients and --requests must be positive; "
+		            "--latency, --jitter and --distinct-queries must not be negative\n");
+		return 1;
+	}
+
+	/* Keep the JSON output machine-readable whatever the locale */
+	setlocale (LC_NUMERIC, "C");
+
+	/* Must be set before anything calls g_get_user_cache_dir() */
+	cache_dir = g_dir_make_tmp ("geocode-load-test-XXXXXX", &error);
+	if (cache_dir == NULL) {
+		g_printerr ("Failed to create cache directory: %s\n", error->message);
+		return 1;
+	}
+	g_setenv ("XDG_CACHE_HOME", cache_dir, TRUE);
+
+	if (fixture == NULL)
+		fixture = g_strdup (test.reverse ? "rev.json" : "search.json");
+	srcdir = g_getenv ("G_TEST_SRCDIR");
+	if (g_path_is_absolute (fixture) || srcdir == NULL)
+		fixture_path = g_strdup (fixture);
+	else
+		fixture_path = g_build_filename (srcdir, fixture, NULL);
+	if (!g_file_get_contents (fixture_path, &contents, &length, &error)) {
+		g_printerr ("Couldn't load contents of '%s': %s\n",
+		            fixture_path, error->message);
+		remove_cache_dir (cache_dir);
+		return 1;
+	}
+	test.response = g_bytes_new_take (contents, length);
+
+	test.latency = latency;
+	test.jitter = jitter;
+	test.n_clients = clients;
+	test.n_requests = requests;
+	test.n_distinct = distinct;
+	test.rand = g_rand_new_with_seed (seed);
+	test.latencies = g_array_sized_new (FALSE, FALSE, sizeof (gint64), requests);
+	test.loop = g_main_loop_new (NULL, FALSE);
+
+	server = soup_server_new ("server-header", "geocode-load-test ", NULL);
+	soup_server_add_handler (server, NULL, server_cb, &test, NULL);
+	if (!soup_server_listen_local (server, 0, SOUP_SERVER_LISTEN_IPV4_ONLY, &error)) {
+		g_printerr ("Failed to start server: %s\n", error->message);
+		remove_cache_dir (cache_dir);
+		return 1;
+	}
+	base_url = server_get_base_url (server);
+
+	test.backend = GEOCODE_BACKEND (geocode_nominatim_new (base_url,
+	                                                        "load-test@example.com"));
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < test.n_clients && test.n_started < test.n_requests; i++)
+		start_query (&test);
+	g_main_loop_run (test.loop);
+	elapsed = g_get_monotonic_time () - start;
+
+	stats = geocode_nominatim_get_stats (GEOCODE_NOMINATIM (test.backend));
+	g_array_sort (test.latencies, compare_int64);
+
+	printf ("{\"requests\":%u,\"clients\":%u,\"errors\":%u,"
+	        "\"elapsed-s\":%.3f,\"requests-per-sec\":%.1f,"
+	        "\"latency-p50-ms\":%.3f,\"latency-p99-ms\":%.3f,"
+	        "\"latency-max-ms\":%.3f,\"cache-hits\":%u",
+	        test.n_requests, test.n_clients, test.n_errors,
+	        elapsed / (gdouble) G_USEC_PER_SEC,
+	        test.n_requests * (gdouble) G_USEC_PER_SEC / MAX (elapsed, 1),
+	        percentile_ms (test.latencies, 50),
+	        percentile_ms (test.latencies, 99),
+	        percentile_ms (test.latencies, 100),
+	        geocode_stats_get_cache_hits (stats));
+	print_kb ("rss-kb", read_proc_status_kb ("VmRSS"));
+	print_kb ("peak-rss-kb", read_proc_status_kb ("VmHWM"));
+	printf ("}\n");
+
+	g_object_unref (test.backend);
+	soup_server_disconnect (server);
+	g_object_unref (server);
+	g_main_loop_unref (test.loop);
+	g_array_unref (test.latencies);
+	g_rand_free (test.rand);
+	g_bytes_unref (test.response);
+	remove_cache_dir (cache_dir);
+
+	return 0;
+}
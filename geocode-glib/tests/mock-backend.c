@@ -415,6 +415,47 @@ test_reverse_single_result (void)
 	g_assert_cmpuint (query_log->len, ==, 1);
 }
 
+/* Test that a #GeocodeReverse created for a #GeocodeCoordinate queries the
+ * backend with the same parameters as one created for a #GeocodeLocation. */
+static void
+test_reverse_coordinate (void)
+{
+	g_autoptr (GeocodeReverse) reverse = NULL;
+	g_autoptr (GeocodeMockBackend) backend = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (GeocodePlace) result = NULL;
+	g_autoptr (PlaceList) expected_results = NULL;
+	g_autoptr (GError) error = NULL;
+	g_autoptr (GeocodeLocation) expected_location = NULL;
+	GeocodeCoordinate coord;
+
+	backend = geocode_mock_backend_new ();
+
+	geocode_coordinate_init (&coord, 52.2127749, 0.0806149693681216, 10.0);
+	reverse = geocode_reverse_new_for_coordinate (&coord);
+	geocode_reverse_set_backend (reverse, GEOCODE_BACKEND (backend));
+
+	params = build_double_params ("lat", 52.2127749,
+	                              "lon", 0.0806149693681216,
+	                              NULL);
+
+	expected_location = geocode_location_new_with_description (
+	    52.2127749, 0.0806149693681216, 10.0, "British Antarctic Survey");
+	expected_results = g_list_prepend (expected_results,
+	                                   geocode_place_new_with_location (
+	                                       "British Antarctic Survey",
+	                                       GEOCODE_PLACE_TYPE_BUILDING,
+	                                       expected_location));
+
+	geocode_mock_backend_add_reverse_result (backend, params,
+	                                         expected_results, NULL);
+
+	result = geocode_reverse_resolve (reverse, &error);
+
+	g_assert_no_error (error);
+	g_assert_true (geocode_place_equal (result, expected_results->data));
+}
+
 /* Test that a #GeocodeReverse query with multiple results from the mock backend
  * works. This has to be done by testing the backend directly, since
  * #GeocodeReverse does not support multiple results. */
@@ -623,6 +664,463 @@ test_clear (void)
 	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NO_MATCHES);
 }
 
+/* Test that results are found among many others, whatever order their
+ * params are inserted in. */
+static void
+test_many_results (void)
+{
+	g_autoptr (GeocodeMockBackend) backend = NULL;
+	const guint n_results = 10000;
+	guint i;
+
+	backend = geocode_mock_backend_new ();
+
+	for (i = 0; i < n_results; i++) {
+		g_autoptr (GHashTable) params = NULL;
+		g_autoptr (GeocodePlace) place = NULL;
+		g_autoptr (PlaceList) results = NULL;
+		g_autofree gchar *name = g_strdup_printf ("Place %u", i);
+
+		params = build_params ("location", name, "limit", "1", NULL);
+		place = geocode_place_new (name, GEOCODE_PLACE_TYPE_TOWN);
+		results = g_list_prepend (NULL, g_steal_pointer (&place));
+
+		geocode_mock_backend_add_forward_result (backend, params,
+		                                         results, NULL);
+	}
+
+	for (i = 0; i < n_results; i += 97) {
+		g_autoptr (GHashTable) params = NULL;
+		g_autoptr (PlaceList) results = NULL;
+		g_autoptr (GError) error = NULL;
+		g_autofree gchar *name = g_strdup_printf ("Place %u", i);
+
+		params = build_params ("limit", "1", "location", name, NULL);
+		results = geocode_backend_forward_search (GEOCODE_BACKEND (backend),
+		                                          params, NULL, &error);
+		g_assert_no_error (error);
+		g_assert_cmpuint (g_list_length (results), ==, 1);
+		g_assert_cmpstr (geocode_place_get_name (results->data), ==, name);
+	}
+}
+
+/* Test that adding a result for equal params replaces the old one, and that
+ * params differing only in the sign of zero are equal. */
+static void
+test_replace_result (void)
+{
+	g_autoptr (GeocodeMockBackend) backend = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (GHashTable) params_negative_zero = NULL;
+	g_autoptr (GeocodePlace) first = NULL;
+	g_autoptr (GeocodePlace) second = NULL;
+	g_autoptr (PlaceList) first_results = NULL;
+	g_autoptr (PlaceList) second_results = NULL;
+	g_autoptr (PlaceList) results = NULL;
+	g_autoptr (GError) error = NULL;
+
+	backend = geocode_mock_backend_new ();
+	params = build_double_params ("lat", 0.0, "lon", 10.0, NULL);
+	params_negative_zero = build_double_params ("lat", -0.0, "lon", 10.0, NULL);
+
+	first = geocode_place_new ("First", GEOCODE_PLACE_TYPE_TOWN);
+	first_results = g_list_prepend (NULL, g_object_ref (first));
+	geocode_mock_backend_add_reverse_result (backend, params,
+	                                         first_results, NULL);
+
+	second = geocode_place_new ("Second", GEOCODE_PLACE_TYPE_TOWN);
+	second_results = g_list_prepend (NULL, g_object_ref (second));
+	geocode_mock_backend_add_reverse_result (backend, params_negative_zero,
+	                                         second_results, NULL);
+
+	results = geocode_backend_reverse_resolve (GEOCODE_BACKEND (backend),
+	                                           params, NULL, &error);
+	g_assert_no_error (error);
+	assert_place_list_equal (results, second_results);
+}
+
+static void
+async_result_cb (GObject      *source_object,
+                 GAsyncResult *res,
+                 gpointer      user_data)
+{
+	GAsyncResult **result_out = user_data;
+
+	*result_out = g_object_ref (res);
+}
+
+static gboolean
+cancel_cb (gpointer user_data)
+{
+	g_cancellable_cancel (G_CANCELLABLE (user_data));
+
+	return G_SOURCE_REMOVE;
+}
+
+/* Runs an asynchronous forward search on @backend and waits for it, while
+ * other sources in the thread-default main context are dispatched. */
+static GList *
+forward_search_async (GeocodeMockBackend  *backend,
+                      GHashTable          *params,
+                      GCancellable        *cancellable,
+                      GError             **error)
+{
+	g_autoptr (GAsyncResult) result = NULL;
+
+	geocode_backend_forward_search_async (GEOCODE_BACKEND (backend), params,
+	                                      cancellable, async_result_cb,
+	                                      &result);
+
+	while (result == NULL)
+		g_main_context_iteration (NULL, TRUE);
+
+	return geocode_backend_forward_search_finish (GEOCODE_BACKEND (backend),
+	                                              result, error);
+}
+
+/* Adds a single place called @name as the result for @params. */
+static void
+add_forward_place (GeocodeMockBackend *backend,
+                   GHashTable         *params,
+                   const gchar        *name)
+{
+	g_autoptr (PlaceList) results = NULL;
+
+	results = g_list_prepend (NULL, geocode_place_new (name, GEOCODE_PLACE_TYPE_TOWN));
+	geocode_mock_backend_add_forward_result (backend, params, results, NULL);
+}
+
+typedef struct {
+	GAsyncResult *result;  /* (owned) (nullable) */
+	gint64 start_time;
+	gint64 end_time;
+} TimedQuery;
+
+static void
+timed_query_cb (GObject      *source_object,
+                GAsyncResult *res,
+                gpointer      user_data)
+{
+	TimedQuery *query = user_data;
+
+	query->end_time = g_get_monotonic_time ();
+	query->result = g_object_ref (res);
+}
+
+/* Test that a fixed latency delays both synchronous and asynchronous
+ * queries, and that several asynchronous queries wait concurrently. */
+static void
+test_latency_fixed (void)
+{
+	g_autoptr (GeocodeMockBackend) backend = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (PlaceList) results = NULL;
+	TimedQuery queries[2] = { { NULL, 0, 0 }, };
+	g_autoptr (GError) error = NULL;
+	gint64 start_time;
+	gsize i;
+
+	backend = geocode_mock_backend_new ();
+	params = build_params ("location", "Bullpot Farm", NULL);
+	add_forward_place (backend, params, "Bullpot Farm");
+	geocode_mock_backend_set_latency (backend, GEOCODE_MOCK_LATENCY_FIXED,
+	                                  200.0, 0.0);
+
+	start_time = g_get_monotonic_time ();
+	results = geocode_backend_forward_search (GEOCODE_BACKEND (backend),
+	                                          params, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (results), ==, 1);
+	g_assert_cmpint (g_get_monotonic_time () - start_time, >=, 200 * 1000);
+	g_clear_pointer (&results, place_list_free);
+
+	start_time = g_get_monotonic_time ();
+	results = forward_search_async (backend, params, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (results), ==, 1);
+	g_assert_cmpint (g_get_monotonic_time () - start_time, >=, 200 * 1000);
+	g_clear_pointer (&results, place_list_free);
+
+	/* Both queries wait in the same main context at the same time: the
+	 * second one starts before the first one has been answered. */
+	for (i = 0; i < G_N_ELEMENTS (queries); i++) {
+		queries[i].start_time = g_get_monotonic_time ();
+		geocode_backend_forward_search_async (GEOCODE_BACKEND (backend),
+		                                      params, NULL,
+		                                      timed_query_cb, &queries[i]);
+	}
+
+	while (queries[0].result == NULL || queries[1].result == NULL)
+		g_main_context_iteration (NULL, TRUE);
+
+	g_assert_cmpint (queries[1].start_time, <, queries[0].end_time);
+
+	for (i = 0; i < G_N_ELEMENTS (queries); i++) {
+		g_assert_cmpint (queries[i].end_time - queries[i].start_time, >=, 200 * 1000);
+
+		results = geocode_backend_forward_search_finish (GEOCODE_BACKEND (backend),
+		                                                 queries[i].result, &error);
+		g_assert_no_error (error);
+		g_assert_cmpuint (g_list_length (results), ==, 1);
+		g_clear_pointer (&results, place_list_free);
+		g_clear_object (&queries[i].result);
+	}
+}
+
+/* Test that slow queries return as soon as they are cancelled. */
+static void
+test_latency_cancel (void)
+{
+	g_autoptr (GeocodeMockBackend) backend = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (GCancellable) cancellable = NULL;
+	g_autoptr (PlaceList) results = NULL;
+	g_autoptr (GError) error = NULL;
+	gint64 start_time;
+
+	backend = geocode_mock_backend_new ();
+	params = build_params ("location", "Bullpot Farm", NULL);
+	add_forward_place (backend, params, "Bullpot Farm");
+	geocode_mock_backend_set_latency (backend, GEOCODE_MOCK_LATENCY_FIXED,
+	                                  60000.0, 0.0);
+
+	cancellable = g_cancellable_new ();
+	g_timeout_add (10, cancel_cb, cancellable);
+
+	start_time = g_get_monotonic_time ();
+	results = forward_search_async (backend, params, cancellable, &error);
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_assert_null (results);
+	g_assert_cmpint (g_get_monotonic_time () - start_time, <, 5 * G_USEC_PER_SEC);
+	g_clear_error (&error);
+
+	/* The synchronous query is already cancelled, so it must not wait. */
+	start_time = g_get_monotonic_time ();
+	results = geocode_backend_forward_search (GEOCODE_BACKEND (backend),
+	                                          params, cancellable, &error);
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_assert_null (results);
+	g_assert_cmpint (g_get_monotonic_time () - start_time, <, 5 * G_USEC_PER_SEC);
+}
+
+/* Test that a per-query latency overrides the latency distribution. */
+static void
+test_latency_query (void)
+{
+	g_autoptr (GeocodeMockBackend) backend = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (PlaceList) results = NULL;
+	g_autoptr (GError) error = NULL;
+	gint64 start_time;
+
+	backend = geocode_mock_backend_new ();
+	params = build_params ("location", "Bullpot Farm", NULL);
+	add_forward_place (backend, params, "Bullpot Farm");
+	geocode_mock_backend_set_latency (backend, GEOCODE_MOCK_LATENCY_LOG_NORMAL,
+	                                  60000.0, 1.0);
+	geocode_mock_backend_set_jitter (backend, 1000.0);
+	geocode_mock_backend_set_query_latency (backend, params, 0.0);
+
+	start_time = g_get_monotonic_time ();
+	results = geocode_backend_forward_search (GEOCODE_BACKEND (backend),
+	                                          params, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (results), ==, 1);
+	g_clear_pointer (&results, place_list_free);
+
+	results = forward_search_async (backend, params, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (results), ==, 1);
+	g_assert_cmpint (g_get_monotonic_time () - start_time, <, 5 * G_USEC_PER_SEC);
+}
+
+/* Test that the error rate controls how many queries fail, and that
+ * failures are logged. */
+static void
+test_error_rate (void)
+{
+	g_autoptr (GeocodeMockBackend) backend = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (GError) injected_error = NULL;
+	GPtrArray *query_log;  /* (element-type GeocodeMockBackendQuery) */
+	const GeocodeMockBackendQuery *query;
+	guint i, n_failures;
+
+	backend = geocode_mock_backend_new ();
+	geocode_mock_backend_set_seed (backend, 42);
+	params = build_params ("location", "Bullpot Farm", NULL);
+	add_forward_place (backend, params, "Bullpot Farm");
+
+	/* Every query fails, with the given error. */
+	injected_error = g_error_new (GEOCODE_ERROR, GEOCODE_ERROR_TIMED_OUT,
+	                              "Timed out");
+	geocode_mock_backend_set_error_rate (backend, 1.0, injected_error);
+
+	for (i = 0; i < 10; i++) {
+		g_autoptr (PlaceList) results = NULL;
+		g_autoptr (GError) error = NULL;
+
+		results = geocode_backend_forward_search (GEOCODE_BACKEND (backend),
+		                                          params, NULL, &error);
+		g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_TIMED_OUT);
+		g_assert_null (results);
+	}
+
+	query_log = geocode_mock_backend_get_query_log (backend);
+	g_assert_cmpuint (query_log->len, ==, 10);
+	query = (const GeocodeMockBackendQuery *) query_log->pdata[0];
+	g_assert_error (query->error, GEOCODE_ERROR, GEOCODE_ERROR_TIMED_OUT);
+	g_assert_null (query->results);
+
+	/* No query fails. */
+	geocode_mock_backend_set_error_rate (backend, 0.0, NULL);
+
+	for (i = 0; i < 10; i++) {
+		g_autoptr (PlaceList) results = NULL;
+		g_autoptr (GError) error = NULL;
+
+		results = geocode_backend_forward_search (GEOCODE_BACKEND (backend),
+		                                          params, NULL, &error);
+		g_assert_no_error (error);
+		g_assert_cmpuint (g_list_length (results), ==, 1);
+	}
+
+	/* About half fail, with the default error. */
+	geocode_mock_backend_set_error_rate (backend, 0.5, NULL);
+
+	for (i = 0, n_failures = 0; i < 1000; i++) {
+		g_autoptr (PlaceList) results = NULL;
+		g_autoptr (GError) error = NULL;
+
+		results = geocode_backend_forward_search (GEOCODE_BACKEND (backend),
+		                                          params, NULL, &error);
+
+		if (error != NULL) {
+			g_assert_error (error, GEOCODE_ERROR,
+			                GEOCODE_ERROR_INTERNAL_SERVER);
+			n_failures++;
+		}
+	}
+
+	g_assert_cmpuint (n_failures, >, 400);
+	g_assert_cmpuint (n_failures, <, 600);
+}
+
+/* Runs a forward search for a single place called @name. */
+static void
+search_for_name (GeocodeMockBackend *backend,
+                 const gchar        *name)
+{
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (PlaceList) results = NULL;
+	g_autoptr (GError) error = NULL;
+
+	params = build_params ("location", name, NULL);
+	results = geocode_backend_forward_search (GEOCODE_BACKEND (backend),
+	                                          params, NULL, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NO_MATCHES);
+}
+
+static void
+assert_query_log_names (GeocodeMockBackend  *backend,
+                        const gchar * const *names)
+{
+	GPtrArray *query_log;  /* (element-type GeocodeMockBackendQuery) */
+	guint i;
+
+	query_log = geocode_mock_backend_get_query_log (backend);
+	g_assert_cmpuint (query_log->len, ==, g_strv_length ((gchar **) names));
+
+	for (i = 0; i < query_log->len; i++) {
+		const GeocodeMockBackendQuery *query = query_log->pdata[i];
+		const GValue *location;
+
+		location = g_hash_table_lookup (query->params, "location");
+		g_assert_cmpstr (g_value_get_string (location), ==, names[i]);
+	}
+}
+
+/* Test that a bounded query log keeps the most recent queries, in order. */
+static void
+test_query_log_capacity (void)
+{
+	g_autoptr (GeocodeMockBackend) backend = NULL;
+	const gchar * const first_three[] = { "A", "B", "C", NULL };
+	const gchar * const last_three[] = { "C", "D", "E", NULL };
+	const gchar * const last_two[] = { "E", "F", NULL };
+	const gchar * const last_four[] = { "E", "F", "G", "H", NULL };
+
+	backend = geocode_mock_backend_new ();
+	g_assert_cmpuint (geocode_mock_backend_get_query_log_capacity (backend), ==, G_MAXUINT);
+
+	geocode_mock_backend_set_query_log_capacity (backend, 3);
+	g_assert_cmpuint (geocode_mock_backend_get_query_log_capacity (backend), ==, 3);
+
+	search_for_name (backend, "A");
+	search_for_name (backend, "B");
+	search_for_name (backend, "C");
+	assert_query_log_names (backend, first_three);
+
+	search_for_name (backend, "D");
+	search_for_name (backend, "E");
+	assert_query_log_names (backend, last_three);
+
+	/* Shrinking the log drops the oldest queries. */
+	search_for_name (backend, "F");
+	geocode_mock_backend_set_query_log_capacity (backend, 2);
+	assert_query_log_names (backend, last_two);
+
+	/* Growing it keeps the order. */
+	geocode_mock_backend_set_query_log_capacity (backend, 4);
+	search_for_name (backend, "G");
+	search_for_name (backend, "H");
+	assert_query_log_names (backend, last_four);
+}
+
+/* Test that queries are only counted when the query log capacity is 0. */
+static void
+test_query_log_stats (void)
+{
+	g_autoptr (GeocodeMockBackend) backend = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (GeocodeStats) stats = NULL;
+	GPtrArray *query_log;  /* (element-type GeocodeMockBackendQuery) */
+	guint i;
+
+	backend = geocode_mock_backend_new ();
+	geocode_mock_backend_set_query_log_capacity (backend, 0);
+
+	params = build_params ("location", "Bullpot Farm", NULL);
+	add_forward_place (backend, params, "Bullpot Farm");
+
+	for (i = 0; i < 100; i++) {
+		g_autoptr (PlaceList) results = NULL;
+		g_autoptr (GError) error = NULL;
+
+		results = geocode_backend_forward_search (GEOCODE_BACKEND (backend),
+		                                          params, NULL, &error);
+		g_assert_no_error (error);
+	}
+
+	search_for_name (backend, "Nowhere");
+
+	query_log = geocode_mock_backend_get_query_log (backend);
+	g_assert_cmpuint (query_log->len, ==, 0);
+
+	stats = geocode_mock_backend_get_stats (backend);
+	g_assert_cmpuint (geocode_stats_get_requests (stats), ==, 101);
+	g_assert_cmpuint (geocode_stats_get_cache_hits (stats), ==, 100);
+	g_assert_cmpuint (geocode_stats_get_cache_misses (stats), ==, 1);
+	g_assert_cmpuint (geocode_stats_get_status_count (stats, 2), ==, 100);
+	g_assert_cmpuint (geocode_stats_get_status_count (stats, 0), ==, 1);
+	g_assert_cmpuint (geocode_stats_get_latency_count (stats, 0), ==, 101);
+	g_clear_pointer (&stats, geocode_stats_free);
+
+	geocode_mock_backend_clear (backend);
+	stats = geocode_mock_backend_get_stats (backend);
+	g_assert_cmpuint (geocode_stats_get_requests (stats), ==, 0);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -642,6 +1140,8 @@ main (int argc, char **argv)
 
 	g_test_add_func ("/mock-backend/reverse-single-result",
 	                 test_reverse_single_result);
+	g_test_add_func ("/mock-backend/reverse-coordinate",
+	                 test_reverse_coordinate);
 	g_test_add_func ("/mock-backend/reverse-multiple-results",
 	                 test_reverse_multiple_results);
 	g_test_add_func ("/mock-backend/reverse-no-results",
@@ -649,6 +1149,17 @@ main (int argc, char **argv)
 	g_test_add_func ("/mock-backend/reverse-error", test_reverse_error);
 
 	g_test_add_func ("/mock-backend/clear", test_clear);
+	g_test_add_func ("/mock-backend/many-results", test_many_results);
+	g_test_add_func ("/mock-backend/replace-result", test_replace_result);
+
+	g_test_add_func ("/mock-backend/latency/fixed", test_latency_fixed);
+	g_test_add_func ("/mock-backend/latency/cancel", test_latency_cancel);
+	g_test_add_func ("/mock-backend/latency/query", test_latency_query);
+	g_test_add_func ("/mock-backend/error-rate", test_error_rate);
+
+	g_test_add_func ("/mock-backend/query-log/capacity",
+	                 test_query_log_capacity);
+	g_test_add_func ("/mock-backend/query-log/stats", test_query_log_stats);
 
 	return g_test_run ();
 }
@@ -0,0 +1,549 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include "config.h"
+
+#include <geocode-glib/geocode-glib.h>
+#include <gio/gio.h>
+#include <glib.h>
+#include <locale.h>
+
+#include "backend-test-utils.h"
+
+/* A backend which answers queries after a delay, unless cancelled first,
+ * so that races have a known winner. */
+#define TEST_TYPE_DELAY_BACKEND (test_delay_backend_get_type ())
+G_DECLARE_FINAL_TYPE (TestDelayBackend, test_delay_backend,
+                      TEST, DELAY_BACKEND, GObject)
+
+struct _TestDelayBackend {
+	GObject parent;
+
+	guint delay;  /* milliseconds */
+	char *name;  /* (nullable) answer, or %NULL to fail */
+	GeocodeError error_code;  /* returned if @name is %NULL */
+	guint n_queries;
+	guint n_cancelled;
+};
+
+static void test_delay_backend_iface_init (GeocodeBackendInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (TestDelayBackend, test_delay_backend, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (GEOCODE_TYPE_BACKEND,
+                                                test_delay_backend_iface_init))
+
+typedef struct {
+	GTask *task;  /* (owned) */
+	GSource *timeout_source;  /* (owned) */
+	GSource *cancel_source;  /* (owned) (nullable) */
+} Pending;
+
+static void
+pending_free (Pending *pending)
+{
+	g_source_destroy (pending->timeout_source);
+	g_source_unref (pending->timeout_source);
+
+	if (pending->cancel_source != NULL) {
+		g_source_destroy (pending->cancel_source);
+		g_source_unref (pending->cancel_source);
+	}
+
+	g_object_unref (pending->task);
+	g_free (pending);
+}
+
+static gboolean
+delay_timeout_cb (gpointer user_data)
+{
+	Pending *pending = user_data;
+	TestDelayBackend *self = g_task_get_source_object (pending->task);
+
+	if (self->name == NULL)
+		g_task_return_new_error (pending->task, GEOCODE_ERROR,
+		                         self->error_code,
+		                         "Test backend failure");
+	else
+		g_task_return_pointer (pending->task,
+		                       g_list_prepend (NULL, geocode_place_new (self->name, GEOCODE_PLACE_TYPE_TOWN)),
+		                       (GDestroyNotify) place_list_free);
+
+	pending_free (pending);
+
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean
+delay_cancelled_cb (GCancellable *cancellable,
+                    gpointer      user_data)
+{
+	Pending *pending = user_data;
+	TestDelayBackend *self = g_task_get_source_object (pending->task);
+
+	self->n_cancelled++;
+	g_task_return_error_if_cancelled (pending->task);
+	pending_free (pending);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+test_delay_backend_query_async (GeocodeBackend      *backend,
+                                GHashTable          *params,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+	TestDelayBackend *self = TEST_DELAY_BACKEND (backend);
+	Pending *pending;
+
+	self->n_queries++;
+
+	pending = g_new0 (Pending, 1);
+	pending->task = g_task_new (backend, cancellable, callback, user_data);
+
+	pending->timeout_source = g_timeout_source_new (self->delay);
+	g_source_set_callback (pending->timeout_source, delay_timeout_cb,
+	                       pending, NULL);
+	g_source_attach (pending->timeout_source, g_task_get_context (pending->task));
+
+	if (cancellable != NULL) {
+		pending->cancel_source = g_cancellable_source_new (cancellable);
+		g_source_set_callback (pending->cancel_source,
+		                       (GSourceFunc) delay_cancelled_cb, pending, NULL);
+		g_source_attach (pending->cancel_source,
+		                 g_task_get_context (pending->task));
+	}
+}
+
+static GList *
+test_delay_backend_query_finish (GeocodeBackend  *backend,
+                                 GAsyncResult    *result,
+                                 GError         **error)
+{
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static void
+test_delay_backend_init (TestDelayBackend *self)
+{
+	self->error_code = GEOCODE_ERROR_NO_MATCHES;
+}
+
+static void
+test_delay_backend_finalize (GObject *object)
+{
+	TestDelayBackend *self = TEST_DELAY_BACKEND (object);
+
+	g_free (self->name);
+
+	G_OBJECT_CLASS (test_delay_backend_parent_class)->finalize (object);
+}
+
+static void
+test_delay_backend_iface_init (GeocodeBackendInterface *iface)
+{
+	iface->forward_search_async = test_delay_backend_query_async;
+	iface->forward_search_finish = test_delay_backend_query_finish;
+	iface->reverse_resolve_async = test_delay_backend_query_async;
+	iface->reverse_resolve_finish = test_delay_backend_query_finish;
+}
+
+static void
+test_delay_backend_class_init (TestDelayBackendClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->finalize = test_delay_backend_finalize;
+}
+
+static TestDelayBackend *
+test_delay_backend_new (const char *name,
+                        guint       delay)
+{
+	TestDelayBackend *self = g_object_new (TEST_TYPE_DELAY_BACKEND, NULL);
+
+	self->name = g_strdup (name);
+	self->delay = delay;
+
+	return self;
+}
+
+/******************************************************************************/
+
+static GHashTable *
+build_params (void)
+{
+	return g_hash_table_new (g_str_hash, g_str_equal);
+}
+
+static GList *
+race_full (GeocodeRacingBackend  *backend,
+           gboolean               is_forward,
+           GCancellable          *cancellable,
+           GError               **error)
+{
+	g_autoptr (GHashTable) params = build_params ();
+	g_autoptr (GAsyncResult) result = NULL;
+
+	if (is_forward)
+		geocode_backend_forward_search_async (GEOCODE_BACKEND (backend), params,
+		                                      cancellable, async_result_cb, &result);
+	else
+		geocode_backend_reverse_resolve_async (GEOCODE_BACKEND (backend), params,
+		                                       cancellable, async_result_cb, &result);
+
+	while (result == NULL)
+		g_main_context_iteration (NULL, TRUE);
+
+	if (is_forward)
+		return geocode_backend_forward_search_finish (GEOCODE_BACKEND (backend),
+		                                              result, error);
+	else
+		return geocode_backend_reverse_resolve_finish (GEOCODE_BACKEND (backend),
+		                                               result, error);
+}
+
+static GList *
+race (GeocodeRacingBackend  *backend,
+      GError               **error)
+{
+	return race_full (backend, TRUE, NULL, error);
+}
+
+/* Wait for the cancelled losers. */
+static void
+drain_main_context (void)
+{
+	while (g_main_context_iteration (NULL, FALSE));
+}
+
+/* Test that a slow primary backend is hedged, and cancelled once the hedge
+ * answers. */
+static void
+test_hedge (void)
+{
+	g_autoptr (GeocodeRacingBackend) backend = NULL;
+	g_autoptr (TestDelayBackend) slow = test_delay_backend_new ("Slow", 10000);
+	g_autoptr (TestDelayBackend) fast = test_delay_backend_new ("Fast", 10);
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	backend = geocode_racing_backend_new ();
+	geocode_racing_backend_set_hedge_delay (backend, 20);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (slow), 1);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (fast), 0);
+
+	places = race (backend, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Fast");
+
+	drain_main_context ();
+
+	g_assert_cmpuint (slow->n_queries, ==, 1);
+	g_assert_cmpuint (slow->n_cancelled, ==, 1);
+	g_assert_cmpuint (fast->n_queries, ==, 1);
+	g_assert_cmpuint (geocode_racing_backend_get_n_wins (backend, GEOCODE_BACKEND (fast)), ==, 1);
+	g_assert_cmpuint (geocode_racing_backend_get_n_wins (backend, GEOCODE_BACKEND (slow)), ==, 0);
+}
+
+/* Test that a primary backend which answers within the hedge delay is the
+ * only one queried. */
+static void
+test_no_hedge (void)
+{
+	g_autoptr (GeocodeRacingBackend) backend = NULL;
+	g_autoptr (TestDelayBackend) primary = test_delay_backend_new ("Primary", 10);
+	g_autoptr (TestDelayBackend) hedge = test_delay_backend_new ("Hedge", 10);
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	backend = geocode_racing_backend_new ();
+	geocode_racing_backend_set_hedge_delay (backend, 10000);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (primary), 1);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (hedge), 0);
+
+	places = race (backend, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Primary");
+	g_assert_cmpuint (hedge->n_queries, ==, 0);
+}
+
+/* Test that a failed backend is replaced without waiting for the hedge
+ * delay, and that the first error is returned if they all fail. */
+static void
+test_errors (void)
+{
+	g_autoptr (GeocodeRacingBackend) backend = NULL;
+	g_autoptr (TestDelayBackend) failing = test_delay_backend_new (NULL, 0);
+	g_autoptr (TestDelayBackend) good = test_delay_backend_new ("Good", 0);
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+	gint64 start_time;
+
+	backend = geocode_racing_backend_new ();
+	geocode_racing_backend_set_hedge_delay (backend, 10000);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (failing), 1);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (good), 0);
+
+	start_time = g_get_monotonic_time ();
+	places = race (backend, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Good");
+	g_assert_cmpint (g_get_monotonic_time () - start_time, <, 5 * G_USEC_PER_SEC);
+	g_clear_pointer (&places, place_list_free);
+
+	g_clear_pointer (&good->name, g_free);
+
+	places = race (backend, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NO_MATCHES);
+	g_assert_null (places);
+}
+
+/* Test that the error from the first backend to be queried is returned,
+ * even if a hedge fails before it. */
+static void
+test_error_order (void)
+{
+	g_autoptr (GeocodeRacingBackend) backend = NULL;
+	g_autoptr (TestDelayBackend) first = test_delay_backend_new (NULL, 100);
+	g_autoptr (TestDelayBackend) hedge = test_delay_backend_new (NULL, 0);
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	first->error_code = GEOCODE_ERROR_NOT_SUPPORTED;
+	hedge->error_code = GEOCODE_ERROR_NO_MATCHES;
+
+	backend = geocode_racing_backend_new ();
+	geocode_racing_backend_set_hedge_delay (backend, 10);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (first), 1);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (hedge), 0);
+
+	places = race (backend, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED);
+	g_assert_null (places);
+	g_assert_cmpuint (first->n_queries, ==, 1);
+	g_assert_cmpuint (hedge->n_queries, ==, 1);
+}
+
+/* Test that weights decide which backend is queried first. */
+static void
+test_weights (void)
+{
+	g_autoptr (GeocodeRacingBackend) backend = NULL;
+	g_autoptr (TestDelayBackend) light = test_delay_backend_new ("Light", 0);
+	g_autoptr (TestDelayBackend) heavy = test_delay_backend_new ("Heavy", 0);
+	guint i, n_heavy_wins;
+
+	/* A backend with no weight is never first, even if added first. */
+	backend = geocode_racing_backend_new ();
+	geocode_racing_backend_set_hedge_delay (backend, 10000);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (light), 0);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (heavy), 1);
+
+	for (i = 0; i < 10; i++) {
+		g_autoptr (PlaceList) places = NULL;
+		g_autoptr (GError) error = NULL;
+
+		places = race (backend, &error);
+		g_assert_no_error (error);
+		g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Heavy");
+	}
+
+	g_assert_cmpuint (light->n_queries, ==, 0);
+	g_clear_object (&backend);
+
+	/* Otherwise, backends are first in proportion to their weights: here
+	 * three times in four for the heavy one. The bounds are more than
+	 * seven standard deviations away from the expected 150 wins. */
+	backend = geocode_racing_backend_new ();
+	geocode_racing_backend_set_hedge_delay (backend, 10000);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (light), 1);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (heavy), 3);
+
+	for (i = 0; i < 200; i++) {
+		g_autoptr (PlaceList) places = NULL;
+		g_autoptr (GError) error = NULL;
+
+		places = race (backend, &error);
+		g_assert_no_error (error);
+	}
+
+	n_heavy_wins = geocode_racing_backend_get_n_wins (backend, GEOCODE_BACKEND (heavy));
+	g_assert_cmpuint (n_heavy_wins, >, 100);
+	g_assert_cmpuint (n_heavy_wins, <, 195);
+	g_assert_cmpuint (geocode_racing_backend_get_n_wins (backend, GEOCODE_BACKEND (light)),
+	                  ==, 200 - n_heavy_wins);
+}
+
+static gboolean
+cancel_cb (gpointer user_data)
+{
+	g_cancellable_cancel (G_CANCELLABLE (user_data));
+
+	return G_SOURCE_REMOVE;
+}
+
+/* Test that cancelling a query cancels every backend it is running on. */
+static void
+test_cancel (void)
+{
+	g_autoptr (GeocodeRacingBackend) backend = NULL;
+	g_autoptr (TestDelayBackend) first = test_delay_backend_new ("First", 10000);
+	g_autoptr (TestDelayBackend) hedge = test_delay_backend_new ("Hedge", 10000);
+	g_autoptr (GCancellable) cancellable = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	backend = geocode_racing_backend_new ();
+	geocode_racing_backend_set_hedge_delay (backend, 10);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (first), 1);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (hedge), 0);
+
+	/* Cancel once both backends are running. */
+	cancellable = g_cancellable_new ();
+	g_timeout_add (50, cancel_cb, cancellable);
+
+	places = race_full (backend, TRUE, cancellable, &error);
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_assert_null (places);
+	g_clear_error (&error);
+
+	drain_main_context ();
+
+	g_assert_cmpuint (first->n_queries, ==, 1);
+	g_assert_cmpuint (first->n_cancelled, ==, 1);
+	g_assert_cmpuint (hedge->n_queries, ==, 1);
+	g_assert_cmpuint (hedge->n_cancelled, ==, 1);
+	g_assert_cmpuint (geocode_racing_backend_get_n_wins (backend, GEOCODE_BACKEND (first)), ==, 0);
+	g_assert_cmpuint (geocode_racing_backend_get_n_wins (backend, GEOCODE_BACKEND (hedge)), ==, 0);
+
+	/* A query which is already cancelled is not sent anywhere. */
+	places = race_full (backend, TRUE, cancellable, &error);
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_assert_null (places);
+	g_assert_cmpuint (first->n_queries, ==, 1);
+	g_assert_cmpuint (hedge->n_queries, ==, 1);
+}
+
+/* Test that reverse queries are raced like forward ones. */
+static void
+test_reverse (void)
+{
+	g_autoptr (GeocodeRacingBackend) backend = NULL;
+	g_autoptr (TestDelayBackend) slow = test_delay_backend_new ("Slow", 10000);
+	g_autoptr (TestDelayBackend) fast = test_delay_backend_new ("Fast", 10);
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	backend = geocode_racing_backend_new ();
+	geocode_racing_backend_set_hedge_delay (backend, 20);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (slow), 1);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (fast), 0);
+
+	places = race_full (backend, FALSE, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Fast");
+
+	drain_main_context ();
+
+	g_assert_cmpuint (slow->n_cancelled, ==, 1);
+	g_assert_cmpuint (geocode_racing_backend_get_n_wins (backend, GEOCODE_BACKEND (fast)), ==, 1);
+}
+
+/* Test that a hedge delay of zero queries every backend at once. */
+static void
+test_all_at_once (void)
+{
+	g_autoptr (GeocodeRacingBackend) backend = NULL;
+	g_autoptr (TestDelayBackend) slow = test_delay_backend_new ("Slow", 10000);
+	g_autoptr (TestDelayBackend) fast = test_delay_backend_new ("Fast", 10);
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	backend = geocode_racing_backend_new ();
+	geocode_racing_backend_set_hedge_delay (backend, 0);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (fast), 1);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (slow), 1);
+
+	places = race (backend, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Fast");
+
+	drain_main_context ();
+
+	g_assert_cmpuint (slow->n_queries, ==, 1);
+	g_assert_cmpuint (slow->n_cancelled, ==, 1);
+}
+
+/* Test that blocking queries run the race too. */
+static void
+test_sync (void)
+{
+	g_autoptr (GeocodeRacingBackend) backend = NULL;
+	g_autoptr (TestDelayBackend) slow = test_delay_backend_new ("Slow", 10000);
+	g_autoptr (TestDelayBackend) fast = test_delay_backend_new ("Fast", 10);
+	g_autoptr (GHashTable) params = build_params ();
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	backend = geocode_racing_backend_new ();
+	geocode_racing_backend_set_hedge_delay (backend, 20);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (slow), 1);
+	geocode_racing_backend_add_backend (backend, GEOCODE_BACKEND (fast), 0);
+
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (backend),
+	                                         params, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Fast");
+	g_assert_cmpuint (slow->n_cancelled, ==, 1);
+}
+
+static void
+test_no_backends (void)
+{
+	g_autoptr (GeocodeRacingBackend) backend = geocode_racing_backend_new ();
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	places = race (backend, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED);
+	g_assert_null (places);
+}
+
+int
+main (int argc, char **argv)
+{
+	setlocale (LC_ALL, "");
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add_func ("/racing-backend/hedge", test_hedge);
+	g_test_add_func ("/racing-backend/no-hedge", test_no_hedge);
+	g_test_add_func ("/racing-backend/errors", test_errors);
+	g_test_add_func ("/racing-backend/error-order", test_error_order);
+	g_test_add_func ("/racing-backend/weights", test_weights);
+	g_test_add_func ("/racing-backend/cancel", test_cancel);
+	g_test_add_func ("/racing-backend/reverse", test_reverse);
+	g_test_add_func ("/racing-backend/all-at-once", test_all_at_once);
+	g_test_add_func ("/racing-backend/sync", test_sync);
+	g_test_add_func ("/racing-backend/no-backends", test_no_backends);
+
+	return g_test_run ();
+}
@@ -0,0 +1,532 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+#include "config.h"
+
+#include <geocode-glib/geocode-glib.h>
+#include <gio/gio.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <locale.h>
+
+#include "backend-test-utils.h"
+
+static void
+assert_place_list_equal (GList *a,
+                         GList *b)
+{
+	for (; a != NULL && b != NULL; a = a->next, b = b->next)
+		g_assert_true (geocode_place_equal (a->data, b->data));
+
+	g_assert (a == NULL);
+	g_assert (b == NULL);
+}
+
+/* Limits the query in @params, as built by build_location_params(), to
+ * @limit results. */
+static void
+add_limit (GHashTable *params,
+           guint       limit)
+{
+	GValue *value;
+
+	value = g_new0 (GValue, 1);
+	g_value_init (value, G_TYPE_UINT);
+	g_value_set_uint (value, limit);
+	g_hash_table_insert (params, (gpointer) "limit", value);
+}
+
+static GHashTable *
+build_reverse_params (gdouble latitude,
+                      gdouble longitude)
+{
+	GHashTable *params;
+	GValue *value;
+
+	params = g_hash_table_new_full (g_str_hash, g_str_equal,
+	                                NULL, (GDestroyNotify) value_free);
+
+	value = g_new0 (GValue, 1);
+	g_value_init (value, G_TYPE_DOUBLE);
+	g_value_set_double (value, latitude);
+	g_hash_table_insert (params, (gpointer) "lat", value);
+
+	value = g_new0 (GValue, 1);
+	g_value_init (value, G_TYPE_DOUBLE);
+	g_value_set_double (value, longitude);
+	g_hash_table_insert (params, (gpointer) "lon", value);
+
+	return params;
+}
+
+static GeocodePlace *
+build_place (void)
+{
+	g_autoptr (GeocodePlace) place = NULL;
+	g_autoptr (GeocodeLocation) location = NULL;
+	g_autoptr (GeocodeBoundingBox) bbox = NULL;
+
+	location = geocode_location_new_with_description (
+	    54.22759825, -2.51857179181113, 5.0,
+	    "Bullpot Farm, Fell Road, South Lakeland, Cumbria, "
+	    "North West England, England, United Kingdom");
+	bbox = geocode_bounding_box_new (54.2276, 54.2275, -2.5186, -2.5185);
+
+	place = geocode_place_new_with_location ("Bullpot Farm",
+	                                         GEOCODE_PLACE_TYPE_BUILDING,
+	                                         location);
+	geocode_place_set_bounding_box (place, bbox);
+	geocode_place_set_street (place, "Fell Road");
+	geocode_place_set_county (place, "South Lakeland");
+	geocode_place_set_country_code (place, "GB");
+	g_object_set (place,
+	              "osm-id", "4321",
+	              "osm-type", GEOCODE_PLACE_OSM_TYPE_WAY,
+	              NULL);
+
+	return g_steal_pointer (&place);
+}
+
+/* Test that queries recorded from a backend are replayed with the same
+ * answers. */
+static void
+test_round_trip (void)
+{
+	g_autoptr (GeocodeMockBackend) mock = NULL;
+	g_autoptr (GeocodeRecordingBackend) recording = NULL;
+	g_autoptr (GeocodeReplayBackend) replay = NULL;
+	g_autoptr (GHashTable) forward_params = NULL;
+	g_autoptr (GHashTable) reverse_params = NULL;
+	g_autoptr (GHashTable) other_params = NULL;
+	g_autoptr (PlaceList) expected_places = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GAsyncResult) result = NULL;
+	g_autoptr (GError) expected_error = NULL;
+	g_autoptr (GError) error = NULL;
+	g_autofree char *dir = NULL;
+	g_autofree char *path = NULL;
+
+	dir = g_dir_make_tmp ("geocode-replay-XXXXXX", &error);
+	g_assert_no_error (error);
+	path = g_build_filename (dir, "trace.jsonl", NULL);
+
+	/* Record a forward query, and a failing reverse one. */
+	forward_params = build_location_params ("Bullpot Farm");
+	add_limit (forward_params, 5);
+	reverse_params = build_reverse_params (54.2276, -2.5186);
+	expected_places = g_list_prepend (NULL, build_place ());
+	expected_error = g_error_new (GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED,
+	                              "Unable to geocode");
+
+	mock = geocode_mock_backend_new ();
+	geocode_mock_backend_add_forward_result (mock, forward_params,
+	                                         expected_places, NULL);
+	geocode_mock_backend_add_reverse_result (mock, reverse_params,
+	                                         NULL, expected_error);
+
+	recording = geocode_recording_backend_new (GEOCODE_BACKEND (mock), path,
+	                                           &error);
+	g_assert_no_error (error);
+	g_assert_true (geocode_recording_backend_get_backend (recording) ==
+	               GEOCODE_BACKEND (mock));
+
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (recording),
+	                                         forward_params, NULL, &error);
+	g_assert_no_error (error);
+	assert_place_list_equal (places, expected_places);
+	g_clear_pointer (&places, place_list_free);
+
+	geocode_backend_reverse_resolve_async (GEOCODE_BACKEND (recording),
+	                                       reverse_params, NULL,
+	                                       async_result_cb, &result);
+	while (result == NULL)
+		g_main_context_iteration (NULL, TRUE);
+
+	places = geocode_backend_reverse_resolve_finish (GEOCODE_BACKEND (recording),
+	                                                 result, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED);
+	g_assert_null (places);
+	g_clear_error (&error);
+
+	g_assert_cmpuint (geocode_recording_backend_get_n_entries (recording), ==, 2);
+	g_clear_object (&recording);
+
+	/* Replay them. */
+	replay = geocode_replay_backend_new ();
+	geocode_replay_backend_set_speed (replay, 0.0);
+	geocode_replay_backend_load_file (replay, path, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (geocode_replay_backend_get_n_entries (replay), ==, 2);
+
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (replay),
+	                                         forward_params, NULL, &error);
+	g_assert_no_error (error);
+	assert_place_list_equal (places, expected_places);
+	g_clear_pointer (&places, place_list_free);
+
+	places = geocode_backend_reverse_resolve (GEOCODE_BACKEND (replay),
+	                                          reverse_params, NULL, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED);
+	g_assert_cmpstr (error->message, ==, "Unable to geocode");
+	g_assert_null (places);
+	g_clear_error (&error);
+
+	/* The limit is part of the query. */
+	other_params = build_location_params ("Bullpot Farm");
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (replay),
+	                                         other_params, NULL, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NO_MATCHES);
+	g_assert_null (places);
+
+	g_unlink (path);
+	g_rmdir (dir);
+}
+
+/* Test that a recording backend can write to any stream. */
+static void
+test_record_to_stream (void)
+{
+	g_autoptr (GeocodeMockBackend) mock = NULL;
+	g_autoptr (GeocodeRecordingBackend) recording = NULL;
+	g_autoptr (GeocodeReplayBackend) replay = NULL;
+	g_autoptr (GOutputStream) stream = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (PlaceList) expected_places = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+
+	params = build_location_params ("Bullpot Farm");
+	expected_places = g_list_prepend (NULL, build_place ());
+
+	mock = geocode_mock_backend_new ();
+	geocode_mock_backend_add_forward_result (mock, params,
+	                                         expected_places, NULL);
+
+	stream = g_memory_output_stream_new_resizable ();
+	recording = g_object_new (GEOCODE_TYPE_RECORDING_BACKEND,
+	                          "backend", mock,
+	                          "stream", stream,
+	                          NULL);
+
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (recording),
+	                                         params, NULL, &error);
+	g_assert_no_error (error);
+	g_clear_pointer (&places, place_list_free);
+	g_assert_cmpuint (geocode_recording_backend_get_n_entries (recording), ==, 1);
+
+	replay = geocode_replay_backend_new ();
+	geocode_replay_backend_set_speed (replay, 0.0);
+	geocode_replay_backend_load_data (replay,
+	                                  g_memory_output_stream_get_data (G_MEMORY_OUTPUT_STREAM (stream)),
+	                                  g_memory_output_stream_get_data_size (G_MEMORY_OUTPUT_STREAM (stream)),
+	                                  &error);
+	g_assert_no_error (error);
+
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (replay),
+	                                         params, NULL, &error);
+	g_assert_no_error (error);
+	assert_place_list_equal (places, expected_places);
+}
+
+static const char paris_trace[] =
+	"{\"forward\":true,\"time\":0,\"latency\":200000,"
+	"\"params\":{\"location\":[\"gchararray\",\"Paris\"]},"
+	"\"places\":[{\"name\":\"Paris\",\"place-type\":\"town\"}]}\n";
+
+/* Test that answers take their recorded latency, divided by the speed. */
+static void
+test_speed (void)
+{
+	g_autoptr (GeocodeReplayBackend) replay = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GAsyncResult) result = NULL;
+	g_autoptr (GError) error = NULL;
+	gint64 start_time;
+
+	replay = geocode_replay_backend_new ();
+	g_assert_cmpfloat (geocode_replay_backend_get_speed (replay), ==, 1.0);
+	geocode_replay_backend_load_data (replay, paris_trace, -1, &error);
+	g_assert_no_error (error);
+
+	params = build_location_params ("Paris");
+
+	start_time = g_get_monotonic_time ();
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (replay),
+	                                         params, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Paris");
+	g_assert_cmpint (g_get_monotonic_time () - start_time, >=, 200 * 1000);
+	g_clear_pointer (&places, place_list_free);
+
+	start_time = g_get_monotonic_time ();
+	geocode_backend_forward_search_async (GEOCODE_BACKEND (replay), params,
+	                                      NULL, async_result_cb, &result);
+	while (result == NULL)
+		g_main_context_iteration (NULL, TRUE);
+
+	places = geocode_backend_forward_search_finish (GEOCODE_BACKEND (replay),
+	                                                result, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (g_list_length (places), ==, 1);
+	g_assert_cmpint (g_get_monotonic_time () - start_time, >=, 200 * 1000);
+	g_clear_pointer (&places, place_list_free);
+
+	/* A hundred times faster. */
+	geocode_replay_backend_set_speed (replay, 100.0);
+
+	start_time = g_get_monotonic_time ();
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (replay),
+	                                         params, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (g_get_monotonic_time () - start_time, >=, 2 * 1000);
+	g_assert_cmpint (g_get_monotonic_time () - start_time, <, 200 * 1000);
+}
+
+static gboolean
+cancel_cb (gpointer user_data)
+{
+	g_cancellable_cancel (G_CANCELLABLE (user_data));
+
+	return G_SOURCE_REMOVE;
+}
+
+/* Test that delays which do not fit in a timeout are clamped, rather than
+ * overflowing into short ones. */
+static void
+test_long_delay (void)
+{
+	g_autoptr (GeocodeReplayBackend) replay = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (GCancellable) cancellable = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GAsyncResult) result = NULL;
+	g_autoptr (GError) error = NULL;
+	const char *trace =
+		"{\"forward\":true,\"latency\":9000000000000000000,"
+		"\"params\":{\"location\":[\"gchararray\",\"Paris\"]},"
+		"\"places\":[{\"name\":\"Paris\"}]}\n";
+
+	replay = geocode_replay_backend_new ();
+	geocode_replay_backend_set_speed (replay, 1e-9);
+	geocode_replay_backend_load_data (replay, trace, -1, &error);
+	g_assert_no_error (error);
+
+	params = build_location_params ("Paris");
+	cancellable = g_cancellable_new ();
+	g_timeout_add (50, cancel_cb, cancellable);
+
+	geocode_backend_forward_search_async (GEOCODE_BACKEND (replay), params,
+	                                      cancellable, async_result_cb, &result);
+	while (result == NULL)
+		g_main_context_iteration (NULL, TRUE);
+
+	places = geocode_backend_forward_search_finish (GEOCODE_BACKEND (replay),
+	                                                result, &error);
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_assert_null (places);
+}
+
+/* Test that several answers to the same query are returned in turn. */
+static void
+test_repeated (void)
+{
+	g_autoptr (GeocodeReplayBackend) replay = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (GError) error = NULL;
+	const char * const expected_names[] = { "First", "Second", "First" };
+	gsize i;
+	const char *trace =
+		"{\"forward\":true,\"params\":{\"location\":[\"gchararray\",\"Paris\"]},"
+		"\"places\":[{\"name\":\"First\"}]}\n"
+		"\n"
+		"{\"forward\":true,\"params\":{\"location\":[\"gchararray\",\"Paris\"]},"
+		"\"places\":[{\"name\":\"Second\"}]}";
+
+	replay = geocode_replay_backend_new ();
+	geocode_replay_backend_load_data (replay, trace, -1, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (geocode_replay_backend_get_n_entries (replay), ==, 2);
+
+	params = build_location_params ("Paris");
+
+	for (i = 0; i < G_N_ELEMENTS (expected_names); i++) {
+		g_autoptr (PlaceList) places = NULL;
+
+		places = geocode_backend_forward_search (GEOCODE_BACKEND (replay),
+		                                         params, NULL, &error);
+		g_assert_no_error (error);
+		g_assert_cmpuint (g_list_length (places), ==, 1);
+		g_assert_cmpstr (geocode_place_get_name (places->data), ==,
+		                 expected_names[i]);
+	}
+}
+
+/* Test that %NULL string parameters, which are recorded as `null`, can be
+ * loaded and matched. */
+static void
+test_null_string (void)
+{
+	g_autoptr (GeocodeReplayBackend) replay = NULL;
+	g_autoptr (GHashTable) params = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+	const char *trace =
+		"{\"forward\":true,\"params\":{\"location\":[\"gchararray\",null]},"
+		"\"places\":[{\"name\":\"First\"}]}\n"
+		"{\"forward\":true,\"params\":{\"location\":[\"gchararray\",null]},"
+		"\"places\":[{\"name\":\"Second\"}]}\n";
+
+	replay = geocode_replay_backend_new ();
+	geocode_replay_backend_load_data (replay, trace, -1, &error);
+	g_assert_no_error (error);
+	g_assert_cmpuint (geocode_replay_backend_get_n_entries (replay), ==, 2);
+
+	params = build_location_params (NULL);
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (replay),
+	                                         params, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "First");
+	g_clear_pointer (&places, place_list_free);
+
+	/* It is not the same as an empty string. */
+	g_clear_pointer (&params, g_hash_table_unref);
+	params = build_location_params ("");
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (replay),
+	                                         params, NULL, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NO_MATCHES);
+	g_assert_null (places);
+}
+
+/* Test that the loaded queries are listed in order, with their times. */
+static void
+test_entries (void)
+{
+	g_autoptr (GeocodeReplayBackend) replay = NULL;
+	g_autoptr (PlaceList) places = NULL;
+	g_autoptr (GError) error = NULL;
+	g_autoptr (GPtrArray) empty_entries = NULL;
+	g_autoptr (GPtrArray) entries = NULL;  /* (element-type GeocodeReplayBackendEntry) */
+	const GeocodeReplayBackendEntry *entry;
+	const char *trace =
+		"{\"forward\":false,\"time\":120345,\"latency\":100,"
+		"\"params\":{\"lat\":[\"gdouble\",0],\"lon\":[\"gdouble\",0]},"
+		"\"error\":{\"domain\":\"geocode_error\",\"code\":1,\"message\":\"No\"}}\n"
+		"{\"forward\":true,\"params\":{\"location\":[\"gchararray\",\"London\"]},"
+		"\"places\":[{\"name\":\"London\"}]}\n";
+
+	replay = geocode_replay_backend_new ();
+	empty_entries = geocode_replay_backend_get_entries (replay);
+	g_assert_cmpuint (empty_entries->len, ==, 0);
+
+	geocode_replay_backend_load_data (replay, trace, -1, &error);
+	g_assert_no_error (error);
+	geocode_replay_backend_load_data (replay, paris_trace, -1, &error);
+	g_assert_no_error (error);
+
+	entries = geocode_replay_backend_get_entries (replay);
+	g_assert_cmpuint (entries->len, ==, 3);
+	g_assert_cmpuint (geocode_replay_backend_get_n_entries (replay), ==, 3);
+
+	/* Arrays already returned are not changed by loading more entries. */
+	g_assert_cmpuint (empty_entries->len, ==, 0);
+
+	entry = entries->pdata[0];
+	g_assert_false (entry->is_forward);
+	g_assert_cmpint (entry->time, ==, 120345);
+
+	/* The parameters can be used to make the query again. */
+	places = geocode_backend_reverse_resolve (GEOCODE_BACKEND (replay),
+	                                          entry->params, NULL, &error);
+	g_assert_error (error, GEOCODE_ERROR, GEOCODE_ERROR_NOT_SUPPORTED);
+	g_assert_null (places);
+	g_clear_error (&error);
+
+	/* A missing time is read as zero. */
+	entry = entries->pdata[1];
+	g_assert_true (entry->is_forward);
+	g_assert_cmpint (entry->time, ==, 0);
+	g_assert_cmpstr (g_value_get_string (g_hash_table_lookup (entry->params, "location")),
+	                 ==, "London");
+
+	entry = entries->pdata[2];
+	g_assert_true (entry->is_forward);
+	g_assert_cmpint (entry->time, ==, 0);
+
+	places = geocode_backend_forward_search (GEOCODE_BACKEND (replay),
+	                                         entry->params, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (geocode_place_get_name (places->data), ==, "Paris");
+}
+
+/* Test that a trace with an invalid entry is not loaded at all. */
+static void
+test_invalid (void)
+{
+	g_autoptr (GeocodeReplayBackend) replay = NULL;
+	g_autoptr (GError) error = NULL;
+	g_autofree char *trace = NULL;
+	gsize i;
+	const char * const invalid_entries[] = {
+		"{\"forward\":true,",
+		"[]",
+		"{\"params\":{},\"places\":[]}",
+		"{\"forward\":true,\"params\":{\"limit\":[\"NoSuchType\",1]},\"places\":[]}",
+		"{\"forward\":true,\"params\":{\"limit\":[\"guint\",{}]},\"places\":[]}",
+		"{\"forward\":true,\"params\":{},\"places\":[{\"place-type\":\"town\"}]}",
+		"{\"forward\":true,\"params\":{},\"places\":[{\"name\":\"X\",\"place-type\":\"nowhere\"}]}",
+		"{\"forward\":true,\"params\":{},\"places\":[{\"name\":\"X\",\"location\":{\"latitude\":100,\"longitude\":0}}]}",
+		"{\"forward\":true,\"params\":{},\"error\":{\"code\":1}}",
+		"{\"forward\":true,\"params\":{}}",
+	};
+
+	replay = geocode_replay_backend_new ();
+
+	for (i = 0; i < G_N_ELEMENTS (invalid_entries); i++) {
+		g_test_message ("Entry %" G_GSIZE_FORMAT ": %s", i, invalid_entries[i]);
+
+		trace = g_strconcat (paris_trace, invalid_entries[i], "\n", NULL);
+		g_assert_false (geocode_replay_backend_load_data (replay, trace, -1,
+		                                                  &error));
+		g_assert_nonnull (error);
+		g_assert_cmpuint (geocode_replay_backend_get_n_entries (replay), ==, 0);
+
+		g_clear_error (&error);
+		g_clear_pointer (&trace, g_free);
+	}
+}
+
+int
+main (int argc, char **argv)
+{
+	setlocale (LC_ALL, "");
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add_func ("/replay-backend/round-trip", test_round_trip);
+	g_test_add_func ("/replay-backend/record-to-stream", test_record_to_stream);
+	g_test_add_func ("/replay-backend/speed", test_speed);
+	g_test_add_func ("/replay-backend/long-delay", test_long_delay);
+	g_test_add_func ("/replay-backend/repeated", test_repeated);
+	g_test_add_func ("/replay-backend/null-string", test_null_string);
+	g_test_add_func ("/replay-backend/entries", test_entries);
+	g_test_add_func ("/replay-backend/invalid", test_invalid);
+
+	return g_test_run ();
+}
@@ -0,0 +1,323 @@
+/*
+ * Copyright 2026 The geocode-glib authors
+ *
+ * The geocode-glib library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * The geocode-glib library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with the Gnome Library; see the file COPYING.LIB.  If not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301  USA.
+ *
+ */
+
+/*
+ * Compiles Nominatim search results into a gazetteer file for
+ * #GeocodeGazetteer:
+ *
+ *   geocode-gazetteer-build [--threads N] [--batch-size N] OUTPUT INPUT…
+ *
+ * Each INPUT is read line by line; every line is a jsonv2 result object, or
+ * an array of them, as returned by Nominatim’s search, lookup and reverse
+ * endpoints. Inputs ending in `.gz` are decompressed on the fly. Lines are
+ * parsed in batches on a thread pool, through the same attribute mapping as
+ * #GeocodeNominatim, and the places are added to the gazetteer in input
+ * order, so more important places should come first. Only the compact
+ * gazetteer records are held in memory, never the JSON input.
+ */
+
+#include "config.h"
+
+#include <gio/gio.h>
+#include <glib.h>
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <geocode-glib/geocode-glib.h>
+#include <geocode-glib/geocode-glib-private.h>
+
+#define DEFAULT_BATCH_SIZE 1024
+
+typedef struct {
+	guint64 sequence;
+	const char *filename;
+	GPtrArray *lines;  /* (owned) (element-type utf8) */
+	GArray *line_numbers;  /* (owned) (element-type guint64) */
+	GPtrArray *places;  /* (owned) (element-type GeocodePlace) */
+	guint n_errors;
+} Batch;
+
+typedef struct {
+	GThreadPool *pool;  /* (owned) */
+	GAsyncQueue *finished;  /* (owned) (element-type Batch) */
+	GHashTable *pending;  /* (owned) finished out of order, by sequence */
+	guint batch_size;
+	guint max_in_flight;
+	guint in_flight;
+	guint64 next_sequence;
+	guint64 next_to_add;
+
+	GeocodeGazetteerWriter *writer;  /* (owned) */
+	guint64 n_lines;
+	guint64 n_errors;
+} Builder;
+
+static Batch *
+batch_new (Builder    *builder,
+           const char *filename)
+{
+	Batch *batch;
+
+	batch = g_new0 (Batch, 1);
+	batch->sequence = builder->next_sequence++;
+	batch->filename = filename;
+	batch->lines = g_ptr_array_new_with_free_func (g_free);
+	batch->line_numbers = g_array_new (FALSE, FALSE, sizeof (guint64));
+	batch->places = g_ptr_array_new_with_free_func (g_object_unref);
+
+	return batch;
+}
+
+static void
+batch_free (Batch *batch)
+{
+	g_ptr_array_unref (batch->lines);
+	g_array_unref (batch->line_numbers);
+	g_ptr_array_unref (batch->places);
+	g_free (batch);
+}
+
+/* Runs in the thread pool. */
+static void
+parse_batch (gpointer data,
+             gpointer user_data)
+{
+	Batch *batch = data;
+	Builder *builder = user_data;
+	guint i;
+
+	for (i = 0; i < batch->lines->len; i++) {
+		const char *line = batch->lines->pdata[i];
+		g_autoptr (GError) error = NULL;
+		GList *places, *l;
+
+		places = _geocode_parse_place_json (line, -1, &error);
+
+		if (error != NULL) {
+			g_printerr ("%s:%" G_GUINT64_FORMAT ": %s\n",
+			            batch->filename,
+			            g_array_index (batch->line_numbers, guint64, i),
+			            error->message);
+			batch->n_errors++;
+			continue;
+		}
+
+		for (l = places; l != NULL; l = l->next)
+			g_ptr_array_add (batch->places, l->data);
+		g_list_free (places);
+	}
+
+	/* The lines are not needed any more; free them before the batch
+	 * waits for its turn to be added. */
+	g_ptr_array_set_size (batch->lines, 0);
+
+	g_async_queue_push (builder->finished, batch);
+}
+
+/* Adds finished batches to the writer in the order they were submitted,
+ * until no more than @max_in_flight batches are left. A batch is in flight
+ * from when it is submitted until it has been added to the writer, so this
+ * counts the batches which are queued, being parsed, or parsed but waiting
+ * for an earlier batch to finish. */
+static void
+wait_for_batches (Builder *builder,
+                  guint    max_in_flight)
+{
+	while (builder->in_flight > max_in_flight) {
+		Batch *batch;
+		guint i;
+
+		batch = g_async_queue_pop (builder->finished);
+		g_hash_table_insert (builder->pending, &batch->sequence, batch);
+
+		while ((batch = g_hash_table_lookup (builder->pending,
+		                                     &builder->next_to_add)) != NULL) {
+			g_hash_table_remove (builder->pending, &builder->next_to_add);
+
+			for (i = 0; i < batch->places->len; i++)
+				_geocode_gazetteer_writer_add_place (builder->writer,
+				                                     batch->places->pdata[i]);
+			builder->n_errors += batch->n_errors;
+			builder->next_to_add++;
+
+			batch_free (batch);
+			builder->in_flight--;
+		}
+	}
+}
+
+static void
+submit_batch (Builder *builder,
+              Batch   *batch)
+{
+	/* Bound the memory used by batches which are queued, or parsed but
+	 * waiting for an earlier batch to finish. */
+	wait_for_batches (builder, builder->max_in_flight - 1);
+
+	builder->in_flight++;
+	g_thread_pool_push (builder->pool, batch, NULL);
+}
+
+static GInputStream *
+open_input (const char  *filename,
+            GError     **error)
+{
+	g_autoptr (GFile) file = NULL;
+	g_autoptr (GInputStream) input = NULL;
+
+	file = g_file_new_for_commandline_arg (filename);
+	input = G_INPUT_STREAM (g_file_read (file, NULL, error));
+	if (input == NULL)
+		return NULL;
+
+	if (g_str_has_suffix (filename, ".gz")) {
+		g_autoptr (GZlibDecompressor) decompressor = NULL;
+
+		decompressor = g_zlib_decompressor_new (G_ZLIB_COMPRESSOR_FORMAT_GZIP);
+		return g_converter_input_stream_new (input, G_CONVERTER (decompressor));
+	}
+
+	return g_steal_pointer (&input);
+}
+
+static gboolean
+read_input (Builder     *builder,
+            const char  *filename,
+            GError     **error)
+{
+	g_autoptr (GInputStream) input = NULL;
+	g_autoptr (GDataInputStream) data = NULL;
+	Batch *batch = NULL;
+	guint64 line_number = 0;
+	char *line;
+	gsize length;
+
+	input = open_input (filename, error);
+	if (input == NULL)
+		return FALSE;
+
+	data = g_data_input_stream_new (input);
+	g_data_input_stream_set_newline_type (data, G_DATA_STREAM_NEWLINE_TYPE_ANY);
+
+	while ((line = g_data_input_stream_read_line (data, &length, NULL, error)) != NULL) {
+		line_number++;
+
+		if (*g_strchug (line) == '\0') {
+			g_free (line);
+			continue;
+		}
+
+		if (batch == NULL)
+			batch = batch_new (builder, filename);
+
+		g_ptr_array_add (batch->lines, line);
+		g_array_append_val (batch->line_numbers, line_number);
+		builder->n_lines++;
+
+		if (batch->lines->len == builder->batch_size) {
+			submit_batch (builder, batch);
+			batch = NULL;
+		}
+	}
+
+	if (batch != NULL)
+		submit_batch (builder, batch);
+
+	return (error == NULL || *error == NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+	g_autoptr (GOptionContext) context = NULL;
+	g_autoptr (GError) error = NULL;
+	Builder builder = { NULL, };
+	gint n_threads = 0;
+	gint batch_size = DEFAULT_BATCH_SIZE;
+	const char *output;
+	gint i;
+	const GOptionEntry entries[] = {
+		{ "threads", 'j', 0, G_OPTION_ARG_INT, &n_threads,
+		  "Number of threads to parse the input with (default: one per CPU)", "N" },
+		{ "batch-size", 'b', 0, G_OPTION_ARG_INT, &batch_size,
+		  "Number of lines to parse in each batch (default: 1024)", "N" },
+		{ NULL }
+	};
+
+	setlocale (LC_ALL, "");
+
+	context = g_option_context_new ("OUTPUT INPUT… — build a gazetteer file");
+	g_option_context_set_summary (context,
+	                              "Compiles Nominatim jsonv2 results, one object or array per line, "
+	                              "into a gazetteer file for GeocodeGazetteer.");
+	g_option_context_add_main_entries (context, entries, NULL);
+
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_printerr ("%s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	if (argc < 3) {
+		g_autofree char *help = g_option_context_get_help (context, TRUE, NULL);
+
+		g_printerr ("%s", help);
+		return EXIT_FAILURE;
+	}
+
+	output = argv[1];
+	if (n_threads <= 0)
+		n_threads = g_get_num_processors ();
+	if (batch_size <= 0)
+		batch_size = DEFAULT_BATCH_SIZE;
+
+	builder.pool = g_thread_pool_new (parse_batch, &builder, n_threads, TRUE, NULL);
+	builder.finished = g_async_queue_new ();
+	builder.pending = g_hash_table_new (g_int64_hash, g_int64_equal);
+	builder.batch_size = batch_size;
+	builder.max_in_flight = 4 * n_threads;
+	builder.writer = _geocode_gazetteer_writer_new ();
+
+	for (i = 2; i < argc && error == NULL; i++)
+		read_input (&builder, argv[i], &error);
+
+	wait_for_batches (&builder, 0);
+	g_thread_pool_free (builder.pool, FALSE, TRUE);
+
+	if (error == NULL)
+		_geocode_gazetteer_writer_write (builder.writer, output, &error);
+
+	if (error == NULL)
+		g_print ("%u places from %" G_GUINT64_FORMAT " lines written to %s "
+		         "(%" G_GUINT64_FORMAT " lines could not be parsed)\n",
+		         _geocode_gazetteer_writer_get_n_places (builder.writer),
+		         builder.n_lines, output, builder.n_errors);
+
+	_geocode_gazetteer_writer_free (builder.writer);
+	g_hash_table_unref (builder.pending);
+	g_async_queue_unref (builder.finished);
+
+	if (error != NULL) {
+		g_printerr ("%s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}